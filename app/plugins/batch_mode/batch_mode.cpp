@@ -17,8 +17,11 @@
 
 #include "batch_mode.h"
 
+#include <fstream>
+
 #include "vulkan_sample.h"
 
+#include "core/util/startup_profiler.hpp"
 #include "platform/parser.h"
 
 namespace plugins
@@ -53,6 +56,11 @@ void BatchMode::init(const vkb::CommandParser &parser)
 		wrap_to_start = true;
 	}
 
+	if (parser.contains(&startup_report_flag))
+	{
+		startup_report_file = parser.as<std::string>(&startup_report_flag);
+	}
+
 	std::vector<std::string> tags;
 	if (parser.contains(&tags_flag))
 	{
@@ -108,6 +116,11 @@ void BatchMode::init(const vkb::CommandParser &parser)
 
 void BatchMode::on_update(float delta_time)
 {
+	if (!startup_recorded)
+	{
+		record_startup();
+	}
+
 	elapsed_time += delta_time;
 
 	// When the runtime for the current configuration is reached, advance to the next config or next sample
@@ -144,9 +157,52 @@ void BatchMode::request_app()
 	LOGI("Running {}", (*sample_iter)->id);
 	LOGI("===========================================");
 
+	startup_recorded = false;
 	platform->request_application((*sample_iter));
 }
 
+void BatchMode::record_startup()
+{
+	// The platform stops the startup profiler once the first frame of the sample is rendered
+	auto &startup_profiler = vkb::StartupProfiler::get();
+	if (startup_profiler.is_recording() || startup_profiler.get_root().name != (*sample_iter)->id)
+	{
+		return;
+	}
+	startup_recorded = true;
+
+	startup_times.emplace_back((*sample_iter)->id, startup_profiler.get_root().duration_ms);
+	startup_reports.push_back(startup_profiler.to_json());
+
+	if (!startup_report_file.empty())
+	{
+		// Written after each sample, so that the report survives a sample crashing the batch
+		std::ofstream report{startup_report_file, std::ios::trunc};
+		report << "[";
+		for (size_t i = 0; i < startup_reports.size(); ++i)
+		{
+			report << (i > 0 ? ",\n" : "\n") << startup_reports[i];
+		}
+		report << "\n]\n";
+
+		if (!report)
+		{
+			LOGW("Failed to write the startup report to {}", startup_report_file);
+		}
+	}
+}
+
+void BatchMode::log_startup_times()
+{
+	LOGI("===========================================");
+	LOGI("Time to first frame");
+	LOGI("===========================================");
+	for (auto &startup_time : startup_times)
+	{
+		LOGI("{}: {:.1f} ms", startup_time.first, startup_time.second);
+	}
+}
+
 void BatchMode::load_next_app()
 {
 	// Wrap it around to the start
@@ -159,6 +215,7 @@ void BatchMode::load_next_app()
 		}
 		else
 		{
+			log_startup_times();
 			platform->close();
 			return;
 		}
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <chrono>
+#include <string>
 #include <vector>
 
 #include "apps.h"
@@ -37,6 +38,9 @@ using BatchModeTags = vkb::PluginBase<vkb::tags::Entrypoint, vkb::tags::FullCont
  *
  * Usage: vulkan_samples batch --duration 3 --category performance --tag arm
  *
+ * The time to first frame of each sample is logged once the batch is over. Using --startup-report also writes it to a file as JSON,
+ * broken down per startup phase, to track cold start regressions across builds.
+ *
  */
 class BatchMode : public BatchModeTags
 {
@@ -64,7 +68,9 @@ class BatchMode : public BatchModeTags
 
 	vkb::FlagCommand skip_flag{vkb::FlagType::ManyValues, "skip", "", "Skip a sample by id"};
 
-	vkb::SubCommand batch_cmd{"batch", "Enable batch mode", {&duration_flag, &wrap_flag, &tags_flag, &categories_flag, &skip_flag}};
+	vkb::FlagCommand startup_report_flag{vkb::FlagType::OneValue, "startup-report", "", "Write the startup timings of each sample as JSON to the given file"};
+
+	vkb::SubCommand batch_cmd{"batch", "Enable batch mode", {&duration_flag, &wrap_flag, &tags_flag, &categories_flag, &skip_flag, &startup_report_flag}};
 
   private:
 	/// The list of suitable samples to be run in conjunction with batch mode
@@ -80,8 +86,23 @@ class BatchMode : public BatchModeTags
 
 	bool wrap_to_start = false;
 
+	/// Whether the startup of the current sample was recorded already
+	bool startup_recorded = false;
+
+	/// The time to first frame of each sample run, in milliseconds
+	std::vector<std::pair<std::string, double>> startup_times;
+
+	/// The startup timings of each sample run, as JSON objects
+	std::vector<std::string> startup_reports;
+
+	std::string startup_report_file;
+
 	void request_app();
 
+	void record_startup();
+
+	void log_startup_times();
+
 	void load_next_app();
 };
 }        // namespace plugins
\ No newline at end of file
@@ -17,15 +17,18 @@
 
 #include "benchmark_mode.h"
 
+#include "core/util/hash.hpp"
 #include "platform/platform.h"
+#include "rendering/gpu_profiler.h"
+#include "rendering/render_context.h"
 
 namespace plugins
 {
 BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
                       "Log frame averages after running an app.",
-                      {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
-                      {&benchmark_flag})
+                      {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                      {&benchmark_flag, &readback_flag})
 {
 }
 
@@ -40,6 +43,11 @@ void BenchmarkMode::init(const vkb::CommandParser &parser)
 	// This will effect the graph outputs of framerate
 	platform->force_simulation_fps(60.0f);
 	platform->force_render(true);
+
+	if (parser.contains(&readback_flag))
+	{
+		readback_interval = parser.as<uint32_t>(&readback_flag);
+	}
 }
 
 void BenchmarkMode::on_update(float delta_time)
@@ -50,13 +58,75 @@ void BenchmarkMode::on_update(float delta_time)
 
 void BenchmarkMode::on_app_start(const std::string &app_id)
 {
-	elapsed_time = 0;
-	total_frames = 0;
+	elapsed_time   = 0;
+	total_frames   = 0;
+	current_app_id = app_id;
+	vkb::GpuProfiler::get().reset_averages();
 	LOGI("Starting Benchmark for {}", app_id);
 }
 
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
 	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+
+	for (auto &pass : vkb::GpuProfiler::get().get_averages())
+	{
+		LOGI("Benchmark for {} GPU pass {} averaged {:.3f} ms over {} frames", app_id, pass.name, pass.average_ms, pass.frame_count);
+	}
+}
+
+void BenchmarkMode::on_post_draw(vkb::RenderContext &context)
+{
+	if (readback_interval == 0 || total_frames % readback_interval != 0)
+	{
+		return;
+	}
+
+	// A swapchain image was already presented and may be acquired again before the copy runs, only offscreen images are read back
+	if (context.has_swapchain())
+	{
+		if (!readback_warned)
+		{
+			LOGW("Benchmark readback requires --offscreen, no checksum is logged");
+			readback_warned = true;
+		}
+		return;
+	}
+
+	// The image of the frame stays in the layout its render target recorded last, until the frame is rendered again
+	auto         &render_target = context.get_last_rendered_frame().get_render_target();
+	auto         &image_view    = render_target.get_views()[0];
+	auto          extent        = image_view.get_image().get_extent();
+	VkImageLayout layout        = render_target.get_layout(0);
+
+	auto           &readback_service = context.get_readback_service();
+	VkCommandBuffer command_buffer   = readback_service.get_command_buffer();
+
+	VkImageSubresourceRange subresource_range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+	vkb::image_layout_transition(command_buffer, image_view.get_image().get_handle(),
+	                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                             VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+	                             layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, subresource_range);
+
+	VkBufferImageCopy region{};
+	region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+	region.imageExtent      = extent;
+
+	VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * vkb::get_bits_per_pixel(image_view.get_format()) / 8;
+
+	// The checksum is logged a few frames later, once the copy completed
+	readback_service.read_image(image_view.get_image().get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, region, size,
+	                            [app_id = current_app_id, frame = total_frames](const uint8_t *data, VkDeviceSize size) {
+		                            LOGI("Benchmark for {} frame {} checksum {:016x}", app_id, frame, vkb::hash_fnv1a(data, static_cast<size_t>(size)));
+	                            });
+
+	vkb::image_layout_transition(command_buffer, image_view.get_image().get_handle(),
+	                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                             VK_ACCESS_TRANSFER_READ_BIT, 0,
+	                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, layout, subresource_range);
+
+	// Submit right away, before the image is rendered to again
+	readback_service.submit();
 }
 }        // namespace plugins
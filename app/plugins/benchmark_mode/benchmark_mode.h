@@ -32,6 +32,12 @@ using BenchmarkModeTags = vkb::PluginBase<BenchmarkMode, vkb::tags::Passive>;
  * 
  * Usage: vulkan_samples sample afbc --benchmark
  * 
+ * Combined with --offscreen, samples are benchmarked without a window nor a swap-chain, for instance on a software implementation.
+ * With --readback-interval, the rendered image is read back every N frames and a checksum of it is logged, so that the output
+ * of runs can be compared. Readback is only done in offscreen mode, as swapchain images are already presented.
+ * 
+ * Usage: vulkan_samples batch --category performance --benchmark --offscreen --readback-interval 100
+ * 
  */
 class BenchmarkMode : public BenchmarkModeTags
 {
@@ -50,11 +56,20 @@ class BenchmarkMode : public BenchmarkModeTags
 
 	virtual void on_app_close(const std::string &app_info) override;
 
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
 	vkb::FlagCommand benchmark_flag = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
+	vkb::FlagCommand readback_flag  = {vkb::FlagType::OneValue, "readback-interval", "", "Log a checksum of the rendered image every N frames"};
 
   private:
 	uint32_t total_frames{0};
 
 	float elapsed_time{0.0f};
+
+	uint32_t readback_interval{0};
+
+	bool readback_warned{false};
+
+	std::string current_app_id;
 };
 }        // namespace plugins
\ No newline at end of file
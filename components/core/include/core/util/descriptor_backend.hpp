@@ -0,0 +1,80 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief How the descriptor sets of a pipeline layout are provided to the GPU when recording
+ */
+enum class DescriptorBackend
+{
+	/// Descriptor sets allocated from the render frame's descriptor pools (default)
+	Pool,
+	/// A single small set pushed directly into the command buffer (VK_KHR_push_descriptor)
+	PushDescriptor,
+	/// Descriptors written into the render frame's descriptor buffer heap (VK_EXT_descriptor_buffer)
+	DescriptorBuffer
+};
+
+/**
+ * @brief The descriptors of a set of a pipeline layout
+ */
+struct DescriptorSetUsage
+{
+	uint32_t set_index{0};
+
+	/// Number of descriptors, counting each array element
+	uint32_t descriptor_count{0};
+
+	/// Whether a binding uses dynamic offsets or update-after-bind, which neither push descriptors nor descriptor buffers support
+	bool dynamic_or_update_after_bind{false};
+
+	/// Whether the descriptor buffer path knows the size and encoding of every descriptor type of the set
+	bool buffer_encodable{true};
+};
+
+/**
+ * @brief The descriptor backends a device can use besides pools
+ */
+struct DescriptorBackendSupport
+{
+	/// VK_KHR_push_descriptor is enabled
+	bool push_descriptor{false};
+
+	/// maxPushDescriptors of VK_KHR_push_descriptor
+	uint32_t max_push_descriptors{0};
+
+	/// VK_EXT_descriptor_buffer is enabled, with its descriptorBuffer and bufferDeviceAddress features
+	bool descriptor_buffer{false};
+};
+
+/**
+ * @brief Selects the cheapest backend the device supports for a pipeline layout
+ *
+ * Push descriptors are preferred, but only a single set per layout may be pushed. Descriptor buffers come next.
+ * Layouts without descriptors, or with dynamic or update-after-bind descriptors, use pools.
+ * @param sets The sets of the layout which have descriptors
+ * @param support The backends the device can use
+ * @param push_descriptor_set_index Set to the index of the set pushed with DescriptorBackend::PushDescriptor
+ */
+DescriptorBackend select_descriptor_backend(const std::vector<DescriptorSetUsage> &sets, const DescriptorBackendSupport &support, uint32_t &push_descriptor_set_index);
+}        // namespace vkb
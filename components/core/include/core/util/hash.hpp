@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 
 namespace vkb
@@ -38,4 +40,18 @@ inline void hash_combine(size_t &seed, const T &v)
 
 	hash_combine(seed, hasher(v));
 }
+
+/**
+ * @brief 64-bit FNV-1a hash of a block of data, stable across runs and platforms, as needed for file cache keys
+ * @param seed Mixed into the offset basis, so that the same data hashes differently for different uses
+ */
+inline uint64_t hash_fnv1a(const uint8_t *data, size_t size, uint64_t seed = 0)
+{
+	uint64_t hash = 14695981039346656037ull ^ seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
 }        // namespace vkb
\ No newline at end of file
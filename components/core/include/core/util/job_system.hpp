@@ -0,0 +1,215 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Counts the jobs submitted with it which have not finished yet
+ *
+ * A counter can be waited for with JobSystem::wait, and jobs can be submitted with a counter as dependency so that
+ * they only start once it reaches zero. The first exception thrown by its jobs is rethrown by JobSystem::wait.
+ */
+class JobCounter
+{
+  public:
+	JobCounter() = default;
+
+	JobCounter(const JobCounter &) = delete;
+
+	JobCounter &operator=(const JobCounter &) = delete;
+
+	bool is_done() const;
+
+	uint32_t get_value() const;
+
+  private:
+	friend class JobSystem;
+
+	std::atomic<uint32_t> value{0};
+
+	std::mutex error_mutex;
+
+	std::exception_ptr error;
+};
+
+/**
+ * @brief Runs jobs on a fixed set of worker threads shared by the whole framework
+ *
+ * Each worker has a deque of its own: jobs it submits are pushed to the back and popped from the back, so nested
+ * work stays hot in its cache, while idle workers steal the oldest jobs from the front of the other deques.
+ * Jobs submitted by other threads are spread over the workers.
+ *
+ * A thread waiting for a counter runs jobs meanwhile, and sleeps once it finds none it may run. Workers run any job,
+ * so that waiting from a job never deadlocks, while other threads, such as the render thread, only run the jobs of the
+ * counter they wait for, so that they are not held up by a long job of another subsystem.
+ *
+ * The job system of the framework is shut down by the platform before static objects are destroyed, jobs submitted
+ * afterwards run on the submitting thread.
+ */
+class JobSystem
+{
+  public:
+	using Job = std::function<void()>;
+
+	/**
+	 * @return The job system of the framework, with a worker per hardware thread besides the calling one
+	 */
+	static JobSystem &get();
+
+	explicit JobSystem(uint32_t worker_count);
+
+	/**
+	 * @brief Shuts down the job system if it is still running
+	 */
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+
+	JobSystem &operator=(const JobSystem &) = delete;
+
+	/**
+	 * @brief Runs the jobs which are still queued, then joins the workers
+	 *        Must not be called from a job.
+	 */
+	void shutdown();
+
+	uint32_t get_worker_count() const;
+
+	/**
+	 * @return The index of the calling worker in this job system, or get_worker_count() if it is not one of its workers
+	 */
+	uint32_t get_current_worker_index() const;
+
+	/**
+	 * @brief Queues a job
+	 * @param job The job to run
+	 * @param counter Optional counter, increased now and decreased once the job has run
+	 * @param dependency Optional counter the job waits for, the job is queued once it reaches zero
+	 */
+	void submit(Job job, JobCounter *counter = nullptr, const JobCounter *dependency = nullptr);
+
+	/**
+	 * @brief Runs jobs until the counter reaches zero, sleeping while none of them can run
+	 * @throws The first exception thrown by a job of the counter
+	 */
+	void wait(JobCounter &counter);
+
+	/**
+	 * @brief Splits [0, count) into ranges of at least grain_size elements and runs them in parallel,
+	 *        the calling thread runs one of them and returns once all of them have run
+	 * @param func Called with the begin and end of each range
+	 */
+	void parallel_for(size_t count, size_t grain_size, const std::function<void(size_t, size_t)> &func);
+
+	/**
+	 * @return The time each worker spent running jobs since it started, in seconds
+	 */
+	std::vector<double> get_worker_busy_times() const;
+
+	/**
+	 * @return The number of jobs which were stolen from the deque of another worker
+	 */
+	uint64_t get_steal_count() const;
+
+  private:
+	struct Task
+	{
+		Job job;
+
+		JobCounter *counter{nullptr};
+	};
+
+	struct Worker
+	{
+		std::mutex mutex;
+
+		std::deque<Task> tasks;
+
+		std::thread thread;
+
+		std::atomic<uint64_t> busy_ns{0};
+	};
+
+	struct PendingTask
+	{
+		Task task;
+
+		const JobCounter *dependency;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	// Jobs waiting for their dependency
+	std::mutex pending_mutex;
+
+	std::vector<PendingTask> pending_tasks;
+
+	// Workers sleep while no job is queued
+	std::mutex sleep_mutex;
+
+	std::condition_variable wake_condition;
+
+	std::atomic<size_t> queued_count{0};
+
+	std::atomic<uint32_t> next_worker{0};
+
+	std::atomic<uint64_t> steal_count{0};
+
+	bool stopping{false};
+
+	// Set once the workers are joined
+	std::atomic<bool> stopped{false};
+
+	// Threads waiting for a counter sleep until a job is queued or a counter reaches zero
+	std::mutex wait_mutex;
+
+	std::condition_variable wait_condition;
+
+	std::atomic<uint32_t> waiting_count{0};
+
+	std::atomic<uint64_t> push_epoch{0};
+
+	void worker_loop(uint32_t worker_index);
+
+	void push_task(Task &&task);
+
+	/**
+	 * @brief Pops a job from the deque of the calling worker, or steals one
+	 * @param counter If not null, only jobs of this counter are taken
+	 */
+	bool pop_task(Task &task, const JobCounter *counter);
+
+	void run_task(Task &task);
+
+	void release_dependents(const JobCounter *counter);
+
+	void notify_waiting_threads();
+};
+}        // namespace vkb
@@ -0,0 +1,85 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Reorders triangles to reuse the post-transform vertex cache, with Tom Forsyth's linear-speed algorithm
+ * @param destination Receives the reordered indices, may be the same memory as indices
+ * @param indices Triangle list indices
+ * @param index_count Number of indices, a multiple of 3
+ * @param vertex_count Number of vertices referenced by the indices
+ */
+void optimize_vertex_cache(uint32_t *destination, const uint32_t *indices, size_t index_count, size_t vertex_count);
+
+/**
+ * @brief Reorders clusters of triangles so that the ones facing outwards are drawn first, reducing overdraw
+ *
+ * The triangle list should already be optimized for the vertex cache. It is split where the cache is flushed,
+ * and where the cache efficiency so far is within the threshold of the one of the whole split (Sander et al., "Fast
+ * triangle reordering for vertex locality and reduced overdraw"). The splits are then sorted by how far out they face.
+ *
+ * @param indices Triangle list indices, reordered in place
+ * @param index_count Number of indices, a multiple of 3
+ * @param positions Three floats per vertex, the first of every position_stride bytes
+ * @param vertex_count Number of vertices referenced by the indices
+ * @param position_stride Distance in bytes between two positions
+ * @param threshold How much worse than the original the vertex cache efficiency may get, 1 keeps it unchanged
+ */
+void optimize_overdraw(uint32_t *indices, size_t index_count, const float *positions, size_t vertex_count, size_t position_stride, float threshold = 1.05f);
+
+/**
+ * @brief Renumbers vertices in the order the triangles first use them, so that vertex fetches walk memory linearly
+ * @param indices Triangle list indices, rewritten in place
+ * @param index_count Number of indices
+ * @param vertex_count Number of vertices referenced by the indices
+ * @return For each new vertex, the index of the old vertex to copy, vertices that no triangle uses are dropped
+ */
+std::vector<uint32_t> optimize_vertex_fetch(uint32_t *indices, size_t index_count, size_t vertex_count);
+
+/**
+ * @brief Computes the average number of vertex shader invocations per triangle for a FIFO cache of the given size
+ */
+float get_average_cache_miss_ratio(const uint32_t *indices, size_t index_count, size_t vertex_count, uint32_t cache_size = 16);
+
+/**
+ * @brief Converts a float to the bits of a half float, rounding to nearest even
+ *        Values out of the half float range become infinities, NaNs stay NaNs
+ */
+uint16_t quantize_half(float value);
+
+/**
+ * @brief Converts a float in [-1, 1] to a signed normalized integer of the given number of bits, rounding to nearest
+ */
+int32_t quantize_snorm(float value, uint32_t bits);
+
+/**
+ * @brief Packs four floats in [-1, 1] as VK_FORMAT_R8G8B8A8_SNORM, x in the lowest byte
+ */
+uint32_t pack_snorm_r8g8b8a8(float x, float y, float z, float w);
+
+/**
+ * @brief Packs four floats in [-1, 1] as VK_FORMAT_A2B10G10R10_SNORM_PACK32, w only keeps its sign
+ */
+uint32_t pack_snorm_a2b10g10r10(float x, float y, float z, float w);
+}        // namespace vkb
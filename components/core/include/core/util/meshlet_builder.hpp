@@ -0,0 +1,119 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Limits of the meshlets built by build_meshlets
+ */
+struct MeshletOptions
+{
+	// At most 255, local vertex indices are stored in a byte
+	uint32_t max_vertices{64};
+
+	uint32_t max_triangles{124};
+
+	// Between 0 and 1, how much the orientation of a triangle matters against its distance when growing a meshlet.
+	// Higher values give tighter normal cones, so more meshlets culled as back facing, at the cost of larger bounding spheres
+	float cone_weight{0.25f};
+};
+
+/**
+ * @brief Ranges of a meshlet in the flat arrays of a MeshletMesh
+ */
+struct MeshletRange
+{
+	uint32_t vertex_offset;
+	uint32_t vertex_count;
+	uint32_t triangle_offset;
+	uint32_t triangle_count;
+};
+
+/**
+ * @brief Culling data of a meshlet
+ *
+ * The meshlet is entirely inside the sphere. It can be culled as back facing from a camera at position p when
+ * dot(normalize(cone_apex - p), cone_axis) >= cone_cutoff.
+ */
+struct MeshletBounds
+{
+	float center[3];
+	float radius;
+	float cone_apex[3];
+	float cone_axis[3];
+
+	// Sine of the cone half angle, 1 when the triangles face too many directions for the meshlet to be culled
+	float cone_cutoff;
+};
+
+/**
+ * @brief Meshlets of a mesh, with all their data in flat arrays
+ */
+struct MeshletMesh
+{
+	std::vector<MeshletRange> meshlets;
+
+	std::vector<MeshletBounds> bounds;
+
+	// Mesh vertex indices referenced by the meshlets, meshlet i uses [vertex_offset, vertex_offset + vertex_count)
+	std::vector<uint32_t> vertices;
+
+	// Three indices per triangle into the vertices of its meshlet, meshlet i uses [3 * triangle_offset, 3 * (triangle_offset + triangle_count))
+	std::vector<uint8_t> triangles;
+};
+
+/**
+ * @brief Indexed triangle list with positions, as read by build_meshlets
+ */
+struct MeshletSource
+{
+	const uint32_t *indices;
+	size_t          index_count;
+
+	// Three floats per vertex, the first of every position_stride bytes
+	const float *positions;
+	size_t       vertex_count;
+	size_t       position_stride;
+};
+
+/**
+ * @brief Splits a triangle list into meshlets
+ *
+ * Triangles are first ordered for vertex cache reuse. Meshlets are then grown from that order, each one adding
+ * the adjacent triangle that brings the fewest new vertices, then the one closest to the meshlet in position and orientation.
+ * A meshlet is closed once no adjacent triangle fits in the limits, or none is left.
+ *
+ * @param source Triangle list to split
+ * @param options Limits of the meshlets
+ */
+MeshletMesh build_meshlets(const MeshletSource &source, const MeshletOptions &options = {});
+
+/**
+ * @brief Builds the meshlets of several meshes, each one on its own thread
+ * @param sources Triangle lists to split
+ * @param options Limits of the meshlets
+ * @param thread_count Maximum number of threads, 0 uses all hardware threads
+ * @return The meshlets of each source, in the same order
+ */
+std::vector<MeshletMesh> build_meshlets(const std::vector<MeshletSource> &sources, const MeshletOptions &options = {}, uint32_t thread_count = 0);
+}        // namespace vkb
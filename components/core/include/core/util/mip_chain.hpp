@@ -0,0 +1,70 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Downsampling filter used to build a mip chain
+ */
+enum class MipFilter
+{
+	// Average of the source texels covered by a destination texel
+	Box,
+
+	// Kaiser windowed sinc, sharper than Box at the cost of more taps
+	Kaiser
+};
+
+/**
+ * @brief Placement of one level in a tightly packed RGBA8 mip chain
+ */
+struct MipLevel
+{
+	uint32_t width;
+	uint32_t height;
+	size_t   offset;
+};
+
+/**
+ * @brief Computes the layout of a full RGBA8 mip chain, from the base level down to 1x1
+ * @param width Width of the base level
+ * @param height Height of the base level
+ * @param total_size Receives the size in bytes of the whole chain, including the base level
+ */
+std::vector<MipLevel> get_mip_chain_layout(uint32_t width, uint32_t height, size_t &total_size);
+
+/**
+ * @brief Fills every level but the first of an RGBA8 mip chain, each from the previous one
+ *
+ * Pixels are filtered four channels at a time with SSE2 or NEON where available.
+ * For sRGB content the color channels are decoded to linear before filtering and encoded again afterwards,
+ * alpha is always filtered as is.
+ *
+ * @param data Memory holding the whole chain, laid out as in levels, with the base level filled in
+ * @param levels Layout of the chain as returned by get_mip_chain_layout
+ * @param srgb Whether the color channels are sRGB encoded
+ * @param filter Downsampling filter
+ * @param thread_count Number of bands the rows of a level are split across, run on the job system, 0 uses all hardware threads
+ */
+void build_mip_chain(uint8_t *data, const std::vector<MipLevel> &levels, bool srgb, MipFilter filter = MipFilter::Box, uint32_t thread_count = 0);
+}        // namespace vkb
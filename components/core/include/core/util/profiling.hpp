@@ -23,24 +23,35 @@
 #include <unordered_map>
 
 #include "core/util/error.hpp"
+#include "core/util/zone_profiler.hpp"
 
 #ifdef TRACY_ENABLE
 #	include <tracy/Tracy.hpp>
 #endif
 
+#define VKB_PROFILE_CONCAT_(a, b) a##b
+#define VKB_PROFILE_CONCAT(a, b) VKB_PROFILE_CONCAT_(a, b)
+
+// Zones are always recorded by vkb::ZoneProfiler while it is enabled, and by Tracy when profiling is enabled
+#define VKB_ZONE_SCOPE(name) vkb::ZoneScope VKB_PROFILE_CONCAT(zone_scope_, __LINE__)(name)
+
 #ifdef TRACY_ENABLE
 // malloc and free are used by Tracy to provide memory profiling
 void *operator new(size_t count);
 void  operator delete(void *ptr) noexcept;
 
 // Tracy a scope
-#	define PROFILE_SCOPE(name) ZoneScopedN(name)
+#	define PROFILE_SCOPE(name) \
+		ZoneScopedN(name);      \
+		VKB_ZONE_SCOPE(name)
 
 // Trace a function
-#	define PROFILE_FUNCTION() ZoneScoped
+#	define PROFILE_FUNCTION() \
+		ZoneScoped;            \
+		VKB_ZONE_SCOPE(__func__)
 #else
-#	define PROFILE_SCOPE(name)
-#	define PROFILE_FUNCTION()
+#	define PROFILE_SCOPE(name) VKB_ZONE_SCOPE(name)
+#	define PROFILE_FUNCTION() VKB_ZONE_SCOPE(__func__)
 #endif
 
 // The type of plot to use
@@ -0,0 +1,156 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief The images a render graph pass uses, as indices into the images of the graph
+ */
+struct RenderGraphPassResources
+{
+	/// Images whose content the pass reads, such as sampled images or loaded attachments
+	std::vector<uint32_t> reads;
+
+	/// Images the pass writes, including all its attachments
+	std::vector<uint32_t> writes;
+};
+
+/**
+ * @brief Finds the passes whose results are used
+ *
+ * Passes run in order, so walking them backwards finds the writers of every needed image. A pass writing a
+ * needed image is active, and the images it reads become needed in turn. The other passes can be culled.
+ * @param passes The resources of the passes, in execution order
+ * @param needed_images Whether the content of each image is used after the execution
+ * @return Whether each pass is active
+ */
+std::vector<bool> find_active_passes(const std::vector<RenderGraphPassResources> &passes, std::vector<bool> needed_images);
+
+/**
+ * @brief Memory requirements and lifetime of a transient image
+ */
+struct RenderGraphImageMemory
+{
+	uint64_t size{0};
+
+	uint64_t alignment{1};
+
+	uint32_t memory_type_bits{~0u};
+
+	/// First and last active passes using the image
+	uint32_t first_pass{0};
+
+	uint32_t last_pass{0};
+
+	/// The image shares its memory with no other image, as lazily allocated images do
+	bool dedicated{false};
+};
+
+/**
+ * @brief Memory shared by images whose lifetimes do not overlap
+ */
+struct RenderGraphMemoryBlock
+{
+	uint64_t size{0};
+
+	uint64_t alignment{1};
+
+	uint32_t memory_type_bits{~0u};
+
+	/// Indices of the images bound to the block
+	std::vector<uint32_t> images;
+};
+
+/**
+ * @brief Assigns transient images to memory blocks
+ *
+ * Images are placed from the largest to the smallest, each in the first block whose images it does not overlap in
+ * time with and whose memory types it supports. A block is as large and as aligned as its largest requirements.
+ * @param images The images to place
+ * @return The memory blocks, every image belongs to exactly one of them
+ */
+std::vector<RenderGraphMemoryBlock> alias_image_memory(const std::vector<RenderGraphImageMemory> &images);
+
+/**
+ * @brief How a pass accesses an image
+ *
+ * Stages, accesses and layouts hold the values of VkPipelineStageFlags2, VkAccessFlags2 and VkImageLayout.
+ */
+struct RenderGraphImageAccess
+{
+	uint64_t stages{0};
+
+	uint64_t access{0};
+
+	uint32_t layout{0};
+
+	bool write{false};
+};
+
+/**
+ * @brief State of an image between the passes of an execution, a layout of 0 is VK_IMAGE_LAYOUT_UNDEFINED
+ */
+struct RenderGraphImageState
+{
+	uint32_t layout{0};
+
+	/// Stages and accesses of the last write, or of the last layout transition
+	uint64_t write_stages{0};
+
+	uint64_t write_access{0};
+
+	/// Stages that read the image since the last write
+	uint64_t read_stages{0};
+
+	/// Stages and accesses the last write was made visible to
+	uint64_t visible_stages{0};
+
+	uint64_t visible_access{0};
+};
+
+/**
+ * @brief The dependency an access needs on the earlier accesses of an image
+ */
+struct RenderGraphImageBarrier
+{
+	bool needed{false};
+
+	uint64_t src_stages{0};
+
+	uint64_t src_access{0};
+
+	uint32_t old_layout{0};
+
+	uint32_t new_layout{0};
+};
+
+/**
+ * @brief Computes the barrier an access needs, and updates the state of the image
+ *
+ * Layout transitions and writes wait for all earlier accesses. Reads wait for the last write, unless an earlier
+ * barrier already made it visible to their stages and accesses.
+ * @param state State of the image, updated with the access
+ * @param access The access of the image
+ * @param write_access_mask The accesses that write memory
+ */
+RenderGraphImageBarrier track_image_access(RenderGraphImageState &state, const RenderGraphImageAccess &access, uint64_t write_access_mask);
+}        // namespace vkb
@@ -0,0 +1,145 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/util/profiling.hpp"
+
+// Time a phase of the startup of an app, also traced by Tracy when profiling is enabled
+#define PROFILE_STARTUP_SCOPE(name) \
+	PROFILE_SCOPE(name);            \
+	vkb::StartupScope VKB_PROFILE_CONCAT(startup_scope_, __LINE__){name}
+
+namespace vkb
+{
+/**
+ * @brief Records a tree of timed phases while an app starts, from its creation until its first frame is rendered
+ *
+ * Scopes are only recorded between start and stop, and on the thread which called start, so the scopes spread
+ * across the framework cost next to nothing once the app runs. Scopes with the same name and parent are merged,
+ * for instance the shader compiles of a scene load, keeping their total duration and how many there were.
+ */
+class StartupProfiler
+{
+  public:
+	struct Node
+	{
+		Node() = default;
+
+		explicit Node(const char *name) :
+		    name{name}
+		{}
+
+		std::string name;
+
+		double duration_ms{0.0};
+
+		uint32_t count{0};
+
+		std::vector<Node> children;
+	};
+
+	static StartupProfiler &get();
+
+	/**
+	 * @brief Starts recording the startup of an app, dropping the previous recording
+	 * @param name Name of the root of the tree, usually the id of the app
+	 */
+	void start(const std::string &name);
+
+	/**
+	 * @brief Stops recording, scopes which are still open are closed
+	 */
+	void stop();
+
+	bool is_recording() const;
+
+	/**
+	 * @brief Opens a scope under the innermost open one
+	 * @return An id to close the scope with, 0 if the scope is not recorded
+	 */
+	uint32_t begin_scope(const char *name);
+
+	void end_scope(uint32_t scope_id);
+
+	/**
+	 * @return The last recording, complete once stopped
+	 */
+	const Node &get_root() const;
+
+	/**
+	 * @return The tree as indented lines, with durations and shares of the parent phase
+	 */
+	std::vector<std::string> to_lines() const;
+
+	/**
+	 * @return The tree as a JSON object, children nested in a "children" array
+	 */
+	std::string to_json() const;
+
+  private:
+	using Clock = std::chrono::steady_clock;
+
+	struct OpenScope
+	{
+		// Ancestors are never reallocated while a scope is open, children are only added to the innermost scope
+		Node *node;
+
+		Clock::time_point start;
+	};
+
+	mutable std::mutex mutex;
+
+	Node root;
+
+	std::vector<OpenScope> open_scopes;
+
+	std::thread::id thread_id;
+
+	bool recording{false};
+
+	// Increased by every start, so that scopes opened during a previous recording are not closed in this one
+	uint32_t recording_index{0};
+
+	void close_scope();
+};
+
+/**
+ * @brief Records a startup phase for the lifetime of the object, see PROFILE_STARTUP_SCOPE
+ */
+class StartupScope
+{
+  public:
+	explicit StartupScope(const char *name);
+
+	~StartupScope();
+
+	StartupScope(const StartupScope &) = delete;
+
+	StartupScope &operator=(const StartupScope &) = delete;
+
+  private:
+	uint32_t scope_id;
+};
+}        // namespace vkb
@@ -35,4 +35,9 @@ std::string trim_right(const std::string &str, const std::string &chars = " ");
  * @brief Removes all occurrences of a set of characters from the beginning of a string.
  */
 std::string trim_left(const std::string &str, const std::string &chars = " ");
+
+/**
+ * @brief Quotes a string for JSON, escaping quotes, backslashes and control characters.
+ */
+std::string to_json_string(const std::string &str);
 }        // namespace vkb
\ No newline at end of file
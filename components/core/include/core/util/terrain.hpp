@@ -0,0 +1,162 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief How height map coordinates out of the map are brought back into it, as the matching sampler address modes
+ */
+enum class HeightMapAddressMode
+{
+	ClampToEdge,
+	MirroredRepeat
+};
+
+/**
+ * @brief Texels of a 16-bit height map, rows first
+ */
+struct HeightMapView
+{
+	const uint16_t *data;
+	uint32_t        width;
+	uint32_t        height;
+};
+
+/**
+ * @brief Reads a grid of heights from a height map, normalized to [0, 1]
+ *
+ * Sample (i, j) reads texel ((x + i) * stride, (y + j) * stride). Grid coordinates out of the map are clamped or mirrored
+ * as a whole, so that a grid of width / stride samples covers the map once.
+ *
+ * @param map Height map to read
+ * @param x First column of the grid
+ * @param y First row of the grid
+ * @param count_x Number of columns
+ * @param count_y Number of rows
+ * @param stride Distance between two samples, in texels
+ * @param address_mode How samples out of the map are read
+ * @param heights Receives count_x * count_y heights, rows first
+ */
+void sample_heights(const HeightMapView &map, int32_t x, int32_t y, uint32_t count_x, uint32_t count_y, uint32_t stride,
+                    HeightMapAddressMode address_mode, float *heights);
+
+/**
+ * @brief Computes terrain normals from a grid of heights with a Sobel filter
+ *
+ * The up axis is y, and the heights go along x and z. The filtered gradient is scaled by 2 on x and z before normalization.
+ *
+ * @param heights (count_x + 2) * (count_y + 2) heights, rows first, with a border of one sample around the grid
+ * @param count_x Number of columns of normals
+ * @param count_y Number of rows of normals
+ * @param normals Receives count_x * count_y normals, three floats each, the first of every normal_stride bytes, rows first
+ * @param normal_stride Distance in bytes between two normals
+ */
+void compute_sobel_normals(const float *heights, uint32_t count_x, uint32_t count_y, float *normals, size_t normal_stride);
+
+/**
+ * @brief Finds the lowest and highest heights of a rectangle of texels, normalized to [0, 1]
+ * @param map Height map to read
+ * @param x First column, in texels
+ * @param y First row, in texels
+ * @param width Number of columns
+ * @param height Number of rows
+ * @param address_mode How texels out of the map are read
+ * @param min_height Receives the lowest height
+ * @param max_height Receives the highest height
+ */
+void get_height_range(const HeightMapView &map, int32_t x, int32_t y, uint32_t width, uint32_t height, HeightMapAddressMode address_mode,
+                      float &min_height, float &max_height);
+
+/**
+ * @brief Placement of a grid of terrain patches in the world
+ *
+ * Patch (i, j) covers x in [origin_x + i * patch_size, origin_x + (i + 1) * patch_size], and the same along z with j.
+ * A normalized height h is at y = h * height_scale, the terrain rises along -y when the scale is negative.
+ */
+struct TerrainLayout
+{
+	float origin_x{0.0f};
+	float origin_z{0.0f};
+	float patch_size{1.0f};
+	float height_scale{1.0f};
+};
+
+/**
+ * @brief Node of a TerrainQuadtree, covering a rectangle of patches
+ */
+struct TerrainQuadtreeNode
+{
+	uint32_t x;
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+
+	// Normalized height range of the patches under the node
+	float min_height;
+	float max_height;
+
+	// Children are stored next to each other, leaves hold a single patch and no children
+	uint32_t first_child;
+	uint32_t child_count;
+};
+
+/**
+ * @brief Quadtree of the height bounds of a grid of terrain patches, culling the patches that cannot be seen
+ */
+class TerrainQuadtree
+{
+  public:
+	/**
+	 * @param patch_height_ranges Lowest and highest normalized height of each patch, two floats per patch, rows first
+	 * @param patch_count_x Number of columns of patches
+	 * @param patch_count_y Number of rows of patches
+	 */
+	TerrainQuadtree(const float *patch_height_ranges, uint32_t patch_count_x, uint32_t patch_count_y);
+
+	const std::vector<TerrainQuadtreeNode> &get_nodes() const;
+
+	uint32_t get_patch_count() const;
+
+	/**
+	 * @brief Lists the patches that may be visible, patch (i, j) being i + j * patch_count_x
+	 *
+	 * Nodes outside of the frustum are culled with their children. With horizon culling, the remaining patches are then
+	 * walked front to back: each patch under the horizon drawn by the lowest heights of the patches in front of it is culled.
+	 *
+	 * @param layout Placement of the patches
+	 * @param frustum_planes Six planes (a, b, c, d), a point p is inside when a * p.x + b * p.y + c * p.z + d >= 0 for all of them
+	 * @param eye World position of the viewer
+	 * @param horizon_culling Whether to cull the patches hidden by the terrain in front of them
+	 * @param visible_patches Receives the patches to draw, front to back with horizon culling
+	 */
+	void cull(const TerrainLayout &layout, const float frustum_planes[6][4], const float eye[3], bool horizon_culling,
+	          std::vector<uint32_t> &visible_patches) const;
+
+  private:
+	std::vector<TerrainQuadtreeNode> nodes;
+
+	uint32_t patch_count_x;
+
+	uint32_t patch_count_y;
+};
+}        // namespace vkb
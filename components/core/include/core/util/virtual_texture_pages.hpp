@@ -0,0 +1,165 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Page grid of a streamed mip level
+ */
+struct VirtualTexturePageLevel
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t columns;
+	uint32_t rows;
+	uint32_t first_page;
+};
+
+/**
+ * @brief A region of the texture, in normalized texture coordinates, sampled at a given level of detail
+ */
+struct VirtualTexturePageRequest
+{
+	float u_min{0.0f};
+	float v_min{0.0f};
+	float u_max{1.0f};
+	float v_max{1.0f};
+	float lod{0.0f};
+};
+
+/**
+ * @brief Tracks which pages of a sparse residency texture are wanted and which memory slots hold them
+ *
+ * Pages are numbered level after level, rows first, from the most detailed level. Slots are page-sized ranges of memory
+ * owned by the caller. Once all slots are used, the least recently used page gives its slot away, unless a frame in flight
+ * may still sample it.
+ *
+ * select_pages only reads the page grid, which does not change after construction, so it may run on another thread than
+ * the residency updates.
+ */
+class VirtualTexturePageTable
+{
+  public:
+	/**
+	 * @param width Width of the most detailed level, in texels
+	 * @param height Height of the most detailed level, in texels
+	 * @param mip_levels Number of levels of the texture, including the mip tail
+	 * @param streamed_levels Number of levels streamed as pages, the following ones are the always resident mip tail
+	 * @param page_width Width of a page, in texels
+	 * @param page_height Height of a page, in texels
+	 * @param slot_capacity Maximum number of slots
+	 * @param frames_in_flight Number of frames that may still sample a page after it was last used
+	 */
+	VirtualTexturePageTable(uint32_t width, uint32_t height, uint32_t mip_levels, uint32_t streamed_levels, uint32_t page_width, uint32_t page_height, uint32_t slot_capacity, uint32_t frames_in_flight);
+
+	const std::vector<VirtualTexturePageLevel> &get_levels() const;
+
+	uint32_t get_page_count() const;
+
+	/**
+	 * @return The level of the given page
+	 */
+	uint32_t get_level(uint32_t page_index) const;
+
+	/**
+	 * @brief Converts requests into a list of unique pages, coarser levels first
+	 *
+	 * The coarsest streamed level is always selected, so every texel has a resident fallback. Each request selects
+	 * the pages it covers in the two levels around its level of detail, as trilinear filtering samples both.
+	 */
+	std::vector<uint32_t> select_pages(const std::vector<VirtualTexturePageRequest> &requests) const;
+
+	/**
+	 * @brief Starts a new frame, pages used from now on are used by this frame
+	 */
+	void begin_frame();
+
+	/**
+	 * @return The slot holding the page, or -1 if it is not resident
+	 */
+	int64_t get_slot(uint32_t page_index) const;
+
+	/**
+	 * @brief Marks a resident page as used by the current frame, making it the most recently used
+	 */
+	void touch(uint32_t page_index);
+
+	/**
+	 * @return True if no slot is free and more can be added within the capacity
+	 */
+	bool needs_slots() const;
+
+	uint32_t get_slot_count() const;
+
+	uint32_t get_slot_capacity() const;
+
+	/**
+	 * @brief Adds free slots, numbered after the existing ones
+	 * @param count Number of slots, limited to the remaining capacity
+	 * @return The number of slots added
+	 */
+	uint32_t add_slots(uint32_t count);
+
+	/**
+	 * @brief Assigns a slot to a page that is not resident, evicting the least recently used page if no slot is free
+	 * @param page_index Page to make resident, it becomes the most recently used
+	 * @param evicted_page Receives the page whose slot was reused, or -1
+	 * @return The slot index, or -1 if all slots hold pages a frame in flight may still sample
+	 */
+	int64_t make_resident(uint32_t page_index, int64_t &evicted_page);
+
+	/**
+	 * @return The number of resident pages
+	 */
+	uint32_t get_resident_page_count() const;
+
+  private:
+	struct Page
+	{
+		int64_t                       slot{-1};
+		uint64_t                      last_used_frame{0};
+		std::list<uint32_t>::iterator lru_position;
+	};
+
+	std::vector<VirtualTexturePageLevel> levels;
+
+	uint32_t mip_levels;
+
+	uint32_t page_count{0};
+
+	std::vector<Page> pages;
+
+	/// Resident pages, the most recently used first
+	std::list<uint32_t> lru;
+
+	std::vector<uint32_t> free_slots;
+
+	uint32_t slot_count{0};
+
+	uint32_t slot_capacity;
+
+	uint32_t frames_in_flight;
+
+	uint64_t frame_counter{0};
+};
+}        // namespace vkb
@@ -0,0 +1,197 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Records the CPU zones of PROFILE_SCOPE in every thread, to show where the time of the last frames went
+ *
+ * Each thread writes the zones it closes into a ring buffer of its own without taking a lock, and captures copy
+ * the zones which overlap the last frames marked with mark_frame. When disabled, which is the default, a zone costs
+ * a single relaxed atomic load.
+ */
+class ZoneProfiler
+{
+  public:
+	// Zones kept per thread, older ones are overwritten
+	static constexpr size_t ZONE_CAPACITY = 16384;
+
+	// Frame boundaries kept, a capture covers at most one less frame
+	static constexpr size_t FRAME_CAPACITY = 256;
+
+	struct Zone
+	{
+		const char *name;
+
+		uint64_t begin_ns;
+
+		uint64_t end_ns;
+
+		// Number of zones the zone is nested in
+		uint32_t depth;
+	};
+
+	struct ThreadZones
+	{
+		std::string thread_name;
+
+		uint32_t thread_index;
+
+		// Ordered by end time
+		std::vector<Zone> zones;
+	};
+
+	struct Capture
+	{
+		// Begin of each captured frame, followed by the end of the last one
+		std::vector<uint64_t> frame_times_ns;
+
+		std::vector<ThreadZones> threads;
+	};
+
+	static ZoneProfiler &get();
+
+	static bool is_enabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	void set_enabled(bool enable);
+
+	/**
+	 * @brief Names the calling thread in captures, threads which are not named show as "Thread <index>"
+	 */
+	void set_thread_name(const std::string &name);
+
+	/**
+	 * @brief Marks the begin of a frame, called once per frame by the main loop
+	 */
+	void mark_frame();
+
+	/**
+	 * @brief Copies the zones of the last complete frames
+	 * @param frame_count Number of frames to capture, fewer are captured if fewer were marked
+	 */
+	Capture capture(uint32_t frame_count) const;
+
+	/**
+	 * @return The capture in the Chrome trace event format, to load in chrome://tracing or Perfetto
+	 */
+	static std::string to_chrome_trace(const Capture &capture);
+
+	/**
+	 * @brief Records a zone measured elsewhere, such as on the GPU, into a track shown like a thread
+	 * @param track Name of the track, created on first use. A track must only be written by one thread at a time.
+	 */
+	void record_zone(const std::string &track, const char *name, uint64_t begin_ns, uint64_t end_ns, uint32_t depth);
+
+	static uint64_t now_ns();
+
+	/**
+	 * @return The depth of the zone, see ZoneScope
+	 */
+	static uint32_t enter_zone();
+
+	static void exit_zone(const char *name, uint64_t begin_ns, uint32_t depth);
+
+  private:
+	struct ThreadBuffer;
+
+	struct ThreadState
+	{
+		ThreadBuffer *buffer{nullptr};
+
+		uint32_t depth{0};
+
+		std::string name;
+
+		// Hands the buffer over to the next thread
+		~ThreadState();
+	};
+
+	static std::atomic<bool> enabled;
+
+	static thread_local ThreadState thread_state;
+
+	mutable std::mutex threads_mutex;
+
+	std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;
+
+	std::unordered_map<std::string, ThreadBuffer *> tracks;
+
+	std::array<std::atomic<uint64_t>, FRAME_CAPACITY> frame_begins_ns{};
+
+	std::atomic<uint64_t> frame_count{0};
+
+	ZoneProfiler();
+
+	~ZoneProfiler();
+
+	ThreadBuffer &acquire_thread_buffer();
+
+	ThreadBuffer &create_thread_buffer();
+
+	static void write_zone(ThreadBuffer &buffer, const char *name, uint64_t begin_ns, uint64_t end_ns, uint32_t depth);
+};
+
+/**
+ * @brief Records a zone for the lifetime of the object, see PROFILE_SCOPE
+ */
+class ZoneScope
+{
+  public:
+	explicit ZoneScope(const char *name) :
+	    name{name}
+	{
+		if (ZoneProfiler::is_enabled())
+		{
+			depth    = ZoneProfiler::enter_zone();
+			begin_ns = ZoneProfiler::now_ns();
+		}
+	}
+
+	~ZoneScope()
+	{
+		if (begin_ns != 0)
+		{
+			ZoneProfiler::exit_zone(name, begin_ns, depth);
+		}
+	}
+
+	ZoneScope(const ZoneScope &) = delete;
+
+	ZoneScope &operator=(const ZoneScope &) = delete;
+
+  private:
+	const char *name;
+
+	uint64_t begin_ns{0};
+
+	uint32_t depth{0};
+};
+}        // namespace vkb
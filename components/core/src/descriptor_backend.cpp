@@ -0,0 +1,60 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/descriptor_backend.hpp"
+
+namespace vkb
+{
+DescriptorBackend select_descriptor_backend(const std::vector<DescriptorSetUsage> &sets, const DescriptorBackendSupport &support, uint32_t &push_descriptor_set_index)
+{
+	if (sets.empty())
+	{
+		return DescriptorBackend::Pool;
+	}
+
+	uint32_t descriptor_count = 0;
+	bool     buffer_encodable = true;
+
+	for (auto &set : sets)
+	{
+		if (set.dynamic_or_update_after_bind)
+		{
+			return DescriptorBackend::Pool;
+		}
+
+		descriptor_count += set.descriptor_count;
+
+		if (!set.buffer_encodable)
+		{
+			buffer_encodable = false;
+		}
+	}
+
+	if (support.push_descriptor && sets.size() == 1 && descriptor_count <= support.max_push_descriptors)
+	{
+		push_descriptor_set_index = sets[0].set_index;
+		return DescriptorBackend::PushDescriptor;
+	}
+
+	if (support.descriptor_buffer && buffer_encodable)
+	{
+		return DescriptorBackend::DescriptorBuffer;
+	}
+
+	return DescriptorBackend::Pool;
+}
+}        // namespace vkb
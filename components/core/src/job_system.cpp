@@ -0,0 +1,452 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/job_system.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+
+namespace vkb
+{
+namespace
+{
+// The job system and worker index of the calling thread, if it is a worker
+thread_local const JobSystem *current_job_system{nullptr};
+thread_local uint32_t         current_worker_index{0};
+
+/**
+ * @brief Takes a job from one end of a deque
+ * @param counter If not null, the job closest to that end with this counter is taken instead
+ */
+template <typename Task>
+bool take_task(std::deque<Task> &tasks, bool from_back, const JobCounter *counter, Task &task)
+{
+	if (counter == nullptr)
+	{
+		if (tasks.empty())
+		{
+			return false;
+		}
+
+		if (from_back)
+		{
+			task = std::move(tasks.back());
+			tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		return true;
+	}
+
+	auto matches = [counter](const Task &task) { return task.counter == counter; };
+	if (from_back)
+	{
+		auto it = std::find_if(tasks.rbegin(), tasks.rend(), matches);
+		if (it == tasks.rend())
+		{
+			return false;
+		}
+		task = std::move(*it);
+		tasks.erase(std::next(it).base());
+	}
+	else
+	{
+		auto it = std::find_if(tasks.begin(), tasks.end(), matches);
+		if (it == tasks.end())
+		{
+			return false;
+		}
+		task = std::move(*it);
+		tasks.erase(it);
+	}
+	return true;
+}
+}        // namespace
+
+bool JobCounter::is_done() const
+{
+	return value.load(std::memory_order_acquire) == 0;
+}
+
+uint32_t JobCounter::get_value() const
+{
+	return value.load(std::memory_order_acquire);
+}
+
+JobSystem &JobSystem::get()
+{
+	static JobSystem job_system{std::max(2u, std::thread::hardware_concurrency()) - 1};
+	return job_system;
+}
+
+JobSystem::JobSystem(uint32_t worker_count)
+{
+	worker_count = std::max(1u, worker_count);
+
+	// All deques exist before any worker may steal from them
+	for (uint32_t i = 0; i < worker_count; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+	for (uint32_t i = 0; i < worker_count; ++i)
+	{
+		workers[i]->thread = std::thread([this, i] { worker_loop(i); });
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	shutdown();
+}
+
+void JobSystem::shutdown()
+{
+	if (stopped.load())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{sleep_mutex};
+		stopping = true;
+	}
+	wake_condition.notify_all();
+
+	for (auto &worker : workers)
+	{
+		worker->thread.join();
+	}
+	stopped = true;
+
+	if (!pending_tasks.empty())
+	{
+		LOGW("Job system destroyed with {} jobs waiting for a dependency", pending_tasks.size());
+	}
+}
+
+uint32_t JobSystem::get_worker_count() const
+{
+	return static_cast<uint32_t>(workers.size());
+}
+
+uint32_t JobSystem::get_current_worker_index() const
+{
+	return current_job_system == this ? current_worker_index : get_worker_count();
+}
+
+void JobSystem::submit(Job job, JobCounter *counter, const JobCounter *dependency)
+{
+	Task task{std::move(job), counter};
+
+	if (counter)
+	{
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (dependency)
+	{
+		// Checked under the lock, so that the dependency cannot reach zero before the job is found by release_dependents
+		std::lock_guard<std::mutex> lock{pending_mutex};
+		if (!dependency->is_done())
+		{
+			pending_tasks.push_back({std::move(task), dependency});
+			return;
+		}
+	}
+
+	push_task(std::move(task));
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+	// Threads which are not workers only help with the jobs they wait for
+	const JobCounter *only_counter = get_current_worker_index() < get_worker_count() ? nullptr : &counter;
+
+	Task task;
+	while (!counter.is_done())
+	{
+		// Read before looking for a job, so that a job queued meanwhile is not slept through
+		uint64_t epoch = push_epoch.load();
+
+		if (pop_task(task, only_counter))
+		{
+			run_task(task);
+			continue;
+		}
+
+		// The jobs of the counter run on other threads or wait for a dependency
+		waiting_count.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock{wait_mutex};
+			wait_condition.wait(lock, [this, &counter, epoch] { return counter.value.load() == 0 || push_epoch.load() != epoch; });
+		}
+		waiting_count.fetch_sub(1);
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock{counter.error_mutex};
+		std::swap(error, counter.error);
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+void JobSystem::parallel_for(size_t count, size_t grain_size, const std::function<void(size_t, size_t)> &func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	grain_size         = std::max<size_t>(1, grain_size);
+	size_t range_count = std::min<size_t>((count + grain_size - 1) / grain_size, get_worker_count() + 1);
+
+	if (range_count <= 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (size_t range = 1; range < range_count; ++range)
+	{
+		submit([&func, count, range, range_count]() { func(count * range / range_count, count * (range + 1) / range_count); }, &counter);
+	}
+
+	// The jobs reference the counter and the function, they must finish before returning
+	std::exception_ptr error;
+	try
+	{
+		func(0, count / range_count);
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+
+	wait(counter);
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+std::vector<double> JobSystem::get_worker_busy_times() const
+{
+	std::vector<double> busy_times;
+	busy_times.reserve(workers.size());
+	for (auto &worker : workers)
+	{
+		busy_times.push_back(static_cast<double>(worker->busy_ns.load(std::memory_order_relaxed)) * 1e-9);
+	}
+	return busy_times;
+}
+
+uint64_t JobSystem::get_steal_count() const
+{
+	return steal_count.load(std::memory_order_relaxed);
+}
+
+void JobSystem::worker_loop(uint32_t worker_index)
+{
+	current_job_system   = this;
+	current_worker_index = worker_index;
+
+	ZoneProfiler::get().set_thread_name(fmt::format("Job worker {}", worker_index));
+
+	Task task;
+	while (true)
+	{
+		if (pop_task(task, nullptr))
+		{
+			run_task(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{sleep_mutex};
+		wake_condition.wait(lock, [this] { return queued_count.load() > 0 || stopping; });
+
+		// Queued jobs are run before stopping
+		if (stopping && queued_count.load() == 0)
+		{
+			return;
+		}
+	}
+}
+
+void JobSystem::push_task(Task &&task)
+{
+	if (stopped.load())
+	{
+		run_task(task);
+		return;
+	}
+
+	// Workers push to their own deque, other threads spread their jobs
+	uint32_t worker_index = get_current_worker_index();
+	if (worker_index >= get_worker_count())
+	{
+		worker_index = next_worker.fetch_add(1, std::memory_order_relaxed) % get_worker_count();
+	}
+
+	// Counted before it is visible, so that the count never goes below zero
+	queued_count.fetch_add(1);
+
+	{
+		auto                       &worker = *workers[worker_index];
+		std::lock_guard<std::mutex> lock{worker.mutex};
+		worker.tasks.push_back(std::move(task));
+	}
+
+	// Sleeping workers check the count under this lock, so the notification cannot be missed
+	{
+		std::lock_guard<std::mutex> lock{sleep_mutex};
+	}
+	wake_condition.notify_one();
+
+	push_epoch.fetch_add(1);
+	notify_waiting_threads();
+}
+
+bool JobSystem::pop_task(Task &task, const JobCounter *counter)
+{
+	uint32_t worker_count = get_worker_count();
+	uint32_t self         = get_current_worker_index();
+
+	if (self < worker_count)
+	{
+		auto                       &worker = *workers[self];
+		std::lock_guard<std::mutex> lock{worker.mutex};
+		if (take_task(worker.tasks, true, counter, task))
+		{
+			queued_count.fetch_sub(1);
+			return true;
+		}
+	}
+
+	for (uint32_t i = 0; i < worker_count; ++i)
+	{
+		uint32_t victim = (self + 1 + i) % worker_count;
+		if (victim == self)
+		{
+			continue;
+		}
+
+		auto                       &worker = *workers[victim];
+		std::lock_guard<std::mutex> lock{worker.mutex};
+		if (take_task(worker.tasks, false, counter, task))
+		{
+			queued_count.fetch_sub(1);
+			if (self < worker_count)
+			{
+				steal_count.fetch_add(1, std::memory_order_relaxed);
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::run_task(Task &task)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	try
+	{
+		PROFILE_SCOPE("Job");
+		task.job();
+	}
+	catch (...)
+	{
+		if (task.counter)
+		{
+			std::lock_guard<std::mutex> lock{task.counter->error_mutex};
+			if (!task.counter->error)
+			{
+				task.counter->error = std::current_exception();
+			}
+		}
+		else
+		{
+			LOGE("Unhandled exception in a job without counter");
+		}
+	}
+
+	uint32_t worker_index = get_current_worker_index();
+	if (worker_index < get_worker_count())
+	{
+		auto busy_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		workers[worker_index]->busy_ns.fetch_add(static_cast<uint64_t>(busy_time.count()), std::memory_order_relaxed);
+	}
+
+	// Captures may reference the stack of the waiting thread, they are released before it can return
+	task.job = nullptr;
+
+	// The counter may be destroyed as soon as it reaches zero, only its address is used afterwards
+	auto *counter = task.counter;
+	task.counter  = nullptr;
+	if (counter && counter->value.fetch_sub(1) == 1)
+	{
+		release_dependents(counter);
+		notify_waiting_threads();
+	}
+}
+
+void JobSystem::release_dependents(const JobCounter *counter)
+{
+	std::vector<Task> ready_tasks;
+	{
+		std::lock_guard<std::mutex> lock{pending_mutex};
+
+		auto it = std::partition(pending_tasks.begin(), pending_tasks.end(), [counter](const PendingTask &pending) { return pending.dependency != counter; });
+		for (auto ready_it = it; ready_it != pending_tasks.end(); ++ready_it)
+		{
+			ready_tasks.push_back(std::move(ready_it->task));
+		}
+		pending_tasks.erase(it, pending_tasks.end());
+	}
+
+	for (auto &task : ready_tasks)
+	{
+		push_task(std::move(task));
+	}
+}
+
+void JobSystem::notify_waiting_threads()
+{
+	// Sequentially consistent with the increment of the waiting threads, so that either they see the change or it sees them
+	if (waiting_count.load() > 0)
+	{
+		// Waiting threads check their condition under this lock, so the notification cannot be missed
+		{
+			std::lock_guard<std::mutex> lock{wait_mutex};
+		}
+		wait_condition.notify_all();
+	}
+}
+}        // namespace vkb
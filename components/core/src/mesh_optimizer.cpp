@@ -0,0 +1,520 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace vkb
+{
+namespace
+{
+constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+// Size of the LRU cache simulated by the vertex cache optimization, larger than actual caches on purpose
+constexpr uint32_t CACHE_SIZE = 32;
+
+constexpr float CACHE_DECAY_POWER   = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+// Size of the FIFO cache simulated to split triangle lists for overdraw optimization
+constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+/**
+ * @brief Triangles using each vertex, in compressed rows
+ */
+struct VertexAdjacency
+{
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> triangles;
+
+	VertexAdjacency(const uint32_t *indices, size_t index_count, size_t vertex_count) :
+	    counts(vertex_count, 0),
+	    offsets(vertex_count, 0),
+	    triangles(index_count)
+	{
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			assert(indices[i] < vertex_count);
+			counts[indices[i]]++;
+		}
+
+		uint32_t offset = 0;
+		for (size_t v = 0; v < vertex_count; ++v)
+		{
+			offsets[v] = offset;
+			offset += counts[v];
+		}
+
+		std::fill(counts.begin(), counts.end(), 0);
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			uint32_t vertex                               = indices[i];
+			triangles[offsets[vertex] + counts[vertex]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+};
+
+float get_vertex_score(int32_t cache_position, uint32_t live_triangles)
+{
+	if (live_triangles == 0)
+	{
+		// No triangle left to emit, the vertex does not matter anymore
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if (cache_position >= 0)
+	{
+		if (cache_position < 3)
+		{
+			// Vertices of the last triangle get a fixed score, so that the next triangle does not favour any of its edges
+			score = LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			float scaled = 1.0f - static_cast<float>(cache_position - 3) / (CACHE_SIZE - 3);
+			score        = std::pow(scaled, CACHE_DECAY_POWER);
+		}
+	}
+
+	// Vertices with few triangles left are boosted, so that they are finished and do not linger
+	return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(live_triangles), -VALENCE_BOOST_POWER);
+}
+
+/**
+ * @brief Simulates a FIFO vertex cache, each vertex records when it entered it
+ */
+struct FifoCache
+{
+	std::vector<size_t> timestamps;
+	size_t              time;
+	uint32_t            size;
+
+	FifoCache(size_t vertex_count, uint32_t size) :
+	    timestamps(vertex_count, 0),
+	    time(size + 1),
+	    size(size)
+	{}
+
+	/**
+	 * @return The number of vertices of the triangle that were not cached
+	 */
+	uint32_t add_triangle(const uint32_t *triangle)
+	{
+		uint32_t misses = 0;
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			if (time - timestamps[triangle[c]] > size)
+			{
+				timestamps[triangle[c]] = time++;
+				++misses;
+			}
+		}
+		return misses;
+	}
+
+	void flush()
+	{
+		time += size + 1;
+	}
+};
+
+inline const float *get_position(const float *positions, size_t position_stride, uint32_t vertex)
+{
+	return reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positions) + vertex * position_stride);
+}
+}        // namespace
+
+void optimize_vertex_cache(uint32_t *destination, const uint32_t *indices, size_t index_count, size_t vertex_count)
+{
+	assert(index_count % 3 == 0);
+
+	size_t triangle_count = index_count / 3;
+	if (triangle_count == 0)
+	{
+		return;
+	}
+
+	// The input is copied, as destination may alias it
+	std::vector<uint32_t> input(indices, indices + index_count);
+
+	VertexAdjacency adjacency{input.data(), index_count, vertex_count};
+
+	// Live triangles of each vertex are kept at the front of its adjacency row
+	std::vector<uint32_t> live_counts = adjacency.counts;
+
+	std::vector<int32_t> cache_positions(vertex_count, -1);
+	std::vector<float>   vertex_scores(vertex_count);
+	for (size_t v = 0; v < vertex_count; ++v)
+	{
+		vertex_scores[v] = get_vertex_score(-1, live_counts[v]);
+	}
+
+	std::vector<float> triangle_scores(triangle_count);
+	for (size_t t = 0; t < triangle_count; ++t)
+	{
+		triangle_scores[t] = vertex_scores[input[t * 3]] + vertex_scores[input[t * 3 + 1]] + vertex_scores[input[t * 3 + 2]];
+	}
+
+	std::vector<bool> emitted(triangle_count, false);
+
+	uint32_t cache[CACHE_SIZE + 3];
+	uint32_t cache_count = 0;
+	uint32_t new_cache[CACHE_SIZE + 3];
+
+	// Next triangle to consider when the cache holds no live triangle
+	size_t input_cursor = 0;
+
+	uint32_t best_triangle = 0;
+
+	for (size_t output_triangle = 0; output_triangle < triangle_count; ++output_triangle)
+	{
+		if (best_triangle == INVALID_INDEX)
+		{
+			while (emitted[input_cursor])
+			{
+				++input_cursor;
+			}
+			best_triangle = static_cast<uint32_t>(input_cursor);
+		}
+
+		const uint32_t *triangle = &input[best_triangle * 3];
+		std::memcpy(&destination[output_triangle * 3], triangle, 3 * sizeof(uint32_t));
+		emitted[best_triangle] = true;
+
+		// Remove the triangle from the live triangles of its vertices
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			uint32_t  vertex = triangle[c];
+			uint32_t *row    = &adjacency.triangles[adjacency.offsets[vertex]];
+			uint32_t &live   = live_counts[vertex];
+			for (uint32_t i = 0; i < live; ++i)
+			{
+				if (row[i] == best_triangle)
+				{
+					std::swap(row[i], row[live - 1]);
+					--live;
+					break;
+				}
+			}
+		}
+
+		// The triangle vertices move to the front of the cache, the others are pushed back
+		uint32_t new_cache_count = 0;
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			new_cache[new_cache_count++] = triangle[c];
+		}
+		for (uint32_t i = 0; i < cache_count; ++i)
+		{
+			uint32_t vertex = cache[i];
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+			{
+				new_cache[new_cache_count++] = vertex;
+			}
+		}
+
+		// Vertices pushed out of the cache lose their cache score
+		for (uint32_t i = CACHE_SIZE; i < new_cache_count; ++i)
+		{
+			cache_positions[new_cache[i]] = -1;
+		}
+
+		cache_count = std::min(new_cache_count, CACHE_SIZE);
+		std::memcpy(cache, new_cache, new_cache_count * sizeof(uint32_t));
+
+		// Rescore the vertices whose cache position changed, and the live triangles using them
+		for (uint32_t i = 0; i < new_cache_count; ++i)
+		{
+			uint32_t vertex = new_cache[i];
+			if (i < CACHE_SIZE)
+			{
+				cache_positions[vertex] = static_cast<int32_t>(i);
+			}
+
+			float score = get_vertex_score(cache_positions[vertex], live_counts[vertex]);
+			float delta = score - vertex_scores[vertex];
+			if (delta != 0.0f)
+			{
+				const uint32_t *row = &adjacency.triangles[adjacency.offsets[vertex]];
+				for (uint32_t j = 0; j < live_counts[vertex]; ++j)
+				{
+					triangle_scores[row[j]] += delta;
+				}
+				vertex_scores[vertex] = score;
+			}
+		}
+
+		// The next triangle is the best live triangle using a cached vertex
+		best_triangle    = INVALID_INDEX;
+		float best_score = -std::numeric_limits<float>::max();
+		for (uint32_t i = 0; i < cache_count; ++i)
+		{
+			uint32_t        vertex = cache[i];
+			const uint32_t *row    = &adjacency.triangles[adjacency.offsets[vertex]];
+			for (uint32_t j = 0; j < live_counts[vertex]; ++j)
+			{
+				if (triangle_scores[row[j]] > best_score)
+				{
+					best_score    = triangle_scores[row[j]];
+					best_triangle = row[j];
+				}
+			}
+		}
+	}
+}
+
+void optimize_overdraw(uint32_t *indices, size_t index_count, const float *positions, size_t vertex_count, size_t position_stride, float threshold)
+{
+	assert(index_count % 3 == 0);
+
+	size_t triangle_count = index_count / 3;
+	if (triangle_count == 0)
+	{
+		return;
+	}
+
+	// Hard boundaries, where the cache is effectively flushed as no vertex of the triangle is cached
+	std::vector<size_t> hard_boundaries;
+	{
+		FifoCache cache{vertex_count, OVERDRAW_CACHE_SIZE};
+		for (size_t t = 0; t < triangle_count; ++t)
+		{
+			if (cache.add_triangle(&indices[t * 3]) == 3)
+			{
+				hard_boundaries.push_back(t);
+			}
+		}
+	}
+	hard_boundaries.push_back(triangle_count);
+
+	// Soft boundaries, where the cache efficiency since the last boundary is close enough to the one of the whole hard cluster
+	std::vector<size_t> clusters;
+	{
+		FifoCache cache{vertex_count, OVERDRAW_CACHE_SIZE};
+		for (size_t h = 0; h + 1 < hard_boundaries.size(); ++h)
+		{
+			size_t start = hard_boundaries[h];
+			size_t end   = hard_boundaries[h + 1];
+
+			cache.flush();
+			size_t cluster_misses = 0;
+			for (size_t t = start; t < end; ++t)
+			{
+				cluster_misses += cache.add_triangle(&indices[t * 3]);
+			}
+			float cluster_threshold = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+			cache.flush();
+			size_t running_misses = 0;
+			clusters.push_back(start);
+			for (size_t t = start; t < end; ++t)
+			{
+				running_misses += cache.add_triangle(&indices[t * 3]);
+				if (t + 1 < end && static_cast<float>(running_misses) / static_cast<float>(t + 1 - start) <= cluster_threshold)
+				{
+					clusters.push_back(t + 1);
+					start          = t + 1;
+					running_misses = 0;
+					cache.flush();
+				}
+			}
+		}
+	}
+	size_t cluster_count = clusters.size();
+	clusters.push_back(triangle_count);
+
+	// Area weighted centroid and normal of each cluster, and of the whole mesh
+	std::vector<float> cluster_centroids(cluster_count * 3, 0.0f);
+	std::vector<float> cluster_normals(cluster_count * 3, 0.0f);
+	std::vector<float> cluster_areas(cluster_count, 0.0f);
+	float              mesh_centroid[3] = {0.0f, 0.0f, 0.0f};
+	float              mesh_area        = 0.0f;
+	for (size_t c = 0; c < cluster_count; ++c)
+	{
+		for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+		{
+			const float *p0 = get_position(positions, position_stride, indices[t * 3]);
+			const float *p1 = get_position(positions, position_stride, indices[t * 3 + 1]);
+			const float *p2 = get_position(positions, position_stride, indices[t * 3 + 2]);
+
+			float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+			float n[3]  = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			float area  = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				float center = (p0[k] + p1[k] + p2[k]) / 3.0f;
+				cluster_centroids[c * 3 + k] += center * area;
+				cluster_normals[c * 3 + k] += n[k];
+				mesh_centroid[k] += center * area;
+			}
+			cluster_areas[c] += area;
+			mesh_area += area;
+		}
+	}
+	if (mesh_area > 0.0f)
+	{
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			mesh_centroid[k] /= mesh_area;
+		}
+	}
+
+	// Clusters facing away from the center of the mesh are likely to occlude the others
+	std::vector<float> sort_keys(cluster_count, 0.0f);
+	for (size_t c = 0; c < cluster_count; ++c)
+	{
+		const float *normal = &cluster_normals[c * 3];
+		float        length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (cluster_areas[c] > 0.0f && length > 0.0f)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				sort_keys[c] += (cluster_centroids[c * 3 + k] / cluster_areas[c] - mesh_centroid[k]) * normal[k] / length;
+			}
+		}
+	}
+
+	std::vector<uint32_t> order(cluster_count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&sort_keys](uint32_t a, uint32_t b) { return sort_keys[a] > sort_keys[b]; });
+
+	std::vector<uint32_t> input(indices, indices + index_count);
+	size_t                offset = 0;
+	for (uint32_t c : order)
+	{
+		size_t count = (clusters[c + 1] - clusters[c]) * 3;
+		std::memcpy(&indices[offset], &input[clusters[c] * 3], count * sizeof(uint32_t));
+		offset += count;
+	}
+}
+
+std::vector<uint32_t> optimize_vertex_fetch(uint32_t *indices, size_t index_count, size_t vertex_count)
+{
+	std::vector<uint32_t> remap(vertex_count, INVALID_INDEX);
+	std::vector<uint32_t> old_vertices;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		uint32_t vertex = indices[i];
+		assert(vertex < vertex_count);
+		if (remap[vertex] == INVALID_INDEX)
+		{
+			remap[vertex] = static_cast<uint32_t>(old_vertices.size());
+			old_vertices.push_back(vertex);
+		}
+		indices[i] = remap[vertex];
+	}
+
+	return old_vertices;
+}
+
+float get_average_cache_miss_ratio(const uint32_t *indices, size_t index_count, size_t vertex_count, uint32_t cache_size)
+{
+	if (index_count < 3)
+	{
+		return 0.0f;
+	}
+
+	// Each vertex records when it entered the FIFO, it is still cached while fewer than cache_size vertices entered since
+	std::vector<size_t> timestamps(vertex_count, 0);
+	size_t              time   = cache_size + 1;
+	size_t              misses = 0;
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		if (time - timestamps[indices[i]] > cache_size)
+		{
+			timestamps[indices[i]] = time++;
+			++misses;
+		}
+	}
+
+	return static_cast<float>(misses) / static_cast<float>(index_count / 3);
+}
+
+uint16_t quantize_half(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+	bits &= 0x7FFFFFFF;
+
+	if (bits >= 0x7F800000)
+	{
+		// Infinity stays infinity, NaN becomes a quiet NaN
+		return sign | 0x7C00 | (bits > 0x7F800000 ? 0x0200 : 0);
+	}
+
+	if (bits >= 0x477FF000)
+	{
+		// 65520 and above round to infinity
+		return sign | 0x7C00;
+	}
+
+	if (bits < 0x38800000)
+	{
+		// Below the smallest normal half, adding 0.5 aligns the mantissa on the half denormal bits and rounds it
+		float magnitude;
+		std::memcpy(&magnitude, &bits, sizeof(bits));
+		magnitude += 0.5f;
+		std::memcpy(&bits, &magnitude, sizeof(bits));
+		return sign | static_cast<uint16_t>(bits - 0x3F000000);
+	}
+
+	// Rebias the exponent from 127 to 15, and round the 13 dropped mantissa bits to nearest even
+	uint32_t odd = (bits >> 13) & 1;
+	bits += 0xC8000FFF + odd;
+	return sign | static_cast<uint16_t>(bits >> 13);
+}
+
+int32_t quantize_snorm(float value, uint32_t bits)
+{
+	assert(bits >= 2 && bits <= 16);
+
+	float scale = static_cast<float>((1 << (bits - 1)) - 1);
+	value       = value >= -1.0f ? (value <= 1.0f ? value : 1.0f) : -1.0f;        // NaN becomes -1
+	return static_cast<int32_t>(std::lround(value * scale));
+}
+
+uint32_t pack_snorm_r8g8b8a8(float x, float y, float z, float w)
+{
+	return (static_cast<uint32_t>(quantize_snorm(x, 8)) & 0xFF) |
+	       (static_cast<uint32_t>(quantize_snorm(y, 8)) & 0xFF) << 8 |
+	       (static_cast<uint32_t>(quantize_snorm(z, 8)) & 0xFF) << 16 |
+	       (static_cast<uint32_t>(quantize_snorm(w, 8)) & 0xFF) << 24;
+}
+
+uint32_t pack_snorm_a2b10g10r10(float x, float y, float z, float w)
+{
+	return (static_cast<uint32_t>(quantize_snorm(x, 10)) & 0x3FF) |
+	       (static_cast<uint32_t>(quantize_snorm(y, 10)) & 0x3FF) << 10 |
+	       (static_cast<uint32_t>(quantize_snorm(z, 10)) & 0x3FF) << 20 |
+	       (static_cast<uint32_t>(quantize_snorm(w, 2)) & 0x3) << 30;
+}
+}        // namespace vkb
@@ -0,0 +1,464 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/meshlet_builder.hpp"
+
+#include "core/util/mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace vkb
+{
+namespace
+{
+constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+constexpr uint8_t INVALID_LOCAL_INDEX = std::numeric_limits<uint8_t>::max();
+
+struct Vec3
+{
+	float x, y, z;
+};
+
+inline Vec3 operator+(const Vec3 &a, const Vec3 &b)
+{
+	return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+inline Vec3 operator-(const Vec3 &a, const Vec3 &b)
+{
+	return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline Vec3 operator*(const Vec3 &a, float s)
+{
+	return {a.x * s, a.y * s, a.z * s};
+}
+
+inline float dot(const Vec3 &a, const Vec3 &b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3 cross(const Vec3 &a, const Vec3 &b)
+{
+	return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline float length(const Vec3 &a)
+{
+	return std::sqrt(dot(a, a));
+}
+
+inline Vec3 normalize_or_zero(const Vec3 &a)
+{
+	float l = length(a);
+	return l > 0.0f ? a * (1.0f / l) : Vec3{0.0f, 0.0f, 0.0f};
+}
+
+inline Vec3 get_position(const MeshletSource &source, uint32_t vertex)
+{
+	const float *position = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(source.positions) + vertex * source.position_stride);
+	return {position[0], position[1], position[2]};
+}
+
+/**
+ * @brief Triangles using each vertex, in compressed rows
+ */
+struct VertexAdjacency
+{
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> triangles;
+
+	VertexAdjacency(const uint32_t *indices, size_t index_count, size_t vertex_count) :
+	    counts(vertex_count, 0),
+	    offsets(vertex_count, 0),
+	    triangles(index_count)
+	{
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			assert(indices[i] < vertex_count);
+			counts[indices[i]]++;
+		}
+
+		uint32_t offset = 0;
+		for (size_t v = 0; v < vertex_count; ++v)
+		{
+			offsets[v] = offset;
+			offset += counts[v];
+		}
+
+		std::fill(counts.begin(), counts.end(), 0);
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			uint32_t vertex                               = indices[i];
+			triangles[offsets[vertex] + counts[vertex]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+};
+
+/**
+ * @brief Bounding sphere of the meshlet vertices and normal cone of its triangles
+ */
+MeshletBounds compute_bounds(const MeshletSource &source, const uint32_t *vertices, uint32_t vertex_count, const uint8_t *triangles, uint32_t triangle_count)
+{
+	MeshletBounds bounds{};
+
+	// Ritter's sphere: start from a pair of distant vertices, then grow to include any vertex left outside
+	Vec3  first    = get_position(source, vertices[0]);
+	Vec3  farthest = first;
+	float distance = 0.0f;
+	for (uint32_t i = 0; i < vertex_count; ++i)
+	{
+		Vec3  position = get_position(source, vertices[i]);
+		float d        = dot(position - first, position - first);
+		if (d > distance)
+		{
+			distance = d;
+			farthest = position;
+		}
+	}
+
+	Vec3 opposite = farthest;
+	distance      = 0.0f;
+	for (uint32_t i = 0; i < vertex_count; ++i)
+	{
+		Vec3  position = get_position(source, vertices[i]);
+		float d        = dot(position - farthest, position - farthest);
+		if (d > distance)
+		{
+			distance = d;
+			opposite = position;
+		}
+	}
+
+	Vec3  center = (farthest + opposite) * 0.5f;
+	float radius = std::sqrt(distance) * 0.5f;
+	for (uint32_t i = 0; i < vertex_count; ++i)
+	{
+		Vec3  position = get_position(source, vertices[i]);
+		float d        = length(position - center);
+		if (d > radius)
+		{
+			float new_radius = (radius + d) * 0.5f;
+			center           = center + (position - center) * ((new_radius - radius) / d);
+			radius           = new_radius;
+		}
+	}
+
+	bounds.center[0] = center.x;
+	bounds.center[1] = center.y;
+	bounds.center[2] = center.z;
+	bounds.radius    = radius;
+
+	// The cone axis is the average normal, degenerate triangles face no direction and are left out.
+	// Normals are recomputed in each pass rather than stored, so that no memory is allocated per meshlet
+	auto get_triangle = [&](uint32_t t, Vec3 &corner, Vec3 &normal) {
+		Vec3 a = get_position(source, vertices[triangles[t * 3 + 0]]);
+		Vec3 b = get_position(source, vertices[triangles[t * 3 + 1]]);
+		Vec3 c = get_position(source, vertices[triangles[t * 3 + 2]]);
+		corner = a;
+		normal = normalize_or_zero(cross(b - a, c - a));
+	};
+
+	Vec3 corner;
+	Vec3 normal;
+	Vec3 normal_sum{0.0f, 0.0f, 0.0f};
+	for (uint32_t t = 0; t < triangle_count; ++t)
+	{
+		get_triangle(t, corner, normal);
+		normal_sum = normal_sum + normal;
+	}
+
+	Vec3  axis    = normalize_or_zero(normal_sum);
+	float min_dot = 1.0f;
+	for (uint32_t t = 0; t < triangle_count; ++t)
+	{
+		get_triangle(t, corner, normal);
+		if (dot(normal, normal) > 0.0f)
+		{
+			min_dot = std::min(min_dot, dot(axis, normal));
+		}
+	}
+
+	if (dot(axis, axis) == 0.0f || min_dot <= 0.0f)
+	{
+		// Triangles face more than a half space, the meshlet can never be entirely back facing
+		std::memcpy(bounds.cone_apex, bounds.center, sizeof(bounds.cone_apex));
+		bounds.cone_cutoff = 1.0f;
+		return bounds;
+	}
+
+	// The apex lies on the axis behind the center, far enough to be behind every triangle plane
+	float max_t = 0.0f;
+	for (uint32_t t = 0; t < triangle_count; ++t)
+	{
+		get_triangle(t, corner, normal);
+		float normal_dot = dot(axis, normal);
+		if (normal_dot > 0.0f)
+		{
+			max_t = std::max(max_t, dot(center - corner, normal) / normal_dot);
+		}
+	}
+
+	Vec3 apex           = center - axis * max_t;
+	bounds.cone_apex[0] = apex.x;
+	bounds.cone_apex[1] = apex.y;
+	bounds.cone_apex[2] = apex.z;
+	bounds.cone_axis[0] = axis.x;
+	bounds.cone_axis[1] = axis.y;
+	bounds.cone_axis[2] = axis.z;
+	bounds.cone_cutoff  = std::sqrt(1.0f - min_dot * min_dot);
+
+	return bounds;
+}
+}        // namespace
+
+MeshletMesh build_meshlets(const MeshletSource &source, const MeshletOptions &options)
+{
+	assert(source.index_count % 3 == 0);
+	assert(options.max_vertices >= 3 && options.max_vertices < INVALID_LOCAL_INDEX);
+	assert(options.max_triangles >= 1);
+
+	MeshletMesh mesh;
+
+	size_t triangle_count = source.index_count / 3;
+	if (triangle_count == 0)
+	{
+		return mesh;
+	}
+
+	std::vector<uint32_t> indices(source.index_count);
+	optimize_vertex_cache(indices.data(), source.indices, source.index_count, source.vertex_count);
+
+	VertexAdjacency adjacency{indices.data(), indices.size(), source.vertex_count};
+
+	std::vector<Vec3> centroids(triangle_count);
+	std::vector<Vec3> normals(triangle_count);
+	float             edge_sum = 0.0f;
+	for (size_t t = 0; t < triangle_count; ++t)
+	{
+		Vec3 a       = get_position(source, indices[t * 3 + 0]);
+		Vec3 b       = get_position(source, indices[t * 3 + 1]);
+		Vec3 c       = get_position(source, indices[t * 3 + 2]);
+		centroids[t] = (a + b + c) * (1.0f / 3.0f);
+		normals[t]   = normalize_or_zero(cross(b - a, c - a));
+		edge_sum += length(b - a);
+	}
+
+	// Distances are measured in average triangle sizes, so that the scores do not depend on the scale of the mesh
+	float triangle_size = std::max(edge_sum / static_cast<float>(triangle_count), std::numeric_limits<float>::min());
+
+	// Reserve for meshlets about three quarters full, the flat arrays then rarely grow
+	mesh.meshlets.reserve(triangle_count / std::max(1u, options.max_triangles * 3 / 4) + 1);
+	mesh.vertices.reserve(source.index_count / 2);
+	mesh.triangles.reserve(source.index_count);
+
+	std::vector<bool>     emitted(triangle_count, false);
+	std::vector<uint32_t> live_counts = adjacency.counts;
+	std::vector<uint8_t>  local_indices(source.vertex_count, INVALID_LOCAL_INDEX);
+
+	MeshletRange meshlet{0, 0, 0, 0};
+	Vec3         centroid_sum{0.0f, 0.0f, 0.0f};
+	Vec3         normal_sum{0.0f, 0.0f, 0.0f};
+
+	size_t   input_cursor = 0;
+	uint32_t next_seed    = INVALID_INDEX;
+
+	auto close_meshlet = [&]() {
+		mesh.bounds.push_back(compute_bounds(source,
+		                                     &mesh.vertices[meshlet.vertex_offset], meshlet.vertex_count,
+		                                     &mesh.triangles[meshlet.triangle_offset * 3], meshlet.triangle_count));
+		mesh.meshlets.push_back(meshlet);
+
+		for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+		{
+			local_indices[mesh.vertices[meshlet.vertex_offset + i]] = INVALID_LOCAL_INDEX;
+		}
+
+		meshlet      = {static_cast<uint32_t>(mesh.vertices.size()), 0, static_cast<uint32_t>(mesh.triangles.size() / 3), 0};
+		centroid_sum = {0.0f, 0.0f, 0.0f};
+		normal_sum   = {0.0f, 0.0f, 0.0f};
+	};
+
+	for (size_t emitted_count = 0; emitted_count < triangle_count;)
+	{
+		uint32_t triangle = INVALID_INDEX;
+
+		if (meshlet.triangle_count == 0)
+		{
+			// New meshlets start next to the previous one when possible, in cache order otherwise
+			if (next_seed != INVALID_INDEX && !emitted[next_seed])
+			{
+				triangle = next_seed;
+			}
+			else
+			{
+				while (emitted[input_cursor])
+				{
+					++input_cursor;
+				}
+				triangle = static_cast<uint32_t>(input_cursor);
+			}
+			next_seed = INVALID_INDEX;
+		}
+		else
+		{
+			// Grow the meshlet with the adjacent triangle adding the fewest vertices, then the closest in position and orientation
+			Vec3  centroid   = centroid_sum * (1.0f / static_cast<float>(meshlet.triangle_count));
+			Vec3  axis       = normalize_or_zero(normal_sum);
+			float extent     = triangle_size * std::sqrt(static_cast<float>(meshlet.triangle_count));
+			float best_score    = std::numeric_limits<float>::max();
+			int   best_priority = 5;
+			int   best_extra    = 0;
+			for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+			{
+				uint32_t vertex = mesh.vertices[meshlet.vertex_offset + i];
+				for (uint32_t j = 0; j < adjacency.counts[vertex]; ++j)
+				{
+					uint32_t candidate = adjacency.triangles[adjacency.offsets[vertex] + j];
+					if (emitted[candidate])
+					{
+						continue;
+					}
+
+					const uint32_t *candidate_indices = &indices[candidate * 3];
+
+					int extra = (local_indices[candidate_indices[0]] == INVALID_LOCAL_INDEX) +
+					            (local_indices[candidate_indices[1]] == INVALID_LOCAL_INDEX) +
+					            (local_indices[candidate_indices[2]] == INVALID_LOCAL_INDEX);
+
+					// Triangles adding no vertex come first. Dangling triangles, the last one of a vertex, come next:
+					// left out they end up isolated, in a meshlet of their own
+					int priority = extra;
+					if (extra != 0)
+					{
+						bool dangling = live_counts[candidate_indices[0]] == 1 ||
+						                live_counts[candidate_indices[1]] == 1 ||
+						                live_counts[candidate_indices[2]] == 1;
+						priority      = dangling ? 1 : extra + 1;
+					}
+
+					if (priority > best_priority)
+					{
+						continue;
+					}
+
+					float distance = length(centroids[candidate] - centroid) / extent;
+					float spread   = 1.0f - dot(normals[candidate], axis);
+					float score    = (1.0f - options.cone_weight) * distance + options.cone_weight * spread;
+
+					if (priority < best_priority || score < best_score)
+					{
+						best_priority = priority;
+						best_extra    = extra;
+						best_score    = score;
+						triangle      = candidate;
+					}
+				}
+			}
+
+			if (triangle == INVALID_INDEX)
+			{
+				// The meshlet surrounds a closed patch of the surface
+				close_meshlet();
+				continue;
+			}
+
+			if (meshlet.vertex_count + static_cast<uint32_t>(best_extra) > options.max_vertices || meshlet.triangle_count == options.max_triangles)
+			{
+				next_seed = triangle;
+				close_meshlet();
+				continue;
+			}
+		}
+
+		const uint32_t *triangle_indices = &indices[triangle * 3];
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			uint32_t vertex = triangle_indices[c];
+			if (local_indices[vertex] == INVALID_LOCAL_INDEX)
+			{
+				local_indices[vertex] = static_cast<uint8_t>(meshlet.vertex_count++);
+				mesh.vertices.push_back(vertex);
+			}
+			mesh.triangles.push_back(local_indices[vertex]);
+		}
+
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			live_counts[triangle_indices[c]]--;
+		}
+
+		meshlet.triangle_count++;
+		centroid_sum = centroid_sum + centroids[triangle];
+		normal_sum   = normal_sum + normals[triangle];
+
+		emitted[triangle] = true;
+		++emitted_count;
+	}
+
+	if (meshlet.triangle_count > 0)
+	{
+		close_meshlet();
+	}
+
+	return mesh;
+}
+
+std::vector<MeshletMesh> build_meshlets(const std::vector<MeshletSource> &sources, const MeshletOptions &options, uint32_t thread_count)
+{
+	std::vector<MeshletMesh> meshes(sources.size());
+
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	thread_count = std::min(thread_count, static_cast<uint32_t>(sources.size()));
+
+	// Meshes are handed out one at a time, so that a few large ones do not leave threads idle
+	std::atomic<size_t> next_source{0};
+	auto                build = [&]() {
+		for (size_t i = next_source++; i < sources.size(); i = next_source++)
+		{
+			meshes[i] = build_meshlets(sources[i], options);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 1; i < thread_count; ++i)
+	{
+		threads.emplace_back(build);
+	}
+
+	build();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	return meshes;
+}
+}        // namespace vkb
@@ -0,0 +1,464 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/mip_chain.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "core/util/job_system.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define VKB_MIP_CHAIN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define VKB_MIP_CHAIN_NEON
+#endif
+
+namespace vkb
+{
+namespace
+{
+constexpr uint32_t CHANNELS = 4;
+
+// Resolution of the linear to 8-bit encoding tables
+constexpr uint32_t ENCODE_STEPS = 4096;
+
+// Levels with fewer destination texels than this are built on a single thread
+constexpr uint32_t MIN_TEXELS_PER_THREAD = 128 * 128;
+
+// Support of the Kaiser filter, in destination texels on each side of the center
+constexpr float KAISER_RADIUS = 2.0f;
+constexpr float KAISER_ALPHA  = 4.0f;
+
+/**
+ * @brief Decoding and encoding tables, shared by all builds
+ */
+struct Tables
+{
+	float   linear_from_srgb[256];
+	float   linear_from_unorm[256];
+	uint8_t srgb_from_linear[ENCODE_STEPS];
+	uint8_t unorm_from_linear[ENCODE_STEPS];
+
+	Tables()
+	{
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			float value          = i / 255.0f;
+			linear_from_unorm[i] = value;
+			linear_from_srgb[i]  = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		for (uint32_t i = 0; i < ENCODE_STEPS; ++i)
+		{
+			float linear         = i / static_cast<float>(ENCODE_STEPS - 1);
+			float srgb           = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+			srgb_from_linear[i]  = static_cast<uint8_t>(std::lround(srgb * 255.0f));
+			unorm_from_linear[i] = static_cast<uint8_t>(std::lround(linear * 255.0f));
+		}
+	}
+};
+
+const Tables &get_tables()
+{
+	static const Tables tables;
+	return tables;
+}
+
+/**
+ * @brief The four channels of a texel, held in one SIMD register where available
+ */
+struct Texel
+{
+#if defined(VKB_MIP_CHAIN_SSE2)
+	__m128 value;
+#elif defined(VKB_MIP_CHAIN_NEON)
+	float32x4_t value;
+#else
+	float value[CHANNELS];
+#endif
+};
+
+inline Texel texel_zero()
+{
+#if defined(VKB_MIP_CHAIN_SSE2)
+	return {_mm_setzero_ps()};
+#elif defined(VKB_MIP_CHAIN_NEON)
+	return {vdupq_n_f32(0.0f)};
+#else
+	return {{0.0f, 0.0f, 0.0f, 0.0f}};
+#endif
+}
+
+inline Texel texel_set(float r, float g, float b, float a)
+{
+#if defined(VKB_MIP_CHAIN_SSE2)
+	return {_mm_setr_ps(r, g, b, a)};
+#elif defined(VKB_MIP_CHAIN_NEON)
+	const float values[CHANNELS] = {r, g, b, a};
+	return {vld1q_f32(values)};
+#else
+	return {{r, g, b, a}};
+#endif
+}
+
+inline Texel texel_add(const Texel &left, const Texel &right)
+{
+#if defined(VKB_MIP_CHAIN_SSE2)
+	return {_mm_add_ps(left.value, right.value)};
+#elif defined(VKB_MIP_CHAIN_NEON)
+	return {vaddq_f32(left.value, right.value)};
+#else
+	return {{left.value[0] + right.value[0], left.value[1] + right.value[1], left.value[2] + right.value[2], left.value[3] + right.value[3]}};
+#endif
+}
+
+/**
+ * @return accumulator + texel * weight
+ */
+inline Texel texel_madd(const Texel &accumulator, const Texel &texel, float weight)
+{
+#if defined(VKB_MIP_CHAIN_SSE2)
+	return {_mm_add_ps(accumulator.value, _mm_mul_ps(texel.value, _mm_set1_ps(weight)))};
+#elif defined(VKB_MIP_CHAIN_NEON)
+	return {vmlaq_n_f32(accumulator.value, texel.value, weight)};
+#else
+	Texel result;
+	for (uint32_t c = 0; c < CHANNELS; ++c)
+	{
+		result.value[c] = accumulator.value[c] + texel.value[c] * weight;
+	}
+	return result;
+#endif
+}
+
+/**
+ * @brief Converts a texel to encoding table indices, clamping it to [0, 1]
+ */
+inline void texel_to_indices(const Texel &texel, int32_t indices[CHANNELS])
+{
+	constexpr float scale = static_cast<float>(ENCODE_STEPS - 1);
+#if defined(VKB_MIP_CHAIN_SSE2)
+	__m128 clamped = _mm_min_ps(_mm_max_ps(texel.value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(indices), _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(scale))));
+#elif defined(VKB_MIP_CHAIN_NEON)
+	float32x4_t clamped = vminq_f32(vmaxq_f32(texel.value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+	vst1q_s32(indices, vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(clamped, scale), vdupq_n_f32(0.5f))));
+#else
+	for (uint32_t c = 0; c < CHANNELS; ++c)
+	{
+		indices[c] = static_cast<int32_t>(std::clamp(texel.value[c], 0.0f, 1.0f) * scale + 0.5f);
+	}
+#endif
+}
+
+/**
+ * @brief Reads and writes RGBA8 texels, color channels go through the sRGB tables if required
+ */
+struct Codec
+{
+	const float   *decode_color;
+	const float   *decode_alpha;
+	const uint8_t *encode_color;
+	const uint8_t *encode_alpha;
+
+	explicit Codec(bool srgb)
+	{
+		const auto &tables = get_tables();
+		decode_color       = srgb ? tables.linear_from_srgb : tables.linear_from_unorm;
+		decode_alpha       = tables.linear_from_unorm;
+		encode_color       = srgb ? tables.srgb_from_linear : tables.unorm_from_linear;
+		encode_alpha       = tables.unorm_from_linear;
+	}
+
+	inline Texel decode(const uint8_t *texel) const
+	{
+		return texel_set(decode_color[texel[0]], decode_color[texel[1]], decode_color[texel[2]], decode_alpha[texel[3]]);
+	}
+
+	inline void encode(const Texel &texel, uint8_t *destination) const
+	{
+		int32_t indices[CHANNELS];
+		texel_to_indices(texel, indices);
+		destination[0] = encode_color[indices[0]];
+		destination[1] = encode_color[indices[1]];
+		destination[2] = encode_color[indices[2]];
+		destination[3] = encode_alpha[indices[3]];
+	}
+};
+
+/**
+ * @brief Source taps and weights of each destination texel along one axis
+ */
+struct FilterTaps
+{
+	uint32_t              tap_count;
+	std::vector<uint32_t> first;          // First source texel of each destination texel
+	std::vector<float>    weights;        // tap_count weights per destination texel
+};
+
+float bessel_i0(float x)
+{
+	// Power series, converges quickly for the small arguments used here
+	float sum  = 1.0f;
+	float term = 1.0f;
+	for (uint32_t k = 1; k < 16; ++k)
+	{
+		term *= (x / (2.0f * k)) * (x / (2.0f * k));
+		sum += term;
+	}
+	return sum;
+}
+
+/**
+ * @brief Evaluates the filter kernel
+ * @param t Distance from the destination texel center, in destination texels
+ */
+float evaluate_kernel(MipFilter filter, float t)
+{
+	if (filter == MipFilter::Box)
+	{
+		return std::abs(t) < 0.5f ? 1.0f : 0.0f;
+	}
+
+	if (std::abs(t) >= KAISER_RADIUS)
+	{
+		return 0.0f;
+	}
+
+	constexpr float pi    = 3.14159265358979f;
+	float           sinc  = t == 0.0f ? 1.0f : std::sin(pi * t) / (pi * t);
+	float           ratio = t / KAISER_RADIUS;
+	return sinc * bessel_i0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / bessel_i0(KAISER_ALPHA);
+}
+
+FilterTaps compute_taps(MipFilter filter, uint32_t source_size, uint32_t destination_size)
+{
+	float scale   = static_cast<float>(source_size) / destination_size;
+	float support = (filter == MipFilter::Box ? 0.5f : KAISER_RADIUS) * scale;
+
+	FilterTaps taps;
+	taps.tap_count = static_cast<uint32_t>(std::ceil(support * 2.0f)) + 1;
+	taps.first.resize(destination_size);
+	taps.weights.resize(static_cast<size_t>(destination_size) * taps.tap_count);
+
+	for (uint32_t x = 0; x < destination_size; ++x)
+	{
+		float   center = (x + 0.5f) * scale;
+		int32_t first  = static_cast<int32_t>(std::floor(center - support));
+
+		float *weights = &taps.weights[static_cast<size_t>(x) * taps.tap_count];
+		float  sum     = 0.0f;
+		for (uint32_t i = 0; i < taps.tap_count; ++i)
+		{
+			weights[i] = evaluate_kernel(filter, (first + static_cast<int32_t>(i) + 0.5f - center) / scale);
+			sum += weights[i];
+		}
+
+		// Taps outside of the image are clamped to the edge, so fold their weights into the edge texels
+		int32_t window_first = std::clamp(first, 0, std::max(0, static_cast<int32_t>(source_size) - static_cast<int32_t>(taps.tap_count)));
+
+		std::vector<float> folded(taps.tap_count, 0.0f);
+		for (uint32_t i = 0; i < taps.tap_count; ++i)
+		{
+			int32_t source = std::clamp(first + static_cast<int32_t>(i), 0, static_cast<int32_t>(source_size) - 1);
+			folded[source - window_first] += sum > 0.0f ? weights[i] / sum : 0.0f;
+		}
+		std::copy(folded.begin(), folded.end(), weights);
+
+		taps.first[x] = static_cast<uint32_t>(window_first);
+	}
+
+	return taps;
+}
+
+/**
+ * @brief 2x2 box filter for levels that are exactly half the size of their source
+ */
+void downsample_box(const uint8_t *source, const MipLevel &source_level, uint8_t *destination, const MipLevel &destination_level,
+                    const Codec &codec, uint32_t row_begin, uint32_t row_end)
+{
+	const size_t source_pitch = static_cast<size_t>(source_level.width) * CHANNELS;
+
+	for (uint32_t y = row_begin; y < row_end; ++y)
+	{
+		const uint8_t *row0 = source + std::min(2 * y, source_level.height - 1) * source_pitch;
+		const uint8_t *row1 = source + std::min(2 * y + 1, source_level.height - 1) * source_pitch;
+		uint8_t       *out  = destination + static_cast<size_t>(y) * destination_level.width * CHANNELS;
+
+		for (uint32_t x = 0; x < destination_level.width; ++x)
+		{
+			size_t x0 = std::min(2 * x, source_level.width - 1) * CHANNELS;
+			size_t x1 = std::min(2 * x + 1, source_level.width - 1) * CHANNELS;
+
+			Texel sum = texel_add(texel_add(codec.decode(row0 + x0), codec.decode(row0 + x1)),
+			                      texel_add(codec.decode(row1 + x0), codec.decode(row1 + x1)));
+
+			codec.encode(texel_madd(texel_zero(), sum, 0.25f), out + x * CHANNELS);
+		}
+	}
+}
+
+/**
+ * @brief Separable filter for arbitrary kernels and odd sizes
+ *        Horizontally filtered source rows are kept in a small ring, as consecutive destination rows share most of them
+ */
+void downsample_separable(const uint8_t *source, const MipLevel &source_level, uint8_t *destination, const MipLevel &destination_level,
+                          const Codec &codec, const FilterTaps &horizontal, const FilterTaps &vertical, uint32_t row_begin, uint32_t row_end)
+{
+	const size_t source_pitch = static_cast<size_t>(source_level.width) * CHANNELS;
+	const size_t ring_size    = vertical.tap_count;
+
+	std::vector<Texel>   ring(ring_size * destination_level.width);
+	std::vector<int64_t> ring_rows(ring_size, -1);
+
+	auto get_row = [&](uint32_t source_row) -> const Texel * {
+		size_t slot = source_row % ring_size;
+		Texel *row  = &ring[slot * destination_level.width];
+		if (ring_rows[slot] != source_row)
+		{
+			const uint8_t *input = source + source_row * source_pitch;
+			for (uint32_t x = 0; x < destination_level.width; ++x)
+			{
+				const float *weights = &horizontal.weights[static_cast<size_t>(x) * horizontal.tap_count];
+				uint32_t     first   = horizontal.first[x];
+				uint32_t     count   = std::min(horizontal.tap_count, source_level.width - first);
+
+				Texel sum = texel_zero();
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					sum = texel_madd(sum, codec.decode(input + (first + i) * CHANNELS), weights[i]);
+				}
+				row[x] = sum;
+			}
+			ring_rows[slot] = source_row;
+		}
+		return row;
+	};
+
+	for (uint32_t y = row_begin; y < row_end; ++y)
+	{
+		const float *weights = &vertical.weights[static_cast<size_t>(y) * vertical.tap_count];
+		uint32_t     first   = vertical.first[y];
+		uint32_t     count   = std::min(vertical.tap_count, source_level.height - first);
+
+		const Texel *rows[32];
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			rows[i] = get_row(first + i);
+		}
+
+		uint8_t *out = destination + static_cast<size_t>(y) * destination_level.width * CHANNELS;
+		for (uint32_t x = 0; x < destination_level.width; ++x)
+		{
+			Texel sum = texel_zero();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				sum = texel_madd(sum, rows[i][x], weights[i]);
+			}
+			codec.encode(sum, out + x * CHANNELS);
+		}
+	}
+}
+}        // namespace
+
+std::vector<MipLevel> get_mip_chain_layout(uint32_t width, uint32_t height, size_t &total_size)
+{
+	std::vector<MipLevel> levels;
+
+	width      = std::max(1u, width);
+	height     = std::max(1u, height);
+	total_size = 0;
+
+	while (true)
+	{
+		levels.push_back({width, height, total_size});
+		total_size += static_cast<size_t>(width) * height * CHANNELS;
+
+		if (width == 1 && height == 1)
+		{
+			break;
+		}
+
+		width  = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+	}
+
+	return levels;
+}
+
+void build_mip_chain(uint8_t *data, const std::vector<MipLevel> &levels, bool srgb, MipFilter filter, uint32_t thread_count)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	const Codec codec{srgb};
+
+	for (size_t i = 1; i < levels.size(); ++i)
+	{
+		const auto &source_level      = levels[i - 1];
+		const auto &destination_level = levels[i];
+
+		const uint8_t *source      = data + source_level.offset;
+		uint8_t       *destination = data + destination_level.offset;
+
+		// Halving even sizes with a box filter only needs the 2x2 footprint of each texel
+		bool exact_box = filter == MipFilter::Box &&
+		                 (source_level.width == 1 || source_level.width == destination_level.width * 2) &&
+		                 (source_level.height == 1 || source_level.height == destination_level.height * 2);
+
+		FilterTaps horizontal;
+		FilterTaps vertical;
+		if (!exact_box)
+		{
+			horizontal = compute_taps(filter, source_level.width, destination_level.width);
+			vertical   = compute_taps(filter, source_level.height, destination_level.height);
+		}
+
+		auto downsample = [&](uint32_t row_begin, uint32_t row_end) {
+			if (exact_box)
+			{
+				downsample_box(source, source_level, destination, destination_level, codec, row_begin, row_end);
+			}
+			else
+			{
+				downsample_separable(source, source_level, destination, destination_level, codec, horizontal, vertical, row_begin, row_end);
+			}
+		};
+
+		uint32_t texel_count = destination_level.width * destination_level.height;
+		uint32_t band_count  = std::min({thread_count, destination_level.height, std::max(1u, texel_count / MIN_TEXELS_PER_THREAD)});
+
+		if (band_count <= 1)
+		{
+			downsample(0, destination_level.height);
+			continue;
+		}
+
+		// Split the level into bands of rows, run by the job system and the calling thread
+		uint32_t rows_per_band = (destination_level.height + band_count - 1) / band_count;
+		JobSystem::get().parallel_for(destination_level.height, rows_per_band, [&downsample](size_t row_begin, size_t row_end) {
+			downsample(static_cast<uint32_t>(row_begin), static_cast<uint32_t>(row_end));
+		});
+	}
+}
+}        // namespace vkb
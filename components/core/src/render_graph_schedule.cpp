@@ -0,0 +1,142 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/render_graph_schedule.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace vkb
+{
+std::vector<bool> find_active_passes(const std::vector<RenderGraphPassResources> &passes, std::vector<bool> needed_images)
+{
+	std::vector<bool> active(passes.size(), false);
+
+	for (size_t i = passes.size(); i > 0; --i)
+	{
+		auto &pass = passes[i - 1];
+
+		active[i - 1] = std::any_of(pass.writes.begin(), pass.writes.end(), [&](uint32_t image) { return needed_images[image]; });
+		if (!active[i - 1])
+		{
+			continue;
+		}
+
+		for (auto image : pass.reads)
+		{
+			needed_images[image] = true;
+		}
+	}
+
+	return active;
+}
+
+std::vector<RenderGraphMemoryBlock> alias_image_memory(const std::vector<RenderGraphImageMemory> &images)
+{
+	std::vector<uint32_t> order(images.size());
+	std::iota(order.begin(), order.end(), 0);
+
+	// Largest images first, so that smaller ones fit in the blocks they create
+	std::stable_sort(order.begin(), order.end(), [&images](uint32_t a, uint32_t b) {
+		return images[a].size > images[b].size;
+	});
+
+	std::vector<RenderGraphMemoryBlock> memory_blocks;
+
+	for (auto index : order)
+	{
+		auto &image = images[index];
+
+		auto fits = [&](const RenderGraphMemoryBlock &memory_block) {
+			if (images[memory_block.images.front()].dedicated || (memory_block.memory_type_bits & image.memory_type_bits) == 0)
+			{
+				return false;
+			}
+			return std::none_of(memory_block.images.begin(), memory_block.images.end(), [&](uint32_t other) {
+				return images[other].first_pass <= image.last_pass && image.first_pass <= images[other].last_pass;
+			});
+		};
+
+		auto it = image.dedicated ? memory_blocks.end() : std::find_if(memory_blocks.begin(), memory_blocks.end(), fits);
+		if (it == memory_blocks.end())
+		{
+			memory_blocks.emplace_back();
+			memory_blocks.back().memory_type_bits = image.memory_type_bits;
+			it                                    = std::prev(memory_blocks.end());
+		}
+
+		it->size             = std::max(it->size, image.size);
+		it->alignment        = std::max(it->alignment, image.alignment);
+		it->memory_type_bits = it->memory_type_bits & image.memory_type_bits;
+		it->images.push_back(index);
+	}
+
+	return memory_blocks;
+}
+
+RenderGraphImageBarrier track_image_access(RenderGraphImageState &state, const RenderGraphImageAccess &access, uint64_t write_access_mask)
+{
+	RenderGraphImageBarrier barrier{};
+	barrier.old_layout = state.layout;
+	barrier.new_layout = access.layout;
+
+	if (state.layout != access.layout || access.write)
+	{
+		// Layout transitions and writes wait for all earlier accesses
+		barrier.needed     = state.layout != access.layout || state.write_stages != 0 || state.read_stages != 0;
+		barrier.src_stages = state.write_stages | state.read_stages;
+		barrier.src_access = state.write_access;
+	}
+	else if (state.write_access != 0 && ((access.stages & ~state.visible_stages) != 0 || (access.access & ~state.visible_access) != 0))
+	{
+		// Reads wait for the last write, unless it was already made visible to them
+		barrier.needed     = true;
+		barrier.src_stages = state.write_stages;
+		barrier.src_access = state.write_access;
+	}
+
+	if (access.write)
+	{
+		state.write_stages   = access.stages;
+		state.write_access   = access.access & write_access_mask;
+		state.read_stages    = 0;
+		state.visible_stages = 0;
+		state.visible_access = 0;
+	}
+	else if (state.layout != access.layout)
+	{
+		// The transition is a write, already visible to the access it was made for
+		state.write_stages   = access.stages;
+		state.write_access   = 0;
+		state.read_stages    = access.stages;
+		state.visible_stages = access.stages;
+		state.visible_access = access.access;
+	}
+	else
+	{
+		state.read_stages |= access.stages;
+		if (barrier.needed)
+		{
+			state.visible_stages |= access.stages;
+			state.visible_access |= access.access;
+		}
+	}
+	state.layout = access.layout;
+
+	return barrier;
+}
+}        // namespace vkb
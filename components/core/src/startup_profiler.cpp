@@ -0,0 +1,188 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/startup_profiler.hpp"
+
+#include <algorithm>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "core/util/strings.hpp"
+
+namespace vkb
+{
+namespace
+{
+void append_lines(const StartupProfiler::Node &node, double parent_duration_ms, uint32_t depth, std::vector<std::string> &lines)
+{
+	std::string line = fmt::format("{:{}}{}: {:.1f} ms", "", depth * 2, node.name, node.duration_ms);
+	if (depth > 0 && parent_duration_ms > 0.0)
+	{
+		line += fmt::format(" ({:.1f}%)", 100.0 * node.duration_ms / parent_duration_ms);
+	}
+	if (node.count > 1)
+	{
+		line += fmt::format(" x{}", node.count);
+	}
+	lines.push_back(std::move(line));
+
+	for (auto &child : node.children)
+	{
+		append_lines(child, node.duration_ms, depth + 1, lines);
+	}
+}
+
+void append_json(const StartupProfiler::Node &node, std::string &json)
+{
+	json += "{\"name\":" + to_json_string(node.name);
+	json += fmt::format(",\"duration_ms\":{:.3f},\"count\":{},\"children\":[", node.duration_ms, node.count);
+	for (size_t i = 0; i < node.children.size(); ++i)
+	{
+		if (i > 0)
+		{
+			json += ',';
+		}
+		append_json(node.children[i], json);
+	}
+	json += "]}";
+}
+}        // namespace
+
+StartupProfiler &StartupProfiler::get()
+{
+	static StartupProfiler profiler;
+	return profiler;
+}
+
+void StartupProfiler::start(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	root       = {};
+	root.name  = name;
+	root.count = 1;
+
+	open_scopes.clear();
+	open_scopes.push_back({&root, Clock::now()});
+
+	thread_id = std::this_thread::get_id();
+	recording = true;
+
+	// 0 is the id of scopes which are not recorded
+	if (++recording_index == 0)
+	{
+		recording_index = 1;
+	}
+}
+
+void StartupProfiler::stop()
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	while (!open_scopes.empty())
+	{
+		close_scope();
+	}
+	recording = false;
+}
+
+bool StartupProfiler::is_recording() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+	return recording;
+}
+
+uint32_t StartupProfiler::begin_scope(const char *name)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	if (!recording || std::this_thread::get_id() != thread_id)
+	{
+		return 0;
+	}
+
+	auto &children = open_scopes.back().node->children;
+
+	auto it = std::find_if(children.begin(), children.end(), [name](const Node &child) { return child.name == name; });
+	if (it == children.end())
+	{
+		children.emplace_back(name);
+		it = children.end() - 1;
+	}
+	it->count++;
+
+	open_scopes.push_back({&*it, Clock::now()});
+
+	return recording_index;
+}
+
+void StartupProfiler::end_scope(uint32_t scope_id)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	// The root is only closed by stop
+	if (!recording || scope_id != recording_index || open_scopes.size() < 2)
+	{
+		return;
+	}
+
+	close_scope();
+}
+
+const StartupProfiler::Node &StartupProfiler::get_root() const
+{
+	return root;
+}
+
+std::vector<std::string> StartupProfiler::to_lines() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	std::vector<std::string> lines;
+	append_lines(root, 0.0, 0, lines);
+	return lines;
+}
+
+std::string StartupProfiler::to_json() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	std::string json;
+	append_json(root, json);
+	return json;
+}
+
+void StartupProfiler::close_scope()
+{
+	auto &scope = open_scopes.back();
+	scope.node->duration_ms += std::chrono::duration<double, std::milli>(Clock::now() - scope.start).count();
+	open_scopes.pop_back();
+}
+
+StartupScope::StartupScope(const char *name) :
+    scope_id{StartupProfiler::get().begin_scope(name)}
+{
+}
+
+StartupScope::~StartupScope()
+{
+	if (scope_id != 0)
+	{
+		StartupProfiler::get().end_scope(scope_id);
+	}
+}
+}        // namespace vkb
@@ -43,4 +43,39 @@ std::string trim_left(const std::string &str, const std::string &chars)
 	result.erase(0, str.find_first_not_of(chars));
 	return result;
 }
+
+std::string to_json_string(const std::string &str)
+{
+	static const char hex_digits[] = "0123456789abcdef";
+
+	std::string result = "\"";
+	for (char c : str)
+	{
+		switch (c)
+		{
+			case '"':
+				result += "\\\"";
+				break;
+			case '\\':
+				result += "\\\\";
+				break;
+			case '\n':
+				result += "\\n";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					result += "\\u00";
+					result += hex_digits[c >> 4];
+					result += hex_digits[c & 0xf];
+				}
+				else
+				{
+					result += c;
+				}
+		}
+	}
+	result += '"';
+	return result;
+}
 }        // namespace vkb
\ No newline at end of file
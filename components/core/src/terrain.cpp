@@ -0,0 +1,660 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/terrain.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define VKB_TERRAIN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define VKB_TERRAIN_NEON
+#endif
+
+namespace vkb
+{
+namespace
+{
+constexpr float HEIGHT_SCALE = 1.0f / 65535.0f;
+
+constexpr double PI = 3.14159265358979323846;
+
+// Directions around the viewer in which the horizon is tracked
+constexpr uint32_t HORIZON_BUCKETS = 256;
+
+/**
+ * @brief Brings a coordinate back into [0, count)
+ */
+uint32_t resolve_coordinate(int64_t coordinate, uint32_t count, HeightMapAddressMode address_mode)
+{
+	if (address_mode == HeightMapAddressMode::ClampToEdge)
+	{
+		return static_cast<uint32_t>(std::clamp<int64_t>(coordinate, 0, count - 1));
+	}
+
+	int64_t period   = 2 * static_cast<int64_t>(count);
+	int64_t mirrored = coordinate % period;
+	if (mirrored < 0)
+	{
+		mirrored += period;
+	}
+	return static_cast<uint32_t>(mirrored < count ? mirrored : period - 1 - mirrored);
+}
+
+/**
+ * @brief Splits the coordinates [first, first + count) into the ranges of texels they read, which may overlap
+ * @param visit Called with the first texel and the number of texels of each range
+ */
+template <typename Visitor>
+void for_each_texel_range(int64_t first, uint32_t count, uint32_t size, HeightMapAddressMode address_mode, Visitor &&visit)
+{
+	if (address_mode == HeightMapAddressMode::ClampToEdge)
+	{
+		uint32_t begin = resolve_coordinate(first, size, address_mode);
+		uint32_t end   = resolve_coordinate(first + count - 1, size, address_mode);
+		visit(begin, end - begin + 1);
+		return;
+	}
+
+	// Two periods read every texel
+	if (count >= 2 * size)
+	{
+		visit(0u, size);
+		return;
+	}
+
+	int64_t period     = 2 * static_cast<int64_t>(size);
+	int64_t coordinate = first;
+	int64_t end        = first + count;
+	while (coordinate < end)
+	{
+		int64_t position = coordinate % period;
+		if (position < 0)
+		{
+			position += period;
+		}
+
+		if (position < size)
+		{
+			// Forward run, up to the end of the map
+			auto length = static_cast<uint32_t>(std::min<int64_t>(size - position, end - coordinate));
+			visit(static_cast<uint32_t>(position), length);
+			coordinate += length;
+		}
+		else
+		{
+			// Mirrored run, down to the start of the map
+			auto last   = static_cast<uint32_t>(period - 1 - position);
+			auto length = static_cast<uint32_t>(std::min<int64_t>(period - position, end - coordinate));
+			visit(last + 1 - length, length);
+			coordinate += length;
+		}
+	}
+}
+
+void convert_heights(const uint16_t *texels, uint32_t count, float *heights)
+{
+	uint32_t i = 0;
+#if defined(VKB_TERRAIN_SSE2)
+	const __m128i zero  = _mm_setzero_si128();
+	const __m128  scale = _mm_set1_ps(HEIGHT_SCALE);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texels + i));
+		_mm_storeu_ps(heights + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(values, zero)), scale));
+		_mm_storeu_ps(heights + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(values, zero)), scale));
+	}
+#elif defined(VKB_TERRAIN_NEON)
+	for (; i + 8 <= count; i += 8)
+	{
+		uint16x8_t values = vld1q_u16(texels + i);
+		vst1q_f32(heights + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(values))), HEIGHT_SCALE));
+		vst1q_f32(heights + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(values))), HEIGHT_SCALE));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		heights[i] = texels[i] * HEIGHT_SCALE;
+	}
+}
+
+void update_range(const uint16_t *texels, uint32_t count, uint16_t &min_value, uint16_t &max_value)
+{
+	uint32_t i = 0;
+#if defined(VKB_TERRAIN_SSE2)
+	if (count >= 8)
+	{
+		// SSE2 only compares signed 16-bit values, flipping the sign bit keeps the unsigned order
+		const __m128i bias    = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+		__m128i       lowest  = _mm_set1_epi16(static_cast<int16_t>(min_value ^ 0x8000));
+		__m128i       highest = _mm_set1_epi16(static_cast<int16_t>(max_value ^ 0x8000));
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i values = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(texels + i)), bias);
+			lowest         = _mm_min_epi16(lowest, values);
+			highest        = _mm_max_epi16(highest, values);
+		}
+
+		alignas(16) uint16_t lowest_lanes[8];
+		alignas(16) uint16_t highest_lanes[8];
+		_mm_store_si128(reinterpret_cast<__m128i *>(lowest_lanes), _mm_xor_si128(lowest, bias));
+		_mm_store_si128(reinterpret_cast<__m128i *>(highest_lanes), _mm_xor_si128(highest, bias));
+		min_value = *std::min_element(lowest_lanes, lowest_lanes + 8);
+		max_value = *std::max_element(highest_lanes, highest_lanes + 8);
+	}
+#elif defined(VKB_TERRAIN_NEON)
+	if (count >= 8)
+	{
+		uint16x8_t lowest  = vdupq_n_u16(min_value);
+		uint16x8_t highest = vdupq_n_u16(max_value);
+		for (; i + 8 <= count; i += 8)
+		{
+			uint16x8_t values = vld1q_u16(texels + i);
+			lowest            = vminq_u16(lowest, values);
+			highest           = vmaxq_u16(highest, values);
+		}
+
+		uint16_t lowest_lanes[8];
+		uint16_t highest_lanes[8];
+		vst1q_u16(lowest_lanes, lowest);
+		vst1q_u16(highest_lanes, highest);
+		min_value = *std::min_element(lowest_lanes, lowest_lanes + 8);
+		max_value = *std::max_element(highest_lanes, highest_lanes + 8);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		min_value = std::min(min_value, texels[i]);
+		max_value = std::max(max_value, texels[i]);
+	}
+}
+
+/**
+ * @brief Sobel filter of one normal, h(dx, dy) being the height at offset (dx, dy)
+ */
+inline void sobel_normal(const float *above, const float *center, const float *below, float *normal)
+{
+	float x = above[0] - above[2] + 2.0f * center[0] - 2.0f * center[2] + below[0] - below[2];
+	float z = above[0] + 2.0f * above[1] + above[2] - below[0] - 2.0f * below[1] - below[2];
+	float y = 0.25f * std::sqrt(std::max(0.0f, 1.0f - x * x - z * z));
+
+	x *= 2.0f;
+	z *= 2.0f;
+	float length = std::sqrt(x * x + y * y + z * z);
+	normal[0]    = x / length;
+	normal[1]    = y / length;
+	normal[2]    = z / length;
+}
+
+inline float *get_normal(float *normals, size_t normal_stride, size_t index)
+{
+	return reinterpret_cast<float *>(reinterpret_cast<uint8_t *>(normals) + index * normal_stride);
+}
+
+/**
+ * @brief Horizontal extent of a patch seen from the viewer
+ */
+struct PatchView
+{
+	uint32_t patch;
+
+	// Closest and farthest horizontal distances to the patch
+	float min_distance;
+	float max_distance;
+
+	// Directions of the patch around the viewer, in buckets from -pi, less than half a turn apart
+	double min_direction;
+	double max_direction;
+
+	// Slope of the line from the eye to the highest point of the patch that is the steepest,
+	// and of the line to the lowest point that is the least steep
+	float top_slope;
+	float bottom_slope;
+};
+
+/**
+ * @brief Horizon in a range of directions around the viewer
+ *
+ * Patches covering the bucket on either side are kept until another one covers the rest of it.
+ */
+struct HorizonBucket
+{
+	float slope{std::numeric_limits<float>::lowest()};
+
+	// Coverage from the start of the bucket up to left_end, and from right_start to its end, in buckets
+	double left_end{0.0};
+	float  left_slope{std::numeric_limits<float>::lowest()};
+	double right_start{1.0};
+	float  right_slope{std::numeric_limits<float>::lowest()};
+};
+
+inline double get_direction(float x, float z)
+{
+	return (std::atan2(static_cast<double>(z), static_cast<double>(x)) / (2.0 * PI) + 0.5) * HORIZON_BUCKETS;
+}
+
+inline uint32_t wrap_bucket(int64_t bucket)
+{
+	return static_cast<uint32_t>(((bucket % HORIZON_BUCKETS) + HORIZON_BUCKETS) % HORIZON_BUCKETS);
+}
+
+/**
+ * @brief Raises the horizon of the directions a patch covers to the slope of the line to its lowest point
+ */
+void add_occluder(std::vector<HorizonBucket> &horizon, const PatchView &occluder)
+{
+	auto first = static_cast<int64_t>(std::floor(occluder.min_direction));
+	auto last  = static_cast<int64_t>(std::floor(occluder.max_direction));
+	for (int64_t bucket = first; bucket <= last; ++bucket)
+	{
+		auto  &state = horizon[wrap_bucket(bucket)];
+		double start = occluder.min_direction - bucket;
+		double end   = occluder.max_direction - bucket;
+
+		if (start <= 0.0 && end >= 1.0)
+		{
+			state.slope = std::max(state.slope, occluder.bottom_slope);
+			continue;
+		}
+
+		if (start <= 0.0)
+		{
+			if (end >= state.right_start)
+			{
+				state.slope = std::max(state.slope, std::min(occluder.bottom_slope, state.right_slope));
+			}
+			if (end > state.left_end)
+			{
+				state.left_end   = end;
+				state.left_slope = occluder.bottom_slope;
+			}
+		}
+		else if (end >= 1.0)
+		{
+			if (start <= state.left_end)
+			{
+				state.slope = std::max(state.slope, std::min(occluder.bottom_slope, state.left_slope));
+			}
+			if (start < state.right_start)
+			{
+				state.right_start = start;
+				state.right_slope = occluder.bottom_slope;
+			}
+		}
+	}
+}
+}        // namespace
+
+void sample_heights(const HeightMapView &map, int32_t x, int32_t y, uint32_t count_x, uint32_t count_y, uint32_t stride,
+                    HeightMapAddressMode address_mode, float *heights)
+{
+	assert(stride > 0 && map.width > 0 && map.height > 0);
+
+	// Number of samples covering the map along each axis
+	uint32_t columns = (map.width - 1) / stride + 1;
+	uint32_t rows    = (map.height - 1) / stride + 1;
+
+	std::vector<uint32_t> offsets(count_x);
+	bool                  contiguous = true;
+	for (uint32_t i = 0; i < count_x; ++i)
+	{
+		offsets[i] = resolve_coordinate(static_cast<int64_t>(x) + i, columns, address_mode) * stride;
+		contiguous = contiguous && (i == 0 || offsets[i] == offsets[i - 1] + 1);
+	}
+
+	for (uint32_t j = 0; j < count_y; ++j)
+	{
+		const uint16_t *row    = map.data + static_cast<size_t>(resolve_coordinate(static_cast<int64_t>(y) + j, rows, address_mode)) * stride * map.width;
+		float          *output = heights + static_cast<size_t>(j) * count_x;
+
+		if (contiguous && count_x > 0)
+		{
+			convert_heights(row + offsets[0], count_x, output);
+			continue;
+		}
+
+		for (uint32_t i = 0; i < count_x; ++i)
+		{
+			output[i] = row[offsets[i]] * HEIGHT_SCALE;
+		}
+	}
+}
+
+void compute_sobel_normals(const float *heights, uint32_t count_x, uint32_t count_y, float *normals, size_t normal_stride)
+{
+	const size_t pitch = static_cast<size_t>(count_x) + 2;
+
+	for (uint32_t j = 0; j < count_y; ++j)
+	{
+		const float *above  = heights + j * pitch;
+		const float *center = above + pitch;
+		const float *below  = center + pitch;
+
+		uint32_t i = 0;
+#if defined(VKB_TERRAIN_SSE2) || defined(VKB_TERRAIN_NEON)
+		// Four normals at a time, from the three rows of heights around them
+		alignas(16) float lanes[3][4];
+		for (; i + 4 <= count_x; i += 4)
+		{
+#	if defined(VKB_TERRAIN_SSE2)
+			__m128 a0 = _mm_loadu_ps(above + i), a1 = _mm_loadu_ps(above + i + 1), a2 = _mm_loadu_ps(above + i + 2);
+			__m128 c0 = _mm_loadu_ps(center + i), c2 = _mm_loadu_ps(center + i + 2);
+			__m128 b0 = _mm_loadu_ps(below + i), b1 = _mm_loadu_ps(below + i + 1), b2 = _mm_loadu_ps(below + i + 2);
+
+			const __m128 two = _mm_set1_ps(2.0f);
+			__m128       x   = _mm_add_ps(_mm_sub_ps(a0, a2), _mm_add_ps(_mm_mul_ps(two, _mm_sub_ps(c0, c2)), _mm_sub_ps(b0, b2)));
+			__m128       z   = _mm_sub_ps(_mm_add_ps(_mm_add_ps(a0, _mm_mul_ps(two, a1)), a2), _mm_add_ps(_mm_add_ps(b0, _mm_mul_ps(two, b1)), b2));
+			__m128       y   = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)));
+			y                = _mm_mul_ps(_mm_set1_ps(0.25f), _mm_sqrt_ps(_mm_max_ps(y, _mm_setzero_ps())));
+
+			x             = _mm_mul_ps(x, two);
+			z             = _mm_mul_ps(z, two);
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+			_mm_store_ps(lanes[0], _mm_div_ps(x, length));
+			_mm_store_ps(lanes[1], _mm_div_ps(y, length));
+			_mm_store_ps(lanes[2], _mm_div_ps(z, length));
+#	else
+			float32x4_t a0 = vld1q_f32(above + i), a1 = vld1q_f32(above + i + 1), a2 = vld1q_f32(above + i + 2);
+			float32x4_t c0 = vld1q_f32(center + i), c2 = vld1q_f32(center + i + 2);
+			float32x4_t b0 = vld1q_f32(below + i), b1 = vld1q_f32(below + i + 1), b2 = vld1q_f32(below + i + 2);
+
+			float32x4_t x = vaddq_f32(vsubq_f32(a0, a2), vaddq_f32(vmulq_n_f32(vsubq_f32(c0, c2), 2.0f), vsubq_f32(b0, b2)));
+			float32x4_t z = vsubq_f32(vaddq_f32(vaddq_f32(a0, vmulq_n_f32(a1, 2.0f)), a2), vaddq_f32(vaddq_f32(b0, vmulq_n_f32(b1, 2.0f)), b2));
+
+			// No vector square root on 32-bit NEON, the lanes finish in scalar code
+			float32x4_t y = vmaxq_f32(vsubq_f32(vdupq_n_f32(1.0f), vaddq_f32(vmulq_f32(x, x), vmulq_f32(z, z))), vdupq_n_f32(0.0f));
+			vst1q_f32(lanes[0], vmulq_n_f32(x, 2.0f));
+			vst1q_f32(lanes[1], y);
+			vst1q_f32(lanes[2], vmulq_n_f32(z, 2.0f));
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				lanes[1][lane] = 0.25f * std::sqrt(lanes[1][lane]);
+
+				float length   = std::sqrt(lanes[0][lane] * lanes[0][lane] + lanes[1][lane] * lanes[1][lane] + lanes[2][lane] * lanes[2][lane]);
+				lanes[0][lane] = lanes[0][lane] / length;
+				lanes[1][lane] = lanes[1][lane] / length;
+				lanes[2][lane] = lanes[2][lane] / length;
+			}
+#	endif
+
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				float *normal = get_normal(normals, normal_stride, static_cast<size_t>(j) * count_x + i + lane);
+				normal[0]     = lanes[0][lane];
+				normal[1]     = lanes[1][lane];
+				normal[2]     = lanes[2][lane];
+			}
+		}
+#endif
+
+		for (; i < count_x; ++i)
+		{
+			sobel_normal(above + i, center + i, below + i, get_normal(normals, normal_stride, static_cast<size_t>(j) * count_x + i));
+		}
+	}
+}
+
+void get_height_range(const HeightMapView &map, int32_t x, int32_t y, uint32_t width, uint32_t height, HeightMapAddressMode address_mode,
+                      float &min_height, float &max_height)
+{
+	assert(width > 0 && height > 0);
+
+	uint16_t min_value = std::numeric_limits<uint16_t>::max();
+	uint16_t max_value = 0;
+
+	for_each_texel_range(y, height, map.height, address_mode, [&](uint32_t first_row, uint32_t row_count) {
+		for (uint32_t row = first_row; row < first_row + row_count; ++row)
+		{
+			const uint16_t *texels = map.data + static_cast<size_t>(row) * map.width;
+			for_each_texel_range(x, width, map.width, address_mode, [&](uint32_t first_column, uint32_t column_count) {
+				update_range(texels + first_column, column_count, min_value, max_value);
+			});
+		}
+	});
+
+	min_height = min_value * HEIGHT_SCALE;
+	max_height = max_value * HEIGHT_SCALE;
+}
+
+TerrainQuadtree::TerrainQuadtree(const float *patch_height_ranges, uint32_t patch_count_x, uint32_t patch_count_y) :
+    patch_count_x{patch_count_x},
+    patch_count_y{patch_count_y}
+{
+	if (patch_count_x == 0 || patch_count_y == 0)
+	{
+		return;
+	}
+
+	// Breadth first, so that children always come after their parent
+	nodes.push_back({0, 0, patch_count_x, patch_count_y, 0.0f, 0.0f, 0, 0});
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		auto node = nodes[i];
+		if (node.width == 1 && node.height == 1)
+		{
+			const float *range  = patch_height_ranges + 2 * (node.x + static_cast<size_t>(node.y) * patch_count_x);
+			nodes[i].min_height = range[0];
+			nodes[i].max_height = range[1];
+			continue;
+		}
+
+		uint32_t half_width  = (node.width + 1) / 2;
+		uint32_t half_height = (node.height + 1) / 2;
+
+		nodes[i].first_child = static_cast<uint32_t>(nodes.size());
+		for (uint32_t child_y = 0; child_y < 2; ++child_y)
+		{
+			for (uint32_t child_x = 0; child_x < 2; ++child_x)
+			{
+				uint32_t width  = child_x == 0 ? half_width : node.width - half_width;
+				uint32_t height = child_y == 0 ? half_height : node.height - half_height;
+				if (width > 0 && height > 0)
+				{
+					nodes.push_back({node.x + child_x * half_width, node.y + child_y * half_height, width, height, 0.0f, 0.0f, 0, 0});
+					++nodes[i].child_count;
+				}
+			}
+		}
+	}
+
+	// Bounds of the parents from their children, bottom up
+	for (size_t i = nodes.size(); i-- > 0;)
+	{
+		auto &node = nodes[i];
+		if (node.child_count == 0)
+		{
+			continue;
+		}
+
+		node.min_height = std::numeric_limits<float>::max();
+		node.max_height = std::numeric_limits<float>::lowest();
+		for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+		{
+			node.min_height = std::min(node.min_height, nodes[child].min_height);
+			node.max_height = std::max(node.max_height, nodes[child].max_height);
+		}
+	}
+}
+
+const std::vector<TerrainQuadtreeNode> &TerrainQuadtree::get_nodes() const
+{
+	return nodes;
+}
+
+uint32_t TerrainQuadtree::get_patch_count() const
+{
+	return patch_count_x * patch_count_y;
+}
+
+void TerrainQuadtree::cull(const TerrainLayout &layout, const float frustum_planes[6][4], const float eye[3], bool horizon_culling,
+                           std::vector<uint32_t> &visible_patches) const
+{
+	if (nodes.empty())
+	{
+		return;
+	}
+
+	// Up is the direction in which the terrain rises, altitudes are measured along it
+	const float up             = layout.height_scale < 0.0f ? -1.0f : 1.0f;
+	const float altitude_scale = std::abs(layout.height_scale);
+	const float eye_altitude   = eye[1] * up;
+
+	// Patches in the frustum, with the part of the view they take
+	std::vector<PatchView> patch_views;
+
+	std::vector<uint32_t> stack{0};
+	while (!stack.empty())
+	{
+		auto &node = nodes[stack.back()];
+		stack.pop_back();
+
+		float min_x = layout.origin_x + node.x * layout.patch_size;
+		float max_x = layout.origin_x + (node.x + node.width) * layout.patch_size;
+		float min_y = std::min(node.min_height * layout.height_scale, node.max_height * layout.height_scale);
+		float max_y = std::max(node.min_height * layout.height_scale, node.max_height * layout.height_scale);
+		float min_z = layout.origin_z + node.y * layout.patch_size;
+		float max_z = layout.origin_z + (node.y + node.height) * layout.patch_size;
+
+		// Outside if the corner the furthest along the plane normal is behind the plane
+		bool outside = false;
+		for (uint32_t p = 0; p < 6 && !outside; ++p)
+		{
+			const float *plane = frustum_planes[p];
+			float        x     = plane[0] >= 0.0f ? max_x : min_x;
+			float        y     = plane[1] >= 0.0f ? max_y : min_y;
+			float        z     = plane[2] >= 0.0f ? max_z : min_z;
+			outside            = plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f;
+		}
+		if (outside)
+		{
+			continue;
+		}
+
+		if (node.child_count > 0)
+		{
+			for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+			{
+				stack.push_back(child);
+			}
+			continue;
+		}
+
+		uint32_t patch = node.x + node.y * patch_count_x;
+		if (!horizon_culling)
+		{
+			visible_patches.push_back(patch);
+			continue;
+		}
+
+		PatchView view{};
+		view.patch = patch;
+
+		float near_x = std::max({min_x - eye[0], 0.0f, eye[0] - max_x});
+		float near_z = std::max({min_z - eye[2], 0.0f, eye[2] - max_z});
+		float far_x  = std::max(std::abs(min_x - eye[0]), std::abs(max_x - eye[0]));
+		float far_z  = std::max(std::abs(min_z - eye[2]), std::abs(max_z - eye[2]));
+
+		view.min_distance = std::sqrt(near_x * near_x + near_z * near_z);
+		view.max_distance = std::sqrt(far_x * far_x + far_z * far_z);
+
+		if (view.min_distance > 0.0f)
+		{
+			// Corner directions on the same side of the -pi / pi seam as the center of the patch
+			double center      = get_direction((min_x + max_x) * 0.5f - eye[0], (min_z + max_z) * 0.5f - eye[2]);
+			view.min_direction = center;
+			view.max_direction = center;
+			for (float corner_x : {min_x, max_x})
+			{
+				for (float corner_z : {min_z, max_z})
+				{
+					double direction = get_direction(corner_x - eye[0], corner_z - eye[2]);
+					if (direction - center > HORIZON_BUCKETS / 2)
+					{
+						direction -= HORIZON_BUCKETS;
+					}
+					else if (direction - center < -static_cast<double>(HORIZON_BUCKETS / 2))
+					{
+						direction += HORIZON_BUCKETS;
+					}
+					view.min_direction = std::min(view.min_direction, direction);
+					view.max_direction = std::max(view.max_direction, direction);
+				}
+			}
+
+			float top         = node.max_height * altitude_scale - eye_altitude;
+			float bottom      = node.min_height * altitude_scale - eye_altitude;
+			view.top_slope    = std::max(top / view.min_distance, top / view.max_distance);
+			view.bottom_slope = std::min(bottom / view.min_distance, bottom / view.max_distance);
+		}
+
+		patch_views.push_back(view);
+	}
+
+	if (!horizon_culling)
+	{
+		return;
+	}
+
+	// Front to back, each patch raises the horizon behind it up to its lowest height. A ray at a direction the patch
+	// fully covers crosses it between its closest and farthest distances, so it is hidden below the least steep line
+	// to its lowest point, for every patch farther than the whole of it.
+	std::sort(patch_views.begin(), patch_views.end(), [](const PatchView &left, const PatchView &right) { return left.min_distance < right.min_distance; });
+
+	std::vector<HorizonBucket> horizon(HORIZON_BUCKETS);
+
+	auto farther = [&](uint32_t left, uint32_t right) { return patch_views[left].max_distance > patch_views[right].max_distance; };
+	std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(farther)> occluders(farther);
+
+	for (uint32_t i = 0; i < patch_views.size(); ++i)
+	{
+		auto &view = patch_views[i];
+
+		while (!occluders.empty() && patch_views[occluders.top()].max_distance <= view.min_distance)
+		{
+			add_occluder(horizon, patch_views[occluders.top()]);
+			occluders.pop();
+		}
+
+		// The viewer stands over this patch, it is neither hidden nor hides a whole direction
+		if (view.min_distance == 0.0f)
+		{
+			visible_patches.push_back(view.patch);
+			continue;
+		}
+
+		bool hidden = true;
+		auto last   = static_cast<int64_t>(std::floor(view.max_direction));
+		for (auto bucket = static_cast<int64_t>(std::floor(view.min_direction)); bucket <= last && hidden; ++bucket)
+		{
+			hidden = view.top_slope < horizon[wrap_bucket(bucket)].slope;
+		}
+
+		if (!hidden)
+		{
+			visible_patches.push_back(view.patch);
+		}
+
+		occluders.push(i);
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,215 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/virtual_texture_pages.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace vkb
+{
+VirtualTexturePageTable::VirtualTexturePageTable(uint32_t width, uint32_t height, uint32_t mip_levels, uint32_t streamed_levels, uint32_t page_width, uint32_t page_height, uint32_t slot_capacity, uint32_t frames_in_flight) :
+    mip_levels{std::max(1U, mip_levels)},
+    slot_capacity{slot_capacity},
+    frames_in_flight{std::max(1U, frames_in_flight)}
+{
+	assert(page_width > 0 && page_height > 0);
+
+	for (uint32_t level = 0; level < std::min(streamed_levels, this->mip_levels); ++level)
+	{
+		VirtualTexturePageLevel properties{};
+		properties.width      = std::max(1U, width >> level);
+		properties.height     = std::max(1U, height >> level);
+		properties.columns    = (properties.width + page_width - 1) / page_width;
+		properties.rows       = (properties.height + page_height - 1) / page_height;
+		properties.first_page = page_count;
+		levels.push_back(properties);
+
+		page_count += properties.columns * properties.rows;
+	}
+	pages.resize(page_count);
+}
+
+const std::vector<VirtualTexturePageLevel> &VirtualTexturePageTable::get_levels() const
+{
+	return levels;
+}
+
+uint32_t VirtualTexturePageTable::get_page_count() const
+{
+	return page_count;
+}
+
+uint32_t VirtualTexturePageTable::get_level(uint32_t page_index) const
+{
+	assert(page_index < page_count);
+
+	auto it = std::upper_bound(levels.begin(), levels.end(), page_index, [](uint32_t index, const VirtualTexturePageLevel &level) { return index < level.first_page; });
+	return static_cast<uint32_t>(std::distance(levels.begin(), it)) - 1;
+}
+
+std::vector<uint32_t> VirtualTexturePageTable::select_pages(const std::vector<VirtualTexturePageRequest> &requests) const
+{
+	if (levels.empty())
+	{
+		return {};
+	}
+
+	std::vector<bool>                  selected(page_count, false);
+	std::vector<std::vector<uint32_t>> level_pages(levels.size());
+
+	auto select_region = [&](uint32_t level, float u_min, float v_min, float u_max, float v_max) {
+		const auto &properties = levels[level];
+
+		uint32_t column_begin = std::min(static_cast<uint32_t>(u_min * properties.columns), properties.columns - 1);
+		uint32_t row_begin    = std::min(static_cast<uint32_t>(v_min * properties.rows), properties.rows - 1);
+		uint32_t column_end   = std::clamp(static_cast<uint32_t>(std::ceil(u_max * properties.columns)), column_begin + 1, properties.columns);
+		uint32_t row_end      = std::clamp(static_cast<uint32_t>(std::ceil(v_max * properties.rows)), row_begin + 1, properties.rows);
+
+		for (uint32_t row = row_begin; row < row_end; ++row)
+		{
+			for (uint32_t column = column_begin; column < column_end; ++column)
+			{
+				uint32_t page_index = properties.first_page + row * properties.columns + column;
+				if (!selected[page_index])
+				{
+					selected[page_index] = true;
+					level_pages[level].push_back(page_index);
+				}
+			}
+		}
+	};
+
+	select_region(static_cast<uint32_t>(levels.size()) - 1, 0.0f, 0.0f, 1.0f, 1.0f);
+
+	for (const auto &request : requests)
+	{
+		float u_min = std::clamp(std::min(request.u_min, request.u_max), 0.0f, 1.0f);
+		float v_min = std::clamp(std::min(request.v_min, request.v_max), 0.0f, 1.0f);
+		float u_max = std::clamp(std::max(request.u_min, request.u_max), 0.0f, 1.0f);
+		float v_max = std::clamp(std::max(request.v_min, request.v_max), 0.0f, 1.0f);
+		float lod   = std::clamp(request.lod, 0.0f, static_cast<float>(mip_levels - 1));
+
+		for (auto level : {static_cast<uint32_t>(std::floor(lod)), static_cast<uint32_t>(std::ceil(lod))})
+		{
+			if (level < levels.size())
+			{
+				select_region(level, u_min, v_min, u_max, v_max);
+			}
+		}
+	}
+
+	// Coarser levels first, they cover more of the screen with fewer pages
+	std::vector<uint32_t> selection;
+	for (auto it = level_pages.rbegin(); it != level_pages.rend(); ++it)
+	{
+		selection.insert(selection.end(), it->begin(), it->end());
+	}
+	return selection;
+}
+
+void VirtualTexturePageTable::begin_frame()
+{
+	++frame_counter;
+}
+
+int64_t VirtualTexturePageTable::get_slot(uint32_t page_index) const
+{
+	return pages[page_index].slot;
+}
+
+void VirtualTexturePageTable::touch(uint32_t page_index)
+{
+	auto &page = pages[page_index];
+	assert(page.slot >= 0);
+
+	lru.splice(lru.begin(), lru, page.lru_position);
+	page.last_used_frame = frame_counter;
+}
+
+bool VirtualTexturePageTable::needs_slots() const
+{
+	return free_slots.empty() && slot_count < slot_capacity;
+}
+
+uint32_t VirtualTexturePageTable::get_slot_count() const
+{
+	return slot_count;
+}
+
+uint32_t VirtualTexturePageTable::get_slot_capacity() const
+{
+	return slot_capacity;
+}
+
+uint32_t VirtualTexturePageTable::add_slots(uint32_t count)
+{
+	count = std::min(count, slot_capacity - slot_count);
+
+	// Free slots are taken from the back, lower slots are used first
+	for (uint32_t i = count; i > 0; --i)
+	{
+		free_slots.push_back(slot_count + i - 1);
+	}
+	slot_count += count;
+
+	return count;
+}
+
+int64_t VirtualTexturePageTable::make_resident(uint32_t page_index, int64_t &evicted_page)
+{
+	auto &page = pages[page_index];
+	assert(page.slot < 0);
+
+	evicted_page = -1;
+
+	int64_t slot_index = -1;
+	if (!free_slots.empty())
+	{
+		slot_index = free_slots.back();
+		free_slots.pop_back();
+	}
+	else
+	{
+		// Evict the least recently used page unless a frame in flight may still sample it
+		if (lru.empty() || pages[lru.back()].last_used_frame + frames_in_flight > frame_counter)
+		{
+			return -1;
+		}
+
+		evicted_page = lru.back();
+		lru.pop_back();
+
+		auto &evicted = pages[evicted_page];
+		slot_index    = evicted.slot;
+		evicted.slot  = -1;
+	}
+
+	page.slot = slot_index;
+	lru.push_front(page_index);
+	page.lru_position    = lru.begin();
+	page.last_used_frame = frame_counter;
+
+	return slot_index;
+}
+
+uint32_t VirtualTexturePageTable::get_resident_page_count() const
+{
+	return static_cast<uint32_t>(lru.size());
+}
+}        // namespace vkb
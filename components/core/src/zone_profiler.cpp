@@ -0,0 +1,317 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/zone_profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "core/util/strings.hpp"
+
+namespace vkb
+{
+struct ZoneProfiler::ThreadBuffer
+{
+	struct Slot
+	{
+		// Read while being overwritten, which would be a data race with plain members
+		std::atomic<const char *> name{nullptr};
+		std::atomic<uint64_t>     begin_ns{0};
+		std::atomic<uint64_t>     end_ns{0};
+		std::atomic<uint32_t>     depth{0};
+	};
+
+	std::array<Slot, ZONE_CAPACITY> slots;
+
+	// Number of zones ever written, the next one goes to write_count % ZONE_CAPACITY
+	std::atomic<uint64_t> write_count{0};
+
+	// Increased before a slot is written, so that readers know which slots may be changing
+	std::atomic<uint64_t> begin_count{0};
+
+	std::atomic<bool> in_use{true};
+
+	uint32_t thread_index{0};
+
+	// Guarded by threads_mutex
+	std::string thread_name;
+};
+
+std::atomic<bool> ZoneProfiler::enabled{false};
+
+thread_local ZoneProfiler::ThreadState ZoneProfiler::thread_state;
+
+ZoneProfiler::ThreadState::~ThreadState()
+{
+	if (buffer)
+	{
+		buffer->in_use.store(false, std::memory_order_release);
+	}
+}
+
+ZoneProfiler &ZoneProfiler::get()
+{
+	// Never destroyed, threads may still close zones while static objects are destroyed
+	static ZoneProfiler *profiler = new ZoneProfiler;
+	return *profiler;
+}
+
+ZoneProfiler::ZoneProfiler() = default;
+
+ZoneProfiler::~ZoneProfiler() = default;
+
+void ZoneProfiler::set_enabled(bool enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+void ZoneProfiler::set_thread_name(const std::string &name)
+{
+	// Buffers are only allocated once a thread records a zone
+	thread_state.name = name;
+
+	if (thread_state.buffer)
+	{
+		std::lock_guard<std::mutex> lock{threads_mutex};
+		thread_state.buffer->thread_name = name;
+	}
+}
+
+void ZoneProfiler::mark_frame()
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+
+	auto index = frame_count.load(std::memory_order_relaxed);
+	frame_begins_ns[index % FRAME_CAPACITY].store(now_ns(), std::memory_order_relaxed);
+	frame_count.store(index + 1, std::memory_order_release);
+}
+
+ZoneProfiler::Capture ZoneProfiler::capture(uint32_t frame_count_to_capture) const
+{
+	Capture capture;
+
+	// Frame boundaries, the last one is the end of the last complete frame
+	auto marked_count   = frame_count.load(std::memory_order_acquire);
+	auto boundary_count = std::min<uint64_t>({marked_count, static_cast<uint64_t>(frame_count_to_capture) + 1, FRAME_CAPACITY});
+	if (boundary_count < 2)
+	{
+		return capture;
+	}
+	for (auto index = marked_count - boundary_count; index < marked_count; ++index)
+	{
+		capture.frame_times_ns.push_back(frame_begins_ns[index % FRAME_CAPACITY].load(std::memory_order_relaxed));
+	}
+
+	uint64_t window_begin = capture.frame_times_ns.front();
+	uint64_t window_end   = capture.frame_times_ns.back();
+
+	std::lock_guard<std::mutex> lock{threads_mutex};
+
+	for (auto &buffer : thread_buffers)
+	{
+		ThreadZones thread_zones;
+		thread_zones.thread_index = buffer->thread_index;
+		thread_zones.thread_name  = buffer->thread_name.empty() ? fmt::format("Thread {}", buffer->thread_index) : buffer->thread_name;
+
+		auto write_count = buffer->write_count.load(std::memory_order_acquire);
+		auto first       = write_count > ZONE_CAPACITY ? write_count - ZONE_CAPACITY : 0;
+
+		std::vector<Zone> zones;
+		zones.reserve(static_cast<size_t>(write_count - first));
+		for (auto index = first; index < write_count; ++index)
+		{
+			auto &slot = buffer->slots[index % ZONE_CAPACITY];
+			zones.push_back({slot.name.load(std::memory_order_relaxed),
+			                 slot.begin_ns.load(std::memory_order_relaxed),
+			                 slot.end_ns.load(std::memory_order_relaxed),
+			                 slot.depth.load(std::memory_order_relaxed)});
+		}
+
+		// Zones written while copying may have overwritten the oldest ones
+		std::atomic_thread_fence(std::memory_order_acquire);
+		auto begin_count = buffer->begin_count.load(std::memory_order_relaxed);
+		auto overwritten = begin_count > ZONE_CAPACITY ? std::min(begin_count - ZONE_CAPACITY, write_count) - first : 0;
+
+		for (size_t i = static_cast<size_t>(overwritten); i < zones.size(); ++i)
+		{
+			if (zones[i].end_ns > window_begin && zones[i].begin_ns < window_end)
+			{
+				thread_zones.zones.push_back(zones[i]);
+			}
+		}
+
+		if (!thread_zones.zones.empty())
+		{
+			capture.threads.push_back(std::move(thread_zones));
+		}
+	}
+
+	std::sort(capture.threads.begin(), capture.threads.end(), [](const ThreadZones &a, const ThreadZones &b) { return a.thread_index < b.thread_index; });
+
+	return capture;
+}
+
+std::string ZoneProfiler::to_chrome_trace(const Capture &capture)
+{
+	uint64_t origin_ns = capture.frame_times_ns.empty() ? 0 : capture.frame_times_ns.front();
+
+	// Chrome traces are in microseconds, relative to the begin of the capture
+	auto to_us = [origin_ns](uint64_t time_ns) { return (static_cast<double>(time_ns) - static_cast<double>(origin_ns)) * 1e-3; };
+
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool        first = true;
+
+	auto append_event = [&json, &first](const std::string &event) {
+		if (!first)
+		{
+			json += ',';
+		}
+		json += event;
+		first = false;
+	};
+
+	for (size_t i = 0; i + 1 < capture.frame_times_ns.size(); ++i)
+	{
+		append_event(fmt::format("{{\"name\":\"Frame {}\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":{:.3f}}}", i, to_us(capture.frame_times_ns[i])));
+	}
+
+	for (auto &thread : capture.threads)
+	{
+		append_event(fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":{}}}}}", thread.thread_index, to_json_string(thread.thread_name)));
+
+		for (auto &zone : thread.zones)
+		{
+			append_event(fmt::format("{{\"name\":{},\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+			                         to_json_string(zone.name ? zone.name : ""), thread.thread_index, to_us(zone.begin_ns), (zone.end_ns - zone.begin_ns) * 1e-3));
+		}
+	}
+
+	json += "]}";
+	return json;
+}
+
+uint64_t ZoneProfiler::now_ns()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint32_t ZoneProfiler::enter_zone()
+{
+	return thread_state.depth++;
+}
+
+void ZoneProfiler::exit_zone(const char *name, uint64_t begin_ns, uint32_t depth)
+{
+	auto &state = thread_state;
+	state.depth = depth;
+
+	if (!state.buffer)
+	{
+		get().acquire_thread_buffer();
+	}
+
+	write_zone(*state.buffer, name, begin_ns, now_ns(), depth);
+}
+
+void ZoneProfiler::record_zone(const std::string &track, const char *name, uint64_t begin_ns, uint64_t end_ns, uint32_t depth)
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+
+	ThreadBuffer *buffer;
+	{
+		std::lock_guard<std::mutex> lock{threads_mutex};
+
+		auto it = tracks.find(track);
+		if (it == tracks.end())
+		{
+			// Tracks are never handed over to threads
+			buffer              = &create_thread_buffer();
+			buffer->thread_name = track;
+			tracks.emplace(track, buffer);
+		}
+		else
+		{
+			buffer = it->second;
+		}
+	}
+
+	write_zone(*buffer, name, begin_ns, end_ns, depth);
+}
+
+void ZoneProfiler::write_zone(ThreadBuffer &buffer, const char *name, uint64_t begin_ns, uint64_t end_ns, uint32_t depth)
+{
+	// Only one thread writes to the buffer, readers check begin_count to skip the zones being overwritten
+	auto index = buffer.write_count.load(std::memory_order_relaxed);
+	buffer.begin_count.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	auto &slot = buffer.slots[index % ZONE_CAPACITY];
+	slot.name.store(name, std::memory_order_relaxed);
+	slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+	slot.end_ns.store(end_ns, std::memory_order_relaxed);
+	slot.depth.store(depth, std::memory_order_relaxed);
+	buffer.write_count.store(index + 1, std::memory_order_release);
+}
+
+ZoneProfiler::ThreadBuffer &ZoneProfiler::acquire_thread_buffer()
+{
+	if (thread_state.buffer)
+	{
+		return *thread_state.buffer;
+	}
+
+	std::lock_guard<std::mutex> lock{threads_mutex};
+
+	// Threads are only registered once they record a zone, and exited threads leave their buffer to new ones
+	auto it = std::find_if(thread_buffers.begin(), thread_buffers.end(), [](const std::unique_ptr<ThreadBuffer> &buffer) {
+		return !buffer->in_use.load(std::memory_order_acquire);
+	});
+
+	ThreadBuffer *buffer;
+	if (it != thread_buffers.end())
+	{
+		buffer = it->get();
+		buffer->in_use.store(true, std::memory_order_relaxed);
+	}
+	else
+	{
+		buffer = &create_thread_buffer();
+	}
+
+	buffer->thread_name = thread_state.name;
+
+	thread_state.buffer = buffer;
+	return *buffer;
+}
+
+ZoneProfiler::ThreadBuffer &ZoneProfiler::create_thread_buffer()
+{
+	thread_buffers.push_back(std::make_unique<ThreadBuffer>());
+
+	auto &buffer        = *thread_buffers.back();
+	buffer.thread_index = static_cast<uint32_t>(thread_buffers.size() - 1);
+	return buffer;
+}
+}        // namespace vkb
@@ -0,0 +1,94 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/descriptor_backend.hpp>
+
+using namespace vkb;
+
+namespace
+{
+DescriptorSetUsage create_set(uint32_t set_index, uint32_t descriptor_count)
+{
+	DescriptorSetUsage set{};
+	set.set_index        = set_index;
+	set.descriptor_count = descriptor_count;
+	return set;
+}
+
+DescriptorBackendSupport create_support(bool push_descriptor, bool descriptor_buffer)
+{
+	DescriptorBackendSupport support{};
+	support.push_descriptor      = push_descriptor;
+	support.max_push_descriptors = push_descriptor ? 32 : 0;
+	support.descriptor_buffer    = descriptor_buffer;
+	return support;
+}
+}        // namespace
+
+TEST_CASE("vkb::select_descriptor_backend uses pools without device support", "[descriptor_backend]")
+{
+	uint32_t push_descriptor_set_index = 0;
+
+	REQUIRE(select_descriptor_backend({create_set(0, 4)}, create_support(false, false), push_descriptor_set_index) == DescriptorBackend::Pool);
+	REQUIRE(select_descriptor_backend({}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::Pool);
+}
+
+TEST_CASE("vkb::select_descriptor_backend pushes a single small set", "[descriptor_backend]")
+{
+	uint32_t push_descriptor_set_index = 0;
+
+	REQUIRE(select_descriptor_backend({create_set(2, 4)}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::PushDescriptor);
+	REQUIRE(push_descriptor_set_index == 2);
+
+	REQUIRE(select_descriptor_backend({create_set(0, 32)}, create_support(true, false), push_descriptor_set_index) == DescriptorBackend::PushDescriptor);
+}
+
+TEST_CASE("vkb::select_descriptor_backend writes into descriptor buffers what cannot be pushed", "[descriptor_backend]")
+{
+	uint32_t push_descriptor_set_index = 0;
+
+	// Only a single set per layout may be pushed
+	REQUIRE(select_descriptor_backend({create_set(0, 1), create_set(1, 1)}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::DescriptorBuffer);
+	REQUIRE(select_descriptor_backend({create_set(0, 1), create_set(1, 1)}, create_support(true, false), push_descriptor_set_index) == DescriptorBackend::Pool);
+
+	// More descriptors than maxPushDescriptors
+	REQUIRE(select_descriptor_backend({create_set(0, 33)}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::DescriptorBuffer);
+	REQUIRE(select_descriptor_backend({create_set(0, 33)}, create_support(true, false), push_descriptor_set_index) == DescriptorBackend::Pool);
+
+	REQUIRE(select_descriptor_backend({create_set(0, 4)}, create_support(false, true), push_descriptor_set_index) == DescriptorBackend::DescriptorBuffer);
+}
+
+TEST_CASE("vkb::select_descriptor_backend falls back to pools for unsupported descriptors", "[descriptor_backend]")
+{
+	uint32_t push_descriptor_set_index = 0;
+
+	auto dynamic_set                         = create_set(0, 4);
+	dynamic_set.dynamic_or_update_after_bind = true;
+
+	REQUIRE(select_descriptor_backend({dynamic_set}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::Pool);
+	REQUIRE(select_descriptor_backend({create_set(1, 1), dynamic_set}, create_support(false, true), push_descriptor_set_index) == DescriptorBackend::Pool);
+
+	// Descriptor types the descriptor buffer path cannot encode may still be pushed
+	auto unencodable_set             = create_set(0, 4);
+	unencodable_set.buffer_encodable = false;
+
+	REQUIRE(select_descriptor_backend({unencodable_set}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::PushDescriptor);
+	REQUIRE(select_descriptor_backend({unencodable_set}, create_support(false, true), push_descriptor_set_index) == DescriptorBackend::Pool);
+	REQUIRE(select_descriptor_backend({create_set(1, 1), unencodable_set}, create_support(true, true), push_descriptor_set_index) == DescriptorBackend::Pool);
+}
@@ -0,0 +1,36 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include <core/util/hash.hpp>
+
+using namespace vkb;
+
+TEST_CASE("vkb::hash_fnv1a", "[hash]")
+{
+	std::string data = "a";
+
+	// Reference values of 64-bit FNV-1a
+	REQUIRE(hash_fnv1a(nullptr, 0) == 0xcbf29ce484222325ull);
+	REQUIRE(hash_fnv1a(reinterpret_cast<const uint8_t *>(data.data()), data.size()) == 0xaf63dc4c8601ec8cull);
+
+	// Seeds tell apart the hashes of the same data
+	REQUIRE(hash_fnv1a(reinterpret_cast<const uint8_t *>(data.data()), data.size(), 1) != hash_fnv1a(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+}
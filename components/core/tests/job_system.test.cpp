@@ -0,0 +1,187 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include <core/util/job_system.hpp>
+
+using namespace vkb;
+
+TEST_CASE("vkb::JobSystem runs all submitted jobs", "[job_system]")
+{
+	JobSystem job_system{4};
+
+	std::atomic<uint32_t> run_count{0};
+
+	JobCounter counter;
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		job_system.submit([&run_count]() { run_count++; }, &counter);
+	}
+	job_system.wait(counter);
+
+	REQUIRE(counter.is_done());
+	REQUIRE(run_count == 1000);
+}
+
+TEST_CASE("vkb::JobSystem runs jobs after their dependency", "[job_system]")
+{
+	JobSystem job_system{2};
+
+	std::atomic<uint32_t> first_count{0};
+	std::atomic<bool>     ordered{true};
+
+	JobCounter first;
+	JobCounter second;
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		job_system.submit([&first_count]() { first_count++; }, &first);
+	}
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		job_system.submit([&first_count, &ordered]() {
+			if (first_count != 64)
+			{
+				ordered = false;
+			}
+		},
+		                  &second, &first);
+	}
+	job_system.wait(second);
+
+	REQUIRE(first.is_done());
+	REQUIRE(ordered);
+}
+
+TEST_CASE("vkb::JobSystem waits from jobs without deadlocking", "[job_system]")
+{
+	JobSystem job_system{2};
+
+	std::atomic<uint32_t> leaf_count{0};
+
+	// More nested waits than workers, waiting workers have to run the jobs themselves
+	JobCounter counter;
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		job_system.submit([&job_system, &leaf_count]() {
+			JobCounter nested;
+			for (uint32_t j = 0; j < 8; ++j)
+			{
+				job_system.submit([&leaf_count]() { leaf_count++; }, &nested);
+			}
+			job_system.wait(nested);
+		},
+		                  &counter);
+	}
+	job_system.wait(counter);
+
+	REQUIRE(leaf_count == 64);
+}
+
+TEST_CASE("vkb::JobSystem rethrows the exceptions of a counter", "[job_system]")
+{
+	JobSystem job_system{2};
+
+	JobCounter counter;
+	job_system.submit([]() { throw std::runtime_error{"job failed"}; }, &counter);
+	job_system.submit([]() {}, &counter);
+
+	REQUIRE_THROWS_AS(job_system.wait(counter), std::runtime_error);
+
+	// The exception is only rethrown once
+	job_system.wait(counter);
+}
+
+TEST_CASE("vkb::JobSystem::parallel_for covers the range once", "[job_system]")
+{
+	JobSystem job_system{3};
+
+	std::vector<uint32_t> values(10000, 0);
+	job_system.parallel_for(values.size(), 100, [&values](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			values[i]++;
+		}
+	});
+
+	REQUIRE(std::accumulate(values.begin(), values.end(), 0u) == 10000);
+	REQUIRE(std::all_of(values.begin(), values.end(), [](uint32_t value) { return value == 1; }));
+
+	// Ranges smaller than the grain run on the calling thread
+	uint32_t call_count = 0;
+	job_system.parallel_for(10, 100, [&call_count](size_t begin, size_t end) {
+		call_count++;
+		REQUIRE(begin == 0);
+		REQUIRE(end == 10);
+	});
+	REQUIRE(call_count == 1);
+}
+
+TEST_CASE("vkb::JobSystem wakes waiting threads once their jobs can run", "[job_system]")
+{
+	JobSystem job_system{2};
+
+	std::atomic<bool> released{false};
+	std::atomic<bool> ordered{true};
+
+	// The calling thread finds no job it may run and sleeps until the dependency releases the second job
+	JobCounter first;
+	JobCounter second;
+	job_system.submit([&released]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		released = true;
+	},
+	                  &first);
+	job_system.submit([&released, &ordered]() { ordered = released.load(); }, &second, &first);
+	job_system.wait(second);
+
+	REQUIRE(first.is_done());
+	REQUIRE(ordered);
+}
+
+TEST_CASE("vkb::JobSystem runs jobs on the submitting thread after shutdown", "[job_system]")
+{
+	JobSystem job_system{2};
+
+	std::atomic<uint32_t> run_count{0};
+
+	JobCounter counter;
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		job_system.submit([&run_count]() { run_count++; }, &counter);
+	}
+
+	// Queued jobs run before the workers are joined
+	job_system.shutdown();
+	REQUIRE(counter.is_done());
+	REQUIRE(run_count == 64);
+
+	auto            submitting_thread = std::this_thread::get_id();
+	std::thread::id job_thread;
+	job_system.submit([&job_thread]() { job_thread = std::this_thread::get_id(); }, &counter);
+	REQUIRE(counter.is_done());
+	REQUIRE(job_thread == submitting_thread);
+
+	job_system.shutdown();
+}
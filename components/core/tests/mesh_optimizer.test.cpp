@@ -0,0 +1,178 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <core/util/mesh_optimizer.hpp>
+
+#include "test_meshes.hpp"
+
+using namespace vkb;
+using namespace vkb::tests;
+
+namespace
+{
+std::vector<std::array<uint32_t, 3>> get_sorted_triangles(const std::vector<uint32_t> &indices)
+{
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		triangles.push_back({indices[i], indices[i + 1], indices[i + 2]});
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+}        // namespace
+
+TEST_CASE("vkb::optimize_vertex_cache", "[mesh_optimizer]")
+{
+	TestMesh mesh;
+	add_sphere(mesh, 1.0f, 64, 64);
+	shuffle_triangles(mesh);
+
+	std::vector<uint32_t> optimized(mesh.indices.size());
+	optimize_vertex_cache(optimized.data(), mesh.indices.data(), mesh.indices.size(), mesh.get_vertex_count());
+
+	// Same triangles, in another order
+	auto sorted_input     = mesh.indices;
+	auto sorted_optimized = optimized;
+	std::sort(sorted_input.begin(), sorted_input.end());
+	std::sort(sorted_optimized.begin(), sorted_optimized.end());
+	REQUIRE(sorted_input == sorted_optimized);
+
+	// A shuffled grid transforms almost every vertex of every triangle, an optimized one reuses most of them
+	float input_acmr     = get_average_cache_miss_ratio(mesh.indices.data(), mesh.indices.size(), mesh.get_vertex_count());
+	float optimized_acmr = get_average_cache_miss_ratio(optimized.data(), optimized.size(), mesh.get_vertex_count());
+	REQUIRE(input_acmr > 2.0f);
+	REQUIRE(optimized_acmr < 0.8f);
+}
+
+TEST_CASE("vkb::optimize_overdraw", "[mesh_optimizer]")
+{
+	// An inner sphere listed before the outer one that hides it
+	TestMesh mesh;
+	add_sphere(mesh, 0.5f, 32, 64);
+	size_t inner_triangle_count = mesh.indices.size() / 3;
+	size_t inner_vertex_count   = mesh.get_vertex_count();
+	add_sphere(mesh, 1.0f, 32, 64);
+
+	std::vector<uint32_t> indices(mesh.indices.size());
+	optimize_vertex_cache(indices.data(), mesh.indices.data(), mesh.indices.size(), mesh.get_vertex_count());
+	float cache_acmr = get_average_cache_miss_ratio(indices.data(), indices.size(), mesh.get_vertex_count());
+
+	optimize_overdraw(indices.data(), indices.size(), mesh.positions.data(), mesh.get_vertex_count(), 3 * sizeof(float), 1.05f);
+
+	// Triangles are moved as a whole, with their winding
+	REQUIRE(get_sorted_triangles(indices) == get_sorted_triangles(mesh.indices));
+
+	// The vertex cache efficiency stays close to the threshold
+	float overdraw_acmr = get_average_cache_miss_ratio(indices.data(), indices.size(), mesh.get_vertex_count());
+	REQUIRE(overdraw_acmr <= cache_acmr * 1.1f);
+
+	// The outer sphere is now drawn first, mostly
+	size_t inner_position_sum = 0;
+	size_t outer_position_sum = 0;
+	for (size_t t = 0; t < indices.size() / 3; ++t)
+	{
+		(indices[t * 3] < inner_vertex_count ? inner_position_sum : outer_position_sum) += t;
+	}
+	size_t outer_triangle_count = indices.size() / 3 - inner_triangle_count;
+	REQUIRE(outer_position_sum / outer_triangle_count < inner_position_sum / inner_triangle_count);
+}
+
+TEST_CASE("vkb::optimize_vertex_fetch", "[mesh_optimizer]")
+{
+	TestMesh mesh;
+	add_sphere(mesh, 1.0f, 16, 16);
+	shuffle_triangles(mesh);
+
+	// One more vertex that no triangle uses
+	size_t vertex_count = mesh.get_vertex_count() + 1;
+
+	auto indices = mesh.indices;
+	auto remap   = optimize_vertex_fetch(indices.data(), indices.size(), vertex_count);
+
+	REQUIRE(remap.size() == vertex_count - 1);
+
+	// The same vertices are referenced, and each new vertex is first used after the previous one
+	uint32_t next_vertex = 0;
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		REQUIRE(remap[indices[i]] == mesh.indices[i]);
+		REQUIRE(indices[i] <= next_vertex);
+		if (indices[i] == next_vertex)
+		{
+			++next_vertex;
+		}
+	}
+}
+
+TEST_CASE("vkb::quantize_half", "[mesh_optimizer]")
+{
+	REQUIRE(quantize_half(0.0f) == 0x0000);
+	REQUIRE(quantize_half(-0.0f) == 0x8000);
+	REQUIRE(quantize_half(1.0f) == 0x3C00);
+	REQUIRE(quantize_half(-2.0f) == 0xC000);
+	REQUIRE(quantize_half(0.333333f) == 0x3555);
+	REQUIRE(quantize_half(65504.0f) == 0x7BFF);
+
+	// Ties round to the even mantissa
+	REQUIRE(quantize_half(1.0f + 1.0f / 2048.0f) == 0x3C00);
+	REQUIRE(quantize_half(1.0f + 3.0f / 2048.0f) == 0x3C02);
+
+	// Denormals
+	REQUIRE(quantize_half(std::ldexp(1.0f, -24)) == 0x0001);
+	REQUIRE(quantize_half(std::ldexp(1.0f, -15)) == 0x0200);
+	REQUIRE(quantize_half(std::ldexp(1.0f, -26)) == 0x0000);
+
+	// Out of range and special values
+	REQUIRE(quantize_half(65520.0f) == 0x7C00);
+	REQUIRE(quantize_half(-1e10f) == 0xFC00);
+	REQUIRE(quantize_half(std::numeric_limits<float>::infinity()) == 0x7C00);
+	REQUIRE((quantize_half(std::numeric_limits<float>::quiet_NaN()) & 0x7FFF) > 0x7C00);
+}
+
+TEST_CASE("vkb::quantize_snorm", "[mesh_optimizer]")
+{
+	REQUIRE(quantize_snorm(1.0f, 8) == 127);
+	REQUIRE(quantize_snorm(-1.0f, 8) == -127);
+	REQUIRE(quantize_snorm(2.0f, 10) == 511);
+	REQUIRE(quantize_snorm(-0.5f, 10) == -256);
+	REQUIRE(quantize_snorm(0.0f, 2) == 0);
+
+	REQUIRE(pack_snorm_r8g8b8a8(1.0f, -1.0f, 0.0f, 0.5f) == 0x4000817F);
+
+	uint32_t packed = pack_snorm_a2b10g10r10(1.0f, -1.0f, 0.0f, -1.0f);
+	REQUIRE((packed & 0x3FF) == 511);
+	REQUIRE(((packed >> 10) & 0x3FF) == 0x201);
+	REQUIRE(((packed >> 20) & 0x3FF) == 0);
+	REQUIRE((packed >> 30) == 0x3);
+
+	// Unit vectors keep their direction within the precision of the format
+	float    normal[3] = {0.267f, 0.535f, -0.802f};
+	uint32_t quantized = pack_snorm_a2b10g10r10(normal[0], normal[1], normal[2], 0.0f);
+	for (uint32_t c = 0; c < 3; ++c)
+	{
+		int32_t value = static_cast<int32_t>(quantized << (22 - c * 10)) >> 22;
+		REQUIRE(std::abs(value / 511.0f - normal[c]) <= 0.5f / 511.0f);
+	}
+}
@@ -0,0 +1,259 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+
+#include <core/util/meshlet_builder.hpp>
+
+#include "test_meshes.hpp"
+
+using namespace vkb;
+using namespace vkb::tests;
+
+namespace
+{
+MeshletSource get_source(const TestMesh &mesh)
+{
+	return {mesh.indices.data(), mesh.indices.size(), mesh.positions.data(), mesh.get_vertex_count(), 3 * sizeof(float)};
+}
+
+// The previous loader behaviour: consecutive triangles until 64 unique vertices or 32 triangles
+size_t count_linear_meshlets(const std::vector<uint32_t> &indices)
+{
+	size_t             meshlet_count = 0;
+	std::set<uint32_t> vertices;
+	uint32_t           triangle_count = 0;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		std::set<uint32_t> added = vertices;
+		added.insert(indices.begin() + i, indices.begin() + i + 3);
+		if (added.size() > 64 || triangle_count == 32)
+		{
+			++meshlet_count;
+			vertices.clear();
+			vertices.insert(indices.begin() + i, indices.begin() + i + 3);
+			triangle_count = 1;
+		}
+		else
+		{
+			vertices = std::move(added);
+			++triangle_count;
+		}
+	}
+	return meshlet_count + (triangle_count > 0);
+}
+
+void check_meshlets(const TestMesh &mesh, const MeshletMesh &meshlets, const MeshletOptions &options)
+{
+	REQUIRE(meshlets.meshlets.size() == meshlets.bounds.size());
+
+	// Every triangle is in exactly one meshlet, with its winding preserved
+	std::multiset<std::array<uint32_t, 3>> expected;
+	for (size_t i = 0; i < mesh.indices.size(); i += 3)
+	{
+		std::array<uint32_t, 3> triangle{mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		expected.insert(triangle);
+	}
+
+	for (size_t m = 0; m < meshlets.meshlets.size(); ++m)
+	{
+		auto &meshlet = meshlets.meshlets[m];
+		auto &bounds  = meshlets.bounds[m];
+
+		REQUIRE(meshlet.vertex_count <= options.max_vertices);
+		REQUIRE(meshlet.triangle_count <= options.max_triangles);
+		REQUIRE(meshlet.triangle_count > 0);
+
+		for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+		{
+			std::array<uint32_t, 3> triangle;
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				uint8_t local = meshlets.triangles[(meshlet.triangle_offset + t) * 3 + c];
+				REQUIRE(local < meshlet.vertex_count);
+				triangle[c] = meshlets.vertices[meshlet.vertex_offset + local];
+			}
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+
+			auto it = expected.find(triangle);
+			REQUIRE(it != expected.end());
+			expected.erase(it);
+		}
+
+		// The bounding sphere holds every vertex
+		for (uint32_t v = 0; v < meshlet.vertex_count; ++v)
+		{
+			const float *position = &mesh.positions[meshlets.vertices[meshlet.vertex_offset + v] * 3];
+
+			float dx = position[0] - bounds.center[0];
+			float dy = position[1] - bounds.center[1];
+			float dz = position[2] - bounds.center[2];
+			REQUIRE(std::sqrt(dx * dx + dy * dy + dz * dz) <= bounds.radius * 1.0001f + 1e-6f);
+		}
+	}
+
+	REQUIRE(expected.empty());
+}
+}        // namespace
+
+TEST_CASE("vkb::build_meshlets limits and coverage", "[meshlet_builder]")
+{
+	auto mesh = create_sphere(48, 96);
+
+	for (auto options : {MeshletOptions{64, 124, 0.25f}, MeshletOptions{64, 32, 0.0f}, MeshletOptions{3, 1, 1.0f}})
+	{
+		auto meshlets = build_meshlets(get_source(mesh), options);
+		check_meshlets(mesh, meshlets, options);
+	}
+}
+
+TEST_CASE("vkb::build_meshlets fewer meshlets than linear splitting", "[meshlet_builder]")
+{
+	auto mesh = create_sphere(48, 96);
+
+	auto meshlets = build_meshlets(get_source(mesh), MeshletOptions{64, 32, 0.25f});
+
+	// Growing meshlets over adjacent triangles fills them, cutting a shuffled list in order does not
+	REQUIRE(meshlets.meshlets.size() < count_linear_meshlets(mesh.indices));
+}
+
+TEST_CASE("vkb::build_meshlets normal cone", "[meshlet_builder]")
+{
+	auto mesh     = create_sphere(48, 96);
+	auto meshlets = build_meshlets(get_source(mesh));
+
+	// Seen from outside the sphere, meshlets on the far side are back facing, while those facing the camera never are
+	const float outside[3] = {0.0f, 0.0f, -10.0f};
+
+	auto is_back_facing = [](const MeshletBounds &bounds, const float *camera) {
+		float direction[3] = {bounds.cone_apex[0] - camera[0], bounds.cone_apex[1] - camera[1], bounds.cone_apex[2] - camera[2]};
+		float length       = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+		return (direction[0] * bounds.cone_axis[0] + direction[1] * bounds.cone_axis[1] + direction[2] * bounds.cone_axis[2]) >= bounds.cone_cutoff * length;
+	};
+
+	size_t culled_outside = 0;
+	for (size_t m = 0; m < meshlets.meshlets.size(); ++m)
+	{
+		auto &bounds = meshlets.bounds[m];
+		if (bounds.center[2] < -0.5f)
+		{
+			REQUIRE_FALSE(is_back_facing(bounds, outside));
+		}
+
+		if (is_back_facing(bounds, outside))
+		{
+			++culled_outside;
+
+			// A culled meshlet must have every triangle facing away from the camera
+			auto &meshlet = meshlets.meshlets[m];
+			for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+			{
+				const uint8_t *triangle = &meshlets.triangles[(meshlet.triangle_offset + t) * 3];
+				const float   *a        = &mesh.positions[meshlets.vertices[meshlet.vertex_offset + triangle[0]] * 3];
+				const float   *b        = &mesh.positions[meshlets.vertices[meshlet.vertex_offset + triangle[1]] * 3];
+				const float   *c        = &mesh.positions[meshlets.vertices[meshlet.vertex_offset + triangle[2]] * 3];
+
+				float ab[3]   = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+				float ac[3]   = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+				float n[3]    = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+				float to_a[3] = {a[0] - outside[0], a[1] - outside[1], a[2] - outside[2]};
+				REQUIRE(n[0] * to_a[0] + n[1] * to_a[1] + n[2] * to_a[2] >= -1e-6f);
+			}
+		}
+	}
+
+	REQUIRE(culled_outside > meshlets.meshlets.size() / 4);
+}
+
+TEST_CASE("vkb::build_meshlets thread count", "[meshlet_builder]")
+{
+	std::vector<TestMesh> meshes;
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		meshes.push_back(create_sphere(16 + i * 8, 32, i));
+	}
+
+	std::vector<MeshletSource> sources;
+	for (auto &mesh : meshes)
+	{
+		sources.push_back(get_source(mesh));
+	}
+
+	auto single_threaded = build_meshlets(sources, {}, 1);
+	auto multi_threaded  = build_meshlets(sources, {}, 4);
+
+	REQUIRE(single_threaded.size() == sources.size());
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		REQUIRE(single_threaded[i].vertices == multi_threaded[i].vertices);
+		REQUIRE(single_threaded[i].triangles == multi_threaded[i].triangles);
+	}
+}
+
+TEST_CASE("vkb::build_meshlets large mesh benchmark", "[meshlet_builder][.benchmark]")
+{
+	// About two million triangles, split in eight submeshes for the parallel build
+	std::vector<TestMesh> meshes;
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		meshes.push_back(create_sphere(256, 512, i));
+	}
+
+	std::vector<MeshletSource> sources;
+	size_t                     linear_count = 0;
+	for (auto &mesh : meshes)
+	{
+		sources.push_back(get_source(mesh));
+		linear_count += count_linear_meshlets(mesh.indices);
+	}
+
+	MeshletOptions options{64, 32, 0.25f};
+
+	size_t built_count = 0;
+	for (auto &meshlets : build_meshlets(sources, options))
+	{
+		built_count += meshlets.meshlets.size();
+	}
+	WARN("Meshlets with 64 vertices and 32 triangles at most: " << linear_count << " linear, " << built_count << " built");
+
+	BENCHMARK("linear split")
+	{
+		size_t count = 0;
+		for (auto &mesh : meshes)
+		{
+			count += count_linear_meshlets(mesh.indices);
+		}
+		return count;
+	};
+
+	BENCHMARK("build_meshlets, single thread")
+	{
+		return build_meshlets(sources, options, 1).size();
+	};
+
+	BENCHMARK("build_meshlets")
+	{
+		return build_meshlets(sources, options).size();
+	};
+}
@@ -0,0 +1,160 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb_image_resize.h>
+VKBP_ENABLE_WARNINGS()
+
+#include <core/util/mip_chain.hpp>
+
+using namespace vkb;
+
+namespace
+{
+std::vector<uint8_t> create_chain(uint32_t width, uint32_t height, std::vector<MipLevel> &levels)
+{
+	size_t total_size = 0;
+	levels            = get_mip_chain_layout(width, height, total_size);
+
+	std::vector<uint8_t> data(total_size, 0);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			uint8_t *texel = &data[(static_cast<size_t>(y) * width + x) * 4];
+			texel[0]       = static_cast<uint8_t>(x * 7 + y * 3);
+			texel[1]       = static_cast<uint8_t>(x ^ y);
+			texel[2]       = (x + y) % 2 ? 255 : 0;
+			texel[3]       = static_cast<uint8_t>(y);
+		}
+	}
+	return data;
+}
+}        // namespace
+
+TEST_CASE("vkb::get_mip_chain_layout", "[mip_chain]")
+{
+	size_t total_size = 0;
+	auto   levels     = get_mip_chain_layout(8, 2, total_size);
+
+	REQUIRE(levels.size() == 4);
+	REQUIRE(levels[1].width == 4);
+	REQUIRE(levels[1].height == 1);
+	REQUIRE(levels[1].offset == 8 * 2 * 4);
+	REQUIRE(levels[3].width == 1);
+	REQUIRE(levels[3].height == 1);
+	REQUIRE(total_size == (16 + 4 + 2 + 1) * 4);
+}
+
+TEST_CASE("vkb::build_mip_chain constant image", "[mip_chain]")
+{
+	for (auto filter : {MipFilter::Box, MipFilter::Kaiser})
+	{
+		std::vector<MipLevel> levels;
+		auto                  data = create_chain(37, 20, levels);
+		for (size_t i = 0; i < levels[0].width * levels[0].height * 4; i += 4)
+		{
+			data[i + 0] = 10;
+			data[i + 1] = 128;
+			data[i + 2] = 250;
+			data[i + 3] = 77;
+		}
+
+		build_mip_chain(data.data(), levels, true, filter, 4);
+
+		// Filtering a constant image must reproduce it at every level, whatever the filter and the size
+		for (size_t i = levels[1].offset; i < data.size(); i += 4)
+		{
+			REQUIRE(data[i + 0] == 10);
+			REQUIRE(data[i + 1] == 128);
+			REQUIRE(data[i + 2] == 250);
+			REQUIRE(data[i + 3] == 77);
+		}
+	}
+}
+
+TEST_CASE("vkb::build_mip_chain srgb box", "[mip_chain]")
+{
+	// A black and white checkerboard averages to 50% linear intensity, which is 188 in sRGB but 128 in UNORM
+	std::vector<MipLevel> levels;
+	auto                  srgb_data  = create_chain(2, 2, levels);
+	auto                  unorm_data = srgb_data;
+
+	build_mip_chain(srgb_data.data(), levels, true);
+	build_mip_chain(unorm_data.data(), levels, false);
+
+	REQUIRE(srgb_data[levels[1].offset + 2] == 188);
+	REQUIRE(unorm_data[levels[1].offset + 2] == 128);
+
+	// Alpha is never gamma corrected
+	REQUIRE(srgb_data[levels[1].offset + 3] == unorm_data[levels[1].offset + 3]);
+}
+
+TEST_CASE("vkb::build_mip_chain thread count", "[mip_chain]")
+{
+	for (auto filter : {MipFilter::Box, MipFilter::Kaiser})
+	{
+		std::vector<MipLevel> levels;
+		auto                  single_threaded = create_chain(515, 300, levels);
+		auto                  multi_threaded  = single_threaded;
+
+		build_mip_chain(single_threaded.data(), levels, true, filter, 1);
+		build_mip_chain(multi_threaded.data(), levels, true, filter, 8);
+
+		REQUIRE(single_threaded == multi_threaded);
+	}
+}
+
+TEST_CASE("vkb::build_mip_chain 4K benchmark", "[mip_chain][.benchmark]")
+{
+	std::vector<MipLevel> levels;
+	auto                  data = create_chain(4096, 4096, levels);
+
+	BENCHMARK("stbir_resize_uint8 per level")
+	{
+		for (size_t i = 1; i < levels.size(); ++i)
+		{
+			stbir_resize_uint8(data.data() + levels[i - 1].offset, levels[i - 1].width, levels[i - 1].height, 0,
+			                   data.data() + levels[i].offset, levels[i].width, levels[i].height, 0, 4);
+		}
+		return data[levels.back().offset];
+	};
+
+	BENCHMARK("build_mip_chain box, single thread")
+	{
+		build_mip_chain(data.data(), levels, true, MipFilter::Box, 1);
+		return data[levels.back().offset];
+	};
+
+	BENCHMARK("build_mip_chain box")
+	{
+		build_mip_chain(data.data(), levels, true, MipFilter::Box);
+		return data[levels.back().offset];
+	};
+
+	BENCHMARK("build_mip_chain kaiser")
+	{
+		build_mip_chain(data.data(), levels, true, MipFilter::Kaiser);
+		return data[levels.back().offset];
+	};
+}
@@ -0,0 +1,192 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/render_graph_schedule.hpp>
+
+using namespace vkb;
+
+namespace
+{
+// Values of the matching Vulkan enums
+constexpr uint32_t LAYOUT_UNDEFINED        = 0;
+constexpr uint32_t LAYOUT_COLOR_ATTACHMENT = 2;
+constexpr uint32_t LAYOUT_SHADER_READ_ONLY = 5;
+
+constexpr uint64_t STAGE_FRAGMENT_SHADER = 0x80;
+constexpr uint64_t STAGE_COLOR_OUTPUT    = 0x400;
+constexpr uint64_t STAGE_COMPUTE_SHADER  = 0x800;
+
+constexpr uint64_t ACCESS_SHADER_READ = 0x20;
+constexpr uint64_t ACCESS_COLOR_READ  = 0x80;
+constexpr uint64_t ACCESS_COLOR_WRITE = 0x100;
+constexpr uint64_t WRITE_ACCESS_MASK  = ACCESS_COLOR_WRITE;
+
+constexpr uint32_t DEVICE_LOCAL_MEMORY_TYPE = 0x1;
+
+const RenderGraphImageAccess color_write{STAGE_COLOR_OUTPUT, ACCESS_COLOR_READ | ACCESS_COLOR_WRITE, LAYOUT_COLOR_ATTACHMENT, true};
+const RenderGraphImageAccess fragment_read{STAGE_FRAGMENT_SHADER, ACCESS_SHADER_READ, LAYOUT_SHADER_READ_ONLY, false};
+const RenderGraphImageAccess compute_read{STAGE_COMPUTE_SHADER, ACCESS_SHADER_READ, LAYOUT_SHADER_READ_ONLY, false};
+
+RenderGraphImageMemory create_image(uint64_t size, uint32_t first_pass, uint32_t last_pass)
+{
+	RenderGraphImageMemory image{};
+	image.size       = size;
+	image.alignment  = 256;
+	image.first_pass = first_pass;
+	image.last_pass  = last_pass;
+	return image;
+}
+}        // namespace
+
+TEST_CASE("vkb::find_active_passes culls the passes whose results are unused", "[render_graph_schedule]")
+{
+	// 0: writes image 0, 1: writes image 1 from image 0, 2: writes image 2, only image 1 is needed
+	std::vector<RenderGraphPassResources> passes = {
+	    {{}, {0}},
+	    {{0}, {1}},
+	    {{}, {2}}};
+
+	REQUIRE(find_active_passes(passes, {false, true, false}) == std::vector<bool>{true, true, false});
+
+	// Nothing is needed, everything is culled
+	REQUIRE(find_active_passes(passes, {false, false, false}) == std::vector<bool>{false, false, false});
+}
+
+TEST_CASE("vkb::find_active_passes keeps the writers that come before a read", "[render_graph_schedule]")
+{
+	// Image 0 is written by passes 0 and 2, pass 1 reads the content written by pass 0
+	std::vector<RenderGraphPassResources> passes = {
+	    {{}, {0}},
+	    {{0}, {1}},
+	    {{}, {0}}};
+
+	REQUIRE(find_active_passes(passes, {true, false}) == std::vector<bool>{true, false, true});
+	REQUIRE(find_active_passes(passes, {false, true}) == std::vector<bool>{true, true, false});
+}
+
+TEST_CASE("vkb::alias_image_memory shares memory between disjoint lifetimes", "[render_graph_schedule]")
+{
+	std::vector<RenderGraphImageMemory> images = {
+	    create_image(1024, 0, 1),
+	    create_image(4096, 2, 3),
+	    create_image(2048, 1, 2)};
+	images[1].alignment = 4096;
+
+	auto memory_blocks = alias_image_memory(images);
+
+	// Image 1 is placed first, image 0 fits in its block, image 2 overlaps both
+	REQUIRE(memory_blocks.size() == 2);
+	REQUIRE(memory_blocks[0].images == std::vector<uint32_t>{1, 0});
+	REQUIRE(memory_blocks[0].size == 4096);
+	REQUIRE(memory_blocks[0].alignment == 4096);
+	REQUIRE(memory_blocks[1].images == std::vector<uint32_t>{2});
+	REQUIRE(memory_blocks[1].size == 2048);
+	REQUIRE(memory_blocks[1].alignment == 256);
+}
+
+TEST_CASE("vkb::alias_image_memory keeps overlapping and incompatible images apart", "[render_graph_schedule]")
+{
+	// Lifetimes sharing a single pass overlap
+	REQUIRE(alias_image_memory({create_image(1024, 0, 1), create_image(1024, 1, 2)}).size() == 2);
+
+	std::vector<RenderGraphImageMemory> images = {
+	    create_image(1024, 0, 0),
+	    create_image(1024, 1, 1),
+	    create_image(1024, 2, 2),
+	    create_image(1024, 3, 3)};
+	images[1].memory_type_bits = DEVICE_LOCAL_MEMORY_TYPE;
+	images[2].dedicated        = true;
+	images[3].memory_type_bits = ~DEVICE_LOCAL_MEMORY_TYPE;
+
+	auto memory_blocks = alias_image_memory(images);
+
+	// The dedicated image gets its own block, the other memory types do not intersect
+	REQUIRE(memory_blocks.size() == 3);
+	REQUIRE(memory_blocks[0].images == std::vector<uint32_t>{0, 1});
+	REQUIRE(memory_blocks[0].memory_type_bits == DEVICE_LOCAL_MEMORY_TYPE);
+	REQUIRE(memory_blocks[1].images == std::vector<uint32_t>{2});
+	REQUIRE(memory_blocks[2].images == std::vector<uint32_t>{3});
+	REQUIRE(memory_blocks[2].memory_type_bits == ~DEVICE_LOCAL_MEMORY_TYPE);
+}
+
+TEST_CASE("vkb::track_image_access transitions the layout before the first write", "[render_graph_schedule]")
+{
+	RenderGraphImageState state{};
+
+	auto barrier = track_image_access(state, color_write, WRITE_ACCESS_MASK);
+	REQUIRE(barrier.needed);
+	REQUIRE(barrier.old_layout == LAYOUT_UNDEFINED);
+	REQUIRE(barrier.new_layout == LAYOUT_COLOR_ATTACHMENT);
+	REQUIRE(barrier.src_stages == 0);
+	REQUIRE(barrier.src_access == 0);
+
+	REQUIRE(state.layout == LAYOUT_COLOR_ATTACHMENT);
+	REQUIRE(state.write_stages == STAGE_COLOR_OUTPUT);
+	REQUIRE(state.write_access == ACCESS_COLOR_WRITE);
+
+	// Writing again waits for the first write
+	barrier = track_image_access(state, color_write, WRITE_ACCESS_MASK);
+	REQUIRE(barrier.needed);
+	REQUIRE(barrier.src_stages == STAGE_COLOR_OUTPUT);
+	REQUIRE(barrier.src_access == ACCESS_COLOR_WRITE);
+}
+
+TEST_CASE("vkb::track_image_access makes a write visible to each reader once", "[render_graph_schedule]")
+{
+	RenderGraphImageState state{};
+	track_image_access(state, color_write, WRITE_ACCESS_MASK);
+
+	// The transition to the read layout waits for the write
+	auto barrier = track_image_access(state, fragment_read, WRITE_ACCESS_MASK);
+	REQUIRE(barrier.needed);
+	REQUIRE(barrier.old_layout == LAYOUT_COLOR_ATTACHMENT);
+	REQUIRE(barrier.new_layout == LAYOUT_SHADER_READ_ONLY);
+	REQUIRE(barrier.src_stages == STAGE_COLOR_OUTPUT);
+	REQUIRE(barrier.src_access == ACCESS_COLOR_WRITE);
+
+	// Reads in the same layout need no barrier, the transition already ordered them after the write
+	REQUIRE(!track_image_access(state, fragment_read, WRITE_ACCESS_MASK).needed);
+	REQUIRE(!track_image_access(state, compute_read, WRITE_ACCESS_MASK).needed);
+
+	// Writing waits for all the readers, which have nothing to make available
+	barrier = track_image_access(state, color_write, WRITE_ACCESS_MASK);
+	REQUIRE(barrier.needed);
+	REQUIRE(barrier.src_stages == (STAGE_FRAGMENT_SHADER | STAGE_COMPUTE_SHADER));
+	REQUIRE(barrier.src_access == 0);
+}
+
+TEST_CASE("vkb::track_image_access waits for writes made in the read layout", "[render_graph_schedule]")
+{
+	// A write in the layout the readers use, such as a storage image written and read in the general layout
+	const RenderGraphImageAccess general_write{STAGE_COMPUTE_SHADER, ACCESS_COLOR_WRITE, LAYOUT_SHADER_READ_ONLY, true};
+
+	RenderGraphImageState state{};
+	track_image_access(state, general_write, WRITE_ACCESS_MASK);
+
+	auto barrier = track_image_access(state, fragment_read, WRITE_ACCESS_MASK);
+	REQUIRE(barrier.needed);
+	REQUIRE(barrier.old_layout == barrier.new_layout);
+	REQUIRE(barrier.src_stages == STAGE_COMPUTE_SHADER);
+	REQUIRE(barrier.src_access == ACCESS_COLOR_WRITE);
+
+	// The write is visible to the fragment shader, not to the compute shader
+	REQUIRE(!track_image_access(state, fragment_read, WRITE_ACCESS_MASK).needed);
+	REQUIRE(track_image_access(state, compute_read, WRITE_ACCESS_MASK).needed);
+	REQUIRE(!track_image_access(state, compute_read, WRITE_ACCESS_MASK).needed);
+}
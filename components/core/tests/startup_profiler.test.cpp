@@ -0,0 +1,121 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/startup_profiler.hpp>
+
+using namespace vkb;
+
+TEST_CASE("vkb::StartupProfiler builds a tree of scopes", "[startup_profiler]")
+{
+	auto &profiler = StartupProfiler::get();
+
+	profiler.start("app");
+	{
+		StartupScope create{"Create device"};
+	}
+	{
+		StartupScope prepare{"Prepare"};
+		for (int i = 0; i < 3; ++i)
+		{
+			StartupScope compile{"Compile shader"};
+		}
+	}
+	profiler.stop();
+
+	const auto &root = profiler.get_root();
+	REQUIRE(root.name == "app");
+	REQUIRE(root.count == 1);
+	REQUIRE(root.children.size() == 2);
+
+	REQUIRE(root.children[0].name == "Create device");
+	REQUIRE(root.children[0].children.empty());
+
+	const auto &prepare = root.children[1];
+	REQUIRE(prepare.name == "Prepare");
+	REQUIRE(prepare.children.size() == 1);
+	REQUIRE(prepare.children[0].name == "Compile shader");
+	REQUIRE(prepare.children[0].count == 3);
+
+	REQUIRE(prepare.duration_ms >= prepare.children[0].duration_ms);
+	REQUIRE(root.duration_ms >= prepare.duration_ms);
+
+	REQUIRE(profiler.to_lines().size() == 4);
+}
+
+TEST_CASE("vkb::StartupProfiler only records between start and stop", "[startup_profiler]")
+{
+	auto &profiler = StartupProfiler::get();
+
+	StartupScope before{"Before start"};
+
+	profiler.start("app");
+	{
+		StartupScope scope{"Recorded"};
+	}
+	profiler.stop();
+
+	{
+		StartupScope after{"After stop"};
+	}
+
+	const auto &root = profiler.get_root();
+	REQUIRE(root.children.size() == 1);
+	REQUIRE(root.children[0].name == "Recorded");
+	REQUIRE_FALSE(profiler.is_recording());
+}
+
+TEST_CASE("vkb::StartupProfiler closes open scopes on stop", "[startup_profiler]")
+{
+	auto &profiler = StartupProfiler::get();
+
+	profiler.start("first");
+	auto *open = new StartupScope{"Open"};
+	profiler.stop();
+
+	// A scope of the previous recording must not close the scopes of the next one
+	profiler.start("second");
+	{
+		StartupScope outer{"Outer"};
+		delete open;
+		StartupScope inner{"Inner"};
+	}
+	profiler.stop();
+
+	const auto &root = profiler.get_root();
+	REQUIRE(root.children.size() == 1);
+	REQUIRE(root.children[0].name == "Outer");
+	REQUIRE(root.children[0].children.size() == 1);
+	REQUIRE(root.children[0].children[0].name == "Inner");
+}
+
+TEST_CASE("vkb::StartupProfiler exports JSON", "[startup_profiler]")
+{
+	auto &profiler = StartupProfiler::get();
+
+	profiler.start("app \"quoted\"");
+	{
+		StartupScope scope{"Load scene"};
+	}
+	profiler.stop();
+
+	auto json = profiler.to_json();
+	REQUIRE(json.find("{\"name\":\"app \\\"quoted\\\"\",\"duration_ms\":") == 0);
+	REQUIRE(json.find("\"children\":[{\"name\":\"Load scene\"") != std::string::npos);
+	REQUIRE(json.back() == '}');
+}
@@ -43,4 +43,12 @@ TEST_CASE("vkb::trim_left", "[common]")
 	REQUIRE(trim_left("   hello", " ") == "hello");
 	REQUIRE(trim_left("ignore   hello", " ") == "ignore   hello");
 	REQUIRE(trim_left("complexhello", "complex") == "hello");        // remember we are trimming a set until the first non-match
+}
+
+TEST_CASE("vkb::to_json_string", "[common]")
+{
+	REQUIRE(to_json_string("hello") == "\"hello\"");
+	REQUIRE(to_json_string("say \"hi\"") == "\"say \\\"hi\\\"\"");
+	REQUIRE(to_json_string("C:\\path\n") == "\"C:\\\\path\\n\"");
+	REQUIRE(to_json_string("\t") == "\"\\u0009\"");
 }
\ No newline at end of file
@@ -0,0 +1,534 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+
+#include <core/util/terrain.hpp>
+
+using namespace vkb;
+
+namespace
+{
+struct TestHeightMap
+{
+	std::vector<uint16_t> texels;
+	uint32_t              width;
+	uint32_t              height;
+
+	HeightMapView get_view() const
+	{
+		return {texels.data(), width, height};
+	}
+};
+
+TestHeightMap create_height_map(uint32_t width, uint32_t height, uint32_t seed = 7)
+{
+	TestHeightMap map{std::vector<uint16_t>(static_cast<size_t>(width) * height), width, height};
+
+	std::mt19937                            generator{seed};
+	std::uniform_int_distribution<uint32_t> distribution{0, 65535};
+	for (auto &texel : map.texels)
+	{
+		texel = static_cast<uint16_t>(distribution(generator));
+	}
+	return map;
+}
+
+// Smooth hills, as a terrain seen from the ground
+TestHeightMap create_hills(uint32_t width, uint32_t height)
+{
+	TestHeightMap map{std::vector<uint16_t>(static_cast<size_t>(width) * height), width, height};
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			float value = 0.5f + 0.25f * std::sin(x * 0.01f) * std::cos(y * 0.013f) + 0.15f * std::sin(x * 0.037f + y * 0.029f);
+
+			map.texels[x + y * width] = static_cast<uint16_t>(value * 65535.0f);
+		}
+	}
+	return map;
+}
+
+// The lookups of the height map the samples used before, one at a time
+int32_t resolve(int32_t coordinate, int32_t count, HeightMapAddressMode address_mode)
+{
+	if (address_mode == HeightMapAddressMode::ClampToEdge)
+	{
+		return std::clamp(coordinate, 0, count - 1);
+	}
+	int32_t mirrored = ((coordinate % (2 * count)) + 2 * count) % (2 * count);
+	return mirrored < count ? mirrored : 2 * count - 1 - mirrored;
+}
+
+float get_height(const TestHeightMap &map, int32_t x, int32_t y, uint32_t stride, HeightMapAddressMode address_mode)
+{
+	int32_t column = resolve(x, static_cast<int32_t>((map.width - 1) / stride + 1), address_mode) * stride;
+	int32_t row    = resolve(y, static_cast<int32_t>((map.height - 1) / stride + 1), address_mode) * stride;
+	return map.texels[column + row * map.width] / 65535.0f;
+}
+
+// The filter of terrain_tessellation, heights[x][y] being at offset (x - 1, y - 1)
+void get_sobel_normal(const float heights[3][3], float *normal)
+{
+	float x = heights[0][0] - heights[2][0] + 2.0f * heights[0][1] - 2.0f * heights[2][1] + heights[0][2] - heights[2][2];
+	float z = heights[0][0] + 2.0f * heights[1][0] + heights[2][0] - heights[0][2] - 2.0f * heights[1][2] - heights[2][2];
+	float y = 0.25f * std::sqrt(1.0f - x * x - z * z);
+
+	float length = std::sqrt(4.0f * x * x + y * y + 4.0f * z * z);
+	normal[0]    = 2.0f * x / length;
+	normal[1]    = y / length;
+	normal[2]    = 2.0f * z / length;
+}
+
+const float NO_PLANES[6][4] = {{0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}};
+
+// Whether the segment from the eye to a point goes under the lowest height of one of the patches it flies over
+bool is_occluded(const std::vector<float> &ranges, uint32_t count_x, uint32_t count_y, uint32_t target, const float *eye, const float *point)
+{
+	for (uint32_t patch = 0; patch < count_x * count_y; ++patch)
+	{
+		if (patch == target)
+		{
+			continue;
+		}
+
+		float min_x = static_cast<float>(patch % count_x), max_x = min_x + 1.0f;
+		float min_z = static_cast<float>(patch / count_x), max_z = min_z + 1.0f;
+
+		// Part of the segment over the patch
+		float enter = 0.0f, leave = 1.0f;
+		for (uint32_t axis : {0u, 2u})
+		{
+			float start = eye[axis], delta = point[axis] - eye[axis];
+			float low = axis == 0 ? min_x : min_z, high = axis == 0 ? max_x : max_z;
+			if (std::abs(delta) < 1e-9f)
+			{
+				if (start < low || start > high)
+				{
+					enter = 1.0f;
+					leave = 0.0f;
+				}
+				continue;
+			}
+			float t0 = (low - start) / delta, t1 = (high - start) / delta;
+			enter    = std::max(enter, std::min(t0, t1));
+			leave    = std::min(leave, std::max(t0, t1));
+		}
+		if (enter > leave)
+		{
+			continue;
+		}
+
+		float altitude = std::min(eye[1] + enter * (point[1] - eye[1]), eye[1] + leave * (point[1] - eye[1]));
+		if (altitude < ranges[2 * patch])
+		{
+			return true;
+		}
+	}
+	return false;
+}
+}        // namespace
+
+TEST_CASE("vkb::sample_heights", "[terrain]")
+{
+	auto map = create_height_map(67, 45);
+
+	for (auto address_mode : {HeightMapAddressMode::ClampToEdge, HeightMapAddressMode::MirroredRepeat})
+	{
+		for (uint32_t stride : {1u, 3u, 16u})
+		{
+			// Out of the map on every side
+			const int32_t  x = -70, y = -50;
+			const uint32_t count_x = 210, count_y = 150;
+
+			std::vector<float> heights(count_x * count_y);
+			sample_heights(map.get_view(), x, y, count_x, count_y, stride, address_mode, heights.data());
+
+			for (uint32_t j = 0; j < count_y; ++j)
+			{
+				for (uint32_t i = 0; i < count_x; ++i)
+				{
+					REQUIRE(std::abs(heights[i + j * count_x] - get_height(map, x + i, y + j, stride, address_mode)) <= 1e-6f);
+				}
+			}
+		}
+	}
+
+	// Contiguous rows inside the map
+	std::vector<float> heights(60 * 40);
+	sample_heights(map.get_view(), 3, 2, 60, 40, 1, HeightMapAddressMode::ClampToEdge, heights.data());
+	for (uint32_t j = 0; j < 40; ++j)
+	{
+		for (uint32_t i = 0; i < 60; ++i)
+		{
+			REQUIRE(std::abs(heights[i + j * 60] - map.texels[3 + i + (2 + j) * map.width] / 65535.0f) <= 1e-6f);
+		}
+	}
+}
+
+TEST_CASE("vkb::compute_sobel_normals", "[terrain]")
+{
+	// Heights of a real terrain are close to each other, a random map would make the filter saturate
+	const uint32_t count_x = 37, count_y = 11;
+
+	std::mt19937                          generator{3};
+	std::uniform_real_distribution<float> distribution{0.4f, 0.5f};
+
+	std::vector<float> heights((count_x + 2) * (count_y + 2));
+	for (auto &height : heights)
+	{
+		height = distribution(generator);
+	}
+
+	// Normals interleaved with other vertex attributes
+	const size_t       stride = 8;
+	std::vector<float> normals(count_x * count_y * stride);
+	compute_sobel_normals(heights.data(), count_x, count_y, normals.data(), stride * sizeof(float));
+
+	for (uint32_t j = 0; j < count_y; ++j)
+	{
+		for (uint32_t i = 0; i < count_x; ++i)
+		{
+			float neighbours[3][3];
+			for (uint32_t dx = 0; dx < 3; ++dx)
+			{
+				for (uint32_t dy = 0; dy < 3; ++dy)
+				{
+					neighbours[dx][dy] = heights[(i + dx) + (j + dy) * (count_x + 2)];
+				}
+			}
+
+			float expected[3];
+			get_sobel_normal(neighbours, expected);
+
+			const float *normal = &normals[(i + j * count_x) * stride];
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				REQUIRE(std::abs(normal[c] - expected[c]) <= 1e-5f);
+			}
+		}
+	}
+
+	// A flat terrain faces up, and a steep one stays finite
+	std::vector<float> flat(5 * 5, 0.5f);
+	float              up[3 * 9];
+	compute_sobel_normals(flat.data(), 3, 3, up, 3 * sizeof(float));
+	REQUIRE(up[0] == 0.0f);
+	REQUIRE(up[1] == 1.0f);
+	REQUIRE(up[2] == 0.0f);
+
+	std::vector<float> cliff(5 * 5, 0.0f);
+	for (uint32_t j = 0; j < 5; ++j)
+	{
+		cliff[4 + j * 5] = 1.0f;
+	}
+	float steep[3 * 9];
+	compute_sobel_normals(cliff.data(), 3, 3, steep, 3 * sizeof(float));
+	for (float component : steep)
+	{
+		REQUIRE(std::isfinite(component));
+	}
+}
+
+TEST_CASE("vkb::get_height_range", "[terrain]")
+{
+	auto map = create_height_map(50, 30, 11);
+
+	std::mt19937 generator{5};
+	for (auto address_mode : {HeightMapAddressMode::ClampToEdge, HeightMapAddressMode::MirroredRepeat})
+	{
+		for (uint32_t test = 0; test < 200; ++test)
+		{
+			int32_t  x      = std::uniform_int_distribution<int32_t>{-120, 120}(generator);
+			int32_t  y      = std::uniform_int_distribution<int32_t>{-80, 80}(generator);
+			uint32_t width  = std::uniform_int_distribution<uint32_t>{1, test < 100 ? 20u : 130u}(generator);
+			uint32_t height = std::uniform_int_distribution<uint32_t>{1, test < 100 ? 20u : 70u}(generator);
+
+			float expected_min = 1.0f, expected_max = 0.0f;
+			for (uint32_t j = 0; j < height; ++j)
+			{
+				for (uint32_t i = 0; i < width; ++i)
+				{
+					float value  = get_height(map, x + i, y + j, 1, address_mode);
+					expected_min = std::min(expected_min, value);
+					expected_max = std::max(expected_max, value);
+				}
+			}
+
+			float min_height, max_height;
+			get_height_range(map.get_view(), x, y, width, height, address_mode, min_height, max_height);
+			REQUIRE(std::abs(min_height - expected_min) <= 1e-6f);
+			REQUIRE(std::abs(max_height - expected_max) <= 1e-6f);
+		}
+	}
+}
+
+TEST_CASE("vkb::TerrainQuadtree bounds", "[terrain]")
+{
+	const uint32_t     count_x = 13, count_y = 6;
+	std::vector<float> ranges(count_x * count_y * 2);
+	for (uint32_t patch = 0; patch < count_x * count_y; ++patch)
+	{
+		ranges[2 * patch]     = 0.01f * patch;
+		ranges[2 * patch + 1] = 0.01f * patch + 0.1f;
+	}
+
+	TerrainQuadtree quadtree{ranges.data(), count_x, count_y};
+	REQUIRE(quadtree.get_patch_count() == count_x * count_y);
+
+	auto &nodes = quadtree.get_nodes();
+	REQUIRE(nodes[0].width == count_x);
+	REQUIRE(nodes[0].height == count_y);
+
+	std::set<uint32_t> leaves;
+	for (auto &node : nodes)
+	{
+		// Each node bounds the patches under it exactly
+		float min_height = 1e9f, max_height = -1e9f;
+		for (uint32_t y = node.y; y < node.y + node.height; ++y)
+		{
+			for (uint32_t x = node.x; x < node.x + node.width; ++x)
+			{
+				min_height = std::min(min_height, ranges[2 * (x + y * count_x)]);
+				max_height = std::max(max_height, ranges[2 * (x + y * count_x) + 1]);
+			}
+		}
+		REQUIRE(node.min_height == min_height);
+		REQUIRE(node.max_height == max_height);
+
+		if (node.child_count == 0)
+		{
+			REQUIRE(node.width * node.height == 1);
+			REQUIRE(leaves.insert(node.x + node.y * count_x).second);
+			continue;
+		}
+
+		uint32_t area = 0;
+		for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+		{
+			area += nodes[child].width * nodes[child].height;
+		}
+		REQUIRE(area == node.width * node.height);
+	}
+	REQUIRE(leaves.size() == count_x * count_y);
+}
+
+TEST_CASE("vkb::TerrainQuadtree frustum culling", "[terrain]")
+{
+	const uint32_t     count = 16;
+	std::vector<float> ranges(count * count * 2, 0.0f);
+	TerrainQuadtree    quadtree{ranges.data(), count, count};
+
+	TerrainLayout layout{-8.0f, -8.0f, 1.0f, 1.0f};
+	const float   eye[3] = {0.0f, 1.0f, 0.0f};
+
+	std::vector<uint32_t> visible;
+	quadtree.cull(layout, NO_PLANES, eye, false, visible);
+	REQUIRE(visible.size() == count * count);
+
+	// Only x >= 2.5 and z <= -3.5, from patch 10 along x and up to patch 4 along z
+	float planes[6][4] = {{1, 0, 0, -2.5f}, {0, 0, -1, -3.5f}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}};
+	visible.clear();
+	quadtree.cull(layout, planes, eye, false, visible);
+
+	std::set<uint32_t> expected;
+	for (uint32_t y = 0; y <= 4; ++y)
+	{
+		for (uint32_t x = 10; x < count; ++x)
+		{
+			expected.insert(x + y * count);
+		}
+	}
+	REQUIRE(std::set<uint32_t>(visible.begin(), visible.end()) == expected);
+}
+
+TEST_CASE("vkb::TerrainQuadtree horizon culling", "[terrain]")
+{
+	// A valley with a ridge across it, seen from the bottom of the valley
+	const uint32_t     count = 32;
+	std::vector<float> ranges(count * count * 2);
+	for (uint32_t y = 0; y < count; ++y)
+	{
+		for (uint32_t x = 0; x < count; ++x)
+		{
+			float height                    = y == 8 ? 0.9f : 0.1f;
+			ranges[2 * (x + y * count)]     = height - 0.05f;
+			ranges[2 * (x + y * count) + 1] = height + 0.05f;
+		}
+	}
+
+	TerrainQuadtree quadtree{ranges.data(), count, count};
+	TerrainLayout   layout{0.0f, 0.0f, 1.0f, 1.0f};
+
+	const float eye[3] = {16.5f, 0.2f, 2.5f};
+
+	std::vector<uint32_t> visible;
+	quadtree.cull(layout, NO_PLANES, eye, true, visible);
+
+	std::set<uint32_t> visible_set(visible.begin(), visible.end());
+	REQUIRE(visible_set.size() == visible.size());
+
+	// Everything up to the ridge is seen, right behind it is hidden
+	for (uint32_t y = 0; y <= 8; ++y)
+	{
+		for (uint32_t x = 0; x < count; ++x)
+		{
+			REQUIRE(visible_set.count(x + y * count) == 1);
+		}
+	}
+	for (uint32_t y = 10; y < count; ++y)
+	{
+		for (uint32_t x = 12; x < 21; ++x)
+		{
+			REQUIRE(visible_set.count(x + y * count) == 0);
+		}
+	}
+
+	// The same terrain rising along -y, as terrain_tessellation displaces it
+	layout.height_scale = -1.0f;
+
+	const float           flipped_eye[3] = {eye[0], -eye[1], eye[2]};
+	std::vector<uint32_t> flipped;
+	quadtree.cull(layout, NO_PLANES, flipped_eye, true, flipped);
+	REQUIRE(std::set<uint32_t>(flipped.begin(), flipped.end()) == visible_set);
+}
+
+TEST_CASE("vkb::TerrainQuadtree horizon culling is conservative", "[terrain]")
+{
+	// Rolling hills with some noise
+	const uint32_t     count = 24;
+	std::vector<float> ranges(count * count * 2);
+	std::mt19937       generator{13};
+	for (uint32_t y = 0; y < count; ++y)
+	{
+		for (uint32_t x = 0; x < count; ++x)
+		{
+			float height                    = 2.0f + std::sin(x * 0.7f) * std::cos(y * 0.5f) + std::uniform_real_distribution<float>{0.0f, 0.3f}(generator);
+			ranges[2 * (x + y * count)]     = height - 0.2f;
+			ranges[2 * (x + y * count) + 1] = height + 0.2f;
+		}
+	}
+
+	TerrainQuadtree quadtree{ranges.data(), count, count};
+	TerrainLayout   layout;
+
+	size_t culled_total = 0;
+	for (const float eye : {2.0f, 2.5f, 3.5f})
+	{
+		for (uint32_t position = 0; position < 8; ++position)
+		{
+			const float eye_position[3] = {1.3f + position * 2.9f, eye, 0.7f + position * 2.7f};
+
+			std::vector<uint32_t> visible;
+			quadtree.cull(layout, NO_PLANES, eye_position, true, visible);
+			std::set<uint32_t> visible_set(visible.begin(), visible.end());
+
+			for (uint32_t patch = 0; patch < count * count; ++patch)
+			{
+				if (visible_set.count(patch))
+				{
+					continue;
+				}
+				++culled_total;
+
+				// Every point of the highest surface of a culled patch is hidden
+				for (float u : {0.0f, 0.5f, 1.0f})
+				{
+					for (float v : {0.0f, 0.5f, 1.0f})
+					{
+						const float point[3] = {(patch % count) + u, ranges[2 * patch + 1], (patch / count) + v};
+						REQUIRE(is_occluded(ranges, count, count, patch, eye_position, point));
+					}
+				}
+			}
+		}
+	}
+
+	// And there is something to cull
+	REQUIRE(culled_total > 0);
+}
+
+TEST_CASE("vkb::terrain generation benchmark", "[terrain][.benchmark]")
+{
+	// A 4096 x 4096 map, sampled as a 1024 x 1024 grid
+	auto           map   = create_hills(4096, 4096);
+	const uint32_t count = 1024, stride = 4;
+
+	BENCHMARK("get_height and Sobel filter, one vertex at a time")
+	{
+		std::vector<float> normals(count * count * 3);
+		for (uint32_t y = 0; y < count; ++y)
+		{
+			for (uint32_t x = 0; x < count; ++x)
+			{
+				float heights[3][3];
+				for (int32_t dx = -1; dx <= 1; ++dx)
+				{
+					for (int32_t dy = -1; dy <= 1; ++dy)
+					{
+						heights[dx + 1][dy + 1] = get_height(map, x + dx, y + dy, stride, HeightMapAddressMode::ClampToEdge) * 0.01f;
+					}
+				}
+				get_sobel_normal(heights, &normals[(x + y * count) * 3]);
+			}
+		}
+		return normals[0];
+	};
+
+	BENCHMARK("sample_heights and compute_sobel_normals")
+	{
+		std::vector<float> heights((count + 2) * (count + 2));
+		std::vector<float> normals(count * count * 3);
+		sample_heights(map.get_view(), -1, -1, count + 2, count + 2, stride, HeightMapAddressMode::ClampToEdge, heights.data());
+		compute_sobel_normals(heights.data(), count, count, normals.data(), 3 * sizeof(float));
+		return normals[0];
+	};
+
+	// Patches of 16 x 16 texels, seen from a low viewer in the middle of the terrain
+	const uint32_t     patch_count = 4096 / 16;
+	std::vector<float> ranges(patch_count * patch_count * 2);
+	for (uint32_t y = 0; y < patch_count; ++y)
+	{
+		for (uint32_t x = 0; x < patch_count; ++x)
+		{
+			get_height_range(map.get_view(), x * 16, y * 16, 17, 17, HeightMapAddressMode::ClampToEdge, ranges[2 * (x + y * patch_count)], ranges[2 * (x + y * patch_count) + 1]);
+		}
+	}
+
+	TerrainQuadtree quadtree{ranges.data(), patch_count, patch_count};
+	TerrainLayout   layout{0.0f, 0.0f, 1.0f, 16.0f};
+
+	const float eye[3] = {patch_count * 0.5f, 10.0f, patch_count * 0.5f};
+
+	std::vector<uint32_t> visible;
+	quadtree.cull(layout, NO_PLANES, eye, true, visible);
+	WARN("Patches drawn with horizon culling: " << visible.size() << " of " << quadtree.get_patch_count());
+
+	BENCHMARK("TerrainQuadtree::cull")
+	{
+		visible.clear();
+		quadtree.cull(layout, NO_PLANES, eye, true, visible);
+		return visible.size();
+	};
+}
@@ -0,0 +1,95 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace vkb
+{
+namespace tests
+{
+struct TestMesh
+{
+	std::vector<float>    positions;
+	std::vector<uint32_t> indices;
+
+	size_t get_vertex_count() const
+	{
+		return positions.size() / 3;
+	}
+};
+
+// A grid of quads on a sphere, facing outwards
+inline void add_sphere(TestMesh &mesh, float radius, uint32_t rings, uint32_t segments)
+{
+	const float pi = 3.14159265358979f;
+
+	uint32_t first_vertex = static_cast<uint32_t>(mesh.get_vertex_count());
+	for (uint32_t r = 0; r <= rings; ++r)
+	{
+		float theta = pi * r / rings;
+		for (uint32_t s = 0; s <= segments; ++s)
+		{
+			float phi = 2.0f * pi * s / segments;
+			mesh.positions.insert(mesh.positions.end(), {radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi)});
+		}
+	}
+
+	for (uint32_t r = 0; r < rings; ++r)
+	{
+		for (uint32_t s = 0; s < segments; ++s)
+		{
+			uint32_t a = first_vertex + r * (segments + 1) + s;
+			uint32_t b = a + segments + 1;
+			mesh.indices.insert(mesh.indices.end(), {a, a + 1, b, a + 1, b + 1, b});
+		}
+	}
+}
+
+inline void shuffle_triangles(TestMesh &mesh, uint32_t seed = 7)
+{
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (size_t i = 0; i < mesh.indices.size(); i += 3)
+	{
+		triangles.push_back({mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]});
+	}
+
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937{seed});
+
+	mesh.indices.clear();
+	for (auto &triangle : triangles)
+	{
+		mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+	}
+}
+
+// A unit sphere with its triangles shuffled
+inline TestMesh create_sphere(uint32_t rings, uint32_t segments, uint32_t seed = 7)
+{
+	TestMesh mesh;
+	add_sphere(mesh, 1.0f, rings, segments);
+	shuffle_triangles(mesh, seed);
+	return mesh;
+}
+}        // namespace tests
+}        // namespace vkb
@@ -0,0 +1,252 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <set>
+
+#include <core/util/virtual_texture_pages.hpp>
+
+using namespace vkb;
+
+namespace
+{
+// 1000x600 texels with 128x128 pages: 8x5 pages in level 0, 4x3 in level 1, 2x2 in level 2, levels 3 and 4 are the mip tail
+VirtualTexturePageTable create_page_table(uint32_t slot_capacity = 16, uint32_t frames_in_flight = 2)
+{
+	return VirtualTexturePageTable{1000, 600, 5, 3, 128, 128, slot_capacity, frames_in_flight};
+}
+
+constexpr uint32_t LEVEL_1_FIRST_PAGE = 40;
+constexpr uint32_t LEVEL_2_FIRST_PAGE = 52;
+constexpr uint32_t PAGE_COUNT         = 56;
+
+std::vector<uint32_t> get_pages(uint32_t first, uint32_t count)
+{
+	std::vector<uint32_t> pages;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		pages.push_back(first + i);
+	}
+	return pages;
+}
+
+bool is_unique(const std::vector<uint32_t> &pages)
+{
+	return std::set<uint32_t>(pages.begin(), pages.end()).size() == pages.size();
+}
+}        // namespace
+
+TEST_CASE("vkb::VirtualTexturePageTable lays out the pages of the streamed levels", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table();
+
+	const auto &levels = page_table.get_levels();
+	REQUIRE(levels.size() == 3);
+
+	REQUIRE(levels[0].width == 1000);
+	REQUIRE(levels[0].height == 600);
+	REQUIRE(levels[0].columns == 8);
+	REQUIRE(levels[0].rows == 5);
+	REQUIRE(levels[0].first_page == 0);
+
+	REQUIRE(levels[1].width == 500);
+	REQUIRE(levels[1].height == 300);
+	REQUIRE(levels[1].columns == 4);
+	REQUIRE(levels[1].rows == 3);
+	REQUIRE(levels[1].first_page == LEVEL_1_FIRST_PAGE);
+
+	REQUIRE(levels[2].width == 250);
+	REQUIRE(levels[2].height == 150);
+	REQUIRE(levels[2].columns == 2);
+	REQUIRE(levels[2].rows == 2);
+	REQUIRE(levels[2].first_page == LEVEL_2_FIRST_PAGE);
+
+	REQUIRE(page_table.get_page_count() == PAGE_COUNT);
+
+	REQUIRE(page_table.get_level(0) == 0);
+	REQUIRE(page_table.get_level(LEVEL_1_FIRST_PAGE - 1) == 0);
+	REQUIRE(page_table.get_level(LEVEL_1_FIRST_PAGE) == 1);
+	REQUIRE(page_table.get_level(LEVEL_2_FIRST_PAGE - 1) == 1);
+	REQUIRE(page_table.get_level(LEVEL_2_FIRST_PAGE) == 2);
+	REQUIRE(page_table.get_level(PAGE_COUNT - 1) == 2);
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable streams no more levels than the texture has", "[virtual_texture_pages]")
+{
+	VirtualTexturePageTable page_table{1, 1, 1, 4, 128, 128, 16, 2};
+
+	REQUIRE(page_table.get_levels().size() == 1);
+	REQUIRE(page_table.get_page_count() == 1);
+	REQUIRE(page_table.select_pages({}) == std::vector<uint32_t>{0});
+
+	VirtualTexturePageTable tail_only{256, 256, 9, 0, 128, 128, 16, 2};
+
+	REQUIRE(tail_only.get_page_count() == 0);
+	REQUIRE(tail_only.select_pages({{0.0f, 0.0f, 1.0f, 1.0f, 0.0f}}).empty());
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable always selects the coarsest streamed level", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table();
+
+	REQUIRE(page_table.select_pages({}) == get_pages(LEVEL_2_FIRST_PAGE, 4));
+
+	// Levels of the mip tail select nothing more
+	REQUIRE(page_table.select_pages({{0.0f, 0.0f, 1.0f, 1.0f, 4.0f}}) == get_pages(LEVEL_2_FIRST_PAGE, 4));
+	REQUIRE(page_table.select_pages({{0.0f, 0.0f, 1.0f, 1.0f, 2.5f}}) == get_pages(LEVEL_2_FIRST_PAGE, 4));
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable selects coarser levels first", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table();
+
+	// Trilinear filtering samples levels 0 and 1
+	auto selection = page_table.select_pages({{0.0f, 0.0f, 1.0f, 1.0f, 0.5f}});
+	REQUIRE(selection.size() == PAGE_COUNT);
+	REQUIRE(is_unique(selection));
+
+	for (size_t i = 1; i < selection.size(); ++i)
+	{
+		REQUIRE(page_table.get_level(selection[i - 1]) >= page_table.get_level(selection[i]));
+	}
+
+	// A whole level of detail selects a single level
+	selection = page_table.select_pages({{0.0f, 0.0f, 1.0f, 1.0f, 1.0f}});
+	REQUIRE(selection.size() == 4 + 12);
+	REQUIRE(page_table.get_level(selection.back()) == 1);
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable selects the pages covered by a request", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table();
+
+	// Columns 0 and 1 of row 0 in level 0
+	auto                  selection = page_table.select_pages({{0.0f, 0.0f, 0.25f, 0.2f, 0.0f}});
+	std::vector<uint32_t> expected  = {52, 53, 54, 55, 0, 1};
+	REQUIRE(selection == expected);
+
+	// Overlapping requests do not select a page twice
+	selection = page_table.select_pages({{0.0f, 0.0f, 0.25f, 0.2f, 0.0f}, {0.1f, 0.0f, 0.3f, 0.1f, 0.0f}});
+	expected  = {52, 53, 54, 55, 0, 1, 2};
+	REQUIRE(selection == expected);
+
+	// A region on the edge of the texture selects the last page
+	selection = page_table.select_pages({{1.0f, 1.0f, 1.0f, 1.0f, 0.0f}});
+	expected  = {52, 53, 54, 55, LEVEL_1_FIRST_PAGE - 1};
+	REQUIRE(selection == expected);
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable clamps requests to the texture", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table();
+
+	auto reference = page_table.select_pages({{0.0f, 0.0f, 1.0f, 1.0f, 0.0f}});
+	REQUIRE(reference.size() == 4 + 40);
+
+	// Swapped and out of range coordinates, negative level of detail
+	REQUIRE(page_table.select_pages({{1.5f, 2.0f, -1.0f, -0.5f, -3.0f}}) == reference);
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable adds slots up to its capacity", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table(3);
+
+	REQUIRE(page_table.needs_slots());
+	REQUIRE(page_table.add_slots(2) == 2);
+	REQUIRE(!page_table.needs_slots());
+
+	page_table.begin_frame();
+
+	int64_t evicted_page = 0;
+	REQUIRE(page_table.make_resident(10, evicted_page) == 0);
+	REQUIRE(evicted_page == -1);
+	REQUIRE(page_table.make_resident(20, evicted_page) == 1);
+	REQUIRE(evicted_page == -1);
+
+	REQUIRE(page_table.needs_slots());
+	REQUIRE(page_table.add_slots(64) == 1);
+	REQUIRE(page_table.get_slot_count() == 3);
+	REQUIRE(page_table.get_slot_capacity() == 3);
+
+	REQUIRE(page_table.make_resident(30, evicted_page) == 2);
+	REQUIRE(!page_table.needs_slots());
+
+	REQUIRE(page_table.get_slot(10) == 0);
+	REQUIRE(page_table.get_slot(20) == 1);
+	REQUIRE(page_table.get_slot(30) == 2);
+	REQUIRE(page_table.get_slot(40) == -1);
+	REQUIRE(page_table.get_resident_page_count() == 3);
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable evicts the least recently used page", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table(3, 1);
+	page_table.add_slots(3);
+
+	int64_t evicted_page = -1;
+
+	page_table.begin_frame();
+	page_table.make_resident(10, evicted_page);
+	page_table.make_resident(20, evicted_page);
+	page_table.make_resident(30, evicted_page);
+
+	page_table.begin_frame();
+	page_table.touch(10);
+
+	REQUIRE(page_table.make_resident(40, evicted_page) == 1);
+	REQUIRE(evicted_page == 20);
+	REQUIRE(page_table.get_slot(20) == -1);
+	REQUIRE(page_table.get_slot(40) == 1);
+
+	REQUIRE(page_table.make_resident(50, evicted_page) == 2);
+	REQUIRE(evicted_page == 30);
+
+	// Page 10 was used by the current frame, like the pages made resident during it
+	REQUIRE(page_table.make_resident(55, evicted_page) == -1);
+	REQUIRE(evicted_page == -1);
+	REQUIRE(page_table.get_resident_page_count() == 3);
+
+	page_table.begin_frame();
+	REQUIRE(page_table.make_resident(55, evicted_page) == 0);
+	REQUIRE(evicted_page == 10);
+}
+
+TEST_CASE("vkb::VirtualTexturePageTable keeps the pages frames in flight may sample", "[virtual_texture_pages]")
+{
+	auto page_table = create_page_table(2, 3);
+	page_table.add_slots(2);
+
+	int64_t evicted_page = -1;
+
+	page_table.begin_frame();
+	page_table.make_resident(10, evicted_page);
+	page_table.make_resident(20, evicted_page);
+
+	// Frames 1 and 2 may still be in flight during frames 2 and 3
+	for (uint32_t frame = 2; frame <= 3; ++frame)
+	{
+		page_table.begin_frame();
+		REQUIRE(page_table.make_resident(30, evicted_page) == -1);
+		REQUIRE(page_table.get_slot(10) == 0);
+		REQUIRE(page_table.get_slot(20) == 1);
+	}
+
+	page_table.begin_frame();
+	REQUIRE(page_table.make_resident(30, evicted_page) == 0);
+	REQUIRE(evicted_page == 10);
+}
@@ -0,0 +1,198 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <core/util/zone_profiler.hpp>
+
+using namespace vkb;
+
+namespace
+{
+const ZoneProfiler::Zone *find_zone(const ZoneProfiler::Capture &capture, const char *name, const ZoneProfiler::ThreadZones **thread = nullptr)
+{
+	for (auto &thread_zones : capture.threads)
+	{
+		for (auto &zone : thread_zones.zones)
+		{
+			if (zone.name && std::strcmp(zone.name, name) == 0)
+			{
+				if (thread)
+				{
+					*thread = &thread_zones;
+				}
+				return &zone;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void sleep_briefly()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+}        // namespace
+
+TEST_CASE("vkb::ZoneProfiler records nested zones within the captured frames", "[zone_profiler]")
+{
+	auto &profiler = ZoneProfiler::get();
+	profiler.set_enabled(true);
+
+	profiler.mark_frame();
+	{
+		ZoneScope outer{"nested outer"};
+		sleep_briefly();
+		{
+			ZoneScope inner{"nested inner"};
+			sleep_briefly();
+		}
+	}
+	profiler.mark_frame();
+
+	auto capture = profiler.capture(1);
+	profiler.set_enabled(false);
+
+	REQUIRE(capture.frame_times_ns.size() == 2);
+
+	auto *outer = find_zone(capture, "nested outer");
+	auto *inner = find_zone(capture, "nested inner");
+	REQUIRE(outer != nullptr);
+	REQUIRE(inner != nullptr);
+
+	REQUIRE(outer->depth == 0);
+	REQUIRE(inner->depth == 1);
+	REQUIRE(outer->begin_ns <= inner->begin_ns);
+	REQUIRE(inner->end_ns <= outer->end_ns);
+	REQUIRE(capture.frame_times_ns.front() <= outer->begin_ns);
+	REQUIRE(outer->end_ns <= capture.frame_times_ns.back());
+}
+
+TEST_CASE("vkb::ZoneProfiler only captures the requested frames", "[zone_profiler]")
+{
+	auto &profiler = ZoneProfiler::get();
+	profiler.set_enabled(true);
+
+	profiler.mark_frame();
+	{
+		ZoneScope zone{"older frame"};
+		sleep_briefly();
+	}
+	profiler.mark_frame();
+	sleep_briefly();
+	{
+		ZoneScope zone{"last frame"};
+		sleep_briefly();
+	}
+	profiler.mark_frame();
+
+	auto last_capture = profiler.capture(1);
+	auto both_capture = profiler.capture(2);
+	profiler.set_enabled(false);
+
+	REQUIRE(find_zone(last_capture, "older frame") == nullptr);
+	REQUIRE(find_zone(last_capture, "last frame") != nullptr);
+
+	REQUIRE(both_capture.frame_times_ns.size() == 3);
+	REQUIRE(find_zone(both_capture, "older frame") != nullptr);
+	REQUIRE(find_zone(both_capture, "last frame") != nullptr);
+}
+
+TEST_CASE("vkb::ZoneProfiler records nothing while disabled", "[zone_profiler]")
+{
+	auto &profiler = ZoneProfiler::get();
+	profiler.set_enabled(true);
+	profiler.mark_frame();
+
+	profiler.set_enabled(false);
+	{
+		ZoneScope zone{"disabled zone"};
+		sleep_briefly();
+	}
+
+	profiler.set_enabled(true);
+	profiler.mark_frame();
+
+	auto capture = profiler.capture(1);
+	profiler.set_enabled(false);
+
+	REQUIRE(find_zone(capture, "disabled zone") == nullptr);
+}
+
+TEST_CASE("vkb::ZoneProfiler records the zones of each thread", "[zone_profiler]")
+{
+	auto &profiler = ZoneProfiler::get();
+	profiler.set_enabled(true);
+	profiler.mark_frame();
+
+	std::thread thread{[&profiler]() {
+		profiler.set_thread_name("Test thread");
+		ZoneScope zone{"thread zone"};
+		sleep_briefly();
+	}};
+	thread.join();
+
+	profiler.mark_frame();
+
+	auto capture = profiler.capture(1);
+	profiler.set_enabled(false);
+
+	const ZoneProfiler::ThreadZones *thread_zones = nullptr;
+	REQUIRE(find_zone(capture, "thread zone", &thread_zones) != nullptr);
+	REQUIRE(thread_zones->thread_name == "Test thread");
+}
+
+TEST_CASE("vkb::ZoneProfiler records zones measured elsewhere into tracks", "[zone_profiler]")
+{
+	auto &profiler = ZoneProfiler::get();
+	profiler.set_enabled(true);
+	profiler.mark_frame();
+
+	auto begin_ns = ZoneProfiler::now_ns();
+	sleep_briefly();
+	profiler.record_zone("Test track", "track zone", begin_ns, ZoneProfiler::now_ns(), 0);
+
+	profiler.mark_frame();
+
+	auto capture = profiler.capture(1);
+	profiler.set_enabled(false);
+
+	const ZoneProfiler::ThreadZones *thread_zones = nullptr;
+	auto                            *zone         = find_zone(capture, "track zone", &thread_zones);
+	REQUIRE(zone != nullptr);
+	REQUIRE(zone->begin_ns == begin_ns);
+	REQUIRE(thread_zones->thread_name == "Test track");
+}
+
+TEST_CASE("vkb::ZoneProfiler writes captures as Chrome traces", "[zone_profiler]")
+{
+	ZoneProfiler::Capture capture;
+	capture.frame_times_ns = {1000, 3000};
+	capture.threads.push_back({"Main \"thread\"", 2, {{"Zone", 1500, 2500, 0}}});
+
+	auto trace = ZoneProfiler::to_chrome_trace(capture);
+
+	REQUIRE(trace.find("\"traceEvents\":[") != std::string::npos);
+	REQUIRE(trace.find("{\"name\":\"Frame 0\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":0.000}") != std::string::npos);
+	REQUIRE(trace.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":2,\"args\":{\"name\":\"Main \\\"thread\\\"\"}}") != std::string::npos);
+	REQUIRE(trace.find("{\"name\":\"Zone\",\"ph\":\"X\",\"pid\":0,\"tid\":2,\"ts\":0.500,\"dur\":1.000}") != std::string::npos);
+	REQUIRE(trace.back() == '}');
+}
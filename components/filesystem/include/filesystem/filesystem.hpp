@@ -18,6 +18,8 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,8 +40,36 @@ struct FileStat
 
 using Path = std::filesystem::path;
 
+// A read-only view of a file mapped into memory, unmapped when the view is destroyed
+class FileMapping
+{
+  public:
+	using Unmap = std::function<void(const uint8_t *data, size_t size)>;
+
+	FileMapping() = default;
+	FileMapping(const uint8_t *data, size_t size, Unmap unmap);
+	FileMapping(const FileMapping &) = delete;
+	FileMapping(FileMapping &&other) noexcept;
+	~FileMapping();
+
+	FileMapping &operator=(const FileMapping &) = delete;
+	FileMapping &operator=(FileMapping &&other) noexcept;
+
+	const uint8_t *data() const;
+	size_t         size() const;
+	bool           empty() const;
+
+	// Unmaps the file, leaving an empty view
+	void reset();
+
+  private:
+	const uint8_t *_data{nullptr};
+	size_t         _size{0};
+	Unmap          _unmap;
+};
+
 // A thin filesystem wrapper
-class FileSystem
+class FileSystem : public std::enable_shared_from_this<FileSystem>
 {
   public:
 	FileSystem()          = default;
@@ -51,6 +81,7 @@ class FileSystem
 	virtual bool                 exists(const Path &path)                                       = 0;
 	virtual bool                 create_directory(const Path &path)                             = 0;
 	virtual std::vector<uint8_t> read_chunk(const Path &path, size_t offset, size_t count)      = 0;
+	virtual FileMapping          map_file(const Path &path)                                     = 0;
 	virtual void                 write_file(const Path &path, const std::vector<uint8_t> &data) = 0;
 	virtual void                 remove(const Path &path)                                       = 0;
 
@@ -65,6 +96,12 @@ class FileSystem
 
 	// Read the entire file into a vector of bytes
 	std::vector<uint8_t> read_file_binary(const Path &path);
+
+	// Read the entire file on the I/O thread pool, the filesystem must be owned by a shared pointer
+	std::future<std::vector<uint8_t>> read_file_binary_async(const Path &path);
+
+	// Read a chunk of the file on the I/O thread pool, the filesystem must be owned by a shared pointer
+	std::future<std::vector<uint8_t>> read_chunk_async(const Path &path, size_t offset, size_t count);
 };
 
 using FileSystemPtr = std::shared_ptr<FileSystem>;
@@ -17,6 +17,13 @@
 
 #include "filesystem/filesystem.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+
 #include "core/platform/context.hpp"
 #include "core/util/error.hpp"
 
@@ -28,6 +35,92 @@ namespace filesystem
 {
 static FileSystemPtr fs = nullptr;
 
+namespace
+{
+// A few threads blocking on file reads, so that callers overlap I/O with their own work
+class IoThreadPool
+{
+  public:
+	explicit IoThreadPool(uint32_t thread_count)
+	{
+		for (uint32_t i = 0; i < thread_count; ++i)
+		{
+			workers.emplace_back([this]() { run(); });
+		}
+	}
+
+	~IoThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			stopping = true;
+		}
+		condition.notify_all();
+
+		for (auto &worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	template <typename Function>
+	auto push(Function &&function) -> std::future<decltype(function())>
+	{
+		auto task   = std::make_shared<std::packaged_task<decltype(function())()>>(std::forward<Function>(function));
+		auto future = task->get_future();
+
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			tasks.emplace([task]() { (*task)(); });
+		}
+		condition.notify_one();
+
+		return future;
+	}
+
+  private:
+	void run()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+				// Pending reads are completed before the pool is destroyed, as callers may wait on them
+				if (tasks.empty())
+				{
+					return;
+				}
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			task();
+		}
+	}
+
+	std::vector<std::thread> workers;
+
+	std::queue<std::function<void()>> tasks;
+
+	std::mutex mutex;
+
+	std::condition_variable condition;
+
+	bool stopping{false};
+};
+
+IoThreadPool &get_io_thread_pool()
+{
+	static IoThreadPool pool{std::clamp(std::thread::hardware_concurrency(), 1u, 4u)};
+	return pool;
+}
+}        // namespace
+
 void init()
 {
 	fs = std::make_shared<StdFileSystem>();
@@ -46,6 +139,64 @@ FileSystemPtr get()
 	return fs;
 }
 
+FileMapping::FileMapping(const uint8_t *data, size_t size, Unmap unmap) :
+    _data{data},
+    _size{size},
+    _unmap{std::move(unmap)}
+{}
+
+FileMapping::FileMapping(FileMapping &&other) noexcept :
+    _data{std::exchange(other._data, nullptr)},
+    _size{std::exchange(other._size, 0)},
+    _unmap{std::move(other._unmap)}
+{
+	other._unmap = nullptr;
+}
+
+FileMapping::~FileMapping()
+{
+	reset();
+}
+
+FileMapping &FileMapping::operator=(FileMapping &&other) noexcept
+{
+	if (this != &other)
+	{
+		reset();
+		_data        = std::exchange(other._data, nullptr);
+		_size        = std::exchange(other._size, 0);
+		_unmap       = std::move(other._unmap);
+		other._unmap = nullptr;
+	}
+	return *this;
+}
+
+const uint8_t *FileMapping::data() const
+{
+	return _data;
+}
+
+size_t FileMapping::size() const
+{
+	return _size;
+}
+
+bool FileMapping::empty() const
+{
+	return _size == 0;
+}
+
+void FileMapping::reset()
+{
+	if (_data && _unmap)
+	{
+		_unmap(_data, _size);
+	}
+	_data  = nullptr;
+	_size  = 0;
+	_unmap = nullptr;
+}
+
 void FileSystem::write_file(const Path &path, const std::string &data)
 {
 	write_file(path, std::vector<uint8_t>(data.begin(), data.end()));
@@ -53,14 +204,25 @@ void FileSystem::write_file(const Path &path, const std::string &data)
 
 std::string FileSystem::read_file_string(const Path &path)
 {
-	auto bin = read_file_binary(path);
-	return {bin.begin(), bin.end()};
+	auto mapping = map_file(path);
+	return {reinterpret_cast<const char *>(mapping.data()), mapping.size()};
 }
 
 std::vector<uint8_t> FileSystem::read_file_binary(const Path &path)
 {
-	auto stat = stat_file(path);
-	return read_chunk(path, 0, stat.size);
+	auto mapping = map_file(path);
+	return {mapping.data(), mapping.data() + mapping.size()};
+}
+
+std::future<std::vector<uint8_t>> FileSystem::read_file_binary_async(const Path &path)
+{
+	// The filesystem is kept alive until the read completed
+	return get_io_thread_pool().push([self = shared_from_this(), path]() { return self->read_file_binary(path); });
+}
+
+std::future<std::vector<uint8_t>> FileSystem::read_chunk_async(const Path &path, size_t offset, size_t count)
+{
+	return get_io_thread_pool().push([self = shared_from_this(), path, offset, count]() { return self->read_chunk(path, offset, count); });
 }
 
 }        // namespace filesystem
@@ -111,7 +111,8 @@ std::vector<uint8_t> read_asset(const std::string &filename)
 
 std::string read_shader(const std::string &filename)
 {
-	return vkb::filesystem::get()->read_file_string(path::get(path::Type::Shaders) + filename);
+	auto mapping = vkb::filesystem::get()->map_file(path::get(path::Type::Shaders) + filename);
+	return {reinterpret_cast<const char *>(mapping.data()), mapping.size()};
 }
 
 std::vector<uint8_t> read_shader_binary(const std::string &filename)
@@ -22,6 +22,18 @@
 #include <filesystem>
 #include <fstream>
 
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
 namespace vkb
 {
 namespace filesystem
@@ -94,7 +106,8 @@ std::vector<uint8_t> StdFileSystem::read_chunk(const Path &path, size_t offset,
 		throw std::runtime_error("Failed to open file for reading at path: " + path.string());
 	}
 
-	auto size = stat_file(path).size;
+	// The stream was opened at its end
+	auto size = static_cast<size_t>(file.tellg());
 
 	if (offset + count > size)
 	{
@@ -109,6 +122,80 @@ std::vector<uint8_t> StdFileSystem::read_chunk(const Path &path, size_t offset,
 	return data;
 }
 
+FileMapping StdFileSystem::map_file(const Path &path)
+{
+#if defined(_WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error("Failed to open file for mapping at path: " + path.string());
+	}
+
+	LARGE_INTEGER file_size{};
+	if (!GetFileSizeEx(file, &file_size))
+	{
+		CloseHandle(file);
+		throw std::runtime_error("Failed to get the size of file at path: " + path.string());
+	}
+
+	// Empty files can not be mapped
+	if (file_size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return {};
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+	{
+		throw std::runtime_error("Failed to map file at path: " + path.string());
+	}
+
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+	{
+		throw std::runtime_error("Failed to map file at path: " + path.string());
+	}
+
+	return {static_cast<const uint8_t *>(data), static_cast<size_t>(file_size.QuadPart), [](const uint8_t *data, size_t) { UnmapViewOfFile(data); }};
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		throw std::runtime_error("Failed to open file for mapping at path: " + path.string());
+	}
+
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0)
+	{
+		close(file);
+		throw std::runtime_error("Failed to get the size of file at path: " + path.string());
+	}
+
+	// Empty files can not be mapped
+	if (file_stat.st_size == 0)
+	{
+		close(file);
+		return {};
+	}
+
+	auto  size = static_cast<size_t>(file_stat.st_size);
+	void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED)
+	{
+		throw std::runtime_error("Failed to map file at path: " + path.string());
+	}
+
+	return {static_cast<const uint8_t *>(data), size, [](const uint8_t *data, size_t size) { munmap(const_cast<uint8_t *>(data), size); }};
+#endif
+}
+
 void StdFileSystem::write_file(const Path &path, const std::vector<uint8_t> &data)
 {
 	// create directory if it doesn't exist
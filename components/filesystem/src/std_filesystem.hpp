@@ -45,6 +45,8 @@ class StdFileSystem final : public FileSystem
 
 	std::vector<uint8_t> read_chunk(const Path &path, size_t offset, size_t count) override;
 
+	FileMapping map_file(const Path &path) override;
+
 	void write_file(const Path &path, const std::vector<uint8_t> &data) override;
 
 	virtual void remove(const Path &path) override;
@@ -15,8 +15,11 @@
  * limitations under the License.
  */
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <numeric>
+
 #include "filesystem/filesystem.hpp"
 
 using namespace vkb::filesystem;
@@ -50,6 +53,20 @@ void create_test_file(FileSystemPtr fs, const Path &path, const std::string &dat
 	REQUIRE(data == written_data);
 }
 
+std::vector<uint8_t> create_large_test_file(FileSystemPtr fs, const Path &path, size_t size)
+{
+	std::vector<uint8_t> data(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+	}
+
+	REQUIRE_NOTHROW(fs->write_file(path, data));
+	REQUIRE(fs->stat_file(path).size == size);
+
+	return data;
+}
+
 void delete_test_file(FileSystemPtr fs, const Path &path)
 {
 	REQUIRE(fs);
@@ -190,3 +207,137 @@ TEST_CASE("Create Directory", "[filesystem]")
 
 	delete_test_directory(fs, test_dir);
 }
+
+TEST_CASE("Map file", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto        test_dir  = create_test_directory(fs, "map_test");
+	const auto        test_file = test_dir / "map_test.txt";
+	const std::string test_data = "Hello, World!";
+
+	create_test_file(fs, test_file, test_data);
+
+	{
+		auto mapping = fs->map_file(test_file);
+		REQUIRE(mapping.size() == test_data.size());
+		REQUIRE(std::string(reinterpret_cast<const char *>(mapping.data()), mapping.size()) == test_data);
+
+		// Ownership of the mapping moves with the view
+		auto moved = std::move(mapping);
+		REQUIRE(mapping.empty());
+		REQUIRE(moved.size() == test_data.size());
+		REQUIRE(moved.data()[7] == 'W');
+	}
+
+	// Empty files map to an empty view
+	const auto empty_file = test_dir / "empty.txt";
+	fs->write_file(empty_file, std::vector<uint8_t>{});
+	REQUIRE(fs->map_file(empty_file).empty());
+	REQUIRE(fs->read_file_binary(empty_file).empty());
+
+	REQUIRE_THROWS(fs->map_file(test_dir / "missing.txt"));
+
+	delete_test_file(fs, empty_file);
+	delete_test_file(fs, test_file);
+	delete_test_directory(fs, test_dir);
+}
+
+TEST_CASE("Read file async", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_dir  = create_test_directory(fs, "async_test");
+	const auto test_file = test_dir / "async_test.bin";
+	const auto test_data = create_large_test_file(fs, test_file, 4 * 1024 * 1024);
+
+	auto whole = fs->read_file_binary_async(test_file);
+
+	// Reads complete in any order, each future holds its own chunk
+	const size_t                                   chunk_size = 256 * 1024;
+	std::vector<std::future<std::vector<uint8_t>>> chunks;
+	for (size_t offset = 0; offset < test_data.size(); offset += chunk_size)
+	{
+		chunks.push_back(fs->read_chunk_async(test_file, offset, chunk_size));
+	}
+
+	REQUIRE(whole.get() == test_data);
+
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		auto chunk = chunks[i].get();
+		REQUIRE(chunk.size() == chunk_size);
+		REQUIRE(std::equal(chunk.begin(), chunk.end(), test_data.begin() + i * chunk_size));
+	}
+
+	auto missing = fs->read_file_binary_async(test_dir / "missing.bin");
+	REQUIRE_THROWS(missing.get());
+
+	delete_test_file(fs, test_file);
+	delete_test_directory(fs, test_dir);
+}
+
+TEST_CASE("Large file read throughput", "[filesystem][.benchmark]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_dir  = create_test_directory(fs, "throughput_test");
+	const auto test_file = test_dir / "throughput_test.bin";
+	const auto test_data = create_large_test_file(fs, test_file, 256 * 1024 * 1024);
+
+	// Every benchmark touches all bytes, so that mapped pages are actually read
+	auto checksum = [](const uint8_t *data, size_t size) {
+		return std::accumulate(data, data + size, uint64_t{0});
+	};
+
+	const auto expected = checksum(test_data.data(), test_data.size());
+
+	BENCHMARK("read_chunk")
+	{
+		auto data = fs->read_chunk(test_file, 0, test_data.size());
+		return checksum(data.data(), data.size());
+	};
+
+	BENCHMARK("read_file_binary")
+	{
+		auto data = fs->read_file_binary(test_file);
+		return checksum(data.data(), data.size());
+	};
+
+	BENCHMARK("map_file")
+	{
+		auto mapping = fs->map_file(test_file);
+		return checksum(mapping.data(), mapping.size());
+	};
+
+	BENCHMARK("read_chunk_async, 16 MB chunks")
+	{
+		const size_t                                   chunk_size = 16 * 1024 * 1024;
+		std::vector<std::future<std::vector<uint8_t>>> chunks;
+		for (size_t offset = 0; offset < test_data.size(); offset += chunk_size)
+		{
+			chunks.push_back(fs->read_chunk_async(test_file, offset, chunk_size));
+		}
+
+		uint64_t sum = 0;
+		for (auto &chunk : chunks)
+		{
+			auto data = chunk.get();
+			sum += checksum(data.data(), data.size());
+		}
+		return sum;
+	};
+
+	auto mapping = fs->map_file(test_file);
+	REQUIRE(checksum(mapping.data(), mapping.size()) == expected);
+	mapping.reset();
+
+	delete_test_file(fs, test_file);
+	delete_test_directory(fs, test_dir);
+}
@@ -21,6 +21,7 @@
 #include "core/device.h"
 #include "core/swapchain.h"
 #include "gltf_loader.h"
+#include "rendering/mipmap_generator.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/sampler.h"
 #include "scene_graph/components/sub_mesh.h"
@@ -508,6 +509,9 @@ void ApiVulkanSample::draw_ui(const VkCommandBuffer command_buffer)
 
 void ApiVulkanSample::prepare_frame()
 {
+	// Deliver the readbacks that completed since the last frame
+	get_render_context().get_readback_service().update();
+
 	if (get_render_context().has_swapchain())
 	{
 		handle_surface_changes();
@@ -529,6 +533,9 @@ void ApiVulkanSample::prepare_frame()
 
 void ApiVulkanSample::submit_frame()
 {
+	// Readbacks recorded during the frame are submitted after its command buffers
+	get_render_context().get_readback_service().submit();
+
 	if (get_render_context().has_swapchain())
 	{
 		const auto &queue = get_device().get_queue_by_present(0);
@@ -577,7 +584,9 @@ void ApiVulkanSample::submit_frame()
 	// DO NOT USE
 	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
 	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	VK_CHECK(get_device().get_queue_by_present(0).wait_idle());
+	// Without a swapchain (offscreen rendering) no queue supports presenting, the frame was submitted to the graphics queue
+	const auto &wait_queue = get_render_context().has_swapchain() ? get_device().get_queue_by_present(0) : get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+	VK_CHECK(wait_queue.wait_idle());
 }
 
 ApiVulkanSample::~ApiVulkanSample()
@@ -1021,7 +1030,31 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	Texture texture{};
 
 	texture.image = vkb::sg::Image::load(file, file, content_type);
-	texture.image->create_vk_image(get_device());
+
+	// Images without a mip chain get it generated on the GPU from the base level, if the format allows
+	auto format        = texture.image->get_format();
+	auto mipmap_method = vkb::MipmapGenerator::Method::None;
+	if (texture.image->get_mipmaps().size() == 1 && texture.image->get_layers() == 1 && !vkb::sg::is_astc(format))
+	{
+		mipmap_method = vkb::MipmapGenerator::get_method(get_device(), format, false);
+	}
+
+	if (mipmap_method == vkb::MipmapGenerator::Method::None)
+	{
+		texture.image->create_vk_image(get_device());
+	}
+	else
+	{
+		texture.image->create_vk_image(get_device(),
+		                               VK_IMAGE_VIEW_TYPE_2D,
+		                               vkb::MipmapGenerator::get_image_flags(mipmap_method, format),
+		                               vkb::MipmapGenerator::get_image_usage(mipmap_method),
+		                               vkb::MipmapGenerator::get_mip_levels(texture.image->get_extent()));
+	}
+
+	const uint32_t mip_levels = texture.image->get_vk_image().get_subresource().mipLevel;
+
+	vkb::MipmapGenerator mipmap_generator{get_device()};
 
 	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 
@@ -1052,7 +1085,7 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	VkImageSubresourceRange subresource_range = {};
 	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
 	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
+	subresource_range.levelCount              = mip_levels;
 	subresource_range.layerCount              = 1;
 
 	// Image barrier for optimal image (target)
@@ -1072,12 +1105,20 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	    static_cast<uint32_t>(bufferCopyRegions.size()),
 	    bufferCopyRegions.data());
 
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
+	if (mipmap_method != vkb::MipmapGenerator::Method::None)
+	{
+		// Generate the remaining levels from the base level, this also leaves them in the shader read layout
+		mipmap_generator.record(command_buffer, texture.image->get_vk_image(), mipmap_method, false);
+	}
+	else
+	{
+		// Change texture image layout to shader read after all mip levels have been copied
+		vkb::image_layout_transition(command_buffer,
+		                             texture.image->get_vk_image().get_handle(),
+		                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		                             subresource_range);
+	}
 
 	get_device().flush_command_buffer(command_buffer, queue.get_handle());
 
@@ -1099,7 +1140,7 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	sampler_create_info.compareOp           = VK_COMPARE_OP_NEVER;
 	sampler_create_info.minLod              = 0.0f;
 	// Max level-of-detail should match mip level count
-	sampler_create_info.maxLod = static_cast<float>(mipmaps.size());
+	sampler_create_info.maxLod = static_cast<float>(mip_levels);
 	// Only enable anisotropic filtering if enabled on the device
 	// Note that for simplicity, we will always be using max. available anisotropy level for the current device
 	// This may have an impact on performance, esp. on lower-specced devices
@@ -93,6 +93,11 @@ struct Meshlet
 	uint32_t indices[126];
 	uint32_t vertex_count;
 	uint32_t index_count;
+
+	// Culling data, see vkb::MeshletBounds
+	glm::vec4 bounding_sphere;         // xyz: center, w: radius
+	glm::vec4 cone_apex;               // xyz: apex
+	glm::vec4 cone_axis_cutoff;        // xyz: axis, w: cutoff
 };
 
 /**
@@ -260,20 +260,24 @@ vk::DeviceSize BufferBlock<bindingType>::aligned_offset() const
 template <vkb::BindingType bindingType>
 vk::DeviceSize BufferBlock<bindingType>::determine_alignment(vk::BufferUsageFlags usage, vk::PhysicalDeviceLimits const &limits) const
 {
-	if (usage == vk::BufferUsageFlagBits::eUniformBuffer)
+	if (usage & (vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT | vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT))
+	{
+		// 256 is the largest descriptorBufferOffsetAlignment allowed by the spec, so descriptor sets can start at any allocation
+		return 256;
+	}
+	else if (usage & vk::BufferUsageFlagBits::eUniformBuffer)
 	{
 		return limits.minUniformBufferOffsetAlignment;
 	}
-	else if (usage == vk::BufferUsageFlagBits::eStorageBuffer)
+	else if (usage & vk::BufferUsageFlagBits::eStorageBuffer)
 	{
 		return limits.minStorageBufferOffsetAlignment;
 	}
-	else if (usage == vk::BufferUsageFlagBits::eUniformTexelBuffer)
+	else if (usage & vk::BufferUsageFlagBits::eUniformTexelBuffer)
 	{
 		return limits.minTexelBufferOffsetAlignment;
 	}
-	else if (usage == vk::BufferUsageFlagBits::eIndexBuffer || usage == vk::BufferUsageFlagBits::eVertexBuffer ||
-	         usage == vk::BufferUsageFlagBits::eIndirectBuffer)
+	else if (usage & (vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer))
 	{
 		// Used to calculate the offset, required when allocating memory (its value should be power of 2)
 		return 16;
@@ -56,39 +56,22 @@ void screenshot(RenderContext &render_context, const std::string &filename)
 	auto height   = render_context.get_surface_extent().height;
 	auto dst_size = width * height * 4;
 
-	vkb::core::BufferC dst_buffer{render_context.get_device(),
-	                              dst_size,
-	                              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-	                              VMA_MEMORY_USAGE_GPU_TO_CPU,
-	                              VMA_ALLOCATION_CREATE_MAPPED_BIT};
+	auto &readback_service = render_context.get_readback_service();
 
-	const auto &queue = render_context.get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+	VkCommandBuffer command_buffer = readback_service.get_command_buffer();
 
-	auto &cmd_buf = render_context.get_device().request_command_buffer();
-
-	cmd_buf.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-	// Enable destination buffer to be written to
-	{
-		BufferMemoryBarrier memory_barrier{};
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-		cmd_buf.buffer_memory_barrier(dst_buffer, 0, dst_size, memory_barrier);
-	}
+	VkImageSubresourceRange subresource_range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 
 	// Enable framebuffer image view to be read from
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-		memory_barrier.new_layout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-		memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-		cmd_buf.image_memory_barrier(src_image_view, memory_barrier);
-	}
+	image_layout_transition(command_buffer,
+	                        src_image_view.get_image().get_handle(),
+	                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+	                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+	                        VK_ACCESS_TRANSFER_READ_BIT,
+	                        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+	                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+	                        subresource_range);
 
 	// Check if framebuffer images are in a BGR format
 	auto bgr_formats = {VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_B8G8R8A8_SNORM};
@@ -104,83 +87,49 @@ void screenshot(RenderContext &render_context, const std::string &filename)
 	image_copy_region.imageExtent.height          = height;
 	image_copy_region.imageExtent.depth           = 1;
 
-	cmd_buf.copy_image_to_buffer(src_image_view.get_image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst_buffer, {image_copy_region});
-
-	// Enable destination buffer to map memory
-	{
-		BufferMemoryBarrier memory_barrier{};
-		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_HOST_READ_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-
-		cmd_buf.buffer_memory_barrier(dst_buffer, 0, dst_size, memory_barrier);
-	}
+	// The file is written once the copy completed, during a later frame, so that the frame loop does not wait for the GPU
+	readback_service.read_image(
+	    src_image_view.get_image().get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image_copy_region, dst_size,
+	    [filename, width, height, swizzle](const uint8_t *raw_data, VkDeviceSize size) {
+		    std::vector<uint8_t> pixels(raw_data, raw_data + size);
+
+		    // Replace the A component with 255 (remove transparency)
+		    // If swapchain format is BGR, swapping the R and B components
+		    uint8_t *data = pixels.data();
+		    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+		    {
+			    if (swizzle)
+			    {
+				    std::swap(data[0], data[2]);
+			    }
+			    data[3] = 255;
+
+			    // Get next pixel
+			    data += 4;
+		    }
+
+		    vkb::fs::write_image(pixels.data(),
+		                         filename,
+		                         width,
+		                         height,
+		                         4,
+		                         width * 4);
+	    });
 
 	// Revert back the framebuffer image view from transfer to present
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-		memory_barrier.new_layout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-		memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-		cmd_buf.image_memory_barrier(src_image_view, memory_barrier);
-	}
-
-	cmd_buf.end();
-
-	queue.submit(cmd_buf, frame.request_fence());
-
-	queue.wait_idle();
-
-	auto raw_data = dst_buffer.map();
-
-	// Creates a pointer to the address of the first byte of the image data
-	// Replace the A component with 255 (remove transparency)
-	// If swapchain format is BGR, swapping the R and B components
-	uint8_t *data = raw_data;
-	if (swizzle)
-	{
-		for (size_t i = 0; i < height; ++i)
-		{
-			// Iterate over each pixel, swapping R and B components and writing the max value for alpha
-			for (size_t j = 0; j < width; ++j)
-			{
-				auto temp   = *(data + 2);
-				*(data + 2) = *(data);
-				*(data)     = temp;
-				*(data + 3) = 255;
-
-				// Get next pixel
-				data += 4;
-			}
-		}
-	}
-	else
-	{
-		for (size_t i = 0; i < height; ++i)
-		{
-			// Iterate over each pixel, writing the max value for alpha
-			for (size_t j = 0; j < width; ++j)
-			{
-				*(data + 3) = 255;
-
-				// Get next pixel
-				data += 4;
-			}
-		}
-	}
-
-	vkb::fs::write_image(raw_data,
-	                     filename,
-	                     width,
-	                     height,
-	                     4,
-	                     width * 4);
-
-	dst_buffer.unmap();
-}        // namespace vkb
+	image_layout_transition(command_buffer,
+	                        src_image_view.get_image().get_handle(),
+	                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                        VK_ACCESS_TRANSFER_READ_BIT,
+	                        0,
+	                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+	                        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+	                        subresource_range);
+
+	// Submit right away, before the image is acquired again
+	readback_service.submit();
+}
 
 std::string to_snake_case(const std::string &text)
 {
@@ -46,7 +46,8 @@ std::string to_snake_case(const std::string &name);
 class CommandBuffer;
 
 /**
- * @brief Takes a screenshot of the app by writing the swapchain image to file (slow function)
+ * @brief Takes a screenshot of the app by writing the swapchain image to file
+ *        The image is copied through the readback service of the render context, and written once the copy completed.
  * @param render_context The RenderContext to use
  * @param filename The name of the file to save the output to
  */
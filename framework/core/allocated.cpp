@@ -86,6 +86,14 @@ void AllocatedBase::flush(VkDeviceSize offset, VkDeviceSize size)
 	}
 }
 
+void AllocatedBase::invalidate(VkDeviceSize offset, VkDeviceSize size)
+{
+	if (!coherent)
+	{
+		vmaInvalidateAllocation(get_memory_allocator(), allocation, offset, size);
+	}
+}
+
 uint8_t *AllocatedBase::map()
 {
 	if (!persistent && !mapped())
@@ -103,6 +103,11 @@ class AllocatedBase
 	 */
 	void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
 
+	/**
+	 * @brief Invalidates memory if it is HOST_VISIBLE and not HOST_COHERENT, so that device writes become visible to the host
+	 */
+	void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
 	/**
 	 * @brief Returns true if the memory is mapped, false otherwise
 	 * @return mapping status
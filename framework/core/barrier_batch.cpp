@@ -0,0 +1,165 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/barrier_batch.h"
+
+#include <algorithm>
+
+#include "common/helpers.h"
+
+namespace vkb
+{
+BarrierBatch::BarrierBatch(bool use_synchronization_2) :
+    use_synchronization_2{use_synchronization_2}
+{}
+
+void BarrierBatch::add_image_barrier(VkImage image, const VkImageSubresourceRange &subresource_range, const ImageMemoryBarrier &memory_barrier, VkCommandBuffer command_buffer)
+{
+	if (std::any_of(image_barriers.begin(), image_barriers.end(), [image](const VkImageMemoryBarrier2KHR &barrier) { return barrier.image == image; }))
+	{
+		flush(command_buffer);
+	}
+
+	VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+	barrier.srcStageMask        = memory_barrier.src_stage_mask;
+	barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	barrier.dstStageMask        = memory_barrier.dst_stage_mask;
+	barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	barrier.oldLayout           = memory_barrier.old_layout;
+	barrier.newLayout           = memory_barrier.new_layout;
+	barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+	barrier.image               = image;
+	barrier.subresourceRange    = subresource_range;
+	image_barriers.push_back(barrier);
+}
+
+void BarrierBatch::add_buffer_barrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier, VkCommandBuffer command_buffer)
+{
+	if (std::any_of(buffer_barriers.begin(), buffer_barriers.end(), [buffer](const VkBufferMemoryBarrier2KHR &barrier) { return barrier.buffer == buffer; }))
+	{
+		flush(command_buffer);
+	}
+
+	VkBufferMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+	barrier.srcStageMask        = memory_barrier.src_stage_mask;
+	barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	barrier.dstStageMask        = memory_barrier.dst_stage_mask;
+	barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer              = buffer;
+	barrier.offset              = offset;
+	barrier.size                = size;
+	buffer_barriers.push_back(barrier);
+}
+
+bool BarrierBatch::empty() const
+{
+	return image_barriers.empty() && buffer_barriers.empty();
+}
+
+bool BarrierBatch::flush(VkCommandBuffer command_buffer)
+{
+	if (empty())
+	{
+		return false;
+	}
+
+	if (use_synchronization_2)
+	{
+		VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+		dependency_info.bufferMemoryBarrierCount = to_u32(buffer_barriers.size());
+		dependency_info.pBufferMemoryBarriers    = buffer_barriers.data();
+		dependency_info.imageMemoryBarrierCount  = to_u32(image_barriers.size());
+		dependency_info.pImageMemoryBarriers     = image_barriers.data();
+		vkCmdPipelineBarrier2KHR(command_buffer, &dependency_info);
+	}
+	else
+	{
+		// The barriers were built from 32 bit stages and accesses, which have the same values in both versions
+		VkPipelineStageFlags src_stages = 0;
+		VkPipelineStageFlags dst_stages = 0;
+
+		std::vector<VkImageMemoryBarrier> legacy_image_barriers;
+		legacy_image_barriers.reserve(image_barriers.size());
+		for (auto &barrier : image_barriers)
+		{
+			src_stages |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+			dst_stages |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+
+			VkImageMemoryBarrier image_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+			image_barrier.srcAccessMask       = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+			image_barrier.dstAccessMask       = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+			image_barrier.oldLayout           = barrier.oldLayout;
+			image_barrier.newLayout           = barrier.newLayout;
+			image_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			image_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			image_barrier.image               = barrier.image;
+			image_barrier.subresourceRange    = barrier.subresourceRange;
+			legacy_image_barriers.push_back(image_barrier);
+		}
+
+		std::vector<VkBufferMemoryBarrier> legacy_buffer_barriers;
+		legacy_buffer_barriers.reserve(buffer_barriers.size());
+		for (auto &barrier : buffer_barriers)
+		{
+			src_stages |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+			dst_stages |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+
+			VkBufferMemoryBarrier buffer_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+			buffer_barrier.srcAccessMask       = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+			buffer_barrier.dstAccessMask       = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+			buffer_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			buffer_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			buffer_barrier.buffer              = barrier.buffer;
+			buffer_barrier.offset              = barrier.offset;
+			buffer_barrier.size                = barrier.size;
+			legacy_buffer_barriers.push_back(buffer_barrier);
+		}
+
+		vkCmdPipelineBarrier(command_buffer,
+		                     src_stages ? src_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		                     dst_stages ? dst_stages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                     0,
+		                     0, nullptr,
+		                     to_u32(legacy_buffer_barriers.size()), legacy_buffer_barriers.data(),
+		                     to_u32(legacy_image_barriers.size()), legacy_image_barriers.data());
+	}
+
+	flush_count++;
+	clear();
+
+	return true;
+}
+
+void BarrierBatch::clear()
+{
+	image_barriers.clear();
+	buffer_barriers.clear();
+}
+
+uint32_t BarrierBatch::get_flush_count() const
+{
+	return flush_count;
+}
+
+void BarrierBatch::reset_flush_count()
+{
+	flush_count = 0;
+}
+}        // namespace vkb
@@ -0,0 +1,74 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief Accumulates image and buffer memory barriers, to record them all with a single pipeline barrier command
+ *
+ * With the synchronization2 feature each barrier keeps its own stage masks and the batch is recorded with one
+ * vkCmdPipelineBarrier2KHR. Otherwise the stage masks of all barriers are merged into the ones of a single
+ * vkCmdPipelineBarrier, which may synchronize a bit more than each barrier asked for.
+ *
+ * Barriers in a batch execute as if they were unordered, so adding a barrier for an image or buffer that already
+ * has one pending flushes the batch first.
+ */
+class BarrierBatch
+{
+  public:
+	BarrierBatch(bool use_synchronization_2 = false);
+
+	void add_image_barrier(VkImage image, const VkImageSubresourceRange &subresource_range, const ImageMemoryBarrier &memory_barrier, VkCommandBuffer command_buffer);
+
+	void add_buffer_barrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier, VkCommandBuffer command_buffer);
+
+	bool empty() const;
+
+	/**
+	 * @brief Records the pending barriers, if any
+	 * @return Whether a pipeline barrier command was recorded
+	 */
+	bool flush(VkCommandBuffer command_buffer);
+
+	/**
+	 * @brief Drops the pending barriers, when the command buffer they were meant for is reset
+	 */
+	void clear();
+
+	/**
+	 * @return The number of pipeline barrier commands recorded since the last call to reset_flush_count
+	 */
+	uint32_t get_flush_count() const;
+
+	void reset_flush_count();
+
+  private:
+	bool use_synchronization_2{false};
+
+	std::vector<VkImageMemoryBarrier2KHR> image_barriers;
+
+	std::vector<VkBufferMemoryBarrier2KHR> buffer_barriers;
+
+	uint32_t flush_count{0};
+};
+}        // namespace vkb
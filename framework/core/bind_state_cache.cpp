@@ -0,0 +1,175 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/bind_state_cache.h"
+
+#include "common/helpers.h"
+
+namespace vkb
+{
+std::atomic<uint64_t> BindStateCache::total_recorded{0};
+std::atomic<uint64_t> BindStateCache::total_skipped{0};
+
+void BindStateCache::bind_pipeline(VkCommandBuffer command_buffer, VkPipelineBindPoint pipeline_bind_point, VkPipeline pipeline)
+{
+	auto *bind_point_state = get_bind_point_state(pipeline_bind_point);
+	if (bind_point_state && bind_point_state->pipeline == pipeline)
+	{
+		counts.skipped++;
+		return;
+	}
+
+	vkCmdBindPipeline(command_buffer, pipeline_bind_point, pipeline);
+	counts.recorded++;
+
+	if (bind_point_state)
+	{
+		bind_point_state->pipeline = pipeline;
+	}
+}
+
+void BindStateCache::bind_vertex_buffers(VkCommandBuffer command_buffer, uint32_t first_binding, const std::vector<VkBuffer> &buffers, const std::vector<VkDeviceSize> &offsets)
+{
+	if (vertex_buffers.size() < first_binding + buffers.size())
+	{
+		vertex_buffers.resize(first_binding + buffers.size());
+	}
+
+	bool bound = true;
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		auto &vertex_buffer = vertex_buffers[first_binding + i];
+		if (vertex_buffer.buffer != buffers[i] || vertex_buffer.offset != offsets[i])
+		{
+			vertex_buffer.buffer = buffers[i];
+			vertex_buffer.offset = offsets[i];
+			bound                = false;
+		}
+	}
+
+	if (bound)
+	{
+		counts.skipped++;
+		return;
+	}
+
+	vkCmdBindVertexBuffers(command_buffer, first_binding, to_u32(buffers.size()), buffers.data(), offsets.data());
+	counts.recorded++;
+}
+
+void BindStateCache::bind_index_buffer(VkCommandBuffer command_buffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType type)
+{
+	if (index_buffer == buffer && index_offset == offset && index_type == type)
+	{
+		counts.skipped++;
+		return;
+	}
+
+	vkCmdBindIndexBuffer(command_buffer, buffer, offset, type);
+	counts.recorded++;
+
+	index_buffer = buffer;
+	index_offset = offset;
+	index_type   = type;
+}
+
+void BindStateCache::bind_descriptor_set(VkCommandBuffer command_buffer, VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout pipeline_layout,
+                                         uint32_t set, VkDescriptorSet descriptor_set, const std::vector<uint32_t> &dynamic_offsets)
+{
+	auto *bind_point_state = get_bind_point_state(pipeline_bind_point);
+	if (bind_point_state)
+	{
+		if (bind_point_state->pipeline_layout != pipeline_layout)
+		{
+			bind_point_state->pipeline_layout = pipeline_layout;
+			bind_point_state->descriptor_sets.clear();
+		}
+
+		if (bind_point_state->descriptor_sets.size() <= set)
+		{
+			bind_point_state->descriptor_sets.resize(set + 1);
+		}
+
+		auto &bound_descriptor_set = bind_point_state->descriptor_sets[set];
+		if (bound_descriptor_set.descriptor_set == descriptor_set && bound_descriptor_set.dynamic_offsets == dynamic_offsets)
+		{
+			counts.skipped++;
+			return;
+		}
+
+		bound_descriptor_set.descriptor_set  = descriptor_set;
+		bound_descriptor_set.dynamic_offsets = dynamic_offsets;
+	}
+
+	vkCmdBindDescriptorSets(command_buffer, pipeline_bind_point, pipeline_layout, set, 1, &descriptor_set, to_u32(dynamic_offsets.size()), dynamic_offsets.data());
+	counts.recorded++;
+}
+
+void BindStateCache::invalidate_descriptor_sets(VkPipelineBindPoint pipeline_bind_point)
+{
+	if (auto *bind_point_state = get_bind_point_state(pipeline_bind_point))
+	{
+		bind_point_state->pipeline_layout = VK_NULL_HANDLE;
+		bind_point_state->descriptor_sets.clear();
+	}
+}
+
+void BindStateCache::clear()
+{
+	for (auto &bind_point_state : bind_points)
+	{
+		bind_point_state = {};
+	}
+
+	vertex_buffers.clear();
+
+	index_buffer = VK_NULL_HANDLE;
+	index_offset = 0;
+	index_type   = VK_INDEX_TYPE_UINT16;
+}
+
+const BindStateCache::BindCounts &BindStateCache::get_counts() const
+{
+	return counts;
+}
+
+void BindStateCache::report_counts()
+{
+	total_recorded.fetch_add(counts.recorded, std::memory_order_relaxed);
+	total_skipped.fetch_add(counts.skipped, std::memory_order_relaxed);
+
+	counts = {};
+}
+
+BindStateCache::BindCounts BindStateCache::get_total_counts()
+{
+	return {total_recorded.load(std::memory_order_relaxed), total_skipped.load(std::memory_order_relaxed)};
+}
+
+BindStateCache::BindPointState *BindStateCache::get_bind_point_state(VkPipelineBindPoint pipeline_bind_point)
+{
+	switch (pipeline_bind_point)
+	{
+		case VK_PIPELINE_BIND_POINT_GRAPHICS:
+			return &bind_points[0];
+		case VK_PIPELINE_BIND_POINT_COMPUTE:
+			return &bind_points[1];
+		default:
+			return nullptr;
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,132 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief Remembers what a command buffer has bound, to skip the bind commands which would not change anything
+ *
+ * Pipelines, vertex buffers, index buffers and descriptor sets are tracked. A descriptor set is only skipped if it
+ * was bound with the same pipeline layout, binding a set with another layout forgets all sets of its bind point,
+ * which is stricter than the compatibility rules of Vulkan but never wrong.
+ *
+ * The state must be cleared whenever it is unknown, such as when the command buffer begins or after it executed
+ * secondary command buffers.
+ */
+class BindStateCache
+{
+  public:
+	struct BindCounts
+	{
+		// Bind commands recorded
+		uint64_t recorded{0};
+
+		// Bind commands skipped, as they would have bound what was already bound
+		uint64_t skipped{0};
+	};
+
+	void bind_pipeline(VkCommandBuffer command_buffer, VkPipelineBindPoint pipeline_bind_point, VkPipeline pipeline);
+
+	void bind_vertex_buffers(VkCommandBuffer command_buffer, uint32_t first_binding, const std::vector<VkBuffer> &buffers, const std::vector<VkDeviceSize> &offsets);
+
+	void bind_index_buffer(VkCommandBuffer command_buffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType type);
+
+	void bind_descriptor_set(VkCommandBuffer command_buffer, VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout pipeline_layout,
+	                         uint32_t set, VkDescriptorSet descriptor_set, const std::vector<uint32_t> &dynamic_offsets);
+
+	/**
+	 * @brief Forgets the descriptor sets of a bind point, when they were changed without bind_descriptor_set
+	 *        such as with push descriptors or descriptor buffers
+	 */
+	void invalidate_descriptor_sets(VkPipelineBindPoint pipeline_bind_point);
+
+	/**
+	 * @brief Forgets everything bound, the counts are kept
+	 */
+	void clear();
+
+	/**
+	 * @return The bind commands recorded and skipped since the last call to report_counts
+	 */
+	const BindCounts &get_counts() const;
+
+	/**
+	 * @brief Adds the counts to the totals of all command buffers and resets them, called when a command buffer ends
+	 */
+	void report_counts();
+
+	/**
+	 * @return The bind commands recorded and skipped by all command buffers which ended since the app started
+	 */
+	static BindCounts get_total_counts();
+
+  private:
+	struct BoundDescriptorSet
+	{
+		VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
+
+		std::vector<uint32_t> dynamic_offsets;
+	};
+
+	struct BindPointState
+	{
+		VkPipeline pipeline{VK_NULL_HANDLE};
+
+		VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
+
+		// Indexed by set
+		std::vector<BoundDescriptorSet> descriptor_sets;
+	};
+
+	struct BoundVertexBuffer
+	{
+		VkBuffer buffer{VK_NULL_HANDLE};
+
+		VkDeviceSize offset{0};
+	};
+
+	// Graphics and compute
+	BindPointState bind_points[2];
+
+	// Indexed by binding
+	std::vector<BoundVertexBuffer> vertex_buffers;
+
+	VkBuffer index_buffer{VK_NULL_HANDLE};
+
+	VkDeviceSize index_offset{0};
+
+	VkIndexType index_type{VK_INDEX_TYPE_UINT16};
+
+	BindCounts counts;
+
+	static std::atomic<uint64_t> total_recorded;
+
+	static std::atomic<uint64_t> total_skipped;
+
+	/**
+	 * @return The state of a graphics or compute bind point, nullptr for other bind points which are not tracked
+	 */
+	BindPointState *get_bind_point_state(VkPipelineBindPoint pipeline_bind_point);
+};
+}        // namespace vkb
@@ -27,11 +27,20 @@
 
 namespace vkb
 {
+namespace
+{
+inline VkDeviceSize aligned_size(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+}        // namespace
+
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     VulkanResource{VK_NULL_HANDLE, &command_pool.get_device()},
     command_pool{command_pool},
     max_push_constants_size{get_device().get_gpu().get_properties().limits.maxPushConstantsSize},
-    level{level}
+    level{level},
+    barrier_batch{get_device().is_synchronization2_enabled()}
 {
 	VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
 
@@ -45,6 +54,12 @@ CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel lev
 	{
 		throw VulkanException{result, "Failed to allocate command buffer"};
 	}
+
+	if (get_device().is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+	{
+		descriptor_buffer_properties =
+		    get_device().get_gpu().get_extension_properties<VkPhysicalDeviceDescriptorBufferPropertiesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT);
+	}
 }
 
 CommandBuffer::~CommandBuffer()
@@ -65,7 +80,11 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    descriptor_buffer_properties(other.descriptor_buffer_properties),
+    bound_descriptor_buffer(std::exchange(other.bound_descriptor_buffer, {})),
+    barrier_batch(std::move(other.barrier_batch)),
+    bind_state(std::move(other.bind_state))
 {}
 
 void CommandBuffer::clear(VkClearAttachment attachment, VkClearRect rect)
@@ -93,6 +112,10 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 	stored_push_constants.clear();
+	bound_descriptor_buffer = VK_NULL_HANDLE;
+	barrier_batch.clear();
+	barrier_batch.reset_flush_count();
+	bind_state.clear();
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -110,6 +133,13 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 		inheritance.subpass     = subpass_index;
 
 		begin_info.pInheritanceInfo = &inheritance;
+
+		// Pipelines recorded in the secondary command buffer are created for the subpass it continues
+		pipeline_state.set_subpass_index(subpass_index);
+
+		auto blend_state = pipeline_state.get_color_blend_state();
+		blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(subpass_index));
+		pipeline_state.set_color_blend_state(blend_state);
 	}
 
 	return vkBeginCommandBuffer(get_handle(), &begin_info);
@@ -117,8 +147,12 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 
 VkResult CommandBuffer::end()
 {
+	flush_barriers();
+
 	vkEndCommandBuffer(get_handle());
 
+	bind_state.report_counts();
+
 	return VK_SUCCESS;
 }
 
@@ -177,7 +211,10 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const R
 		last_render_area_extent = begin_info.renderArea.extent;
 	}
 
+	flush_barriers();
+
 	vkCmdBeginRenderPass(get_handle(), &begin_info, contents);
+	subpass_contents = contents;
 
 	// Update blend state attachments for first subpass
 	auto blend_state = pipeline_state.get_color_blend_state();
@@ -185,7 +222,7 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const R
 	pipeline_state.set_color_blend_state(blend_state);
 }
 
-void CommandBuffer::next_subpass()
+void CommandBuffer::next_subpass(VkSubpassContents contents)
 {
 	// Increment subpass index
 	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
@@ -202,25 +239,77 @@ void CommandBuffer::next_subpass()
 	// Clear stored push constants
 	stored_push_constants.clear();
 
-	vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdNextSubpass(get_handle(), contents);
+	subpass_contents = contents;
+}
+
+CommandPool &CommandBuffer::get_command_pool()
+{
+	return command_pool;
+}
+
+VkSubpassContents CommandBuffer::get_subpass_contents() const
+{
+	return subpass_contents;
+}
+
+void CommandBuffer::inherit_resource_bindings(CommandBuffer &command_buffer)
+{
+	// Bound again rather than copied, so that they are dirty even if the other command buffer flushed them already
+	for (auto &set_it : command_buffer.resource_binding_state.get_resource_sets())
+	{
+		for (auto &binding_it : set_it.second.get_resource_bindings())
+		{
+			for (auto &element_it : binding_it.second)
+			{
+				const auto &resource_info = element_it.second;
+
+				if (resource_info.buffer)
+				{
+					resource_binding_state.bind_buffer(*resource_info.buffer, resource_info.offset, resource_info.range, set_it.first, binding_it.first, element_it.first);
+				}
+				else if (resource_info.image_view && resource_info.sampler)
+				{
+					resource_binding_state.bind_image(*resource_info.image_view, *resource_info.sampler, set_it.first, binding_it.first, element_it.first);
+				}
+				else if (resource_info.image_view)
+				{
+					resource_binding_state.bind_image(*resource_info.image_view, set_it.first, binding_it.first, element_it.first);
+				}
+			}
+		}
+	}
 }
 
 void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
 {
+	flush_barriers();
+
 	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
+
+	// The state bound by the secondary command buffer is undefined afterwards
+	bind_state.clear();
 }
 
 void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
 {
+	flush_barriers();
+
 	std::vector<VkCommandBuffer> sec_cmd_buf_handles(secondary_command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
 	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
+
+	// The state bound by the secondary command buffers is undefined afterwards
+	bind_state.clear();
 }
 
 void CommandBuffer::end_render_pass()
 {
 	vkCmdEndRenderPass(get_handle());
+
+	// Commands outside of a render pass are always recorded inline
+	subpass_contents = VK_SUBPASS_CONTENTS_INLINE;
 }
 
 void CommandBuffer::bind_pipeline_layout(PipelineLayout &pipeline_layout)
@@ -273,12 +362,12 @@ void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vecto
 	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
 	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(),
 	               [](const vkb::core::BufferC &buffer) { return buffer.get_handle(); });
-	vkCmdBindVertexBuffers(get_handle(), first_binding, to_u32(buffer_handles.size()), buffer_handles.data(), offsets.data());
+	bind_state.bind_vertex_buffers(get_handle(), first_binding, buffer_handles, offsets);
 }
 
 void CommandBuffer::bind_index_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkIndexType index_type)
 {
-	vkCmdBindIndexBuffer(get_handle(), buffer.get_handle(), offset, index_type);
+	bind_state.bind_index_buffer(get_handle(), buffer.get_handle(), offset, index_type);
 }
 
 void CommandBuffer::bind_lighting(vkb::rendering::LightingStateC &lighting_state, uint32_t set, uint32_t binding)
@@ -357,6 +446,8 @@ void CommandBuffer::set_depth_bounds(float min_depth_bounds, float max_depth_bou
 
 void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
 	vkCmdDraw(get_handle(), vertex_count, instance_count, first_vertex, first_instance);
@@ -364,6 +455,8 @@ void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_
 
 void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
 	vkCmdDrawIndexed(get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
@@ -371,6 +464,8 @@ void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count,
 
 void CommandBuffer::draw_indexed_indirect(const vkb::core::BufferC &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
@@ -378,6 +473,8 @@ void CommandBuffer::draw_indexed_indirect(const vkb::core::BufferC &buffer, VkDe
 
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatch(get_handle(), group_count_x, group_count_y, group_count_z);
@@ -385,6 +482,8 @@ void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uin
 
 void CommandBuffer::dispatch_indirect(const vkb::core::BufferC &buffer, VkDeviceSize offset)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatchIndirect(get_handle(), buffer.get_handle(), offset);
@@ -392,11 +491,15 @@ void CommandBuffer::dispatch_indirect(const vkb::core::BufferC &buffer, VkDevice
 
 void CommandBuffer::update_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data)
 {
+	flush_barriers();
+
 	vkCmdUpdateBuffer(get_handle(), buffer.get_handle(), offset, data.size(), data.data());
 }
 
 void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageBlit> &regions)
 {
+	flush_barriers();
+
 	vkCmdBlitImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	               dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	               to_u32(regions.size()), regions.data(), VK_FILTER_NEAREST);
@@ -404,6 +507,8 @@ void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &ds
 
 void CommandBuffer::resolve_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageResolve> &regions)
 {
+	flush_barriers();
+
 	vkCmdResolveImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	                  dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	                  to_u32(regions.size()), regions.data());
@@ -411,6 +516,8 @@ void CommandBuffer::resolve_image(const core::Image &src_img, const core::Image
 
 void CommandBuffer::copy_buffer(const vkb::core::BufferC &src_buffer, const vkb::core::BufferC &dst_buffer, VkDeviceSize size)
 {
+	flush_barriers();
+
 	VkBufferCopy copy_region = {};
 	copy_region.size         = size;
 	vkCmdCopyBuffer(get_handle(), src_buffer.get_handle(), dst_buffer.get_handle(), 1, &copy_region);
@@ -418,6 +525,8 @@ void CommandBuffer::copy_buffer(const vkb::core::BufferC &src_buffer, const vkb:
 
 void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions)
 {
+	flush_barriers();
+
 	vkCmdCopyImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	               dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	               to_u32(regions.size()), regions.data());
@@ -425,6 +534,8 @@ void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &ds
 
 void CommandBuffer::copy_buffer_to_image(const vkb::core::BufferC &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
 {
+	flush_barriers();
+
 	vkCmdCopyBufferToImage(get_handle(), buffer.get_handle(),
 	                       image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	                       to_u32(regions.size()), regions.data());
@@ -432,11 +543,25 @@ void CommandBuffer::copy_buffer_to_image(const vkb::core::BufferC &buffer, const
 
 void CommandBuffer::copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const vkb::core::BufferC &buffer, const std::vector<VkBufferImageCopy> &regions)
 {
+	flush_barriers();
+
 	vkCmdCopyImageToBuffer(get_handle(), image.get_handle(), image_layout,
 	                       buffer.get_handle(), to_u32(regions.size()), regions.data());
 }
 
-void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier) const
+void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
+{
+	add_image_memory_barrier(image_view, memory_barrier);
+	flush_barriers();
+}
+
+void CommandBuffer::buffer_memory_barrier(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+{
+	add_buffer_memory_barrier(buffer, offset, size, memory_barrier);
+	flush_barriers();
+}
+
+void CommandBuffer::add_image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
 {
 	// Adjust barrier's subresource range for depth images
 	auto subresource_range = image_view.get_subresource_range();
@@ -450,37 +575,22 @@ void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, cons
 		subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 	}
 
-	vkb::image_layout_transition(get_handle(),
-	                             image_view.get_image().get_handle(),
-	                             memory_barrier.src_stage_mask,
-	                             memory_barrier.dst_stage_mask,
-	                             memory_barrier.src_access_mask,
-	                             memory_barrier.dst_access_mask,
-	                             memory_barrier.old_layout,
-	                             memory_barrier.new_layout,
-	                             subresource_range);
+	barrier_batch.add_image_barrier(image_view.get_image().get_handle(), subresource_range, memory_barrier, get_handle());
 }
 
-void CommandBuffer::buffer_memory_barrier(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+void CommandBuffer::add_buffer_memory_barrier(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
 {
-	VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
-	buffer_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
-	buffer_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
-	buffer_memory_barrier.buffer        = buffer.get_handle();
-	buffer_memory_barrier.offset        = offset;
-	buffer_memory_barrier.size          = size;
+	barrier_batch.add_buffer_barrier(buffer.get_handle(), offset, size, memory_barrier, get_handle());
+}
 
-	VkPipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	VkPipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
+void CommandBuffer::flush_barriers()
+{
+	barrier_batch.flush(get_handle());
+}
 
-	vkCmdPipelineBarrier(
-	    get_handle(),
-	    src_stage_mask,
-	    dst_stage_mask,
-	    0,
-	    0, nullptr,
-	    1, &buffer_memory_barrier,
-	    0, nullptr);
+uint32_t CommandBuffer::get_barrier_count() const
+{
+	return barrier_batch.get_flush_count();
 }
 
 void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
@@ -499,17 +609,13 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 		pipeline_state.set_render_pass(*current_render_pass.render_pass);
 		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
 
-		vkCmdBindPipeline(get_handle(),
-		                  pipeline_bind_point,
-		                  pipeline.get_handle());
+		bind_state.bind_pipeline(get_handle(), pipeline_bind_point, pipeline.get_handle());
 	}
 	else if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
 	{
 		auto &pipeline = get_device().get_resource_cache().request_compute_pipeline(pipeline_state);
 
-		vkCmdBindPipeline(get_handle(),
-		                  pipeline_bind_point,
-		                  pipeline.get_handle());
+		bind_state.bind_pipeline(get_handle(), pipeline_bind_point, pipeline.get_handle());
 	}
 	else
 	{
@@ -560,6 +666,13 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 	{
 		resource_binding_state.clear_dirty();
 
+		// Descriptor buffer sets share a single heap allocation, so they are always written together
+		if (pipeline_layout.get_descriptor_backend() == DescriptorBackend::DescriptorBuffer)
+		{
+			flush_descriptor_buffers(pipeline_bind_point);
+			return;
+		}
+
 		// Iterate over all of the resource sets bound by the command buffer
 		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
 		{
@@ -591,107 +704,341 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 
 			std::vector<uint32_t> dynamic_offsets;
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			collect_descriptor_infos(descriptor_set_layout, resource_set, buffer_infos, image_infos, dynamic_offsets);
+
+			// Sets without descriptors of a push descriptor layout are still regular sets
+			if (descriptor_set_layout.get_create_flags() & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR)
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				push_descriptor_set(pipeline_bind_point, descriptor_set_id, descriptor_set_layout, buffer_infos, image_infos);
+				continue;
+			}
 
-				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
-				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
-					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+			VkDescriptorSet descriptor_set_handle =
+			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
+			                                                            buffer_infos,
+			                                                            image_infos,
+			                                                            update_after_bind,
+			                                                            command_pool.get_thread_index());
+
+			// Bind descriptor set, unless the same set with the same offsets is bound already
+			bind_state.bind_descriptor_set(get_handle(), pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_id, descriptor_set_handle, dynamic_offsets);
+		}
+	}
+}
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+void CommandBuffer::collect_descriptor_infos(const DescriptorSetLayout          &descriptor_set_layout,
+                                             const ResourceSet                  &resource_set,
+                                             BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                             BindingMap<VkDescriptorImageInfo>  &image_infos,
+                                             std::vector<uint32_t>              &dynamic_offsets) const
+{
+	// Iterate over all resource bindings
+	for (auto &binding_it : resource_set.get_resource_bindings())
+	{
+		auto  binding_index     = binding_it.first;
+		auto &binding_resources = binding_it.second;
 
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							VkDescriptorBufferInfo buffer_info{};
+		// Check if binding exists in the pipeline layout
+		if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+		{
+			// Iterate over all binding resources
+			for (auto &element_it : binding_resources)
+			{
+				auto  array_element = element_it.first;
+				auto &resource_info = element_it.second;
 
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
+				// Pointer references
+				auto &buffer     = resource_info.buffer;
+				auto &sampler    = resource_info.sampler;
+				auto &image_view = resource_info.image_view;
 
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
+				// Get buffer info
+				if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+				{
+					VkDescriptorBufferInfo buffer_info{};
 
-								buffer_info.offset = 0;
-							}
+					buffer_info.buffer = resource_info.buffer->get_handle();
+					buffer_info.offset = resource_info.offset;
+					buffer_info.range  = resource_info.range;
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+					if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						dynamic_offsets.push_back(to_u32(buffer_info.offset));
+
+						buffer_info.offset = 0;
+					}
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+					buffer_infos[binding_index][array_element] = buffer_info;
+				}
+
+				// Get image info
+				else if (image_view != nullptr || sampler != nullptr)
+				{
+					// Can be null for input attachments
+					VkDescriptorImageInfo image_info{};
+					image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+					image_info.imageView = image_view->get_handle();
+
+					if (image_view != nullptr)
+					{
+						// Add image layout info based on descriptor type
+						switch (binding_info->descriptorType)
 						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
+							case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+								break;
+							case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+								if (is_depth_format(image_view->get_format()))
+								{
+									image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+								}
+								else
 								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
+									image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 								}
-							}
+								break;
+							case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+								break;
 
-							image_infos[binding_index][array_element] = image_info;
+							default:
+								continue;
 						}
 					}
 
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+					image_infos[binding_index][array_element] = image_info;
 				}
 			}
 
-			VkDescriptorSet descriptor_set_handle =
-			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
-			                                                            update_after_bind,
-			                                                            command_pool.get_thread_index());
+			assert((!update_after_bind ||
+			        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
+			       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+		}
+	}
+}
+
+void CommandBuffer::push_descriptor_set(VkPipelineBindPoint                       pipeline_bind_point,
+                                        uint32_t                                  descriptor_set_id,
+                                        const DescriptorSetLayout                &descriptor_set_layout,
+                                        const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                        const BindingMap<VkDescriptorImageInfo>  &image_infos)
+{
+	std::vector<VkWriteDescriptorSet> write_descriptor_sets;
+
+	// The writes point straight into the binding maps, which outlive the push call
+	for (auto &binding_it : buffer_infos)
+	{
+		auto binding_info = descriptor_set_layout.get_layout_binding(binding_it.first);
+
+		for (auto &element_it : binding_it.second)
+		{
+			VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+
+			write_descriptor_set.dstBinding      = binding_it.first;
+			write_descriptor_set.dstArrayElement = element_it.first;
+			write_descriptor_set.descriptorCount = 1;
+			write_descriptor_set.descriptorType  = binding_info->descriptorType;
+			write_descriptor_set.pBufferInfo     = &element_it.second;
+
+			write_descriptor_sets.push_back(write_descriptor_set);
+		}
+	}
+
+	for (auto &binding_it : image_infos)
+	{
+		auto binding_info = descriptor_set_layout.get_layout_binding(binding_it.first);
+
+		for (auto &element_it : binding_it.second)
+		{
+			VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+
+			write_descriptor_set.dstBinding      = binding_it.first;
+			write_descriptor_set.dstArrayElement = element_it.first;
+			write_descriptor_set.descriptorCount = 1;
+			write_descriptor_set.descriptorType  = binding_info->descriptorType;
+			write_descriptor_set.pImageInfo      = &element_it.second;
 
-			// Bind descriptor set
-			vkCmdBindDescriptorSets(get_handle(),
-			                        pipeline_bind_point,
-			                        pipeline_layout.get_handle(),
-			                        descriptor_set_id,
-			                        1, &descriptor_set_handle,
-			                        to_u32(dynamic_offsets.size()),
-			                        dynamic_offsets.data());
+			write_descriptor_sets.push_back(write_descriptor_set);
 		}
 	}
+
+	if (write_descriptor_sets.empty())
+	{
+		return;
+	}
+
+	vkCmdPushDescriptorSetKHR(get_handle(),
+	                          pipeline_bind_point,
+	                          pipeline_state.get_pipeline_layout().get_handle(),
+	                          descriptor_set_id,
+	                          to_u32(write_descriptor_sets.size()),
+	                          write_descriptor_sets.data());
+	bind_state.invalidate_descriptor_sets(pipeline_bind_point);
+}
+
+void CommandBuffer::flush_descriptor_buffers(VkPipelineBindPoint pipeline_bind_point)
+{
+	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+
+	// Gather the descriptor data of every set bound to the layout
+	std::vector<std::pair<uint32_t, std::vector<uint8_t>>> set_data;
+	VkDeviceSize                                           total_size = 0;
+
+	for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+	{
+		uint32_t descriptor_set_id = resource_set_it.first;
+		auto    &resource_set      = resource_set_it.second;
+
+		resource_binding_state.clear_dirty(descriptor_set_id);
+
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
+		}
+
+		auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+
+		descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+		BindingMap<VkDescriptorBufferInfo> buffer_infos;
+		BindingMap<VkDescriptorImageInfo>  image_infos;
+
+		std::vector<uint32_t> dynamic_offsets;
+
+		collect_descriptor_infos(descriptor_set_layout, resource_set, buffer_infos, image_infos, dynamic_offsets);
+
+		std::vector<uint8_t> data(to_u32(descriptor_set_layout.get_descriptor_buffer_size()));
+
+		for (auto &binding_it : buffer_infos)
+		{
+			auto         binding_info    = descriptor_set_layout.get_layout_binding(binding_it.first);
+			size_t       descriptor_size = get_descriptor_buffer_descriptor_size(binding_info->descriptorType);
+			VkDeviceSize binding_offset  = descriptor_set_layout.get_descriptor_buffer_binding_offset(binding_it.first);
+
+			for (auto &element_it : binding_it.second)
+			{
+				VkBufferDeviceAddressInfoKHR address_query{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR};
+				address_query.buffer = element_it.second.buffer;
+
+				VkDescriptorAddressInfoEXT address_info{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+				address_info.address = vkGetBufferDeviceAddressKHR(get_device().get_handle(), &address_query) + element_it.second.offset;
+				address_info.range   = element_it.second.range;
+
+				VkDescriptorGetInfoEXT descriptor_info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+				descriptor_info.type = binding_info->descriptorType;
+				if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				{
+					descriptor_info.data.pStorageBuffer = &address_info;
+				}
+				else
+				{
+					descriptor_info.data.pUniformBuffer = &address_info;
+				}
+
+				vkGetDescriptorEXT(get_device().get_handle(), &descriptor_info, descriptor_size, data.data() + binding_offset + element_it.first * descriptor_size);
+			}
+		}
+
+		for (auto &binding_it : image_infos)
+		{
+			auto         binding_info    = descriptor_set_layout.get_layout_binding(binding_it.first);
+			size_t       descriptor_size = get_descriptor_buffer_descriptor_size(binding_info->descriptorType);
+			VkDeviceSize binding_offset  = descriptor_set_layout.get_descriptor_buffer_binding_offset(binding_it.first);
+
+			for (auto &element_it : binding_it.second)
+			{
+				VkDescriptorGetInfoEXT descriptor_info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+				descriptor_info.type = binding_info->descriptorType;
+				switch (binding_info->descriptorType)
+				{
+					case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+						descriptor_info.data.pCombinedImageSampler = &element_it.second;
+						break;
+					case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+						descriptor_info.data.pSampledImage = &element_it.second;
+						break;
+					case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+						descriptor_info.data.pStorageImage = &element_it.second;
+						break;
+					case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+						descriptor_info.data.pInputAttachmentImage = &element_it.second;
+						break;
+					case VK_DESCRIPTOR_TYPE_SAMPLER:
+						descriptor_info.data.pSampler = &element_it.second.sampler;
+						break;
+					default:
+						continue;
+				}
+
+				vkGetDescriptorEXT(get_device().get_handle(), &descriptor_info, descriptor_size, data.data() + binding_offset + element_it.first * descriptor_size);
+			}
+		}
+
+		// Keep every set aligned to the descriptor buffer offset alignment
+		total_size += aligned_size(data.size(), descriptor_buffer_properties.descriptorBufferOffsetAlignment);
+		set_data.emplace_back(descriptor_set_id, std::move(data));
+	}
+
+	if (total_size == 0)
+	{
+		return;
+	}
+
+	auto allocation = command_pool.get_render_frame()->allocate_descriptor_buffer(total_size, command_pool.get_thread_index());
+	if (allocation.empty())
+	{
+		throw std::runtime_error("Failed to allocate descriptor buffer memory");
+	}
+
+	// The frame's descriptor heap may grow new blocks, rebind it whenever the allocation moves to one
+	if (bound_descriptor_buffer != allocation.get_buffer().get_handle())
+	{
+		VkDescriptorBufferBindingInfoEXT binding_info{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+		binding_info.address = allocation.get_buffer().get_device_address();
+		binding_info.usage   = RenderFrame::DESCRIPTOR_BUFFER_USAGE;
+
+		vkCmdBindDescriptorBuffersEXT(get_handle(), 1, &binding_info);
+
+		bound_descriptor_buffer = allocation.get_buffer().get_handle();
+	}
+
+	const uint32_t buffer_index = 0;
+	VkDeviceSize   set_offset   = 0;
+
+	for (auto &set_data_it : set_data)
+	{
+		allocation.update(set_data_it.second, to_u32(set_offset));
+
+		VkDeviceSize buffer_offset = allocation.get_offset() + set_offset;
+		vkCmdSetDescriptorBufferOffsetsEXT(get_handle(), pipeline_bind_point, pipeline_layout.get_handle(), set_data_it.first, 1, &buffer_index, &buffer_offset);
+
+		set_offset += aligned_size(set_data_it.second.size(), descriptor_buffer_properties.descriptorBufferOffsetAlignment);
+	}
+
+	bind_state.invalidate_descriptor_sets(pipeline_bind_point);
+}
+
+size_t CommandBuffer::get_descriptor_buffer_descriptor_size(VkDescriptorType descriptor_type) const
+{
+	switch (descriptor_type)
+	{
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			return descriptor_buffer_properties.uniformBufferDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			return descriptor_buffer_properties.storageBufferDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			return descriptor_buffer_properties.combinedImageSamplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			return descriptor_buffer_properties.sampledImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			return descriptor_buffer_properties.storageImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+			return descriptor_buffer_properties.inputAttachmentDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			return descriptor_buffer_properties.samplerDescriptorSize;
+		default:
+			throw std::runtime_error("Descriptor type not supported by the descriptor buffer backend");
+	}
 }
 
 void CommandBuffer::flush_push_constants()
@@ -759,6 +1106,8 @@ void CommandBuffer::end_query(const QueryPool &query_pool, uint32_t query)
 void CommandBuffer::write_timestamp(VkPipelineStageFlagBits pipeline_stage,
                                     const QueryPool &query_pool, uint32_t query)
 {
+	flush_barriers();
+
 	vkCmdWriteTimestamp(get_handle(), pipeline_stage, query_pool.get_handle(), query);
 }
 
@@ -768,6 +1117,8 @@ VkResult CommandBuffer::reset(ResetMode reset_mode)
 
 	assert(reset_mode == command_pool.get_reset_mode() && "Command buffer reset mode must match the one used by the pool to allocate it");
 
+	barrier_batch.clear();
+
 	if (reset_mode == ResetMode::ResetIndividually)
 	{
 		result = vkResetCommandBuffer(get_handle(), VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
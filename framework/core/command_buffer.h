@@ -21,6 +21,8 @@
 
 #include "common/helpers.h"
 #include "common/vk_common.h"
+#include "core/barrier_batch.h"
+#include "core/bind_state_cache.h"
 #include "core/buffer.h"
 #include "core/image.h"
 #include "core/image_view.h"
@@ -129,7 +131,27 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	void begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
-	void next_subpass();
+	void next_subpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+
+	/**
+	 * @return The command pool the command buffer was allocated from
+	 */
+	CommandPool &get_command_pool();
+
+	/**
+	 * @return How the commands of the current subpass are provided, inline or through secondary command buffers
+	 */
+	VkSubpassContents get_subpass_contents() const;
+
+	const RenderPassBinding &get_current_render_pass() const;
+
+	const uint32_t get_current_subpass_index() const;
+
+	/**
+	 * @brief Binds the resources bound on another command buffer, for instance on the secondary command buffers
+	 *        continuing the subpass of a primary one, as secondary command buffers do not inherit bindings
+	 */
+	void inherit_resource_bindings(CommandBuffer &command_buffer);
 
 	void execute_commands(CommandBuffer &secondary_command_buffer);
 
@@ -230,10 +252,39 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	void copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const vkb::core::BufferC &buffer, const std::vector<VkBufferImageCopy> &regions);
 
-	void image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier) const;
+	/**
+	 * @brief Records an image memory barrier, along with any barrier added before it
+	 */
+	void image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Records a buffer memory barrier, along with any barrier added before it
+	 */
 	void buffer_memory_barrier(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Adds an image memory barrier to the pending batch, recorded with the next command that needs it
+	 *        or with flush_barriers
+	 */
+	void add_image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
+
+	/**
+	 * @brief Adds a buffer memory barrier to the pending batch, recorded with the next command that needs it
+	 *        or with flush_barriers
+	 */
+	void add_buffer_memory_barrier(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
+
+	/**
+	 * @brief Records the pending barriers as a single pipeline barrier command
+	 *        Draws, dispatches, transfers, render pass begins and end call it implicitly
+	 */
+	void flush_barriers();
+
+	/**
+	 * @return The number of pipeline barrier commands recorded through this command buffer since it began
+	 */
+	uint32_t get_barrier_count() const;
+
 	void set_update_after_bind(bool update_after_bind_);
 
 	void reset_query_pool(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count);
@@ -279,9 +330,19 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
 
-	const RenderPassBinding &get_current_render_pass() const;
+	// Limits of VK_EXT_descriptor_buffer, only queried when the extension is enabled
+	VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
 
-	const uint32_t get_current_subpass_index() const;
+	// Descriptor heap block currently bound with vkCmdBindDescriptorBuffersEXT
+	VkBuffer bound_descriptor_buffer{VK_NULL_HANDLE};
+
+	// Barriers waiting for the next command that needs them
+	BarrierBatch barrier_batch;
+
+	VkSubpassContents subpass_contents{VK_SUBPASS_CONTENTS_INLINE};
+
+	// What is bound, to skip redundant bind commands
+	BindStateCache bind_state;
 
 	/**
 	 * @brief Check that the render area is an optimal size by comparing to the render area granularity
@@ -298,6 +359,31 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	 */
 	void flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Gather the buffer and image infos of a resource set, as described by its descriptor set layout
+	 */
+	void collect_descriptor_infos(const DescriptorSetLayout          &descriptor_set_layout,
+	                              const ResourceSet                  &resource_set,
+	                              BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                              BindingMap<VkDescriptorImageInfo>  &image_infos,
+	                              std::vector<uint32_t>              &dynamic_offsets) const;
+
+	/**
+	 * @brief Record the descriptors of a set straight into the command buffer (DescriptorBackend::PushDescriptor)
+	 */
+	void push_descriptor_set(VkPipelineBindPoint                       pipeline_bind_point,
+	                         uint32_t                                  descriptor_set_id,
+	                         const DescriptorSetLayout                &descriptor_set_layout,
+	                         const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                         const BindingMap<VkDescriptorImageInfo>  &image_infos);
+
+	/**
+	 * @brief Write all bound sets into the render frame's descriptor heap and point the layout at them (DescriptorBackend::DescriptorBuffer)
+	 */
+	void flush_descriptor_buffers(VkPipelineBindPoint pipeline_bind_point);
+
+	size_t get_descriptor_buffer_descriptor_size(VkDescriptorType descriptor_type) const;
+
 	/**
 	 * @brief Flush the push constant state
 	 */
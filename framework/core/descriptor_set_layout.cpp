@@ -97,9 +97,11 @@ inline bool validate_flags(const PhysicalDevice &gpu, const std::vector<VkDescri
 DescriptorSetLayout::DescriptorSetLayout(Device &                           device,
                                          const uint32_t                     set_index,
                                          const std::vector<ShaderModule *> &shader_modules,
-                                         const std::vector<ShaderResource> &resource_set) :
+                                         const std::vector<ShaderResource> &resource_set,
+                                         VkDescriptorSetLayoutCreateFlags   create_flags) :
     device{device},
     set_index{set_index},
+    create_flags{create_flags},
     shader_modules{shader_modules}
 {
 	// NOTE: `shader_modules` is passed in mainly for hashing their handles in `request_resource`.
@@ -151,7 +153,7 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	}
 
 	VkDescriptorSetLayoutCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-	create_info.flags        = 0;
+	create_info.flags        = create_flags;
 	create_info.bindingCount = to_u32(bindings.size());
 	create_info.pBindings    = bindings.data();
 
@@ -186,6 +188,19 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	{
 		throw VulkanException{result, "Cannot create DescriptorSetLayout"};
 	}
+
+	// Descriptor buffer layouts are written directly into buffer memory, so cache where each binding lives
+	if (create_flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
+	{
+		vkGetDescriptorSetLayoutSizeEXT(device.get_handle(), handle, &descriptor_buffer_size);
+
+		for (auto &binding : bindings)
+		{
+			VkDeviceSize binding_offset{0};
+			vkGetDescriptorSetLayoutBindingOffsetEXT(device.get_handle(), handle, binding.binding, &binding_offset);
+			descriptor_buffer_binding_offsets.emplace(binding.binding, binding_offset);
+		}
+	}
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -193,6 +208,9 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     shader_modules{other.shader_modules},
     handle{other.handle},
     set_index{other.set_index},
+    create_flags{other.create_flags},
+    descriptor_buffer_size{other.descriptor_buffer_size},
+    descriptor_buffer_binding_offsets{std::move(other.descriptor_buffer_binding_offsets)},
     bindings{std::move(other.bindings)},
     binding_flags{std::move(other.binding_flags)},
     bindings_lookup{std::move(other.bindings_lookup)},
@@ -272,4 +290,26 @@ const std::vector<ShaderModule *> &DescriptorSetLayout::get_shader_modules() con
 	return shader_modules;
 }
 
+VkDescriptorSetLayoutCreateFlags DescriptorSetLayout::get_create_flags() const
+{
+	return create_flags;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_size() const
+{
+	return descriptor_buffer_size;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_binding_offset(const uint32_t binding_index) const
+{
+	auto it = descriptor_buffer_binding_offsets.find(binding_index);
+
+	if (it == descriptor_buffer_binding_offsets.end())
+	{
+		throw std::runtime_error("Binding " + to_string(binding_index) + " is not part of the descriptor buffer layout");
+	}
+
+	return it->second;
+}
+
 }        // namespace vkb
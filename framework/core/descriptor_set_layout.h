@@ -41,11 +41,13 @@ class DescriptorSetLayout
 	 * @param set_index The descriptor set index this layout maps to
 	 * @param shader_modules The shader modules this set layout will be used for
 	 * @param resource_set A grouping of shader resources belonging to the same set
+	 * @param create_flags Additional layout flags, used to create push descriptor or descriptor buffer layouts
 	 */
 	DescriptorSetLayout(Device &                           device,
 	                    const uint32_t                     set_index,
 	                    const std::vector<ShaderModule *> &shader_modules,
-	                    const std::vector<ShaderResource> &resource_set);
+	                    const std::vector<ShaderResource> &resource_set,
+	                    VkDescriptorSetLayoutCreateFlags   create_flags = 0);
 
 	DescriptorSetLayout(const DescriptorSetLayout &) = delete;
 
@@ -73,6 +75,18 @@ class DescriptorSetLayout
 
 	const std::vector<ShaderModule *> &get_shader_modules() const;
 
+	VkDescriptorSetLayoutCreateFlags get_create_flags() const;
+
+	/**
+	 * @return The size in bytes this layout occupies in a descriptor buffer, 0 if it isn't a descriptor buffer layout
+	 */
+	VkDeviceSize get_descriptor_buffer_size() const;
+
+	/**
+	 * @return The byte offset of a binding within the layout's descriptor buffer memory
+	 */
+	VkDeviceSize get_descriptor_buffer_binding_offset(const uint32_t binding_index) const;
+
   private:
 	Device &device;
 
@@ -80,6 +94,12 @@ class DescriptorSetLayout
 
 	const uint32_t set_index;
 
+	VkDescriptorSetLayoutCreateFlags create_flags{0};
+
+	VkDeviceSize descriptor_buffer_size{0};
+
+	std::unordered_map<uint32_t, VkDeviceSize> descriptor_buffer_binding_offsets;
+
 	std::vector<VkDescriptorSetLayoutBinding> bindings;
 
 	std::vector<VkDescriptorBindingFlagsEXT> binding_flags;
@@ -84,32 +84,117 @@ Device::Device(PhysicalDevice                        &gpu,
 		LOGI("Dedicated Allocation enabled");
 	}
 
+	// Host query reset lets the render frames reset their GPU zone timestamps once read back
+	bool has_host_query_reset = false;
+	if (is_extension_supported("VK_EXT_host_query_reset") &&
+	    gpu.get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		// The feature structs promoted to Vulkan 1.2 must not be chained along with the Vulkan 1.2 features a sample may have requested
+		if (gpu.has_extension_features(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+		{
+			if (gpu.get_extension_features<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES).hostQueryReset)
+			{
+				gpu.add_extension_features<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES).hostQueryReset = VK_TRUE;
+				has_host_query_reset                                                                                                           = true;
+			}
+		}
+		else
+		{
+			auto host_query_reset_features =
+			    gpu.get_extension_features<VkPhysicalDeviceHostQueryResetFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES);
+
+			if (host_query_reset_features.hostQueryReset)
+			{
+				gpu.add_extension_features<VkPhysicalDeviceHostQueryResetFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES).hostQueryReset =
+				    VK_TRUE;
+				has_host_query_reset = true;
+			}
+		}
+
+		if (has_host_query_reset)
+		{
+			enabled_extensions.push_back("VK_EXT_host_query_reset");
+		}
+	}
+
+	// Calibrated timestamps place the GPU zones on the CPU timeline
+	if (is_extension_supported("VK_EXT_calibrated_timestamps"))
+	{
+		enabled_extensions.push_back("VK_EXT_calibrated_timestamps");
+	}
+
 	// For performance queries, we also use host query reset since queryPool resets cannot
 	// live in the same command buffer as beginQuery
-	if (is_extension_supported("VK_KHR_performance_query") &&
-	    is_extension_supported("VK_EXT_host_query_reset"))
+	if (is_extension_supported("VK_KHR_performance_query") && has_host_query_reset)
 	{
 		auto perf_counter_features =
 		    gpu.get_extension_features<VkPhysicalDevicePerformanceQueryFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR);
-		auto host_query_reset_features =
-		    gpu.get_extension_features<VkPhysicalDeviceHostQueryResetFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES);
 
-		if (perf_counter_features.performanceCounterQueryPools && host_query_reset_features.hostQueryReset)
+		if (perf_counter_features.performanceCounterQueryPools)
 		{
 			gpu.add_extension_features<VkPhysicalDevicePerformanceQueryFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR)
 			    .performanceCounterQueryPools = VK_TRUE;
-			gpu.add_extension_features<VkPhysicalDeviceHostQueryResetFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES).hostQueryReset =
-			    VK_TRUE;
 			enabled_extensions.push_back("VK_KHR_performance_query");
-			enabled_extensions.push_back("VK_EXT_host_query_reset");
 			LOGI("Performance query enabled");
 		}
 	}
 
+	// Pipeline layouts only bind through descriptor buffers if their features are enabled, see PipelineLayout
+	bool descriptor_buffer_requested =
+	    std::any_of(requested_extensions.begin(), requested_extensions.end(),
+	                [](const std::pair<const char *const, bool> &extension) { return strcmp(extension.first, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0; });
+	if (descriptor_buffer_requested && is_extension_supported(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+	    gpu.get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		bool has_buffer_device_address = false;
+		if (gpu.has_extension_features(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+		{
+			has_buffer_device_address = gpu.get_extension_features<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES).bufferDeviceAddress;
+		}
+		else
+		{
+			has_buffer_device_address = gpu.get_extension_features<VkPhysicalDeviceBufferDeviceAddressFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES).bufferDeviceAddress;
+		}
+
+		auto descriptor_buffer_features =
+		    gpu.get_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+
+		if (has_buffer_device_address && descriptor_buffer_features.descriptorBuffer)
+		{
+			if (gpu.has_extension_features(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+			{
+				gpu.add_extension_features<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES).bufferDeviceAddress = VK_TRUE;
+			}
+			else
+			{
+				gpu.add_extension_features<VkPhysicalDeviceBufferDeviceAddressFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES).bufferDeviceAddress = VK_TRUE;
+			}
+			gpu.add_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT).descriptorBuffer = VK_TRUE;
+
+			// The allocator only creates device addressable memory with the extension enabled
+			if (is_extension_supported(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+			{
+				enabled_extensions.push_back(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+			}
+
+			LOGI("Descriptor buffers enabled");
+		}
+		else
+		{
+			LOGW("VK_EXT_descriptor_buffer is supported without the descriptorBuffer or bufferDeviceAddress features, descriptor sets are bound from pools");
+		}
+	}
+
 	// Check that extensions are supported before trying to create the device
 	std::vector<const char *> unsupported_extensions{};
 	for (auto &extension : requested_extensions)
 	{
+		if (std::any_of(enabled_extensions.begin(), enabled_extensions.end(),
+		                [&extension](const char *enabled_extension) { return strcmp(enabled_extension, extension.first) == 0; }))
+		{
+			continue;
+		}
+
 		if (is_extension_supported(extension.first))
 		{
 			enabled_extensions.emplace_back(extension.first);
@@ -222,6 +307,20 @@ bool Device::is_enabled(const char *extension) const
 	return std::find_if(enabled_extensions.begin(), enabled_extensions.end(), [extension](const char *enabled_extension) { return strcmp(extension, enabled_extension) == 0; }) != enabled_extensions.end();
 }
 
+bool Device::is_synchronization2_enabled() const
+{
+	if (!is_enabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	// The feature may have been requested on its own or along with the other Vulkan 1.3 features
+	auto *synchronization2_features = gpu.get_requested_extension_features<VkPhysicalDeviceSynchronization2FeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR);
+	auto *vulkan13_features         = gpu.get_requested_extension_features<VkPhysicalDeviceVulkan13Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES);
+
+	return (synchronization2_features && synchronization2_features->synchronization2) || (vulkan13_features && vulkan13_features->synchronization2);
+}
+
 const PhysicalDevice &Device::get_gpu() const
 {
 	return gpu;
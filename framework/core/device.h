@@ -130,6 +130,11 @@ class Device : public vkb::core::VulkanResourceC<VkDevice>
 
 	bool is_enabled(const char *extension) const;
 
+	/**
+	 * @brief Checks whether the synchronization2 feature is enabled, which VK_KHR_synchronization2 alone does not do
+	 */
+	bool is_synchronization2_enabled() const;
+
 	uint32_t get_queue_family_index(VkQueueFlagBits queue_flag);
 
 	uint32_t get_num_queues_for_queue_family(uint32_t queue_family_index);
@@ -30,11 +30,18 @@ HPPCommandBuffer::HPPCommandBuffer(vkb::core::HPPCommandPool &command_pool, vk::
     VulkanResource(nullptr, &command_pool.get_device()),
     level(level),
     command_pool(command_pool),
-    max_push_constants_size(get_device().get_gpu().get_properties().limits.maxPushConstantsSize)
+    max_push_constants_size(get_device().get_gpu().get_properties().limits.maxPushConstantsSize),
+    barrier_batch(get_device().is_synchronization2_enabled())
 {
 	vk::CommandBufferAllocateInfo allocate_info(command_pool.get_handle(), level, 1);
 
 	set_handle(get_device().get_handle().allocateCommandBuffers(allocate_info).front());
+
+	if (get_device().is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+	{
+		descriptor_buffer_properties =
+		    get_device().get_gpu().get_handle().getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorBufferPropertiesEXT>().get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+	}
 }
 
 HPPCommandBuffer::HPPCommandBuffer(HPPCommandBuffer &&other) :
@@ -49,7 +56,11 @@ HPPCommandBuffer::HPPCommandBuffer(HPPCommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    descriptor_buffer_properties(other.descriptor_buffer_properties),
+    bound_descriptor_buffer(std::exchange(other.bound_descriptor_buffer, {})),
+    barrier_batch(std::move(other.barrier_batch)),
+    bind_state(std::move(other.bind_state))
 {
 }
 
@@ -82,6 +93,10 @@ vk::Result HPPCommandBuffer::begin(vk::CommandBufferUsageFlags flags, const vkb:
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 	stored_push_constants.clear();
+	bound_descriptor_buffer = nullptr;
+	barrier_batch.clear();
+	barrier_batch.reset_flush_count();
+	bind_state.clear();
 
 	vk::CommandBufferBeginInfo       begin_info(flags);
 	vk::CommandBufferInheritanceInfo inheritance;
@@ -98,6 +113,13 @@ vk::Result HPPCommandBuffer::begin(vk::CommandBufferUsageFlags flags, const vkb:
 		inheritance.subpass     = subpass_index;
 
 		begin_info.pInheritanceInfo = &inheritance;
+
+		// Pipelines recorded in the secondary command buffer are created for the subpass it continues
+		pipeline_state.set_subpass_index(subpass_index);
+
+		auto blend_state = pipeline_state.get_color_blend_state();
+		blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(subpass_index));
+		pipeline_state.set_color_blend_state(blend_state);
 	}
 
 	get_handle().begin(begin_info);
@@ -155,6 +177,7 @@ void HPPCommandBuffer::begin_render_pass(const vkb::rendering::HPPRenderTarget &
 	}
 
 	get_handle().beginRenderPass(begin_info, contents);
+	subpass_contents = contents;
 
 	// Update blend state attachments for first subpass
 	auto blend_state = pipeline_state.get_color_blend_state();
@@ -181,7 +204,7 @@ void HPPCommandBuffer::bind_image(const vkb::core::HPPImageView &image_view, uin
 
 void HPPCommandBuffer::bind_index_buffer(const vkb::core::BufferCpp &buffer, vk::DeviceSize offset, vk::IndexType index_type)
 {
-	get_handle().bindIndexBuffer(buffer.get_handle(), offset, index_type);
+	bind_state.bind_index_buffer(static_cast<VkCommandBuffer>(get_handle()), static_cast<VkBuffer>(buffer.get_handle()), offset, static_cast<VkIndexType>(index_type));
 }
 
 void HPPCommandBuffer::bind_input(const vkb::core::HPPImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
@@ -207,9 +230,9 @@ void HPPCommandBuffer::bind_vertex_buffers(uint32_t
                                            const std::vector<std::reference_wrapper<const vkb::core::BufferCpp>> &buffers,
                                            const std::vector<vk::DeviceSize>                                     &offsets)
 {
-	std::vector<vk::Buffer> buffer_handles(buffers.size(), nullptr);
-	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(), [](const vkb::core::BufferCpp &buffer) { return buffer.get_handle(); });
-	get_handle().bindVertexBuffers(first_binding, buffer_handles, offsets);
+	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
+	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(), [](const vkb::core::BufferCpp &buffer) { return static_cast<VkBuffer>(buffer.get_handle()); });
+	bind_state.bind_vertex_buffers(static_cast<VkCommandBuffer>(get_handle()), first_binding, buffer_handles, offsets);
 }
 
 void HPPCommandBuffer::blit_image(const vkb::core::HPPImage &src_img, const vkb::core::HPPImage &dst_img, const std::vector<vk::ImageBlit> &regions)
@@ -294,8 +317,12 @@ void HPPCommandBuffer::draw_indexed_indirect(const vkb::core::BufferCpp &buffer,
 
 vk::Result HPPCommandBuffer::end()
 {
+	barrier_batch.flush(static_cast<VkCommandBuffer>(get_handle()));
+
 	get_handle().end();
 
+	bind_state.report_counts();
+
 	return vk::Result::eSuccess;
 }
 
@@ -307,11 +334,17 @@ void HPPCommandBuffer::end_query(const vkb::core::HPPQueryPool &query_pool, uint
 void HPPCommandBuffer::end_render_pass()
 {
 	get_handle().endRenderPass();
+
+	// Commands outside of a render pass are always recorded inline
+	subpass_contents = vk::SubpassContents::eInline;
 }
 
 void HPPCommandBuffer::execute_commands(HPPCommandBuffer &secondary_command_buffer)
 {
 	get_handle().executeCommands(secondary_command_buffer.get_handle());
+
+	// The state bound by the secondary command buffer is undefined afterwards
+	bind_state.clear();
 }
 
 void HPPCommandBuffer::execute_commands(std::vector<HPPCommandBuffer *> &secondary_command_buffers)
@@ -322,6 +355,9 @@ void HPPCommandBuffer::execute_commands(std::vector<HPPCommandBuffer *> &seconda
 	               sec_cmd_buf_handles.begin(),
 	               [](const vkb::core::HPPCommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	get_handle().executeCommands(sec_cmd_buf_handles);
+
+	// The state bound by the secondary command buffers is undefined afterwards
+	bind_state.clear();
 }
 
 vkb::core::HPPRenderPass &HPPCommandBuffer::get_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
@@ -349,7 +385,12 @@ vkb::core::HPPRenderPass &HPPCommandBuffer::get_render_pass(const vkb::rendering
 	return get_device().get_resource_cache().request_render_pass(render_target.get_attachments(), load_store_infos, subpass_infos);
 }
 
-void HPPCommandBuffer::image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier) const
+vk::SubpassContents HPPCommandBuffer::get_subpass_contents() const
+{
+	return subpass_contents;
+}
+
+void HPPCommandBuffer::image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier)
 {
 	// Adjust barrier's subresource range for depth images
 	auto subresource_range = image_view.get_subresource_range();
@@ -363,22 +404,22 @@ void HPPCommandBuffer::image_memory_barrier(const vkb::core::HPPImageView &image
 		subresource_range.aspectMask = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
 	}
 
-	vk::ImageMemoryBarrier image_memory_barrier(memory_barrier.src_access_mask,
-	                                            memory_barrier.dst_access_mask,
-	                                            memory_barrier.old_layout,
-	                                            memory_barrier.new_layout,
-	                                            memory_barrier.old_queue_family,
-	                                            memory_barrier.new_queue_family,
-	                                            image_view.get_image().get_handle(),
-	                                            subresource_range);
+	vkb::ImageMemoryBarrier barrier;
+	barrier.src_stage_mask   = static_cast<VkPipelineStageFlags>(memory_barrier.src_stage_mask);
+	barrier.dst_stage_mask   = static_cast<VkPipelineStageFlags>(memory_barrier.dst_stage_mask);
+	barrier.src_access_mask  = static_cast<VkAccessFlags>(memory_barrier.src_access_mask);
+	barrier.dst_access_mask  = static_cast<VkAccessFlags>(memory_barrier.dst_access_mask);
+	barrier.old_layout       = static_cast<VkImageLayout>(memory_barrier.old_layout);
+	barrier.new_layout       = static_cast<VkImageLayout>(memory_barrier.new_layout);
+	barrier.old_queue_family = memory_barrier.old_queue_family;
+	barrier.new_queue_family = memory_barrier.new_queue_family;
 
-	vk::PipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	vk::PipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
-
-	get_handle().pipelineBarrier(src_stage_mask, dst_stage_mask, {}, {}, {}, image_memory_barrier);
+	// Recorded along with any barrier added through vkb::CommandBuffer before it
+	barrier_batch.add_image_barrier(static_cast<VkImage>(image_view.get_image().get_handle()), static_cast<VkImageSubresourceRange>(subresource_range), barrier, static_cast<VkCommandBuffer>(get_handle()));
+	barrier_batch.flush(static_cast<VkCommandBuffer>(get_handle()));
 }
 
-void HPPCommandBuffer::next_subpass()
+void HPPCommandBuffer::next_subpass(vk::SubpassContents contents)
 {
 	// Increment subpass index
 	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
@@ -395,7 +436,8 @@ void HPPCommandBuffer::next_subpass()
 	// Clear stored push constants
 	stored_push_constants.clear();
 
-	get_handle().nextSubpass(vk::SubpassContents::eInline);
+	get_handle().nextSubpass(contents);
+	subpass_contents = contents;
 }
 
 void HPPCommandBuffer::push_constants(const std::vector<uint8_t> &values)
@@ -417,6 +459,8 @@ vk::Result HPPCommandBuffer::reset(ResetMode reset_mode)
 {
 	assert(reset_mode == command_pool.get_reset_mode() && "Command buffer reset mode must match the one used by the pool to allocate it");
 
+	barrier_batch.clear();
+
 	if (reset_mode == ResetMode::ResetIndividually)
 	{
 		get_handle().reset(vk::CommandBufferResetFlagBits::eReleaseResources);
@@ -674,8 +718,10 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			vk::DescriptorSet descriptor_set_handle = command_pool.get_render_frame()->request_descriptor_set(
 			    descriptor_set_layout, buffer_infos, image_infos, update_after_bind, command_pool.get_thread_index());
 
-			// Bind descriptor set
-			get_handle().bindDescriptorSets(pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_id, descriptor_set_handle, dynamic_offsets);
+			// Bind descriptor set, unless the same set with the same offsets is bound already
+			bind_state.bind_descriptor_set(static_cast<VkCommandBuffer>(get_handle()), static_cast<VkPipelineBindPoint>(pipeline_bind_point),
+			                               static_cast<VkPipelineLayout>(pipeline_layout.get_handle()), descriptor_set_id,
+			                               static_cast<VkDescriptorSet>(descriptor_set_handle), dynamic_offsets);
 		}
 	}
 }
@@ -696,13 +742,13 @@ void HPPCommandBuffer::flush_pipeline_state(vk::PipelineBindPoint pipeline_bind_
 		pipeline_state.set_render_pass(*current_render_pass.render_pass);
 		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
 
-		get_handle().bindPipeline(pipeline_bind_point, pipeline.get_handle());
+		bind_state.bind_pipeline(static_cast<VkCommandBuffer>(get_handle()), static_cast<VkPipelineBindPoint>(pipeline_bind_point), static_cast<VkPipeline>(pipeline.get_handle()));
 	}
 	else if (pipeline_bind_point == vk::PipelineBindPoint::eCompute)
 	{
 		auto &pipeline = get_device().get_resource_cache().request_compute_pipeline(pipeline_state);
 
-		get_handle().bindPipeline(pipeline_bind_point, pipeline.get_handle());
+		bind_state.bind_pipeline(static_cast<VkCommandBuffer>(get_handle()), static_cast<VkPipelineBindPoint>(pipeline_bind_point), static_cast<VkPipeline>(pipeline.get_handle()));
 	}
 	else
 	{
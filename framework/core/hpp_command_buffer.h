@@ -18,6 +18,8 @@
 #pragma once
 
 #include <common/hpp_vk_common.h>
+#include <core/barrier_batch.h>
+#include <core/bind_state_cache.h>
 #include <core/hpp_framebuffer.h>
 #include <core/hpp_query_pool.h>
 #include <hpp_resource_binding_state.h>
@@ -139,8 +141,9 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	vkb::core::HPPRenderPass &get_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
 	                                          const std::vector<vkb::common::HPPLoadStoreInfo>               &load_store_infos,
 	                                          const std::vector<std::unique_ptr<vkb::rendering::SubpassCpp>> &subpasses);
-	void                      image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier) const;
-	void                      next_subpass();
+	vk::SubpassContents       get_subpass_contents() const;
+	void                      image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier);
+	void                      next_subpass(vk::SubpassContents contents = vk::SubpassContents::eInline);
 
 	/**
 	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
@@ -240,6 +243,18 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	bool update_after_bind = false;
 
 	std::unordered_map<uint32_t, vkb::core::HPPDescriptorSetLayout const *> descriptor_set_layout_binding_state;
+
+	// The members below mirror the ones of vkb::CommandBuffer, as both classes are reinterpret_cast to each other
+	vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties;
+	vk::Buffer                                      bound_descriptor_buffer;
+
+	// Barriers added through vkb::CommandBuffer, waiting for the next command that needs them
+	vkb::BarrierBatch barrier_batch;
+
+	vk::SubpassContents subpass_contents = vk::SubpassContents::eInline;
+
+	// What is bound, to skip redundant bind commands
+	vkb::BindStateCache bind_state;
 };
 
 template <class T>
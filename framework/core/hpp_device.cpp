@@ -85,27 +85,103 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 		LOGI("Dedicated Allocation enabled");
 	}
 
+	// Host query reset lets the render frames reset their GPU zone timestamps once read back
+	bool has_host_query_reset = false;
+	if (is_extension_supported(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) &&
+	    gpu.get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		// The feature structs promoted to Vulkan 1.2 must not be chained along with the Vulkan 1.2 features a sample may have requested
+		if (gpu.has_extension_features<vk::PhysicalDeviceVulkan12Features>())
+		{
+			if (gpu.get_extension_features<vk::PhysicalDeviceVulkan12Features>().hostQueryReset)
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceVulkan12Features>().hostQueryReset = true;
+				has_host_query_reset                                                            = true;
+			}
+		}
+		else if (gpu.get_extension_features<vk::PhysicalDeviceHostQueryResetFeatures>().hostQueryReset)
+		{
+			gpu.add_extension_features<vk::PhysicalDeviceHostQueryResetFeatures>().hostQueryReset = true;
+			has_host_query_reset                                                                  = true;
+		}
+
+		if (has_host_query_reset)
+		{
+			enabled_extensions.push_back(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME);
+		}
+	}
+
+	// Calibrated timestamps place the GPU zones on the CPU timeline
+	if (is_extension_supported(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+	{
+		enabled_extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+	}
+
 	// For performance queries, we also use host query reset since queryPool resets cannot
 	// live in the same command buffer as beginQuery
-	if (is_extension_supported(VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME) && is_extension_supported(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME))
+	if (is_extension_supported(VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME) && has_host_query_reset)
 	{
-		auto perf_counter_features     = gpu.get_extension_features<vk::PhysicalDevicePerformanceQueryFeaturesKHR>();
-		auto host_query_reset_features = gpu.get_extension_features<vk::PhysicalDeviceHostQueryResetFeatures>();
-
-		if (perf_counter_features.performanceCounterQueryPools && host_query_reset_features.hostQueryReset)
+		if (gpu.get_extension_features<vk::PhysicalDevicePerformanceQueryFeaturesKHR>().performanceCounterQueryPools)
 		{
 			gpu.add_extension_features<vk::PhysicalDevicePerformanceQueryFeaturesKHR>().performanceCounterQueryPools = true;
-			gpu.add_extension_features<vk::PhysicalDeviceHostQueryResetFeatures>().hostQueryReset                    = true;
 			enabled_extensions.push_back(VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
-			enabled_extensions.push_back(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME);
 			LOGI("Performance query enabled");
 		}
 	}
 
+	// Pipeline layouts only bind through descriptor buffers if their features are enabled, see vkb::PipelineLayout
+	bool descriptor_buffer_requested =
+	    std::any_of(requested_extensions.begin(), requested_extensions.end(),
+	                [](const std::pair<const char *const, bool> &extension) { return strcmp(extension.first, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0; });
+	if (descriptor_buffer_requested && is_extension_supported(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+	    gpu.get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		bool has_buffer_device_address = false;
+		if (gpu.has_extension_features<vk::PhysicalDeviceVulkan12Features>())
+		{
+			has_buffer_device_address = gpu.get_extension_features<vk::PhysicalDeviceVulkan12Features>().bufferDeviceAddress;
+		}
+		else
+		{
+			has_buffer_device_address = gpu.get_extension_features<vk::PhysicalDeviceBufferDeviceAddressFeatures>().bufferDeviceAddress;
+		}
+
+		if (has_buffer_device_address && gpu.get_extension_features<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>().descriptorBuffer)
+		{
+			if (gpu.has_extension_features<vk::PhysicalDeviceVulkan12Features>())
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceVulkan12Features>().bufferDeviceAddress = true;
+			}
+			else
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceBufferDeviceAddressFeatures>().bufferDeviceAddress = true;
+			}
+			gpu.add_extension_features<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>().descriptorBuffer = true;
+
+			// The allocator only creates device addressable memory with the extension enabled
+			if (is_extension_supported(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+			{
+				enabled_extensions.push_back(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+			}
+
+			LOGI("Descriptor buffers enabled");
+		}
+		else
+		{
+			LOGW("VK_EXT_descriptor_buffer is supported without the descriptorBuffer or bufferDeviceAddress features, descriptor sets are bound from pools");
+		}
+	}
+
 	// Check that extensions are supported before trying to create the device
 	std::vector<const char *> unsupported_extensions{};
 	for (auto &extension : requested_extensions)
 	{
+		if (std::any_of(enabled_extensions.begin(), enabled_extensions.end(),
+		                [&extension](const char *enabled_extension) { return strcmp(enabled_extension, extension.first) == 0; }))
+		{
+			continue;
+		}
+
 		if (is_extension_supported(extension.first))
 		{
 			enabled_extensions.emplace_back(extension.first);
@@ -161,7 +237,7 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 	{
 		vk::QueueFamilyProperties const &queue_family_property = queue_family_properties[queue_family_index];
 
-		vk::Bool32 present_supported = gpu.get_handle().getSurfaceSupportKHR(queue_family_index, surface);
+		vk::Bool32 present_supported = surface ? gpu.get_handle().getSurfaceSupportKHR(queue_family_index, surface) : false;
 
 		for (uint32_t queue_index = 0U; queue_index < queue_family_property.queueCount; ++queue_index)
 		{
@@ -203,6 +279,20 @@ bool HPPDevice::is_enabled(std::string const &extension) const
 	                    [extension](const char *enabled_extension) { return extension == enabled_extension; }) != enabled_extensions.end();
 }
 
+bool HPPDevice::is_synchronization2_enabled() const
+{
+	if (!is_enabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	// The feature may have been requested on its own or along with the other Vulkan 1.3 features
+	auto *synchronization2_features = gpu.get_requested_extension_features<vk::PhysicalDeviceSynchronization2FeaturesKHR>();
+	auto *vulkan13_features         = gpu.get_requested_extension_features<vk::PhysicalDeviceVulkan13Features>();
+
+	return (synchronization2_features && synchronization2_features->synchronization2) || (vulkan13_features && vulkan13_features->synchronization2);
+}
+
 vkb::core::HPPPhysicalDevice const &HPPDevice::get_gpu() const
 {
 	return gpu;
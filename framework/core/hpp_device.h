@@ -81,6 +81,11 @@ class HPPDevice : public vkb::core::VulkanResourceCpp<vk::Device>
 
 	bool is_enabled(std::string const &extension) const;
 
+	/**
+	 * @brief Checks whether the synchronization2 feature is enabled, which VK_KHR_synchronization2 alone does not do
+	 */
+	bool is_synchronization2_enabled() const;
+
 	uint32_t get_queue_family_index(vk::QueueFlagBits queue_flag) const;
 
 	vkb::core::HPPCommandPool &get_command_pool();
@@ -149,6 +149,27 @@ class HPPPhysicalDevice
 		return *static_cast<HPPStructureType *>(it->second.get());
 	}
 
+	/**
+	 * @brief Check whether an extension features struct is in the structure chain used for device creation
+	 * @returns True if the struct was added with HPPPhysicalDevice::add_extension_features()
+	 */
+	template <typename HPPStructureType>
+	bool has_extension_features() const
+	{
+		return extension_features.find(HPPStructureType::structureType) != extension_features.end();
+	}
+
+	/**
+	 * @brief Get an extension features struct from the structure chain used for device creation
+	 * @returns The struct with the requested flags set, or nullptr if it was not added with HPPPhysicalDevice::add_extension_features()
+	 */
+	template <typename HPPStructureType>
+	HPPStructureType const *get_requested_extension_features() const
+	{
+		auto it = extension_features.find(HPPStructureType::structureType);
+		return it != extension_features.end() ? static_cast<HPPStructureType const *>(it->second.get()) : nullptr;
+	}
+
 	/**
 	 * @brief Request an optional features flag
 	 *
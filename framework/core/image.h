@@ -168,6 +168,8 @@ class Image : public allocated::Allocated<VkImage>
 
 	VkImageUsageFlags get_usage() const;
 
+	VkImageCreateFlags get_flags() const;
+
 	VkImageTiling get_tiling() const;
 
 	const VkImageSubresource &get_subresource() const;
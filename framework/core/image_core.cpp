@@ -174,6 +174,11 @@ VkImageUsageFlags Image::get_usage() const
 	return create_info.usage;
 }
 
+VkImageCreateFlags Image::get_flags() const
+{
+	return create_info.flags;
+}
+
 VkImageTiling Image::get_tiling() const
 {
 	return create_info.tiling;
@@ -56,6 +56,21 @@ ImageView::ImageView(Image &img, VkImageViewType view_type, VkFormat format,
 	view_info.format           = format;
 	view_info.subresourceRange = subresource_range;
 
+	// Images created with extended usage may have usages their own format does not support, such as storage on sRGB images
+	// written through UNORM views, which views of that format must not inherit
+	VkImageViewUsageCreateInfo usage_info{VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO};
+	if ((image->get_flags() & VK_IMAGE_CREATE_EXTENDED_USAGE_BIT) && (image->get_usage() & VK_IMAGE_USAGE_STORAGE_BIT))
+	{
+		const VkFormatProperties   properties = get_device().get_gpu().get_format_properties(format);
+		const VkFormatFeatureFlags features   = image->get_tiling() == VK_IMAGE_TILING_LINEAR ? properties.linearTilingFeatures : properties.optimalTilingFeatures;
+
+		if (!(features & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+		{
+			usage_info.usage = image->get_usage() & ~VK_IMAGE_USAGE_STORAGE_BIT;
+			view_info.pNext  = &usage_info;
+		}
+	}
+
 	auto result = vkCreateImageView(get_device().get_handle(), &view_info, nullptr, &get_handle());
 
 	if (result != VK_SUCCESS)
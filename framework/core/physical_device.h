@@ -106,6 +106,32 @@ class PhysicalDevice
 		return features;
 	}
 
+	/**
+	 * @brief Get an extension properties struct
+	 *
+	 *        Gets the actual extension properties struct (e.g. the limits of an extension) for this GPU.
+	 * @param type The VkStructureType for the extension properties you are requesting
+	 * @returns The extension properties struct
+	 */
+	template <typename T>
+	T get_extension_properties(VkStructureType type) const
+	{
+		// We cannot request extension properties if the physical device properties 2 instance extension isn't enabled
+		if (!instance.is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+		{
+			throw std::runtime_error("Couldn't request properties from device as " + std::string(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) +
+			                         " isn't enabled!");
+		}
+
+		// Get the extension properties
+		T                              properties{type};
+		VkPhysicalDeviceProperties2KHR physical_device_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+		physical_device_properties.pNext = &properties;
+		vkGetPhysicalDeviceProperties2KHR(handle, &physical_device_properties);
+
+		return properties;
+	}
+
 	/**
 	 * @brief Add an extension features struct to the structure chain used for device creation
 	 *
@@ -144,6 +170,28 @@ class PhysicalDevice
 		return *static_cast<T *>(it->second.get());
 	}
 
+	/**
+	 * @brief Check whether an extension features struct is in the structure chain used for device creation
+	 * @param type The VkStructureType of the extension features struct
+	 * @returns True if the struct was added with PhysicalDevice::add_extension_features()
+	 */
+	bool has_extension_features(VkStructureType type) const
+	{
+		return extension_features.find(type) != extension_features.end();
+	}
+
+	/**
+	 * @brief Get an extension features struct from the structure chain used for device creation
+	 * @param type The VkStructureType of the extension features struct
+	 * @returns The struct with the requested flags set, or nullptr if it was not added with PhysicalDevice::add_extension_features()
+	 */
+	template <typename T>
+	const T *get_requested_extension_features(VkStructureType type) const
+	{
+		auto it = extension_features.find(type);
+		return it != extension_features.end() ? static_cast<const T *>(it->second.get()) : nullptr;
+	}
+
 	/**
 	 * @brief Request an optional features flag
 	 *
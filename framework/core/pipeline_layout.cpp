@@ -78,10 +78,24 @@ PipelineLayout::PipelineLayout(Device &device, const std::vector<ShaderModule *>
 		}
 	}
 
+	uint32_t push_descriptor_set_index = 0;
+	descriptor_backend                 = select_descriptor_backend(push_descriptor_set_index);
+
 	// Create a descriptor set layout for each shader set in the shader modules
 	for (auto &shader_set_it : shader_sets)
 	{
-		descriptor_set_layouts.emplace_back(&device.get_resource_cache().request_descriptor_set_layout(shader_set_it.first, shader_modules, shader_set_it.second));
+		// Every set of a descriptor buffer layout must use descriptor buffers, but a layout may only have one push descriptor set
+		VkDescriptorSetLayoutCreateFlags set_layout_flags = 0;
+		if (descriptor_backend == DescriptorBackend::PushDescriptor && shader_set_it.first == push_descriptor_set_index)
+		{
+			set_layout_flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+		}
+		else if (descriptor_backend == DescriptorBackend::DescriptorBuffer)
+		{
+			set_layout_flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+		}
+
+		descriptor_set_layouts.emplace_back(&device.get_resource_cache().request_descriptor_set_layout(shader_set_it.first, shader_modules, shader_set_it.second, set_layout_flags));
 	}
 
 	// Collect all the descriptor set layout handles, maintaining set order
@@ -127,7 +141,8 @@ PipelineLayout::PipelineLayout(PipelineLayout &&other) :
     shader_modules{std::move(other.shader_modules)},
     shader_resources{std::move(other.shader_resources)},
     shader_sets{std::move(other.shader_sets)},
-    descriptor_set_layouts{std::move(other.descriptor_set_layouts)}
+    descriptor_set_layouts{std::move(other.descriptor_set_layouts)},
+    descriptor_backend{other.descriptor_backend}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -206,4 +221,79 @@ VkShaderStageFlags PipelineLayout::get_push_constant_range_stage(uint32_t size,
 	}
 	return stages;
 }
+
+DescriptorBackend PipelineLayout::get_descriptor_backend() const
+{
+	return descriptor_backend;
+}
+
+DescriptorBackend PipelineLayout::select_descriptor_backend(uint32_t &push_descriptor_set_index) const
+{
+	std::vector<DescriptorSetUsage> sets;
+
+	for (auto &shader_set_it : shader_sets)
+	{
+		DescriptorSetUsage set{};
+		set.set_index = shader_set_it.first;
+
+		bool set_has_descriptors = false;
+
+		for (auto &resource : shader_set_it.second)
+		{
+			if (resource.type == ShaderResourceType::Input ||
+			    resource.type == ShaderResourceType::Output ||
+			    resource.type == ShaderResourceType::PushConstant ||
+			    resource.type == ShaderResourceType::SpecializationConstant)
+			{
+				continue;
+			}
+
+			set_has_descriptors = true;
+			set.descriptor_count += resource.array_size;
+
+			if (resource.mode == ShaderResourceMode::Dynamic || resource.mode == ShaderResourceMode::UpdateAfterBind)
+			{
+				set.dynamic_or_update_after_bind = true;
+			}
+
+			// The descriptor buffer path only knows the size and encoding of these descriptor types
+			switch (resource.type)
+			{
+				case ShaderResourceType::InputAttachment:
+				case ShaderResourceType::Image:
+				case ShaderResourceType::ImageSampler:
+				case ShaderResourceType::ImageStorage:
+				case ShaderResourceType::Sampler:
+				case ShaderResourceType::BufferUniform:
+				case ShaderResourceType::BufferStorage:
+					break;
+				default:
+					set.buffer_encodable = false;
+					break;
+			}
+		}
+
+		if (set_has_descriptors)
+		{
+			sets.push_back(set);
+		}
+	}
+
+	DescriptorBackendSupport support{};
+
+	if (device.is_enabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME))
+	{
+		support.push_descriptor      = true;
+		support.max_push_descriptors = device.get_gpu().get_extension_properties<VkPhysicalDevicePushDescriptorPropertiesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR).maxPushDescriptors;
+	}
+
+	// The device enables the features along with the extension when they are supported, see Device::Device
+	if (device.is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+	{
+		auto *descriptor_buffer_features = device.get_gpu().get_requested_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+		support.descriptor_buffer        = descriptor_buffer_features && descriptor_buffer_features->descriptorBuffer;
+	}
+
+	return vkb::select_descriptor_backend(sets, support, push_descriptor_set_index);
+}
 }        // namespace vkb
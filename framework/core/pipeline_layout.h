@@ -21,6 +21,7 @@
 #include "common/vk_common.h"
 #include "core/descriptor_set_layout.h"
 #include "core/shader_module.h"
+#include "core/util/descriptor_backend.hpp"
 
 namespace vkb
 {
@@ -57,6 +58,12 @@ class PipelineLayout
 
 	VkShaderStageFlags get_push_constant_range_stage(uint32_t size, uint32_t offset = 0) const;
 
+	/**
+	 * @brief The backend is selected at creation from the enabled device extensions and the shape of the layout
+	 * @return The descriptor backend used to bind the sets of this pipeline layout
+	 */
+	DescriptorBackend get_descriptor_backend() const;
+
   private:
 	Device &device;
 
@@ -73,5 +80,13 @@ class PipelineLayout
 
 	// The different descriptor set layouts for this pipeline layout
 	std::vector<DescriptorSetLayout *> descriptor_set_layouts;
+
+	DescriptorBackend descriptor_backend{DescriptorBackend::Pool};
+
+	/**
+	 * @brief Selects the descriptor backend of the layout
+	 * @param push_descriptor_set_index Set to the index of the only set with descriptors, which is pushed with DescriptorBackend::PushDescriptor
+	 */
+	DescriptorBackend select_descriptor_backend(uint32_t &push_descriptor_set_index) const;
 };
 }        // namespace vkb
@@ -24,6 +24,8 @@
 #include <glslang/OSDependent/osinclude.h>
 #include <glslang/Public/ResourceLimits.h>
 
+#include <core/util/startup_profiler.hpp>
+
 namespace vkb
 {
 namespace
@@ -102,6 +104,8 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     std::vector<std::uint32_t> &spirv,
                                     std::string                &info_log)
 {
+	PROFILE_STARTUP_SCOPE("Compile GLSL shader");
+
 	// Initialize glslang library.
 	glslang::InitializeProcess();
 
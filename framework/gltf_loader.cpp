@@ -19,15 +19,34 @@
 #define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
 
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <exception>
 #include <limits>
+#include <mutex>
 #include <queue>
 
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+
+#	include <psapi.h>
+#else
+#	include <sys/resource.h>
+#endif
+
 #include "common/error.h"
 
 #include "common/glm_common.h"
 #include <glm/gtc/type_ptr.hpp>
 
+#include <core/util/mesh_optimizer.hpp>
+#include <core/util/meshlet_builder.hpp>
 #include <core/util/profiling.hpp>
+#include <core/util/startup_profiler.hpp>
 
 #include "api_vulkan_sample.h"
 #include "common/utils.h"
@@ -35,10 +54,14 @@
 #include "core/device.h"
 #include "core/image.h"
 #include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
 #include "filesystem/legacy.h"
+#include "rendering/mipmap_generator.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/image/astc.h"
+#include "scene_graph/components/image/ktx.h"
+#include "scene_graph/components/image/stb.h"
 #include "scene_graph/components/light.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
@@ -51,12 +74,86 @@
 #include "scene_graph/scene.h"
 #include "scene_graph/scripts/animation.h"
 
-#include <ctpl_stl.h>
+#include <core/util/job_system.hpp>
 
 namespace vkb
 {
 namespace
 {
+// Binary glTF container, see https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#glb-file-format-specification
+constexpr uint32_t GLB_MAGIC      = 0x46546C67;        // "glTF"
+constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;        // "JSON"
+constexpr uint32_t GLB_CHUNK_BIN  = 0x004E4942;        // "BIN\0"
+
+// A one byte data URI standing in for buffers that are read in place
+constexpr const char *GLB_STUB_BUFFER_URI = "data:application/octet-stream;base64,AA==";
+
+struct GlbHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t length;
+};
+
+struct GlbChunkHeader
+{
+	uint32_t length;
+	uint32_t type;
+};
+
+/**
+ * @return The peak resident memory of the process in bytes, 0 if unknown
+ */
+size_t get_peak_resident_memory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#	if defined(__APPLE__)
+	return static_cast<size_t>(usage.ru_maxrss);
+#	else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#	endif
+#endif
+}
+
+inline bool is_glb_file(const std::string &file_name)
+{
+	auto extension = file_name.substr(file_name.find_last_of('.') + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == "glb";
+}
+
+/**
+ * @brief Copies elements of src_stride bytes into elements of dst_stride bytes, zero extending them
+ *        Used to widen little endian indices while writing them to their buffer
+ */
+inline void copy_with_stride(const uint8_t *src, size_t count, size_t src_stride, uint8_t *dst, size_t dst_stride)
+{
+	if (src_stride == dst_stride)
+	{
+		std::memcpy(dst, src, count * src_stride);
+		return;
+	}
+
+	size_t element_size = std::min(src_stride, dst_stride);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::memcpy(dst + i * dst_stride, src + i * src_stride, element_size);
+		std::memset(dst + i * dst_stride + element_size, 0, dst_stride - element_size);
+	}
+}
+
 inline VkFilter find_min_filter(int min_filter)
 {
 	switch (min_filter)
@@ -117,22 +214,6 @@ inline VkSamplerAddressMode find_wrap_mode(int wrap)
 	}
 };
 
-inline std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uint32_t accessorId)
-{
-	assert(accessorId < model->accessors.size());
-	auto &accessor = model->accessors[accessorId];
-	assert(accessor.bufferView < model->bufferViews.size());
-	auto &bufferView = model->bufferViews[accessor.bufferView];
-	assert(bufferView.buffer < model->buffers.size());
-	auto &buffer = model->buffers[bufferView.buffer];
-
-	size_t stride    = accessor.ByteStride(bufferView);
-	size_t startByte = accessor.byteOffset + bufferView.byteOffset;
-	size_t endByte   = startByte + accessor.count * stride;
-
-	return {buffer.data.begin() + startByte, buffer.data.begin() + endByte};
-};
-
 inline size_t get_attribute_size(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
@@ -269,23 +350,7 @@ inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t acce
 	return format;
 };
 
-inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uint8_t> &src_data, uint32_t src_stride, uint32_t dst_stride)
-{
-	auto elem_count = to_u32(src_data.size()) / src_stride;
-
-	std::vector<uint8_t> result(elem_count * dst_stride);
-
-	for (uint32_t idxSrc = 0, idxDst = 0;
-	     idxSrc < src_data.size() && idxDst < result.size();
-	     idxSrc += src_stride, idxDst += dst_stride)
-	{
-		std::copy(src_data.begin() + idxSrc, src_data.begin() + idxSrc + src_stride, result.begin() + idxDst);
-	}
-
-	return result;
-}
-
-inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::BufferC &staging_buffer, sg::Image &image)
+inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::BufferC &staging_buffer, sg::Image &image, MipmapGenerator &mipmap_generator, bool srgb)
 {
 	// Clean up the image data, as they are copied in the staging buffer
 	image.clear_data();
@@ -321,6 +386,14 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::Buffer
 
 	command_buffer.copy_buffer_to_image(staging_buffer, image.get_vk_image(), buffer_copy_regions);
 
+	// Levels missing from the data are generated from the base level in the same submission
+	if (image.get_vk_image().get_subresource().mipLevel > mipmaps.size())
+	{
+		auto method = MipmapGenerator::get_method(command_buffer.get_device(), image.get_format(), srgb);
+		mipmap_generator.record(command_buffer.get_handle(), image.get_vk_image(), method, srgb);
+		return;
+	}
+
 	{
 		ImageMemoryBarrier memory_barrier{};
 		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
@@ -334,53 +407,34 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::Buffer
 	}
 }
 
-inline void prepare_meshlets(std::vector<Meshlet> &meshlets, std::unique_ptr<vkb::sg::SubMesh> &submesh, std::vector<unsigned char> &index_data)
+inline void prepare_meshlets(std::vector<Meshlet> &meshlets, const MeshletSource &source)
 {
-	Meshlet meshlet;
-	meshlet.vertex_count = 0;
-	meshlet.index_count  = 0;
+	// 32 triangles, because for each triangle the mesh shader sample draws a line, 32 lines per meshlet = 64 vertices on output
+	MeshletOptions options;
+	options.max_vertices  = 64;
+	options.max_triangles = 32;
 
-	std::set<uint32_t> vertices;                  // set for unique vertices
-	uint32_t           triangle_check = 0;        // each meshlet needs to contain full primitives
+	auto mesh = build_meshlets(source, options);
 
-	for (uint32_t i = 0; i < submesh->vertex_indices; i++)
+	meshlets.resize(mesh.meshlets.size());
+	for (size_t i = 0; i < mesh.meshlets.size(); ++i)
 	{
-		// index_data is unsigned char type, casting to uint32_t* will give proper value
-		meshlet.indices[meshlet.index_count] = *(reinterpret_cast<uint32_t *>(index_data.data()) + i);
-
-		if (vertices.insert(meshlet.indices[meshlet.index_count]).second)
+		auto &range   = mesh.meshlets[i];
+		auto &bounds  = mesh.bounds[i];
+		auto &meshlet = meshlets[i];
+
+		// The shader reads vertex indices, not indices local to the meshlet
+		meshlet.vertex_count = range.vertex_count;
+		meshlet.index_count  = range.triangle_count * 3;
+		std::copy_n(&mesh.vertices[range.vertex_offset], range.vertex_count, meshlet.vertices);
+		for (uint32_t j = 0; j < meshlet.index_count; ++j)
 		{
-			++meshlet.vertex_count;
+			meshlet.indices[j] = mesh.vertices[range.vertex_offset + mesh.triangles[range.triangle_offset * 3 + j]];
 		}
 
-		meshlet.index_count++;
-		triangle_check = triangle_check < 3 ? ++triangle_check : 1;
-
-		// 96 because for each traingle we draw a line in a mesh shader sample, 32 triangles/lines per meshlet = 64 vertices on output
-		if (meshlet.vertex_count == 64 || meshlet.index_count == 96 || i == submesh->vertex_indices - 1)
-		{
-			if (i == submesh->vertex_indices - 1)
-			{
-				assert(triangle_check == 3);
-			}
-
-			uint32_t counter = 0;
-			for (auto v : vertices)
-			{
-				meshlet.vertices[counter++] = v;
-			}
-			if (triangle_check != 3)
-			{
-				meshlet.index_count -= triangle_check;
-				i -= triangle_check;
-				triangle_check = 0;
-			}
-
-			meshlets.push_back(meshlet);
-			meshlet.vertex_count = 0;
-			meshlet.index_count  = 0;
-			vertices.clear();
-		}
+		meshlet.bounding_sphere  = glm::vec4(glm::make_vec3(bounds.center), bounds.radius);
+		meshlet.cone_apex        = glm::vec4(glm::make_vec3(bounds.cone_apex), 0.0f);
+		meshlet.cone_axis_cutoff = glm::vec4(glm::make_vec3(bounds.cone_axis), bounds.cone_cutoff);
 	}
 }
 
@@ -398,20 +452,522 @@ static inline bool texture_needs_srgb_colorspace(const std::string &name)
 	return false;
 }
 
+inline std::unique_ptr<sg::Image> create_placeholder_image(Device &device, const std::string &name, const std::array<uint8_t, 4> &color)
+{
+	auto image = std::make_unique<sg::Image>(name, std::vector<uint8_t>(color.begin(), color.end()), std::vector<sg::Mipmap>{{0, 0, {1, 1, 1}}});
+	image->set_format(VK_FORMAT_R8G8B8A8_UNORM);
+	image->create_vk_image(device);
+	return image;
+}
 }        // namespace
 
 std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
-    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false}};
+    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false},
+    {KHR_TEXTURE_BASISU_EXTENSION, false}};
+
+struct GLTFLoader::StreamingState
+{
+	struct Job
+	{
+		enum class Type
+		{
+			Mesh,
+			Image
+		};
+
+		Type type;
+
+		size_t index;
+
+		// Screen size estimate of the mesh, or of the largest mesh using the image
+		float priority{0.0f};
+
+		bool started{false};
+	};
+
+	StreamingState(Device &device) :
+	    command_pool{device, device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_family_index()},
+	    mipmap_generator{device}
+	{}
+
+	// Set by load_scene
+	sg::Scene                     *scene{nullptr};
+	VkBufferUsageFlags             additional_buffer_usage_flags{0};
+	VkFormat                       normal_format{VK_FORMAT_UNDEFINED};
+	std::vector<bool>              srgb_images;
+	std::vector<sg::Image *>       placeholders;
+	std::vector<sg::PBRMaterial *> materials;
+	sg::PBRMaterial               *default_material{nullptr};
+
+	// Set by read_scene_from_file_async
+	std::vector<sg::Mesh *>                 meshes;
+	std::vector<std::vector<sg::Texture *>> image_textures;
+	std::vector<std::vector<size_t>>        image_meshes;
+	std::vector<std::vector<glm::vec4>>     mesh_spheres;
+
+	// Shared with the workers
+	std::mutex                                                                mutex;
+	std::vector<Job>                                                          jobs;
+	std::vector<std::pair<size_t, std::unique_ptr<sg::Image>>>                loaded_images;
+	std::vector<std::pair<size_t, std::vector<std::unique_ptr<sg::SubMesh>>>> loaded_meshes;
+	MeshOptimizationStats                                                     optimization_stats;
+	std::exception_ptr                                                        error;
+	std::atomic<bool>                                                         cancelled{false};
+
+	// Render thread only
+	bool                                                       workers_started{false};
+	size_t                                                     published_count{0};
+	CommandPool                                                command_pool;
+	VkFence                                                    upload_fence{VK_NULL_HANDLE};
+	bool                                                       upload_in_flight{false};
+	std::vector<vkb::core::BufferC>                            staging_buffers;
+	std::vector<std::pair<size_t, std::unique_ptr<sg::Image>>> uploading_images;
+	MipmapGenerator                                            mipmap_generator;
+
+	// Streaming jobs submitted to the job system which have not returned yet
+	JobCounter job_counter;
+};
 
 GLTFLoader::GLTFLoader(Device &device) :
     device{device}
 {
 }
 
+GLTFLoader::~GLTFLoader()
+{
+	if (streaming)
+	{
+		// Queued jobs return right away, running ones are waited for
+		streaming->cancelled = true;
+		JobSystem::get().wait(streaming->job_counter);
+
+		if (streaming->upload_fence != VK_NULL_HANDLE)
+		{
+			vkWaitForFences(device.get_handle(), 1, &streaming->upload_fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+			vkDestroyFence(device.get_handle(), streaming->upload_fence, nullptr);
+		}
+	}
+}
+
 std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &file_name, int scene_index, VkBufferUsageFlags additional_buffer_usage_flags)
 {
-	PROFILE_SCOPE("Load GLTF Scene");
+	PROFILE_STARTUP_SCOPE("Load GLTF Scene");
 
+	Timer timer;
+	timer.start();
+
+	if (!load_model_file(file_name))
+	{
+		return nullptr;
+	}
+
+	auto scene = std::make_unique<sg::Scene>(load_scene(scene_index, additional_buffer_usage_flags));
+
+	LOGI("Loaded {} in {} seconds, peak resident memory {} MB", file_name, vkb::to_string(timer.stop()), get_peak_resident_memory() / (1024 * 1024));
+
+	return scene;
+}
+
+std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file_async(const std::string &file_name, int scene_index, VkBufferUsageFlags additional_buffer_usage_flags)
+{
+	PROFILE_SCOPE("Load GLTF Scene Async");
+
+	if (streaming)
+	{
+		throw std::runtime_error("Cannot load glTF file " + file_name + " while another scene is streaming");
+	}
+
+	Timer timer;
+	timer.start();
+
+	if (!load_model_file(file_name))
+	{
+		return nullptr;
+	}
+
+	streaming = std::make_unique<StreamingState>(device);
+
+	auto scene = std::make_unique<sg::Scene>(load_scene(scene_index, additional_buffer_usage_flags, true));
+
+	auto &state  = *streaming;
+	state.scene  = scene.get();
+	state.meshes = scene->get_components<sg::Mesh>();
+
+	// World bounding spheres of every instance of a mesh, from the bounds of its positions
+	state.mesh_spheres.resize(state.meshes.size());
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); ++mesh_index)
+	{
+		sg::AABB bounds;
+		bool     has_bounds = false;
+		for (auto &gltf_primitive : model.meshes[mesh_index].primitives)
+		{
+			auto position = gltf_primitive.attributes.find("POSITION");
+			if (position != gltf_primitive.attributes.end())
+			{
+				auto &accessor = model.accessors[position->second];
+				if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+				{
+					bounds.update(glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]));
+					bounds.update(glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]));
+					has_bounds = true;
+				}
+			}
+		}
+
+		// Meshes without bounds keep the lowest priority
+		if (!has_bounds)
+		{
+			continue;
+		}
+
+		for (auto *node : state.meshes[mesh_index]->get_nodes())
+		{
+			auto world_bounds = bounds;
+			auto world_matrix = node->get_transform().get_world_matrix();
+			world_bounds.transform(world_matrix);
+
+			auto center = world_bounds.get_center();
+			state.mesh_spheres[mesh_index].push_back(glm::vec4(center, glm::length(world_bounds.get_max() - center)));
+		}
+	}
+
+	// Textures of each image, and meshes that show them
+	auto textures = scene->get_components<sg::Texture>();
+	state.image_textures.resize(model.images.size());
+	state.image_meshes.resize(model.images.size());
+	for (size_t texture_index = 0; texture_index < model.textures.size(); ++texture_index)
+	{
+		auto source = model.textures[texture_index].source;
+		if (source >= 0 && source < static_cast<int>(model.images.size()))
+		{
+			state.image_textures[source].push_back(textures[texture_index]);
+		}
+	}
+
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); ++mesh_index)
+	{
+		for (auto &gltf_primitive : model.meshes[mesh_index].primitives)
+		{
+			if (gltf_primitive.material < 0)
+			{
+				continue;
+			}
+
+			auto *material = state.materials[gltf_primitive.material];
+			for (size_t image_index = 0; image_index < state.image_textures.size(); ++image_index)
+			{
+				for (auto *texture : state.image_textures[image_index])
+				{
+					auto used = std::find_if(material->textures.begin(), material->textures.end(),
+					                         [texture](const auto &material_texture) { return material_texture.second == texture; });
+
+					auto &image_meshes = state.image_meshes[image_index];
+					if (used != material->textures.end() && std::find(image_meshes.begin(), image_meshes.end(), mesh_index) == image_meshes.end())
+					{
+						image_meshes.push_back(mesh_index);
+					}
+				}
+			}
+		}
+	}
+
+	for (size_t mesh_index = 0; mesh_index < state.meshes.size(); ++mesh_index)
+	{
+		state.jobs.push_back({StreamingState::Job::Type::Mesh, mesh_index});
+	}
+	for (size_t image_index = 0; image_index < model.images.size(); ++image_index)
+	{
+		state.jobs.push_back({StreamingState::Job::Type::Image, image_index});
+	}
+
+	VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &state.upload_fence));
+
+	// Priorities are set by the first update, jobs are submitted then
+
+	LOGI("Loaded the structure of {} in {} seconds, streaming {} meshes and {} images", file_name, vkb::to_string(timer.stop()), state.meshes.size(), model.images.size());
+
+	return scene;
+}
+
+bool GLTFLoader::update_streaming(const glm::vec3 &viewer_position)
+{
+	if (!streaming)
+	{
+		return false;
+	}
+
+	auto &state = *streaming;
+
+	std::vector<std::pair<size_t, std::vector<std::unique_ptr<sg::SubMesh>>>> loaded_meshes;
+	{
+		std::lock_guard<std::mutex> lock{state.mutex};
+
+		if (state.error)
+		{
+			std::rethrow_exception(state.error);
+		}
+
+		// Meshes that look larger from the viewer are loaded first, and so are the images they show
+		std::vector<float> mesh_priorities(state.meshes.size(), 0.0f);
+		for (size_t mesh_index = 0; mesh_index < state.meshes.size(); ++mesh_index)
+		{
+			for (auto &sphere : state.mesh_spheres[mesh_index])
+			{
+				float distance              = glm::length(glm::vec3(sphere) - viewer_position);
+				mesh_priorities[mesh_index] = std::max(mesh_priorities[mesh_index], sphere.w / std::max(distance, 1e-3f));
+			}
+		}
+
+		for (auto &job : state.jobs)
+		{
+			if (job.type == StreamingState::Job::Type::Mesh)
+			{
+				job.priority = mesh_priorities[job.index];
+			}
+			else
+			{
+				job.priority = 0.0f;
+				for (auto mesh_index : state.image_meshes[job.index])
+				{
+					job.priority = std::max(job.priority, mesh_priorities[mesh_index]);
+				}
+			}
+		}
+
+		loaded_meshes = std::move(state.loaded_meshes);
+		state.loaded_meshes.clear();
+
+		if (!state.workers_started)
+		{
+			// Each task runs whichever job has the highest priority when it starts
+			for (size_t i = 0; i < state.jobs.size(); ++i)
+			{
+				JobSystem::get().submit([this]() { run_streaming_job(); }, &state.job_counter);
+			}
+			state.workers_started = true;
+		}
+	}
+
+	// Meshes are host visible, they can be drawn as soon as they are loaded
+	for (auto &loaded_mesh : loaded_meshes)
+	{
+		for (auto &submesh : loaded_mesh.second)
+		{
+			state.meshes[loaded_mesh.first]->add_submesh(*submesh);
+			state.scene->add_component(std::move(submesh));
+		}
+		++state.published_count;
+	}
+
+	update_streaming_uploads();
+
+	if (state.published_count < state.jobs.size())
+	{
+		return true;
+	}
+
+	auto &stats = state.optimization_stats;
+	if (stats.triangle_count > 0)
+	{
+		auto triangle_count = static_cast<double>(stats.triangle_count);
+		LOGI("Optimized {} triangles: ACMR {:.3f} -> {:.3f}, vertex and index data {:.2f} MB -> {:.2f} MB",
+		     stats.triangle_count,
+		     stats.cache_misses_before / triangle_count,
+		     stats.cache_misses_after / triangle_count,
+		     stats.bytes_before / (1024.0 * 1024.0),
+		     stats.bytes_after / (1024.0 * 1024.0));
+	}
+
+	LOGI("Streamed {} meshes and {} images", state.meshes.size(), state.image_textures.size());
+
+	vkDestroyFence(device.get_handle(), state.upload_fence, nullptr);
+	state.upload_fence = VK_NULL_HANDLE;
+	streaming.reset();
+
+	return false;
+}
+
+float GLTFLoader::get_streaming_progress() const
+{
+	if (!streaming || streaming->jobs.empty())
+	{
+		return 1.0f;
+	}
+
+	return static_cast<float>(streaming->published_count) / static_cast<float>(streaming->jobs.size());
+}
+
+void GLTFLoader::run_streaming_job()
+{
+	auto &state = *streaming;
+
+	StreamingState::Job job;
+	{
+		std::lock_guard<std::mutex> lock{state.mutex};
+
+		if (state.cancelled || state.error)
+		{
+			return;
+		}
+
+		auto next = std::end(state.jobs);
+		for (auto it = state.jobs.begin(); it != state.jobs.end(); ++it)
+		{
+			if (!it->started && (next == state.jobs.end() || it->priority > next->priority))
+			{
+				next = it;
+			}
+		}
+
+		if (next == state.jobs.end())
+		{
+			return;
+		}
+
+		next->started = true;
+		job           = *next;
+	}
+
+	try
+	{
+		if (job.type == StreamingState::Job::Type::Image)
+		{
+			bool srgb  = state.srgb_images[job.index];
+			auto image = parse_image(model.images[job.index], srgb);
+			if (srgb)
+			{
+				image->coerce_format_to_srgb();
+			}
+
+			std::lock_guard<std::mutex> lock{state.mutex};
+			state.loaded_images.emplace_back(job.index, std::move(image));
+		}
+		else
+		{
+			auto                                     &gltf_mesh = model.meshes[job.index];
+			std::vector<std::unique_ptr<sg::SubMesh>> submeshes;
+			MeshOptimizationStats                     stats;
+
+			for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size() && !state.cancelled; i_primitive++)
+			{
+				auto submesh = load_primitive(gltf_mesh, i_primitive, state.additional_buffer_usage_flags, state.normal_format, stats);
+
+				auto material = gltf_mesh.primitives[i_primitive].material;
+				submesh->set_material(material < 0 ? *state.default_material : *state.materials[material]);
+
+				submeshes.push_back(std::move(submesh));
+			}
+
+			std::lock_guard<std::mutex> lock{state.mutex};
+			state.loaded_meshes.emplace_back(job.index, std::move(submeshes));
+			state.optimization_stats.triangle_count += stats.triangle_count;
+			state.optimization_stats.cache_misses_before += stats.cache_misses_before;
+			state.optimization_stats.cache_misses_after += stats.cache_misses_after;
+			state.optimization_stats.bytes_before += stats.bytes_before;
+			state.optimization_stats.bytes_after += stats.bytes_after;
+		}
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock{state.mutex};
+		state.error = std::current_exception();
+	}
+}
+
+void GLTFLoader::update_streaming_uploads()
+{
+	auto &state = *streaming;
+
+	if (state.upload_in_flight)
+	{
+		auto result = vkGetFenceStatus(device.get_handle(), state.upload_fence);
+		if (result == VK_NOT_READY)
+		{
+			return;
+		}
+		VK_CHECK(result);
+
+		// The upload completed, textures can switch from their placeholder
+		for (auto &uploaded_image : state.uploading_images)
+		{
+			for (auto *texture : state.image_textures[uploaded_image.first])
+			{
+				texture->set_image(*uploaded_image.second);
+			}
+			state.scene->add_component(std::move(uploaded_image.second));
+			++state.published_count;
+		}
+
+		state.uploading_images.clear();
+		state.staging_buffers.clear();
+		state.mipmap_generator.release_transient_resources();
+		state.command_pool.reset_pool();
+		VK_CHECK(vkResetFences(device.get_handle(), 1, &state.upload_fence));
+		state.upload_in_flight = false;
+	}
+
+	// Keeps the staging memory of a frame low, larger images still go in a batch of their own
+	{
+		std::lock_guard<std::mutex> lock{state.mutex};
+
+		size_t batch_size = 0;
+		auto   it         = state.loaded_images.begin();
+		for (; it != state.loaded_images.end() && batch_size < 32 * 1024 * 1024; ++it)
+		{
+			batch_size += it->second->get_data().size();
+			state.uploading_images.push_back(std::move(*it));
+		}
+		state.loaded_images.erase(state.loaded_images.begin(), it);
+	}
+
+	if (state.uploading_images.empty())
+	{
+		return;
+	}
+
+	auto &command_buffer = state.command_pool.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	state.staging_buffers.reserve(state.uploading_images.size());
+	for (auto &uploading_image : state.uploading_images)
+	{
+		auto &image = *uploading_image.second;
+		state.staging_buffers.push_back(vkb::core::BufferC::create_staging_buffer(device, image.get_data()));
+		upload_image_to_gpu(command_buffer, state.staging_buffers.back(), image, state.mipmap_generator, state.srgb_images[uploading_image.first]);
+	}
+
+	command_buffer.end();
+
+	VK_CHECK(device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).submit(command_buffer, state.upload_fence));
+	state.upload_in_flight = true;
+}
+
+std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer, VkBufferUsageFlags additional_buffer_usage_flags)
+{
+	PROFILE_SCOPE("Load GLTF Model");
+
+	if (!load_model_file(file_name))
+	{
+		return nullptr;
+	}
+
+	return std::move(load_model(index, storage_buffer, additional_buffer_usage_flags));
+}
+
+void GLTFLoader::set_mesh_optimization(bool enabled)
+{
+	optimize_meshes = enabled;
+}
+
+void GLTFLoader::set_mipmap_generation(bool enabled)
+{
+	generate_mipmaps = enabled;
+}
+
+bool GLTFLoader::load_model_file(const std::string &file_name)
+{
 	std::string err;
 	std::string warn;
 
@@ -419,19 +975,30 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 
 	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	model = {};
+	glb_mapping.reset();
+	buffer_data.clear();
+
+	bool importResult = is_glb_file(file_name) ? load_glb_file(gltf_loader, gltf_file, err, warn) :
+	                                             gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
 
 	if (!importResult)
 	{
 		LOGE("Failed to load gltf file {}.", gltf_file.c_str());
 
-		return nullptr;
+		if (!err.empty())
+		{
+			LOGE("{}", err.c_str());
+		}
+
+		return false;
 	}
 
 	if (!err.empty())
 	{
 		LOGE("Error loading gltf model: {}.", err.c_str());
-		return nullptr;
+
+		return false;
 	}
 
 	if (!warn.empty())
@@ -439,6 +1006,16 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 		LOGI("{}", warn.c_str());
 	}
 
+	// Buffers not read in place from a binary glTF file are owned by the model
+	buffer_data.resize(model.buffers.size(), nullptr);
+	for (size_t i = 0; i < model.buffers.size(); ++i)
+	{
+		if (buffer_data[i] == nullptr)
+		{
+			buffer_data[i] = model.buffers[i].data.data();
+		}
+	}
+
 	size_t pos = file_name.find_last_of('/');
 
 	model_path = file_name.substr(0, pos);
@@ -448,54 +1025,226 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 		model_path.clear();
 	}
 
-	return std::make_unique<sg::Scene>(load_scene(scene_index, additional_buffer_usage_flags));
+	return true;
 }
 
-std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer, VkBufferUsageFlags additional_buffer_usage_flags)
+bool GLTFLoader::load_glb_file(tinygltf::TinyGLTF &gltf_loader, const std::string &path, std::string &err, std::string &warn)
 {
-	PROFILE_SCOPE("Load GLTF Model");
+	try
+	{
+		glb_mapping = vkb::filesystem::get()->map_file(path);
+	}
+	catch (const std::runtime_error &e)
+	{
+		err = e.what();
+		return false;
+	}
 
-	std::string err;
-	std::string warn;
+	const uint8_t *data = glb_mapping.data();
+	size_t         size = glb_mapping.size();
 
-	tinygltf::TinyGLTF gltf_loader;
+	GlbHeader header;
+	if (size < sizeof(header))
+	{
+		err = "File too small to be a binary glTF file";
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
 
-	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
+	if (header.magic != GLB_MAGIC || header.version != 2 || header.length > size)
+	{
+		err = "Invalid binary glTF header";
+		return false;
+	}
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	const uint8_t *json_chunk = nullptr;
+	size_t         json_size  = 0;
+	const uint8_t *bin_chunk  = nullptr;
+	size_t         bin_size   = 0;
 
-	if (!importResult)
+	size_t offset = sizeof(header);
+	while (offset + sizeof(GlbChunkHeader) <= header.length)
 	{
-		LOGE("Failed to load gltf file {}.", gltf_file.c_str());
+		GlbChunkHeader chunk;
+		std::memcpy(&chunk, data + offset, sizeof(chunk));
+		offset += sizeof(chunk);
 
-		return nullptr;
+		if (offset + chunk.length > header.length)
+		{
+			err = "Binary glTF chunk exceeds the file";
+			return false;
+		}
+
+		if (chunk.type == GLB_CHUNK_JSON && json_chunk == nullptr)
+		{
+			json_chunk = data + offset;
+			json_size  = chunk.length;
+		}
+		else if (chunk.type == GLB_CHUNK_BIN && bin_chunk == nullptr)
+		{
+			bin_chunk = data + offset;
+			bin_size  = chunk.length;
+		}
+
+		offset += chunk.length;
 	}
 
-	if (!err.empty())
+	if (json_chunk == nullptr)
 	{
-		LOGE("Error loading gltf model: {}.", err.c_str());
+		err = "Binary glTF file has no JSON chunk";
+		return false;
+	}
+
+	auto json = nlohmann::json::parse(json_chunk, json_chunk + json_size, nullptr, false);
+	if (json.is_discarded() || !json.is_object())
+	{
+		err = "Failed to parse the JSON chunk of the binary glTF file";
+		return false;
+	}
+
+	// The buffer without uri is the BIN chunk, tinygltf is handed a one byte stub instead
+	std::vector<const uint8_t *> in_place_buffers;
+	if (json.contains("buffers"))
+	{
+		auto &buffers = json["buffers"];
+		in_place_buffers.resize(buffers.size(), nullptr);
+		for (size_t i = 0; i < buffers.size(); ++i)
+		{
+			auto &buffer = buffers[i];
+			if (buffer.contains("uri"))
+			{
+				continue;
+			}
+
+			if (bin_chunk == nullptr || buffer.value("byteLength", size_t{0}) > bin_size)
+			{
+				err = "Binary glTF buffer exceeds the BIN chunk";
+				return false;
+			}
+
+			buffer["uri"]        = GLB_STUB_BUFFER_URI;
+			buffer["byteLength"] = 1;
+			in_place_buffers[i]  = bin_chunk;
+		}
+	}
+
+	// tinygltf would read the images stored in buffer views out of the stub buffers, and requires a uri for the others.
+	// Images are left out of the JSON it parses, and only described here: parse_image decodes them
+	std::vector<tinygltf::Image> images;
+	if (json.contains("images"))
+	{
+		for (auto &image : json["images"])
+		{
+			tinygltf::Image gltf_image;
+			gltf_image.name       = image.value("name", std::string{});
+			gltf_image.mimeType   = image.value("mimeType", std::string{});
+			gltf_image.bufferView = image.value("bufferView", -1);
+			gltf_image.uri        = image.value("uri", std::string{});
+
+			if (gltf_image.bufferView < 0 && (gltf_image.uri.empty() || gltf_image.uri.rfind("data:", 0) == 0))
+			{
+				err = "Binary glTF image " + gltf_image.name + " has neither a buffer view nor an external uri";
+				return false;
+			}
+			images.push_back(std::move(gltf_image));
+		}
+		json.erase("images");
+	}
+
+	auto patched_json = json.dump();
+	auto base_dir     = path.substr(0, path.find_last_of("/\\") + 1);
+
+	if (!gltf_loader.LoadASCIIFromString(&model, &err, &warn, patched_json.c_str(), to_u32(patched_json.size()), base_dir))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < in_place_buffers.size() && i < model.buffers.size(); ++i)
+	{
+		if (in_place_buffers[i] != nullptr)
+		{
+			model.buffers[i].uri.clear();
+			model.buffers[i].data.clear();
+		}
+	}
+	model.images = std::move(images);
+
+	// Buffers are read in place, so the ranges of the JSON chunk are checked against the data before anything reads them
+	std::vector<size_t> buffer_sizes(model.buffers.size());
+	for (size_t i = 0; i < model.buffers.size(); ++i)
+	{
+		buffer_sizes[i] = i < in_place_buffers.size() && in_place_buffers[i] != nullptr ? bin_size : model.buffers[i].data.size();
+	}
+
+	for (auto &buffer_view : model.bufferViews)
+	{
+		if (buffer_view.buffer < 0 || static_cast<size_t>(buffer_view.buffer) >= buffer_sizes.size() ||
+		    buffer_view.byteOffset + buffer_view.byteLength > buffer_sizes[buffer_view.buffer])
+		{
+			err = "Binary glTF buffer view " + buffer_view.name + " exceeds its buffer";
+			return false;
+		}
+	}
+
+	for (auto &image : model.images)
+	{
+		if (image.bufferView >= static_cast<int>(model.bufferViews.size()))
+		{
+			err = "Binary glTF image " + image.name + " refers to a missing buffer view";
+			return false;
+		}
+	}
+
+	for (auto &accessor : model.accessors)
+	{
+		if (accessor.bufferView < 0 || accessor.count == 0)
+		{
+			continue;
+		}
+
+		if (static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size())
+		{
+			err = "Binary glTF accessor " + accessor.name + " refers to a missing buffer view";
+			return false;
+		}
 
-		return nullptr;
-	}
+		auto &buffer_view  = model.bufferViews[accessor.bufferView];
+		int   stride       = accessor.ByteStride(buffer_view);
+		int   element_size = tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type);
 
-	if (!warn.empty())
-	{
-		LOGI("{}", warn.c_str());
+		if (stride <= 0 || element_size <= 0 ||
+		    accessor.byteOffset + (accessor.count - 1) * static_cast<size_t>(stride) + element_size > buffer_view.byteLength)
+		{
+			err = "Binary glTF accessor " + accessor.name + " exceeds its buffer view";
+			return false;
+		}
 	}
 
-	size_t pos = file_name.find_last_of('/');
+	buffer_data = std::move(in_place_buffers);
 
-	model_path = file_name.substr(0, pos);
+	return true;
+}
 
-	if (pos == std::string::npos)
-	{
-		model_path.clear();
-	}
+GLTFLoader::AccessorView GLTFLoader::get_accessor_view(uint32_t accessor_id) const
+{
+	assert(accessor_id < model.accessors.size());
+	auto &accessor = model.accessors[accessor_id];
+	assert(accessor.bufferView < model.bufferViews.size());
+	auto &buffer_view = model.bufferViews[accessor.bufferView];
 
-	return std::move(load_model(index, storage_buffer, additional_buffer_usage_flags));
+	return {get_buffer_view_data(accessor.bufferView) + accessor.byteOffset, accessor.count, static_cast<size_t>(accessor.ByteStride(buffer_view))};
 }
 
-sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_buffer_usage_flags)
+const uint8_t *GLTFLoader::get_buffer_view_data(int buffer_view_index) const
+{
+	assert(buffer_view_index >= 0 && buffer_view_index < static_cast<int>(model.bufferViews.size()));
+	auto &buffer_view = model.bufferViews[buffer_view_index];
+	assert(buffer_view.buffer >= 0 && buffer_view.buffer < static_cast<int>(buffer_data.size()));
+
+	return buffer_data[buffer_view.buffer] + buffer_view.byteOffset;
+}
+
+sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_buffer_usage_flags, bool stream)
 {
 	PROFILE_SCOPE("Process Scene");
 
@@ -550,76 +1299,147 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 	Timer timer;
 	timer.start();
 
-	// Load images
-	auto thread_count = std::thread::hardware_concurrency();
-	thread_count      = thread_count == 0 ? 1 : thread_count;
-	ctpl::thread_pool thread_pool(thread_count);
+	// Textures with a KTX2 source use it instead of their fallback image
+	if (is_extension_enabled(KHR_TEXTURE_BASISU_EXTENSION))
+	{
+		for (auto &gltf_texture : model.textures)
+		{
+			auto extension = gltf_texture.extensions.find(KHR_TEXTURE_BASISU_EXTENSION);
+			if (extension != gltf_texture.extensions.end() && extension->second.Has("source"))
+			{
+				gltf_texture.source = extension->second.Get("source").Get<int>();
+			}
+		}
+
+		ktx_transcode_target = sg::Ktx::get_transcode_target(device);
+	}
+
+	// Load images on the job system, the calling thread helps while it waits for them
+	auto thread_count = JobSystem::get().get_worker_count() + 1;
 
 	auto image_count = to_u32(model.images.size());
 
-	std::vector<std::future<std::unique_ptr<sg::Image>>> image_component_futures;
-	for (size_t image_index = 0; image_index < image_count; image_index++)
+	// Color textures get their mipmaps filtered in linear space
+	std::vector<bool> srgb_images(image_count, false);
+	for (auto &gltf_material : model.materials)
 	{
-		auto fut = thread_pool.push(
-		    [this, image_index](size_t) {
-			    auto image = parse_image(model.images[image_index]);
+		for (auto *gltf_values : {&gltf_material.values, &gltf_material.additionalValues})
+		{
+			for (auto &gltf_value : *gltf_values)
+			{
+				if (gltf_value.first.find("Texture") == std::string::npos || !texture_needs_srgb_colorspace(gltf_value.first))
+				{
+					continue;
+				}
 
-			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
+				auto texture_index = gltf_value.second.TextureIndex();
+				if (texture_index >= 0 && texture_index < static_cast<int>(model.textures.size()))
+				{
+					auto source = model.textures[texture_index].source;
+					if (source >= 0 && source < static_cast<int>(image_count))
+					{
+						srgb_images[source] = true;
+					}
+				}
+			}
+		}
+	}
+
+	// When streaming, images are loaded by the streaming workers instead
+	uint32_t loaded_image_count = stream ? 0 : image_count;
+
+	// Images are loaded in parallel, spare threads are used to split the mip generation of each image
+	uint32_t mip_thread_count = std::max(1u, thread_count / std::max(1u, image_count));
 
-			    return image;
-		    });
+	std::vector<std::unique_ptr<sg::Image>> loaded_images(loaded_image_count);
+	std::vector<JobCounter>                 image_counters(loaded_image_count);
+	for (size_t image_index = 0; image_index < loaded_image_count; image_index++)
+	{
+		bool srgb = srgb_images[image_index];
+
+		JobSystem::get().submit(
+		    [this, image_index, srgb, mip_thread_count, &loaded_images]() {
+			    loaded_images[image_index] = parse_image(model.images[image_index], srgb, mip_thread_count);
 
-		image_component_futures.push_back(std::move(fut));
+			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
+		    },
+		    &image_counters[image_index]);
 	}
 
+	// The jobs reference locals of this function, an error while uploading has to wait for them before unwinding
+	auto wait_for_images = [&image_counters]() {
+		for (auto &image_counter : image_counters)
+		{
+			try
+			{
+				JobSystem::get().wait(image_counter);
+			}
+			catch (...)
+			{
+			}
+		}
+	};
+
 	std::vector<std::unique_ptr<sg::Image>> image_components;
 
+	MipmapGenerator mipmap_generator{device};
+
 	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
 	// double the amount of memory (all the images and all the corresponding buffers).
 	// This helps keep memory footprint lower which is helpful on smaller devices.
 	size_t image_index = 0;
-	while (image_index < image_count)
+	try
 	{
-		std::vector<vkb::core::BufferC> transient_buffers;
+		while (image_index < loaded_image_count)
+		{
+			std::vector<vkb::core::BufferC> transient_buffers;
 
-		auto &command_buffer = device.request_command_buffer();
+			auto &command_buffer = device.request_command_buffer();
 
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+			command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
 
-		size_t batch_size = 0;
+			size_t batch_size = 0;
 
-		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
-		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
+			// Deal with 64MB of image data at a time to keep memory footprint low
+			while (image_index < loaded_image_count && batch_size < 64 * 1024 * 1024)
+			{
+				// Wait for this image to complete loading, then stage for upload
+				JobSystem::get().wait(image_counters[image_index]);
+				image_components.push_back(std::move(loaded_images[image_index]));
 
-			auto &image = image_components[image_index];
+				auto &image = image_components[image_index];
 
-			core::Buffer stage_buffer = vkb::core::BufferC::create_staging_buffer(device, image->get_data());
+				core::Buffer stage_buffer = vkb::core::BufferC::create_staging_buffer(device, image->get_data());
 
-			batch_size += image->get_data().size();
+				batch_size += image->get_data().size();
 
-			upload_image_to_gpu(command_buffer, stage_buffer, *image);
+				upload_image_to_gpu(command_buffer, stage_buffer, *image, mipmap_generator, srgb_images[image_index]);
 
-			transient_buffers.push_back(std::move(stage_buffer));
+				transient_buffers.push_back(std::move(stage_buffer));
 
-			image_index++;
-		}
+				image_index++;
+			}
 
-		command_buffer.end();
+			command_buffer.end();
 
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+			auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 
-		queue.submit(command_buffer, device.request_fence());
+			queue.submit(command_buffer, device.request_fence());
 
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
+			device.get_fence_pool().wait();
+			device.get_fence_pool().reset();
+			device.get_command_pool().reset_pool();
+			device.wait_idle();
 
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+			// Remove the staging buffers and mipmap generation resources for the batch we just processed
+			transient_buffers.clear();
+			mipmap_generator.release_transient_resources();
+		}
+	}
+	catch (...)
+	{
+		wait_for_images();
+		throw;
 	}
 
 	scene.set_components(std::move(image_components));
@@ -628,8 +1448,54 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 
 	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
 
+	// Until they are streamed in, textures show a white image, or a flat normal for normal maps
+	if (stream)
+	{
+		auto placeholder        = create_placeholder_image(device, "placeholder", {255, 255, 255, 255});
+		auto normal_placeholder = create_placeholder_image(device, "normal_placeholder", {128, 128, 255, 255});
+
+		auto &command_buffer = device.request_command_buffer();
+		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+		auto stage_buffer        = vkb::core::BufferC::create_staging_buffer(device, placeholder->get_data());
+		auto normal_stage_buffer = vkb::core::BufferC::create_staging_buffer(device, normal_placeholder->get_data());
+		upload_image_to_gpu(command_buffer, stage_buffer, *placeholder, mipmap_generator, false);
+		upload_image_to_gpu(command_buffer, normal_stage_buffer, *normal_placeholder, mipmap_generator, false);
+
+		command_buffer.end();
+		device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).submit(command_buffer, device.request_fence());
+		device.get_fence_pool().wait();
+		device.get_fence_pool().reset();
+		device.get_command_pool().reset_pool();
+
+		std::vector<sg::Image *> placeholders(image_count, placeholder.get());
+		for (auto &gltf_material : model.materials)
+		{
+			auto normal_texture = gltf_material.additionalValues.find("normalTexture");
+			if (normal_texture == gltf_material.additionalValues.end())
+			{
+				continue;
+			}
+
+			auto texture_index = normal_texture->second.TextureIndex();
+			if (texture_index >= 0 && texture_index < static_cast<int>(model.textures.size()))
+			{
+				auto source = model.textures[texture_index].source;
+				if (source >= 0 && source < static_cast<int>(image_count))
+				{
+					placeholders[source] = normal_placeholder.get();
+				}
+			}
+		}
+
+		scene.add_component(std::move(placeholder));
+		scene.add_component(std::move(normal_placeholder));
+
+		streaming->placeholders = std::move(placeholders);
+	}
+
 	// Load textures
-	auto images                  = scene.get_components<sg::Image>();
+	auto images                  = stream ? streaming->placeholders : scene.get_components<sg::Image>();
 	auto samplers                = scene.get_components<sg::Sampler>();
 	auto default_sampler_linear  = create_default_sampler(TINYGLTF_TEXTURE_FILTER_LINEAR);
 	auto default_sampler_nearest = create_default_sampler(TINYGLTF_TEXTURE_FILTER_NEAREST);
@@ -732,88 +1598,30 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 	// Load meshes
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
+	// Storage and ray tracing users of the vertex buffers read floats, so their attributes are not quantized
+	VkFormat normal_format = VK_FORMAT_UNDEFINED;
+	if (optimize_meshes && additional_buffer_usage_flags == 0)
+	{
+		auto properties = device.get_gpu().get_format_properties(VK_FORMAT_A2B10G10R10_SNORM_PACK32);
+		normal_format   = (properties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT) ? VK_FORMAT_A2B10G10R10_SNORM_PACK32 : VK_FORMAT_R8G8B8A8_SNORM;
+	}
+
+	MeshOptimizationStats optimization_stats;
+
 	for (auto &gltf_mesh : model.meshes)
 	{
 		PROFILE_SCOPE("Processing Mesh");
 
 		auto mesh = parse_mesh(gltf_mesh);
 
-		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
+		// When streaming, submeshes are added as the workers load them
+		size_t primitive_count = stream ? 0 : gltf_mesh.primitives.size();
+
+		for (size_t i_primitive = 0; i_primitive < primitive_count; i_primitive++)
 		{
 			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
 
-			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
-			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
-
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
-
-				auto vertex_data = get_attribute_data(&model, attribute.second);
-
-				if (attrib_name == "position")
-				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
-
-				vkb::core::BufferC buffer{device,
-				                          vertex_data.size(),
-				                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | additional_buffer_usage_flags,
-				                          VMA_MEMORY_USAGE_CPU_TO_GPU};
-				buffer.update(vertex_data);
-				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
-
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
-
-				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
-
-				submesh->set_attribute(attrib_name, attrib);
-			}
-
-			if (gltf_primitive.indices >= 0)
-			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
-
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
-
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
-
-				switch (format)
-				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
-				}
-
-				submesh->index_buffer = std::make_unique<vkb::core::BufferC>(device,
-				                                                             index_data.size(),
-				                                                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additional_buffer_usage_flags,
-				                                                             VMA_MEMORY_USAGE_GPU_TO_CPU);
-				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
-				                                                  gltf_mesh.name, i_primitive));
-
-				submesh->index_buffer->update(index_data);
-			}
-			else
-			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
-			}
+			auto submesh = load_primitive(gltf_mesh, i_primitive, additional_buffer_usage_flags, normal_format, optimization_stats);
 
 			if (gltf_primitive.material < 0)
 			{
@@ -833,10 +1641,30 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 		scene.add_component(std::move(mesh));
 	}
 
+	if (optimization_stats.triangle_count > 0)
+	{
+		auto triangle_count = static_cast<double>(optimization_stats.triangle_count);
+		LOGI("Optimized {} triangles: ACMR {:.3f} -> {:.3f}, vertex and index data {:.2f} MB -> {:.2f} MB",
+		     optimization_stats.triangle_count,
+		     optimization_stats.cache_misses_before / triangle_count,
+		     optimization_stats.cache_misses_after / triangle_count,
+		     optimization_stats.bytes_before / (1024.0 * 1024.0),
+		     optimization_stats.bytes_after / (1024.0 * 1024.0));
+	}
+
 	device.get_fence_pool().wait();
 	device.get_fence_pool().reset();
 	device.get_command_pool().reset_pool();
 
+	if (stream)
+	{
+		streaming->additional_buffer_usage_flags = additional_buffer_usage_flags;
+		streaming->normal_format                 = normal_format;
+		streaming->srgb_images                   = std::move(srgb_images);
+		streaming->materials                     = materials;
+		streaming->default_material              = default_material.get();
+	}
+
 	scene.add_component(std::move(default_material));
 
 	// Load cameras
@@ -924,22 +1752,22 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 			}
 
 			auto input_accessor      = model.accessors[gltf_sampler.input];
-			auto input_accessor_data = get_attribute_data(&model, gltf_sampler.input);
+			auto input_accessor_data = get_accessor_view(gltf_sampler.input);
 
-			const float *data = reinterpret_cast<const float *>(input_accessor_data.data());
+			const float *data = reinterpret_cast<const float *>(input_accessor_data.data);
 			for (size_t i = 0; i < input_accessor.count; ++i)
 			{
 				sampler.inputs.push_back(data[i]);
 			}
 
 			auto output_accessor      = model.accessors[gltf_sampler.output];
-			auto output_accessor_data = get_attribute_data(&model, gltf_sampler.output);
+			auto output_accessor_data = get_accessor_view(gltf_sampler.output);
 
 			switch (output_accessor.type)
 			{
 				case TINYGLTF_TYPE_VEC3:
 				{
-					const glm::vec3 *data = reinterpret_cast<const glm::vec3 *>(output_accessor_data.data());
+					const glm::vec3 *data = reinterpret_cast<const glm::vec3 *>(output_accessor_data.data);
 					for (size_t i = 0; i < output_accessor.count; ++i)
 					{
 						sampler.outputs.push_back(glm::vec4(data[i], 0.0f));
@@ -948,7 +1776,7 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 				}
 				case TINYGLTF_TYPE_VEC4:
 				{
-					const glm::vec4 *data = reinterpret_cast<const glm::vec4 *>(output_accessor_data.data());
+					const glm::vec4 *data = reinterpret_cast<const glm::vec4 *>(output_accessor_data.data);
 					for (size_t i = 0; i < output_accessor.count; ++i)
 					{
 						sampler.outputs.push_back(glm::vec4(data[i]));
@@ -1099,6 +1927,228 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 	return scene;
 }
 
+std::unique_ptr<sg::SubMesh> GLTFLoader::load_primitive(const tinygltf::Mesh &gltf_mesh, size_t i_primitive, VkBufferUsageFlags additional_buffer_usage_flags,
+                                                        VkFormat normal_format, MeshOptimizationStats &stats)
+{
+	const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
+
+	auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
+	auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
+
+	// Morph targets are indexed like the vertices, and are left unoptimized rather than remapped
+	bool optimize = optimize_meshes && gltf_primitive.mode == TINYGLTF_MODE_TRIANGLES && gltf_primitive.indices >= 0 && gltf_primitive.targets.empty() &&
+	                get_attribute_format(&model, gltf_primitive.attributes.at("POSITION")) == VK_FORMAT_R32G32B32_SFLOAT;
+
+	if (optimize)
+	{
+		load_optimized_primitive(*submesh, gltf_primitive, submesh->get_name(), additional_buffer_usage_flags, normal_format, stats);
+	}
+	else
+	{
+		for (auto &attribute : gltf_primitive.attributes)
+		{
+			std::string attrib_name = attribute.first;
+			std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+
+			auto vertex_data = get_accessor_view(attribute.second);
+
+			if (attrib_name == "position")
+			{
+				assert(attribute.second < model.accessors.size());
+				submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
+			}
+
+			vkb::core::BufferC buffer{device,
+			                          vertex_data.count * vertex_data.stride,
+			                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | additional_buffer_usage_flags,
+			                          VMA_MEMORY_USAGE_CPU_TO_GPU};
+			buffer.update(vertex_data.data, vertex_data.count * vertex_data.stride);
+			buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
+			                                  gltf_mesh.name, i_primitive, attrib_name));
+
+			submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+
+			sg::VertexAttribute attrib;
+			attrib.format = get_attribute_format(&model, attribute.second);
+			attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+
+			submesh->set_attribute(attrib_name, attrib);
+		}
+
+		if (gltf_primitive.indices >= 0)
+		{
+			submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+
+			auto format = get_attribute_format(&model, gltf_primitive.indices);
+
+			auto index_data = get_accessor_view(gltf_primitive.indices);
+
+			// Stride of the indices in the index buffer
+			size_t index_stride = index_data.stride;
+
+			switch (format)
+			{
+				case VK_FORMAT_R8_UINT:
+					// uint8 data is widened into uint16 data while it is copied
+					index_stride        = 2;
+					submesh->index_type = VK_INDEX_TYPE_UINT16;
+					break;
+				case VK_FORMAT_R16_UINT:
+					submesh->index_type = VK_INDEX_TYPE_UINT16;
+					break;
+				case VK_FORMAT_R32_UINT:
+					submesh->index_type = VK_INDEX_TYPE_UINT32;
+					break;
+				default:
+					LOGE("gltf primitive has invalid format type");
+					break;
+			}
+
+			submesh->index_buffer = std::make_unique<vkb::core::BufferC>(device,
+			                                                             index_data.count * index_stride,
+			                                                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additional_buffer_usage_flags,
+			                                                             VMA_MEMORY_USAGE_GPU_TO_CPU);
+			submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
+			                                                  gltf_mesh.name, i_primitive));
+
+			bool was_mapped = submesh->index_buffer->mapped();
+			copy_with_stride(index_data.data, index_data.count, index_data.stride, submesh->index_buffer->map(), index_stride);
+			submesh->index_buffer->flush();
+			if (!was_mapped)
+			{
+				submesh->index_buffer->unmap();
+			}
+		}
+		else
+		{
+			submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+		}
+	}
+
+	return submesh;
+}
+
+void GLTFLoader::load_optimized_primitive(sg::SubMesh &submesh, const tinygltf::Primitive &gltf_primitive, const std::string &debug_name,
+                                          VkBufferUsageFlags additional_buffer_usage_flags, VkFormat normal_format, MeshOptimizationStats &stats)
+{
+	PROFILE_SCOPE("Optimize Primitive");
+
+	auto index_view   = get_accessor_view(gltf_primitive.indices);
+	auto index_format = get_attribute_format(&model, gltf_primitive.indices);
+
+	auto position_view = get_accessor_view(gltf_primitive.attributes.at("POSITION"));
+	auto positions     = reinterpret_cast<const float *>(position_view.data);
+	auto vertex_count  = position_view.count;
+
+	std::vector<uint32_t> indices(index_view.count);
+	copy_with_stride(index_view.data, index_view.count, index_view.stride, reinterpret_cast<uint8_t *>(indices.data()), sizeof(uint32_t));
+
+	size_t triangle_count = indices.size() / 3;
+	stats.triangle_count += triangle_count;
+	stats.cache_misses_before += get_average_cache_miss_ratio(indices.data(), indices.size(), vertex_count) * triangle_count;
+	stats.bytes_before += index_view.count * (index_format == VK_FORMAT_R8_UINT ? 2 : index_view.stride);
+
+	optimize_vertex_cache(indices.data(), indices.data(), indices.size(), vertex_count);
+	optimize_overdraw(indices.data(), indices.size(), positions, vertex_count, position_view.stride);
+	auto remap = optimize_vertex_fetch(indices.data(), indices.size(), vertex_count);
+
+	stats.cache_misses_after += get_average_cache_miss_ratio(indices.data(), indices.size(), remap.size()) * triangle_count;
+
+	submesh.vertices_count = to_u32(remap.size());
+
+	for (auto &attribute : gltf_primitive.attributes)
+	{
+		std::string attrib_name = attribute.first;
+		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+
+		auto  vertex_data = get_accessor_view(attribute.second);
+		auto &accessor    = model.accessors[attribute.second];
+
+		sg::VertexAttribute attrib;
+		attrib.format = get_attribute_format(&model, attribute.second);
+
+		bool quantize          = normal_format != VK_FORMAT_UNDEFINED;
+		bool quantize_normal   = quantize && ((attrib_name == "normal" && attrib.format == VK_FORMAT_R32G32B32_SFLOAT) ||
+		                                      (attrib_name == "tangent" && attrib.format == VK_FORMAT_R32G32B32A32_SFLOAT));
+		bool quantize_texcoord = quantize && attrib_name.rfind("texcoord_", 0) == 0 && attrib.format == VK_FORMAT_R32G32_SFLOAT;
+
+		std::vector<uint8_t> data;
+		if (quantize_normal || quantize_texcoord)
+		{
+			attrib.format = quantize_normal ? normal_format : VK_FORMAT_R16G16_SFLOAT;
+			attrib.stride = sizeof(uint32_t);
+			data.resize(remap.size() * attrib.stride);
+
+			uint32_t components = attrib_name == "normal" ? 3 : (attrib_name == "tangent" ? 4 : 2);
+			for (size_t v = 0; v < remap.size(); ++v)
+			{
+				float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+				std::memcpy(value, vertex_data.data + remap[v] * vertex_data.stride, components * sizeof(float));
+
+				uint32_t packed;
+				if (quantize_texcoord)
+				{
+					packed = quantize_half(value[0]) | static_cast<uint32_t>(quantize_half(value[1])) << 16;
+				}
+				else if (normal_format == VK_FORMAT_A2B10G10R10_SNORM_PACK32)
+				{
+					packed = pack_snorm_a2b10g10r10(value[0], value[1], value[2], value[3]);
+				}
+				else
+				{
+					packed = pack_snorm_r8g8b8a8(value[0], value[1], value[2], value[3]);
+				}
+				std::memcpy(data.data() + v * attrib.stride, &packed, sizeof(packed));
+			}
+		}
+		else
+		{
+			// Vertices are gathered in their new order, tightly packed
+			attrib.stride = to_u32(tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type));
+			data.resize(remap.size() * attrib.stride);
+			for (size_t v = 0; v < remap.size(); ++v)
+			{
+				std::memcpy(data.data() + v * attrib.stride, vertex_data.data + remap[v] * vertex_data.stride, attrib.stride);
+			}
+		}
+
+		stats.bytes_before += vertex_data.count * vertex_data.stride;
+		stats.bytes_after += data.size();
+
+		vkb::core::BufferC buffer{device,
+		                          data.size(),
+		                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | additional_buffer_usage_flags,
+		                          VMA_MEMORY_USAGE_CPU_TO_GPU};
+		buffer.update(data);
+		buffer.set_debug_name(fmt::format("{}: '{}' vertex buffer", debug_name, attrib_name));
+
+		submesh.vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+
+		submesh.set_attribute(attrib_name, attrib);
+	}
+
+	// Vertices that are never referenced were dropped, so 32 bit indices may now fit in 16 bits
+	size_t index_stride    = remap.size() <= static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1 ? sizeof(uint16_t) : sizeof(uint32_t);
+	submesh.index_type     = index_stride == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	submesh.vertex_indices = to_u32(indices.size());
+
+	submesh.index_buffer = std::make_unique<vkb::core::BufferC>(device,
+	                                                            indices.size() * index_stride,
+	                                                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additional_buffer_usage_flags,
+	                                                            VMA_MEMORY_USAGE_GPU_TO_CPU);
+	submesh.index_buffer->set_debug_name(fmt::format("{}: index buffer", debug_name));
+
+	bool was_mapped = submesh.index_buffer->mapped();
+	copy_with_stride(reinterpret_cast<const uint8_t *>(indices.data()), indices.size(), sizeof(uint32_t), submesh.index_buffer->map(), index_stride);
+	submesh.index_buffer->flush();
+	if (!was_mapped)
+	{
+		submesh.index_buffer->unmap();
+	}
+
+	stats.bytes_after += indices.size() * index_stride;
+}
+
 std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage_buffer, VkBufferUsageFlags additional_buffer_usage_flags)
 {
 	PROFILE_SCOPE("Process Model");
@@ -1133,30 +2183,24 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 	// Position attribute is required
 	auto  &accessor     = model.accessors[gltf_primitive.attributes.find("POSITION")->second];
 	size_t vertex_count = accessor.count;
-	auto  &buffer_view  = model.bufferViews[accessor.bufferView];
-	pos                 = reinterpret_cast<const float *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
+	pos                 = reinterpret_cast<const float *>(get_accessor_view(gltf_primitive.attributes.find("POSITION")->second).data);
 
 	submesh->vertices_count = static_cast<uint32_t>(vertex_count);
 
 	if (gltf_primitive.attributes.find("NORMAL") != gltf_primitive.attributes.end())
 	{
-		accessor    = model.accessors[gltf_primitive.attributes.find("NORMAL")->second];
-		buffer_view = model.bufferViews[accessor.bufferView];
-		normals     = reinterpret_cast<const float *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
+		normals = reinterpret_cast<const float *>(get_accessor_view(gltf_primitive.attributes.find("NORMAL")->second).data);
 	}
 
 	if (gltf_primitive.attributes.find("TEXCOORD_0") != gltf_primitive.attributes.end())
 	{
-		accessor    = model.accessors[gltf_primitive.attributes.find("TEXCOORD_0")->second];
-		buffer_view = model.bufferViews[accessor.bufferView];
-		uvs         = reinterpret_cast<const float *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
+		uvs = reinterpret_cast<const float *>(get_accessor_view(gltf_primitive.attributes.find("TEXCOORD_0")->second).data);
 	}
 
 	if (gltf_primitive.attributes.find("COLOR_0") != gltf_primitive.attributes.end())
 	{
 		accessor              = model.accessors[gltf_primitive.attributes.find("COLOR_0")->second];
-		buffer_view           = model.bufferViews[accessor.bufferView];
-		colors                = reinterpret_cast<const float *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
+		colors                = reinterpret_cast<const float *>(get_accessor_view(gltf_primitive.attributes.find("COLOR_0")->second).data);
 		color_component_count = accessor.type == TINYGLTF_PARAMETER_TYPE_FLOAT_VEC3 ? 3 : 4;
 	}
 
@@ -1164,16 +2208,12 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 	// Joints
 	if (gltf_primitive.attributes.find("JOINTS_0") != gltf_primitive.attributes.end())
 	{
-		accessor    = model.accessors[gltf_primitive.attributes.find("JOINTS_0")->second];
-		buffer_view = model.bufferViews[accessor.bufferView];
-		joints      = reinterpret_cast<const uint16_t *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
+		joints = reinterpret_cast<const uint16_t *>(get_accessor_view(gltf_primitive.attributes.find("JOINTS_0")->second).data);
 	}
 
 	if (gltf_primitive.attributes.find("WEIGHTS_0") != gltf_primitive.attributes.end())
 	{
-		accessor    = model.accessors[gltf_primitive.attributes.find("WEIGHTS_0")->second];
-		buffer_view = model.bufferViews[accessor.bufferView];
-		weights     = reinterpret_cast<const float *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
+		weights = reinterpret_cast<const float *>(get_accessor_view(gltf_primitive.attributes.find("WEIGHTS_0")->second).data);
 	}
 
 	bool has_skin = (joints && weights);
@@ -1250,40 +2290,22 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 	{
 		submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
 
-		auto format     = get_attribute_format(&model, gltf_primitive.indices);
-		auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+		auto index_view = get_accessor_view(gltf_primitive.indices);
 
-		switch (format)
-		{
-			case VK_FORMAT_R32_UINT:
-			{
-				// Correct format
-				break;
-			}
-			case VK_FORMAT_R16_UINT:
-			{
-				index_data = convert_underlying_data_stride(index_data, 2, 4);
-				break;
-			}
-			case VK_FORMAT_R8_UINT:
-			{
-				index_data = convert_underlying_data_stride(index_data, 1, 4);
-				break;
-			}
-			default:
-			{
-				break;
-			}
-		}
+		// Always do uint32, narrower indices are widened while they are copied
+		std::vector<uint8_t> index_data(index_view.count * sizeof(uint32_t));
+		copy_with_stride(index_view.data, index_view.count, index_view.stride, index_data.data(), sizeof(uint32_t));
 
-		// Always do uint32
 		submesh->index_type = VK_INDEX_TYPE_UINT32;
 
 		if (storage_buffer)
 		{
 			// prepare meshlets
+			auto position_view = get_accessor_view(gltf_primitive.attributes.find("POSITION")->second);
+
 			std::vector<Meshlet> meshlets;
-			prepare_meshlets(meshlets, submesh, index_data);
+			prepare_meshlets(meshlets, {reinterpret_cast<const uint32_t *>(index_data.data()), index_view.count,
+			                            reinterpret_cast<const float *>(position_view.data), position_view.count, position_view.stride});
 
 			// vertex_indices and index_buffer are used for meshlets now
 			submesh->vertex_indices = static_cast<uint32_t>(meshlets.size());
@@ -1458,7 +2480,7 @@ std::unique_ptr<sg::PBRMaterial> GLTFLoader::parse_material(const tinygltf::Mate
 	return material;
 }
 
-std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image) const
+std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image, bool srgb, uint32_t mip_thread_count) const
 {
 	std::unique_ptr<sg::Image> image{nullptr};
 
@@ -1474,6 +2496,31 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 		std::vector<sg::Mipmap> mipmaps{mipmap};
 		image = std::make_unique<sg::Image>(gltf_image.name, std::move(gltf_image.image), std::move(mipmaps));
 	}
+	else if (gltf_image.bufferView >= 0)
+	{
+		// Image stored in a buffer view of a binary gltf file, decoded straight from the file mapping
+		auto &buffer_view = model.bufferViews[gltf_image.bufferView];
+		auto *data        = get_buffer_view_data(gltf_image.bufferView);
+
+		if (gltf_image.mimeType == "image/png" || gltf_image.mimeType == "image/jpeg")
+		{
+			image = std::make_unique<sg::Stb>(gltf_image.name, data, buffer_view.byteLength, vkb::sg::Image::Unknown);
+		}
+		else if (gltf_image.mimeType == "image/ktx2")
+		{
+			image = std::make_unique<sg::Ktx>(gltf_image.name, data, buffer_view.byteLength, vkb::sg::Image::Unknown, ktx_transcode_target);
+		}
+		else
+		{
+			throw std::runtime_error("Unsupported image type " + gltf_image.mimeType + " for " + gltf_image.name);
+		}
+	}
+	else if (get_extension(gltf_image.uri) == "ktx2")
+	{
+		// Basis Universal data is transcoded on this loader thread
+		auto mapping = filesystem::get()->map_file(fs::path::get(fs::path::Type::Assets) + model_path + "/" + gltf_image.uri);
+		image        = std::make_unique<sg::Ktx>(gltf_image.name, mapping.data(), mapping.size(), vkb::sg::Image::Unknown, ktx_transcode_target);
+	}
 	else
 	{
 		// Load image from uri
@@ -1482,17 +2529,44 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 	}
 
 	// Check whether the format is supported by the GPU
+	bool decoded_astc = false;
 	if (sg::is_astc(image->get_format()))
 	{
 		if (!device.is_image_format_supported(image->get_format()))
 		{
 			LOGW("ASTC not supported: decoding {}", image->get_name());
-			image = std::make_unique<sg::Astc>(*image);
-			image->generate_mipmaps();
+			image        = std::make_unique<sg::Astc>(*image);
+			decoded_astc = true;
 		}
 	}
 
-	image->create_vk_image(device);
+	// PNG and JPG images only provide the base level, mipmaps are generated for them if enabled, and always for decoded ASTC images.
+	// They are generated on the GPU when the format allows, so that only the base level is staged
+	auto format        = image->get_format();
+	auto mipmap_method = MipmapGenerator::Method::None;
+	if ((generate_mipmaps || decoded_astc) && image->get_mipmaps().size() == 1 && image->get_layers() == 1 && format != VK_FORMAT_UNDEFINED && !sg::is_astc(format))
+	{
+		mipmap_method = MipmapGenerator::get_method(device, format, srgb);
+
+		if (mipmap_method == MipmapGenerator::Method::None &&
+		    (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB))
+		{
+			image->generate_mipmaps_srgb(srgb, mip_thread_count);
+		}
+	}
+
+	if (mipmap_method == MipmapGenerator::Method::None)
+	{
+		image->create_vk_image(device);
+	}
+	else
+	{
+		image->create_vk_image(device,
+		                       VK_IMAGE_VIEW_TYPE_2D,
+		                       MipmapGenerator::get_image_flags(mipmap_method, format),
+		                       MipmapGenerator::get_image_usage(mipmap_method),
+		                       MipmapGenerator::get_mip_levels(image->get_extent()));
+	}
 
 	return image;
 }
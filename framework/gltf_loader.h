@@ -26,11 +26,15 @@
 #define TINYGLTF_NO_EXTERNAL_IMAGE
 #include <tiny_gltf.h>
 
+#include "common/glm_common.h"
+#include "filesystem/filesystem.hpp"
+#include "scene_graph/components/image/ktx.h"
 #include "timer.h"
 
 #include "vulkan/vulkan.h"
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
+#define KHR_TEXTURE_BASISU_EXTENSION "KHR_texture_basisu"
 
 namespace vkb
 {
@@ -73,16 +77,52 @@ class GLTFLoader
   public:
 	GLTFLoader(Device &device);
 
-	virtual ~GLTFLoader() = default;
+	virtual ~GLTFLoader();
 
 	std::unique_ptr<sg::Scene> read_scene_from_file(const std::string &file_name, int scene_index = -1, VkBufferUsageFlags additional_buffer_usage_flags = 0);
 
+	/**
+	 * @brief Loads the structure of a scene and returns it right away, its meshes and images are then streamed in the background
+	 *        Textures show placeholder images and meshes have no submeshes until their data is published by update_streaming.
+	 *        Worker threads load the meshes and images that look the largest from the viewer first.
+	 *        The loader must outlive the streaming, or be destroyed before the scene to cancel it.
+	 */
+	std::unique_ptr<sg::Scene> read_scene_from_file_async(const std::string &file_name, int scene_index = -1, VkBufferUsageFlags additional_buffer_usage_flags = 0);
+
+	/**
+	 * @brief Publishes the streamed meshes and images to the scene, to be called by the render thread before recording a frame
+	 *        Images are uploaded with a transfer submitted from here, and published once it completed.
+	 * @param viewer_position World position the loading priorities are computed from
+	 * @return True while streaming is in progress
+	 */
+	bool update_streaming(const glm::vec3 &viewer_position);
+
+	/**
+	 * @return The fraction of the streamed meshes and images that have been published, 1 when streaming is done
+	 */
+	float get_streaming_progress() const;
+
 	/**
 	 * @brief Loads the first model from a GLTF file for use in simpler samples
 	 *        makes use of the Vertex struct in vulkan_example_base.h
 	 */
 	std::unique_ptr<sg::SubMesh> read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer = false, VkBufferUsageFlags additional_buffer_usage_flags = 0);
 
+	/**
+	 * @brief Enables the optimization of the indexed triangle meshes loaded by read_scene_from_file
+	 *        Indices are reordered for the vertex cache and overdraw, and vertices for fetch locality.
+	 *        Unless buffers need additional usages, normals and tangents are also quantized to 10 or 8 bit snorm,
+	 *        and texture coordinates to half floats.
+	 */
+	void set_mesh_optimization(bool enabled);
+
+	/**
+	 * @brief Enables the generation of mipmaps for the single level images loaded by read_scene_from_file, such as PNG and JPG images
+	 *        Mipmaps are generated on the GPU where the format allows, on the loader threads otherwise.
+	 *        They take an extra third of the image memory, and add to the load time when generated on the CPU.
+	 */
+	void set_mipmap_generation(bool enabled);
+
   protected:
 	virtual std::unique_ptr<sg::Node> parse_node(const tinygltf::Node &gltf_node, size_t index) const;
 
@@ -92,7 +132,13 @@ class GLTFLoader
 
 	virtual std::unique_ptr<sg::PBRMaterial> parse_material(const tinygltf::Material &gltf_material) const;
 
-	virtual std::unique_ptr<sg::Image> parse_image(tinygltf::Image &gltf_image) const;
+	/**
+	 * @brief Loads an image and creates its Vulkan image, generating mipmaps for single level images if enabled
+	 * @param gltf_image The glTF image to load
+	 * @param srgb Whether a material samples the image as sRGB, so that mipmaps are filtered in linear space
+	 * @param mip_thread_count Number of threads used to generate each mip level
+	 */
+	virtual std::unique_ptr<sg::Image> parse_image(tinygltf::Image &gltf_image, bool srgb = false, uint32_t mip_thread_count = 1) const;
 
 	virtual std::unique_ptr<sg::Sampler> parse_sampler(const tinygltf::Sampler &gltf_sampler) const;
 
@@ -130,11 +176,91 @@ class GLTFLoader
 
 	std::string model_path;
 
+	/// Mapping of the binary glTF file being loaded, its BIN chunk is read in place
+	vkb::filesystem::FileMapping glb_mapping;
+
+	/// Memory of each glTF buffer, either owned by the model or inside the mapped binary glTF file
+	std::vector<const uint8_t *> buffer_data;
+
+	/// Native format that KTX2 images with Basis Universal data are transcoded to
+	sg::Ktx::TranscodeTarget ktx_transcode_target{sg::Ktx::TranscodeTarget::Rgba8};
+
 	/// The extensions that the GLTFLoader can load mapped to whether they should be enabled or not
 	static std::unordered_map<std::string, bool> supported_extensions;
 
   private:
-	sg::Scene load_scene(int scene_index = -1, VkBufferUsageFlags additional_buffer_usage_flags = 0);
+	/// Memory of an accessor, valid while the model is loaded
+	struct AccessorView
+	{
+		const uint8_t *data;
+		size_t         count;
+		size_t         stride;
+	};
+
+	/// Totals of the optimized primitives of a scene, reported once it is loaded
+	struct MeshOptimizationStats
+	{
+		size_t triangle_count{0};
+		double cache_misses_before{0.0};
+		double cache_misses_after{0.0};
+		size_t bytes_before{0};
+		size_t bytes_after{0};
+	};
+
+	/// Meshes, images and upload state of a scene being streamed
+	struct StreamingState;
+
+	bool optimize_meshes{false};
+
+	bool generate_mipmaps{false};
+
+	std::unique_ptr<StreamingState> streaming;
+
+	/**
+	 * @brief Parses a .gltf or .glb file into the model
+	 * @param file_name Path of the file, relative to the assets folder
+	 */
+	bool load_model_file(const std::string &file_name);
+
+	/**
+	 * @brief Parses a memory-mapped binary glTF file
+	 *        tinygltf copies every buffer into the model, so the JSON chunk is patched to leave the BIN chunk
+	 *        and the images out, both are then read in place from the mapping.
+	 *        The buffer views and accessors are checked against the size of the buffers they read.
+	 */
+	bool load_glb_file(tinygltf::TinyGLTF &gltf_loader, const std::string &path, std::string &err, std::string &warn);
+
+	AccessorView get_accessor_view(uint32_t accessor_id) const;
+
+	const uint8_t *get_buffer_view_data(int buffer_view_index) const;
+
+	/**
+	 * @param stream Whether meshes and images are left to the streaming workers, textures then use placeholder images
+	 */
+	sg::Scene load_scene(int scene_index = -1, VkBufferUsageFlags additional_buffer_usage_flags = 0, bool stream = false);
+
+	/**
+	 * @brief Creates the submesh of a primitive, with its buffers filled, without its material
+	 */
+	std::unique_ptr<sg::SubMesh> load_primitive(const tinygltf::Mesh &gltf_mesh, size_t i_primitive, VkBufferUsageFlags additional_buffer_usage_flags,
+	                                            VkFormat normal_format, MeshOptimizationStats &stats);
+
+	/**
+	 * @brief Loads the pending mesh or image that looks the largest from the viewer, run by the streaming workers
+	 */
+	void run_streaming_job();
+
+	/**
+	 * @brief Records and submits the upload of loaded images, and publishes those of the previous upload once it completed
+	 */
+	void update_streaming_uploads();
+
+	/**
+	 * @brief Fills the buffers of an indexed triangle list primitive with optimized, and possibly quantized, data
+	 * @param normal_format Format of quantized normals and tangents, VK_FORMAT_UNDEFINED to keep all attributes unquantized
+	 */
+	void load_optimized_primitive(sg::SubMesh &submesh, const tinygltf::Primitive &gltf_primitive, const std::string &debug_name,
+	                              VkBufferUsageFlags additional_buffer_usage_flags, VkFormat normal_format, MeshOptimizationStats &stats);
 
 	std::unique_ptr<sg::SubMesh> load_model(uint32_t index, bool storage_buffer = false, VkBufferUsageFlags additional_buffer_usage_flags = 0);
 };
@@ -39,6 +39,7 @@
 #include "filesystem/legacy.h"
 #include "imgui_internal.h"
 #include "platform/window.h"
+#include "rendering/gpu_profiler.h"
 #include "rendering/render_context.h"
 #include "timer.h"
 #include "vulkan_sample.h"
@@ -495,6 +496,7 @@ void Gui::draw(CommandBuffer &command_buffer)
 	}
 
 	ScopedDebugLabel debug_label{command_buffer, "GUI"};
+	ScopedGpuZone    gpu_zone{command_buffer, "GUI"};
 
 	// Vertex input state
 	VkVertexInputBindingDescription vertex_input_binding{};
@@ -884,6 +886,9 @@ void Gui::show_debug_window(DebugInfo &debug_info, const ImVec2 &position)
 	ImGui::Columns(1);
 	ImGui::EndChild();
 
+	ImGui::Separator();
+	zone_timeline.draw(io.DisplaySize.x - 2 * style.WindowPadding.x);
+
 	ImGui::PopFont();
 	ImGui::End();
 }
@@ -964,6 +969,19 @@ void Gui::show_options_window(std::function<void()> body, const uint32_t lines)
 	ImGui::PopStyleVar();
 }
 
+void Gui::show_progress_window(const std::string &label, float progress) const
+{
+	auto &io = ImGui::GetIO();
+	ImGui::SetNextWindowBgAlpha(overlay_alpha);
+	ImGui::SetNextWindowPos(ImVec2{io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f}, ImGuiCond_Always, ImVec2{0.5f, 0.5f});
+
+	bool is_open = true;
+	ImGui::Begin("Progress", &is_open, info_flags);
+	ImGui::Text("%s", label.c_str());
+	ImGui::ProgressBar(progress, ImVec2{io.DisplaySize.x * 0.4f, 0.0f});
+	ImGui::End();
+}
+
 void Gui::show_simple_window(const std::string &name, uint32_t last_fps, std::function<void()> body)
 {
 	ImGuiIO &io = ImGui::GetIO();
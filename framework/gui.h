@@ -35,6 +35,7 @@
 #include "rendering/render_context.h"
 #include "stats/stats.h"
 #include "vulkan_sample.h"
+#include "zone_timeline.h"
 
 namespace vkb
 {
@@ -233,6 +234,13 @@ class Gui
 
 	void show_simple_window(const std::string &name, uint32_t last_fps, std::function<void()> body);
 
+	/**
+	 * @brief Shows a progress bar at the center of the screen
+	 * @param label Text shown above the bar
+	 * @param progress Fraction of the bar to fill, between 0 and 1
+	 */
+	void show_progress_window(const std::string &label, float progress) const;
+
 	bool input_event(const InputEvent &input_event);
 
 	/**
@@ -322,6 +330,9 @@ class Gui
 	bool show_graph_file_output = false;
 
 	uint32_t subpass = 0;
+
+	/// Appended last, HPPGui has the same layout
+	ZoneTimeline zone_timeline;
 };
 
 void Gui::new_frame()
@@ -17,6 +17,7 @@
 
 #include "heightmap.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/error.h"
@@ -40,27 +41,47 @@ HeightMap::HeightMap(const std::string &file_name, const uint32_t patchsize)
 	ktx_size_t   ktx_size  = ktxTexture_GetImageSize(ktx_texture, 0);
 	ktx_uint8_t *ktx_image = ktxTexture_GetData(ktx_texture);
 
-	dim  = ktx_texture->baseWidth;
-	data = new uint16_t[dim * dim];
+	dim = ktx_texture->baseWidth;
+	data.resize(dim * dim);
 
-	memcpy(data, ktx_image, ktx_size);
+	memcpy(data.data(), ktx_image, std::min<size_t>(ktx_size, data.size() * sizeof(uint16_t)));
 
 	this->scale = dim / patchsize;
 
 	ktxTexture_Destroy(ktx_texture);
 }
 
-HeightMap::~HeightMap()
-{
-	delete[] data;
-}
-
 float HeightMap::get_height(const uint32_t x, const uint32_t y)
 {
 	glm::ivec2 rpos = glm::ivec2(x, y) * glm::ivec2(scale);
 	rpos.x          = std::max(0, std::min(rpos.x, static_cast<int>(dim) - 1));
 	rpos.y          = std::max(0, std::min(rpos.y, static_cast<int>(dim) - 1));
 	rpos /= glm::ivec2(scale);
-	return *(data + (rpos.x + rpos.y * dim) * scale) / 65535.0f;
+	return data[(rpos.x + rpos.y * dim) * scale] / 65535.0f;
+}
+
+void HeightMap::get_heights(int32_t x, int32_t y, uint32_t count_x, uint32_t count_y, HeightMapAddressMode address_mode, float *heights) const
+{
+	sample_heights(get_view(), x, y, count_x, count_y, scale, address_mode, heights);
+}
+
+void HeightMap::get_normals(int32_t x, int32_t y, uint32_t count_x, uint32_t count_y, HeightMapAddressMode address_mode, float *normals, size_t normal_stride) const
+{
+	// One more sample on each side for the filter
+	std::vector<float> heights((count_x + 2) * (count_y + 2));
+	sample_heights(get_view(), x - 1, y - 1, count_x + 2, count_y + 2, scale, address_mode, heights.data());
+	compute_sobel_normals(heights.data(), count_x, count_y, normals, normal_stride);
+}
+
+void HeightMap::get_height_range(int32_t x, int32_t y, uint32_t width, uint32_t height, HeightMapAddressMode address_mode, float &min_height, float &max_height) const
+{
+	// Linear filtering reads the texels on either side of each coordinate
+	vkb::get_height_range(get_view(), x * static_cast<int32_t>(scale) - 1, y * static_cast<int32_t>(scale) - 1, width * scale + 2, height * scale + 2,
+	                      address_mode, min_height, max_height);
+}
+
+HeightMapView HeightMap::get_view() const
+{
+	return {data.data(), dim, dim};
 }
 }        // namespace vkb
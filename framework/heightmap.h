@@ -19,6 +19,9 @@
 
 #include <ktx.h>
 #include <string>
+#include <vector>
+
+#include <core/util/terrain.hpp>
 
 namespace vkb
 {
@@ -35,8 +38,6 @@ class HeightMap
 	 */
 	HeightMap(const std::string &filename, const uint32_t patchsize);
 
-	~HeightMap();
-
 	/**
 	 * @brief Retrieves a value from the heightmap at a specific coordinates
 	 * @param x The x coordinate
@@ -45,8 +46,45 @@ class HeightMap
 	 */
 	float get_height(const uint32_t x, const uint32_t y);
 
+	/**
+	 * @brief Retrieves a grid of heights, in the coordinates of get_height
+	 * @param x The first x coordinate
+	 * @param y The first y coordinate
+	 * @param count_x The number of columns
+	 * @param count_y The number of rows
+	 * @param address_mode How coordinates out of the heightmap are handled
+	 * @param heights Receives count_x * count_y heights, rows first
+	 */
+	void get_heights(int32_t x, int32_t y, uint32_t count_x, uint32_t count_y, HeightMapAddressMode address_mode, float *heights) const;
+
+	/**
+	 * @brief Computes the normals of a grid of vertices with a Sobel filter over the heights around each of them
+	 * @param x The first x coordinate
+	 * @param y The first y coordinate
+	 * @param count_x The number of columns
+	 * @param count_y The number of rows
+	 * @param address_mode How coordinates out of the heightmap are handled
+	 * @param normals Receives count_x * count_y normals, rows first, as three floats at the start of every normal_stride bytes
+	 * @param normal_stride The distance in bytes between two normals
+	 */
+	void get_normals(int32_t x, int32_t y, uint32_t count_x, uint32_t count_y, HeightMapAddressMode address_mode, float *normals, size_t normal_stride) const;
+
+	/**
+	 * @brief Retrieves the lowest and highest heights a linear sampler can read between two coordinates
+	 * @param x The first x coordinate
+	 * @param y The first y coordinate
+	 * @param width The distance to the last x coordinate
+	 * @param height The distance to the last y coordinate
+	 * @param address_mode How coordinates out of the heightmap are handled
+	 * @param min_height Receives the lowest height
+	 * @param max_height Receives the highest height
+	 */
+	void get_height_range(int32_t x, int32_t y, uint32_t width, uint32_t height, HeightMapAddressMode address_mode, float &min_height, float &max_height) const;
+
   private:
-	uint16_t *data;
+	HeightMapView get_view() const;
+
+	std::vector<uint16_t> data;
 
 	uint32_t dim;
 
@@ -473,6 +473,9 @@ void HPPApiVulkanSample::draw_ui(const vk::CommandBuffer command_buffer)
 
 void HPPApiVulkanSample::prepare_frame()
 {
+	// Deliver the readbacks that completed since the last frame
+	get_render_context().get_readback_service().update();
+
 	if (get_render_context().has_swapchain())
 	{
 		handle_surface_changes();
@@ -496,6 +499,9 @@ void HPPApiVulkanSample::prepare_frame()
 
 void HPPApiVulkanSample::submit_frame()
 {
+	// Readbacks recorded during the frame are submitted after its command buffers
+	get_render_context().get_readback_service().submit();
+
 	if (get_render_context().has_swapchain())
 	{
 		const auto &queue = get_device().get_queue_by_present(0);
@@ -542,7 +548,9 @@ void HPPApiVulkanSample::submit_frame()
 	// DO NOT USE
 	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
 	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	get_device().get_queue_by_present(0).get_handle().waitIdle();
+	// Without a swapchain (offscreen rendering) no queue supports presenting, the frame was submitted to the graphics queue
+	const auto &wait_queue = get_render_context().has_swapchain() ? get_device().get_queue_by_present(0) : get_device().get_queue_by_flags(vk::QueueFlagBits::eGraphics, 0);
+	wait_queue.get_handle().waitIdle();
 }
 
 HPPApiVulkanSample::~HPPApiVulkanSample()
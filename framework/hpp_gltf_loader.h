@@ -37,6 +37,10 @@ class HPPGLTFLoader : private vkb::GLTFLoader
 	    GLTFLoader(reinterpret_cast<vkb::Device &>(device))
 	{}
 
+	using vkb::GLTFLoader::get_streaming_progress;
+	using vkb::GLTFLoader::set_mesh_optimization;
+	using vkb::GLTFLoader::update_streaming;
+
 	std::unique_ptr<vkb::scene_graph::components::HPPSubMesh> read_model_from_file(
 	    const std::string &file_name, uint32_t index, bool storage_buffer = false, vk::BufferUsageFlags additional_buffer_usage_flags = {})
 	{
@@ -48,5 +52,10 @@ class HPPGLTFLoader : private vkb::GLTFLoader
 	{
 		return std::unique_ptr<vkb::scene_graph::HPPScene>(reinterpret_cast<vkb::scene_graph::HPPScene *>(vkb::GLTFLoader::read_scene_from_file(file_name, scene_index).release()));
 	}
+
+	std::unique_ptr<vkb::scene_graph::HPPScene> read_scene_from_file_async(const std::string &file_name, int scene_index = -1)
+	{
+		return std::unique_ptr<vkb::scene_graph::HPPScene>(reinterpret_cast<vkb::scene_graph::HPPScene *>(vkb::GLTFLoader::read_scene_from_file_async(file_name, scene_index).release()));
+	}
 };
 }        // namespace vkb
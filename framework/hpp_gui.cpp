@@ -20,6 +20,7 @@
 #include <common/hpp_utils.h>
 #include <core/hpp_command_pool.h>
 #include <imgui_internal.h>
+#include <rendering/gpu_profiler.h>
 
 #include <numeric>
 
@@ -461,6 +462,7 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 	}
 
 	vkb::core::HPPScopedDebugLabel debug_label(command_buffer, "GUI");
+	vkb::ScopedGpuZone             gpu_zone(reinterpret_cast<vkb::CommandBuffer &>(command_buffer), "GUI");
 
 	// Vertex input state
 	vk::VertexInputBindingDescription vertex_input_binding({}, to_u32(sizeof(ImDrawVert)));
@@ -831,6 +833,9 @@ void HPPGui::show_debug_window(const DebugInfo &debug_info, const ImVec2 &positi
 	ImGui::Columns(1);
 	ImGui::EndChild();
 
+	ImGui::Separator();
+	zone_timeline.draw(io.DisplaySize.x - 2 * style.WindowPadding.x);
+
 	ImGui::PopFont();
 	ImGui::End();
 }
@@ -911,6 +916,19 @@ void HPPGui::show_options_window(std::function<void()> body, const uint32_t line
 	ImGui::PopStyleVar();
 }
 
+void HPPGui::show_progress_window(const std::string &label, float progress) const
+{
+	auto &io = ImGui::GetIO();
+	ImGui::SetNextWindowBgAlpha(overlay_alpha);
+	ImGui::SetNextWindowPos(ImVec2{io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f}, ImGuiCond_Always, ImVec2{0.5f, 0.5f});
+
+	bool is_open = true;
+	ImGui::Begin("Progress", &is_open, info_flags);
+	ImGui::Text("%s", label.c_str());
+	ImGui::ProgressBar(progress, ImVec2{io.DisplaySize.x * 0.4f, 0.0f});
+	ImGui::End();
+}
+
 void HPPGui::show_simple_window(const std::string &name, uint32_t last_fps, std::function<void()> body) const
 {
 	ImGuiIO &io = ImGui::GetIO();
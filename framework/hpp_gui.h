@@ -27,6 +27,7 @@
 #include "filesystem/legacy.h"
 #include "platform/input_events.h"
 #include "stats/hpp_stats.h"
+#include "zone_timeline.h"
 
 namespace vkb
 {
@@ -207,6 +208,13 @@ class HPPGui
 
 	void show_simple_window(const std::string &name, uint32_t last_fps, std::function<void()> body) const;
 
+	/**
+	 * @brief Shows a progress bar at the center of the screen
+	 * @param label Text shown above the bar
+	 * @param progress Fraction of the bar to fill, between 0 and 1
+	 */
+	void show_progress_window(const std::string &label, float progress) const;
+
 	bool input_event(const InputEvent &input_event);
 
 	/**
@@ -284,5 +292,6 @@ class HPPGui
 	bool                                     two_finger_tap         = false;        // Whether or not the GUI has detected a multi touch gesture
 	bool                                     show_graph_file_output = false;
 	uint32_t                                 subpass                = 0;
+	ZoneTimeline                             zone_timeline;        // Appended last, Gui has the same layout
 };
 }        // namespace vkb
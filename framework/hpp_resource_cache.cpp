@@ -21,6 +21,7 @@
 #include <core/hpp_device.h>
 #include <core/hpp_image_view.h>
 #include <core/hpp_pipeline_layout.h>
+#include <core/util/startup_profiler.hpp>
 
 namespace vkb
 {
@@ -205,6 +206,8 @@ void HPPResourceCache::update_descriptor_sets(const std::vector<vkb::core::HPPIm
 
 void HPPResourceCache::warmup(const std::vector<uint8_t> &data)
 {
+	PROFILE_STARTUP_SCOPE("Warm up resource cache");
+
 	recorder.set_data(data);
 
 	replayer.play(*this, recorder);
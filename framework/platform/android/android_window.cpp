@@ -35,7 +35,7 @@ VkSurfaceKHR AndroidWindow::create_surface(Instance &instance)
 
 VkSurfaceKHR AndroidWindow::create_surface(VkInstance instance, VkPhysicalDevice)
 {
-	if (instance == VK_NULL_HANDLE || !handle || properties.mode == Mode::Headless)
+	if (instance == VK_NULL_HANDLE || !handle || properties.mode == Mode::Headless || properties.mode == Mode::Offscreen)
 	{
 		return VK_NULL_HANDLE;
 	}
@@ -25,6 +25,9 @@ namespace vkb
  * @brief Surface-less implementation of a Window using VK_EXT_headless_surface.
  * A surface and swapchain are still created but the the present operation resolves to a no op.
  * Useful for testing and benchmarking in CI environments.
+ *
+ * In Window::Mode::Offscreen no surface is created at all, the RenderContext renders into a ring of
+ * offscreen images instead. This works on implementations which do not expose VK_EXT_headless_surface.
  */
 class HeadlessWindow : public Window
 {
@@ -34,14 +37,14 @@ class HeadlessWindow : public Window
 	virtual ~HeadlessWindow() = default;
 
 	/**
-	 * @brief A direct window doesn't have a surface
-	 * @returns VK_NULL_HANDLE
+	 * @brief Creates a headless surface
+	 * @returns VK_NULL_HANDLE in offscreen mode
 	 */
 	VkSurfaceKHR create_surface(Instance &instance) override;
 
 	/**
-	 * @brief A direct window doesn't have a surface
-	 * @returns nullptr
+	 * @brief Creates a headless surface
+	 * @returns VK_NULL_HANDLE in offscreen mode
 	 */
 	VkSurfaceKHR create_surface(VkInstance instance, VkPhysicalDevice physical_device) override;
 
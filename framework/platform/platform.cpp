@@ -28,7 +28,9 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include "core/util/job_system.hpp"
 #include "core/util/logging.hpp"
+#include "core/util/startup_profiler.hpp"
 #include "force_close/force_close.h"
 #include "glsl_compiler.h"
 #include "platform/parsers/CLI11.h"
@@ -62,6 +64,8 @@ ExitCode Platform::initialize(const std::vector<Plugin *> &plugins)
 
 	LOGI("Logger initialized");
 
+	ZoneProfiler::get().set_thread_name("Main");
+
 	parser = std::make_unique<CLI11CommandParser>("vulkan_samples", "\n\tVulkan Samples\n\n\t\tA collection of samples to demonstrate the Vulkan best practice.\n", arguments);
 
 	// Process command line arguments
@@ -133,7 +137,19 @@ ExitCode Platform::main_loop_frame()
 
 			// Compensate for load times of the app by rendering the first frame pre-emptively
 			timer.tick<Timer::Seconds>();
-			active_app->update(0.01667f);
+			{
+				PROFILE_STARTUP_SCOPE("Render first frame");
+				active_app->update(0.01667f);
+			}
+
+			auto &startup_profiler = StartupProfiler::get();
+			startup_profiler.stop();
+
+			LOGI("Time to first frame:");
+			for (auto &line : startup_profiler.to_lines())
+			{
+				LOGI("  {}", line);
+			}
 		}
 
 		if (!active_app)
@@ -141,6 +157,8 @@ ExitCode Platform::main_loop_frame()
 			return ExitCode::NoSample;
 		}
 
+		ZoneProfiler::get().mark_frame();
+
 		update();
 
 		if (active_app->should_close())
@@ -205,7 +223,10 @@ void Platform::update()
 		active_app->update_overlay(delta_time, [=]() {
 			on_update_ui_overlay(*active_app->get_drawer());
 		});
-		active_app->update(delta_time);
+		{
+			PROFILE_SCOPE("Update app");
+			active_app->update(delta_time);
+		}
 
 		if (auto *app = dynamic_cast<VulkanSampleCpp *>(active_app.get()))
 		{
@@ -259,6 +280,9 @@ void Platform::terminate(ExitCode code)
 	active_app.reset();
 	window.reset();
 
+	// Joined while the loggers still exist, rather than during the destruction of static objects
+	JobSystem::get().shutdown();
+
 	spdlog::drop_all();
 
 	on_platform_close();
@@ -378,7 +402,13 @@ bool Platform::start_app()
 	// Reset target environment to default prior to each sample to properly support batch mode
 	vkb::GLSLCompiler::reset_target_environment();
 
-	active_app = requested_app_info->create();
+	// Time the startup of the app until its first frame is rendered
+	StartupProfiler::get().start(requested_app_info->id);
+
+	{
+		PROFILE_STARTUP_SCOPE("Create app");
+		active_app = requested_app_info->create();
+	}
 
 	if (!active_app)
 	{
@@ -388,10 +418,13 @@ bool Platform::start_app()
 	auto sample_info = static_cast<const apps::SampleInfo *>(requested_app_info);
 	active_app->set_name(sample_info->name);
 
-	if (!active_app->prepare({false, window.get()}))
 	{
-		LOGE("Failed to prepare vulkan app.");
-		return false;
+		PROFILE_STARTUP_SCOPE("Prepare app");
+		if (!active_app->prepare({false, window.get()}))
+		{
+			LOGE("Failed to prepare vulkan app.");
+			return false;
+		}
 	}
 
 	on_app_start(requested_app_info->id);
@@ -50,7 +50,7 @@ UnixPlatform::UnixPlatform(const PlatformContext &context, const UnixType &type)
 
 void UnixPlatform::create_window(const Window::Properties &properties)
 {
-	if (properties.mode == vkb::Window::Mode::Headless)
+	if (properties.mode == vkb::Window::Mode::Headless || properties.mode == vkb::Window::Mode::Offscreen)
 	{
 		window = std::make_unique<HeadlessWindow>(properties);
 	}
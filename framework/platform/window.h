@@ -44,6 +44,7 @@ class Window
 	enum class Mode
 	{
 		Headless,
+		Offscreen,
 		Fullscreen,
 		FullscreenBorderless,
 		FullscreenStretch,
@@ -0,0 +1,303 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_profiler.h"
+
+#include <algorithm>
+
+#include <core/util/logging.hpp>
+#include <core/util/zone_profiler.hpp>
+
+#include "core/command_buffer.h"
+#include "core/command_pool.h"
+#include "core/device.h"
+#include "rendering/render_frame.h"
+
+namespace vkb
+{
+namespace
+{
+VkQueryPoolCreateInfo get_query_pool_create_info()
+{
+	VkQueryPoolCreateInfo create_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	create_info.queryCount = GpuZoneQueries::MAX_ZONE_COUNT * 2;
+	return create_info;
+}
+}        // namespace
+
+GpuProfiler &GpuProfiler::get()
+{
+	static GpuProfiler profiler;
+	return profiler;
+}
+
+std::vector<GpuProfiler::PassTime> GpuProfiler::get_last_frame() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+	return last_frame;
+}
+
+double GpuProfiler::get_last_frame_time() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	double time_ms = 0.0;
+	for (auto &pass : last_frame)
+	{
+		if (pass.depth == 0)
+		{
+			time_ms += pass.time_ms;
+		}
+	}
+	return time_ms * 1e-3;
+}
+
+std::vector<GpuProfiler::PassAverage> GpuProfiler::get_averages() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	std::vector<PassAverage> averages;
+	averages.reserve(totals.size());
+	for (auto &total : totals)
+	{
+		averages.push_back({total.name, total.total_ms / total.frame_count, total.frame_count});
+	}
+	return averages;
+}
+
+void GpuProfiler::reset_averages()
+{
+	std::lock_guard<std::mutex> lock{mutex};
+	totals.clear();
+	total_indices.clear();
+}
+
+const char *GpuProfiler::intern(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{names_mutex};
+	return names.insert(name).first->c_str();
+}
+
+void GpuProfiler::add_frame(std::vector<PassTime> &&passes)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	for (auto &pass : passes)
+	{
+		auto it = total_indices.find(pass.name);
+		if (it == total_indices.end())
+		{
+			it = total_indices.emplace(pass.name, totals.size()).first;
+			totals.push_back({pass.name, 0.0, 0});
+		}
+
+		// A pass recorded several times in a frame counts once, with the sum of its times
+		auto &total = totals[it->second];
+		total.total_ms += pass.time_ms;
+		if (std::none_of(passes.data(), &pass, [&pass](const PassTime &other) { return other.name == pass.name; }))
+		{
+			total.frame_count++;
+		}
+	}
+
+	last_frame = std::move(passes);
+}
+
+bool GpuZoneQueries::is_supported(Device &device)
+{
+	if (!device.get_gpu().get_properties().limits.timestampComputeAndGraphics || !device.is_enabled("VK_EXT_host_query_reset"))
+	{
+		return false;
+	}
+
+	return device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_properties().timestampValidBits != 0;
+}
+
+GpuZoneQueries::GpuZoneQueries(Device &device) :
+    device{device},
+    query_pool{device, get_query_pool_create_info()},
+    timestamp_period{device.get_gpu().get_properties().limits.timestampPeriod}
+{
+	uint32_t valid_bits = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_properties().timestampValidBits;
+	timestamp_mask      = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+	// Queries must be reset before their first use
+	query_pool.host_reset(0, MAX_ZONE_COUNT * 2);
+
+	if (device.is_enabled("VK_EXT_calibrated_timestamps"))
+	{
+		uint32_t time_domain_count = 0;
+		VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &time_domain_count, nullptr));
+		std::vector<VkTimeDomainEXT> time_domains(time_domain_count);
+		VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &time_domain_count, time_domains.data()));
+
+		has_calibrated_timestamps = std::find(time_domains.begin(), time_domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != time_domains.end();
+	}
+}
+
+uint32_t GpuZoneQueries::begin_zone(CommandBuffer &command_buffer, const std::string &name)
+{
+	uint32_t zone_index;
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+
+		if (zones.size() == MAX_ZONE_COUNT)
+		{
+			return MAX_ZONE_COUNT;
+		}
+
+		if (zones.empty())
+		{
+			first_record_ns = ZoneProfiler::now_ns();
+		}
+
+		zone_index = static_cast<uint32_t>(zones.size());
+		zones.push_back({GpuProfiler::get().intern(name), open_zone_counts[command_buffer.get_handle()]++});
+	}
+
+	command_buffer.write_timestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, zone_index * 2);
+
+	return zone_index;
+}
+
+void GpuZoneQueries::end_zone(CommandBuffer &command_buffer, uint32_t zone_index)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		open_zone_counts[command_buffer.get_handle()]--;
+	}
+
+	command_buffer.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, zone_index * 2 + 1);
+}
+
+void GpuZoneQueries::resolve()
+{
+	std::vector<Zone> recorded_zones;
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		std::swap(recorded_zones, zones);
+		open_zone_counts.clear();
+	}
+
+	if (recorded_zones.empty())
+	{
+		return;
+	}
+
+	// Each timestamp is followed by its availability, zones of command buffers which were not submitted are not available
+	uint32_t              query_count = static_cast<uint32_t>(recorded_zones.size()) * 2;
+	std::vector<uint64_t> results(query_count * 2);
+	VkResult              result = query_pool.get_results(0, query_count, results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+	                                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	query_pool.host_reset(0, query_count);
+
+	if (result != VK_SUCCESS && result != VK_NOT_READY)
+	{
+		LOGW("Failed to read back the GPU zones: {}", to_string(result));
+		return;
+	}
+
+	// Zones are placed on the CPU timeline from a pair of GPU and CPU times taken at the same moment,
+	// or else from the first zone, as if it began when it was recorded
+	bool     record_zones    = ZoneProfiler::is_enabled();
+	uint64_t reference_ticks = 0;
+	uint64_t reference_ns    = 0;
+	bool     has_reference   = record_zones && has_calibrated_timestamps && calibrate(reference_ticks, reference_ns);
+
+	std::vector<GpuProfiler::PassTime> passes;
+	passes.reserve(recorded_zones.size());
+
+	for (size_t i = 0; i < recorded_zones.size(); ++i)
+	{
+		const uint64_t *zone_results = &results[i * 4];
+		if (zone_results[1] == 0 || zone_results[3] == 0)
+		{
+			continue;
+		}
+
+		uint64_t begin_ticks = zone_results[0];
+		uint64_t end_ticks   = zone_results[2];
+		double   duration_ns = static_cast<double>((end_ticks - begin_ticks) & timestamp_mask) * timestamp_period;
+
+		passes.push_back({recorded_zones[i].name, recorded_zones[i].depth, duration_ns * 1e-6});
+
+		if (record_zones)
+		{
+			if (!has_reference)
+			{
+				reference_ticks = begin_ticks;
+				reference_ns    = first_record_ns;
+				has_reference   = true;
+			}
+
+			// Ticks wrap around past timestamp_mask, zones far before the reference appear as far after it
+			uint64_t ticks_after  = (begin_ticks - reference_ticks) & timestamp_mask;
+			int64_t  offset_ticks = ticks_after > timestamp_mask / 2 ? -static_cast<int64_t>((reference_ticks - begin_ticks) & timestamp_mask) : static_cast<int64_t>(ticks_after);
+
+			uint64_t begin_ns = reference_ns + static_cast<int64_t>(static_cast<double>(offset_ticks) * timestamp_period);
+			ZoneProfiler::get().record_zone("GPU", recorded_zones[i].name, begin_ns, begin_ns + static_cast<uint64_t>(duration_ns), recorded_zones[i].depth);
+		}
+	}
+
+	GpuProfiler::get().add_frame(std::move(passes));
+}
+
+bool GpuZoneQueries::calibrate(uint64_t &gpu_ticks, uint64_t &cpu_ns)
+{
+	VkCalibratedTimestampInfoEXT timestamp_info{VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT};
+	timestamp_info.timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+
+	// The CPU time is taken around the call rather than from a host time domain, which is a different clock on each platform
+	uint64_t max_deviation = 0;
+	uint64_t before_ns     = ZoneProfiler::now_ns();
+	VkResult result        = vkGetCalibratedTimestampsEXT(device.get_handle(), 1, &timestamp_info, &gpu_ticks, &max_deviation);
+	uint64_t after_ns      = ZoneProfiler::now_ns();
+
+	cpu_ns = before_ns + (after_ns - before_ns) / 2;
+	return result == VK_SUCCESS;
+}
+
+ScopedGpuZone::ScopedGpuZone(CommandBuffer &command_buffer, const std::string &name) :
+    command_buffer{command_buffer}
+{
+	auto *render_frame = command_buffer.get_command_pool().get_render_frame();
+	if (!render_frame)
+	{
+		return;
+	}
+
+	if (command_buffer.level == VK_COMMAND_BUFFER_LEVEL_PRIMARY && command_buffer.get_subpass_contents() == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+	{
+		return;
+	}
+
+	queries = render_frame->get_gpu_zone_queries();
+	if (queries)
+	{
+		zone_index = queries->begin_zone(command_buffer, name);
+	}
+}
+
+ScopedGpuZone::~ScopedGpuZone()
+{
+	if (queries && zone_index < GpuZoneQueries::MAX_ZONE_COUNT)
+	{
+		queries->end_zone(command_buffer, zone_index);
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,208 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/query_pool.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+/**
+ * @brief Collects the GPU time of the passes timed with ScopedGpuZone
+ *
+ * The zones of a frame are read back once the frame is reused and its fence was waited, so reading them never
+ * waits for the GPU. They are also recorded as the "GPU" track of ZoneProfiler, on the CPU timeline when
+ * VK_EXT_calibrated_timestamps is enabled.
+ */
+class GpuProfiler
+{
+  public:
+	struct PassTime
+	{
+		std::string name;
+
+		// Number of zones the pass is nested in
+		uint32_t depth;
+
+		double time_ms;
+	};
+
+	struct PassAverage
+	{
+		std::string name;
+
+		double average_ms;
+
+		uint32_t frame_count;
+	};
+
+	static GpuProfiler &get();
+
+	/**
+	 * @return The passes of the last frame read back, in the order they were recorded
+	 */
+	std::vector<PassTime> get_last_frame() const;
+
+	/**
+	 * @return The GPU time of the outermost passes of the last frame read back, in seconds
+	 */
+	double get_last_frame_time() const;
+
+	/**
+	 * @return The average time of each pass since the last call to reset_averages
+	 */
+	std::vector<PassAverage> get_averages() const;
+
+	void reset_averages();
+
+	/**
+	 * @return A copy of the name which stays valid until the app exits, as zone names of ZoneProfiler must
+	 */
+	const char *intern(const std::string &name);
+
+	/**
+	 * @brief Called by GpuZoneQueries with the passes of a frame once they were read back
+	 */
+	void add_frame(std::vector<PassTime> &&passes);
+
+  private:
+	struct PassTotal
+	{
+		std::string name;
+
+		double total_ms;
+
+		uint32_t frame_count;
+	};
+
+	mutable std::mutex mutex;
+
+	std::vector<PassTime> last_frame;
+
+	// In the order the passes were first seen
+	std::vector<PassTotal> totals;
+
+	std::unordered_map<std::string, size_t> total_indices;
+
+	std::mutex names_mutex;
+
+	std::unordered_set<std::string> names;
+};
+
+/**
+ * @brief The timestamp queries of the GPU zones of a render frame
+ *
+ * Each zone writes a timestamp when it begins and when it ends, into the query pool of the frame. Zones may be
+ * recorded from several threads, into different command buffers.
+ */
+class GpuZoneQueries
+{
+  public:
+	// Zones a frame can time, the others are ignored
+	static constexpr uint32_t MAX_ZONE_COUNT = 128;
+
+	/**
+	 * @return Whether the device can time zones, which needs timestamps on graphics queues and host query resets
+	 */
+	static bool is_supported(Device &device);
+
+	explicit GpuZoneQueries(Device &device);
+
+	/**
+	 * @return The index of the zone, or MAX_ZONE_COUNT if the frame has no query left
+	 */
+	uint32_t begin_zone(CommandBuffer &command_buffer, const std::string &name);
+
+	void end_zone(CommandBuffer &command_buffer, uint32_t zone_index);
+
+	/**
+	 * @brief Reads back the zones recorded since the last call and resets their queries,
+	 *        called once the fence of the frame was waited
+	 */
+	void resolve();
+
+  private:
+	struct Zone
+	{
+		const char *name;
+
+		uint32_t depth;
+	};
+
+	Device &device;
+
+	QueryPool query_pool;
+
+	// Nanoseconds per timestamp tick
+	double timestamp_period;
+
+	uint64_t timestamp_mask;
+
+	bool has_calibrated_timestamps{false};
+
+	std::mutex mutex;
+
+	std::vector<Zone> zones;
+
+	// Zones begun and not ended yet in each command buffer, for nesting
+	std::unordered_map<VkCommandBuffer, uint32_t> open_zone_counts;
+
+	// When the first zone of the frame was recorded, to place the zones without calibrated timestamps
+	uint64_t first_record_ns{0};
+
+	/**
+	 * @brief Samples the GPU and CPU clocks at the same time
+	 * @return Whether calibrated timestamps are supported
+	 */
+	bool calibrate(uint64_t &gpu_ticks, uint64_t &cpu_ns);
+};
+
+/**
+ * @brief Times the commands recorded during its lifetime on the GPU, if the command buffer belongs to a render frame
+ *
+ * Nothing is timed inside of a subpass whose commands are recorded into secondary command buffers, as timestamps
+ * cannot be written into the primary command buffer there.
+ */
+class ScopedGpuZone
+{
+  public:
+	ScopedGpuZone(CommandBuffer &command_buffer, const std::string &name);
+
+	~ScopedGpuZone();
+
+	ScopedGpuZone(const ScopedGpuZone &) = delete;
+
+	ScopedGpuZone &operator=(const ScopedGpuZone &) = delete;
+
+  private:
+	CommandBuffer &command_buffer;
+
+	GpuZoneQueries *queries{nullptr};
+
+	uint32_t zone_index{GpuZoneQueries::MAX_ZONE_COUNT};
+};
+}        // namespace vkb
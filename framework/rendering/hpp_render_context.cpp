@@ -19,6 +19,7 @@
 #include "hpp_render_context.h"
 
 #include <core/hpp_image.h>
+#include <core/util/profiling.hpp>
 
 namespace vkb
 {
@@ -26,13 +27,16 @@ namespace rendering
 {
 vk::Format HPPRenderContext::DEFAULT_VK_FORMAT = vk::Format::eR8G8B8A8Srgb;
 
+uint32_t HPPRenderContext::OFFSCREEN_FRAME_COUNT = 3;
+
 HPPRenderContext::HPPRenderContext(vkb::core::HPPDevice                    &device,
                                    vk::SurfaceKHR                           surface,
                                    const vkb::Window                       &window,
                                    vk::PresentModeKHR                       present_mode,
                                    std::vector<vk::PresentModeKHR> const   &present_mode_priority_list,
                                    std::vector<vk::SurfaceFormatKHR> const &surface_format_priority_list) :
-    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}
+    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height},
+    readback_service{reinterpret_cast<vkb::Device &>(device), reinterpret_cast<vkb::Queue const &>(queue)}
 {
 	if (surface)
 	{
@@ -69,17 +73,20 @@ void HPPRenderContext::prepare(size_t thread_count, vkb::rendering::HPPRenderTar
 	}
 	else
 	{
-		// Otherwise, create a single RenderFrame
+		// Otherwise, create a ring of offscreen RenderFrames, so that the CPU records a frame while the GPU renders the previous ones
 		swapchain = nullptr;
 
-		auto color_image = vkb::core::HPPImage{device,
-		                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
-		                                       DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
-		                                       VMA_MEMORY_USAGE_GPU_ONLY};
+		for (uint32_t i = 0; i < OFFSCREEN_FRAME_COUNT; ++i)
+		{
+			auto color_image = vkb::core::HPPImage{device,
+			                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
+			                                       DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+			                                       VMA_MEMORY_USAGE_GPU_ONLY};
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+			auto render_target = create_render_target_func(std::move(color_image));
+			frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+		}
 	}
 
 	this->create_render_target_func = create_render_target_func;
@@ -237,6 +244,7 @@ vkb::core::HPPCommandBuffer &HPPRenderContext::begin(vkb::core::HPPCommandBuffer
 
 	if (!frame_active)
 	{
+		PROFILE_SCOPE("Begin frame");
 		begin_frame();
 	}
 
@@ -256,6 +264,8 @@ void HPPRenderContext::submit(vkb::core::HPPCommandBuffer &command_buffer)
 
 void HPPRenderContext::submit(const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers)
 {
+	PROFILE_SCOPE("Submit frame");
+
 	assert(frame_active && "HPPRenderContext is inactive, cannot submit command buffer. Please call begin()");
 
 	vk::Semaphore render_semaphore;
@@ -326,12 +336,19 @@ void HPPRenderContext::begin_frame()
 			return;
 		}
 	}
+	else
+	{
+		// Without a swapchain to acquire from, go through the offscreen frames in order
+		active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
+	}
 
 	// Now the frame is active again
 	frame_active = true;
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	readback_service.update();
 }
 
 vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue                        &queue,
@@ -383,6 +400,8 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
 
+	readback_service.submit();
+
 	if (swapchain)
 	{
 		vk::SwapchainKHR   vk_swapchain = swapchain->get_handle();
@@ -511,5 +530,10 @@ std::vector<std::unique_ptr<vkb::rendering::HPPRenderFrame>> &HPPRenderContext::
 	return frames;
 }
 
+vkb::ReadbackService &HPPRenderContext::get_readback_service()
+{
+	return readback_service;
+}
+
 }        // namespace rendering
 }        // namespace vkb
@@ -22,6 +22,7 @@
 #include <core/hpp_swapchain.h>
 #include <platform/window.h>
 #include <rendering/hpp_render_frame.h>
+#include <rendering/readback_service.h>
 
 namespace vkb
 {
@@ -38,6 +39,9 @@ class HPPRenderContext
 	// The format to use for the RenderTargets if a swapchain isn't created
 	static vk::Format DEFAULT_VK_FORMAT;
 
+	// The number of RenderFrames rendered in flight if a swapchain isn't created
+	static uint32_t OFFSCREEN_FRAME_COUNT;
+
 	/**
 	 * @brief Constructor
 	 * @param device A valid device
@@ -194,6 +198,8 @@ class HPPRenderContext
 
 	std::vector<std::unique_ptr<HPPRenderFrame>> &get_render_frames();
 
+	vkb::ReadbackService &get_readback_service();
+
 	/**
 	 * @brief Handles surface changes, only applicable if the render_context makes use of a swapchain
 	 */
@@ -237,6 +243,8 @@ class HPPRenderContext
 	vk::SurfaceTransformFlagBitsKHR pre_transform{vk::SurfaceTransformFlagBitsKHR::eIdentity};
 
 	size_t thread_count{1};
+
+	vkb::ReadbackService readback_service;
 };
 
 }        // namespace rendering
@@ -51,6 +51,12 @@ HPPRenderFrame::HPPRenderFrame(vkb::core::HPPDevice &device, std::unique_ptr<vkb
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, vkb::core::HPPDescriptorPool>>());
 		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>>());
 	}
+
+	auto &c_device = reinterpret_cast<vkb::Device &>(device);
+	if (vkb::GpuZoneQueries::is_supported(c_device))
+	{
+		gpu_zone_queries = std::make_unique<vkb::GpuZoneQueries>(c_device);
+	}
 }
 
 vkb::BufferAllocationCpp HPPRenderFrame::allocate_buffer(const vk::BufferUsageFlags usage, const vk::DeviceSize size, size_t thread_index)
@@ -259,6 +265,12 @@ void HPPRenderFrame::reset()
 
 	fence_pool.reset();
 
+	// The GPU is done with the frame, so its zones are read back without waiting
+	if (gpu_zone_queries)
+	{
+		gpu_zone_queries->resolve();
+	}
+
 	for (auto &command_pools_per_queue : command_pools)
 	{
 		for (auto &command_pool : command_pools_per_queue.second)
@@ -304,6 +316,11 @@ void HPPRenderFrame::update_descriptor_sets(size_t thread_index)
 	}
 }
 
+vkb::GpuZoneQueries *HPPRenderFrame::get_gpu_zone_queries()
+{
+	return gpu_zone_queries.get();
+}
+
 void HPPRenderFrame::update_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target)
 {
 	swapchain_render_target = std::move(render_target);
@@ -19,6 +19,7 @@
 
 #include "buffer_pool.h"
 #include <core/hpp_device.h>
+#include <rendering/gpu_profiler.h>
 #include <hpp_semaphore_pool.h>
 #include <vulkan/vulkan_hash.hpp>
 
@@ -129,6 +130,11 @@ class HPPRenderFrame
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @return The timestamp queries of the GPU zones recorded in this frame, or nullptr if the device cannot time them
+	 */
+	vkb::GpuZoneQueries *get_gpu_zone_queries();
+
   private:
 	/**
 	 * @brief Retrieve the frame's command pool(s)
@@ -176,6 +182,8 @@ class HPPRenderFrame
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<vk::BufferUsageFlags, std::vector<std::pair<vkb::BufferPoolCpp, vkb::BufferBlockCpp *>>> buffer_pools;
+
+	std::unique_ptr<vkb::GpuZoneQueries> gpu_zone_queries;
 };
 }        // namespace rendering
 }        // namespace vkb
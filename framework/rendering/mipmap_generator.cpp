@@ -0,0 +1,353 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/mipmap_generator.h"
+
+#include <array>
+
+#include "common/utils.h"
+#include "common/vk_initializers.h"
+
+namespace vkb
+{
+namespace
+{
+// Workgroup size of the downsampling shader
+constexpr uint32_t WORKGROUP_SIZE = 8;
+
+bool is_srgb(VkFormat format)
+{
+	return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_A8B8G8R8_SRGB_PACK32;
+}
+
+VkImageSubresourceRange get_level_range(const core::Image &image, uint32_t base_level, uint32_t level_count)
+{
+	VkImageSubresourceRange range{};
+	range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+	range.baseMipLevel   = base_level;
+	range.levelCount     = level_count;
+	range.baseArrayLayer = 0;
+	range.layerCount     = image.get_array_layer_count();
+	return range;
+}
+}        // namespace
+
+MipmapGenerator::MipmapGenerator(Device &device) :
+    device{device}
+{
+}
+
+MipmapGenerator::~MipmapGenerator()
+{
+	release_transient_resources();
+
+	if (pipeline != VK_NULL_HANDLE)
+	{
+		vkDestroyPipeline(device.get_handle(), pipeline, nullptr);
+	}
+
+	if (pipeline_layout != VK_NULL_HANDLE)
+	{
+		vkDestroyPipelineLayout(device.get_handle(), pipeline_layout, nullptr);
+	}
+
+	if (descriptor_set_layout != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorSetLayout(device.get_handle(), descriptor_set_layout, nullptr);
+	}
+}
+
+uint32_t MipmapGenerator::get_mip_levels(const VkExtent3D &extent)
+{
+	uint32_t size   = std::max(extent.width, extent.height);
+	uint32_t levels = 1;
+	while (size > 1)
+	{
+		size >>= 1;
+		++levels;
+	}
+	return levels;
+}
+
+MipmapGenerator::Method MipmapGenerator::get_method(Device &device, VkFormat format, bool srgb)
+{
+	const VkFormatProperties properties = device.get_gpu().get_format_properties(format);
+
+	const VkFormatFeatureFlags blit_features = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+	bool                       can_blit      = (properties.optimalTilingFeatures & blit_features) == blit_features;
+
+	// The compute path writes through R8G8B8A8_UNORM views, the image format itself only has to support sampling
+	// sRGB images need extended usage to get the storage usage their format does not support
+	bool can_compute = false;
+	if (format == VK_FORMAT_R8G8B8A8_UNORM ||
+	    (format == VK_FORMAT_R8G8B8A8_SRGB && device.is_enabled(VK_KHR_MAINTENANCE_2_EXTENSION_NAME)))
+	{
+		const VkFormatProperties view_properties = device.get_gpu().get_format_properties(VK_FORMAT_R8G8B8A8_UNORM);
+
+		can_compute = view_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+	}
+
+	// Blits filter in the color space of the format, which is wrong for sRGB data in a UNORM image
+	bool blit_is_gamma_correct = !srgb || is_srgb(format);
+
+	if (can_compute && !blit_is_gamma_correct)
+	{
+		return Method::Compute;
+	}
+	else if (can_blit)
+	{
+		return Method::Blit;
+	}
+	else if (can_compute)
+	{
+		return Method::Compute;
+	}
+
+	return Method::None;
+}
+
+VkImageUsageFlags MipmapGenerator::get_image_usage(Method method)
+{
+	switch (method)
+	{
+		case Method::Blit:
+			return VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		case Method::Compute:
+			return VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		default:
+			return 0;
+	}
+}
+
+VkImageCreateFlags MipmapGenerator::get_image_flags(Method method, VkFormat format)
+{
+	// Other formats are written through UNORM views, and get the storage usage they may not support through extended usage
+	if (method == Method::Compute && format != VK_FORMAT_R8G8B8A8_UNORM)
+	{
+		return VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+	}
+
+	return 0;
+}
+
+void MipmapGenerator::record(VkCommandBuffer command_buffer, const core::Image &image, Method method, bool srgb)
+{
+	assert(image.get_type() == VK_IMAGE_TYPE_2D && "Mipmaps can only be generated for 2D images");
+	assert(method != Method::None && "Mipmaps have to be generated on the CPU");
+
+	if (method == Method::Blit || image.get_subresource().mipLevel == 1)
+	{
+		record_blit(command_buffer, image);
+	}
+	else
+	{
+		// Views use a UNORM format, so sRGB formats are converted in the shader
+		record_compute(command_buffer, image, srgb || is_srgb(image.get_format()));
+	}
+}
+
+void MipmapGenerator::release_transient_resources()
+{
+	for (auto image_view : image_views)
+	{
+		vkDestroyImageView(device.get_handle(), image_view, nullptr);
+	}
+	image_views.clear();
+
+	for (auto descriptor_pool : descriptor_pools)
+	{
+		vkDestroyDescriptorPool(device.get_handle(), descriptor_pool, nullptr);
+	}
+	descriptor_pools.clear();
+}
+
+void MipmapGenerator::record_blit(VkCommandBuffer command_buffer, const core::Image &image)
+{
+	const auto    &extent      = image.get_extent();
+	const uint32_t level_count = image.get_subresource().mipLevel;
+
+	for (uint32_t level = 1; level < level_count; ++level)
+	{
+		// The previous level becomes the source of the blit
+		vkb::image_layout_transition(command_buffer,
+		                             image.get_handle(),
+		                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		                             get_level_range(image, level - 1, 1));
+
+		VkImageBlit image_blit{};
+		image_blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		image_blit.srcSubresource.mipLevel   = level - 1;
+		image_blit.srcSubresource.layerCount = image.get_array_layer_count();
+		image_blit.srcOffsets[1].x           = static_cast<int32_t>(std::max(1u, extent.width >> (level - 1)));
+		image_blit.srcOffsets[1].y           = static_cast<int32_t>(std::max(1u, extent.height >> (level - 1)));
+		image_blit.srcOffsets[1].z           = 1;
+		image_blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		image_blit.dstSubresource.mipLevel   = level;
+		image_blit.dstSubresource.layerCount = image.get_array_layer_count();
+		image_blit.dstOffsets[1].x           = static_cast<int32_t>(std::max(1u, extent.width >> level));
+		image_blit.dstOffsets[1].y           = static_cast<int32_t>(std::max(1u, extent.height >> level));
+		image_blit.dstOffsets[1].z           = 1;
+
+		vkCmdBlitImage(command_buffer,
+		               image.get_handle(),
+		               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		               image.get_handle(),
+		               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		               1,
+		               &image_blit,
+		               VK_FILTER_LINEAR);
+	}
+
+	// All levels but the last one were used as blit sources
+	if (level_count > 1)
+	{
+		vkb::image_layout_transition(command_buffer,
+		                             image.get_handle(),
+		                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		                             get_level_range(image, 0, level_count - 1));
+	}
+
+	vkb::image_layout_transition(command_buffer,
+	                             image.get_handle(),
+	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                             get_level_range(image, level_count - 1, 1));
+}
+
+void MipmapGenerator::record_compute(VkCommandBuffer command_buffer, const core::Image &image, bool srgb)
+{
+	prepare_pipeline();
+
+	const auto    &extent      = image.get_extent();
+	const uint32_t level_count = image.get_subresource().mipLevel;
+	const uint32_t layer_count = image.get_array_layer_count();
+
+	// One storage view per level, each level is written once and read once
+	std::vector<VkImageView> level_views(level_count);
+	for (uint32_t level = 0; level < level_count; ++level)
+	{
+		VkImageViewCreateInfo view_create_info = vkb::initializers::image_view_create_info();
+		view_create_info.image                 = image.get_handle();
+		view_create_info.viewType              = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+		view_create_info.format                = VK_FORMAT_R8G8B8A8_UNORM;
+		view_create_info.subresourceRange      = get_level_range(image, level, 1);
+		VK_CHECK(vkCreateImageView(device.get_handle(), &view_create_info, nullptr, &level_views[level]));
+		image_views.push_back(level_views[level]);
+	}
+
+	std::vector<VkDescriptorPoolSize> pool_sizes = {vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2 * (level_count - 1))};
+	VkDescriptorPoolCreateInfo        pool_info  = vkb::initializers::descriptor_pool_create_info(pool_sizes, level_count - 1);
+	VkDescriptorPool                  descriptor_pool;
+	VK_CHECK(vkCreateDescriptorPool(device.get_handle(), &pool_info, nullptr, &descriptor_pool));
+	descriptor_pools.push_back(descriptor_pool);
+
+	vkb::image_layout_transition(command_buffer,
+	                             image.get_handle(),
+	                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                             VK_ACCESS_TRANSFER_WRITE_BIT,
+	                             VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                             VK_IMAGE_LAYOUT_GENERAL,
+	                             get_level_range(image, 0, level_count));
+
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+	uint32_t srgb_constant = srgb ? 1 : 0;
+	vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(srgb_constant), &srgb_constant);
+
+	for (uint32_t level = 1; level < level_count; ++level)
+	{
+		VkDescriptorSetAllocateInfo allocate_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layout, 1);
+		VkDescriptorSet             descriptor_set;
+		VK_CHECK(vkAllocateDescriptorSets(device.get_handle(), &allocate_info, &descriptor_set));
+
+		VkDescriptorImageInfo source_info      = vkb::initializers::descriptor_image_info(VK_NULL_HANDLE, level_views[level - 1], VK_IMAGE_LAYOUT_GENERAL);
+		VkDescriptorImageInfo destination_info = vkb::initializers::descriptor_image_info(VK_NULL_HANDLE, level_views[level], VK_IMAGE_LAYOUT_GENERAL);
+
+		std::array<VkWriteDescriptorSet, 2> writes = {
+		    vkb::initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0, &source_info),
+		    vkb::initializers::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, &destination_info)};
+		vkUpdateDescriptorSets(device.get_handle(), to_u32(writes.size()), writes.data(), 0, nullptr);
+
+		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+
+		uint32_t width  = std::max(1u, extent.width >> level);
+		uint32_t height = std::max(1u, extent.height >> level);
+		vkCmdDispatch(command_buffer, (width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, (height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, layer_count);
+
+		// The level just written is the source of the next dispatch
+		vkb::image_layout_transition(command_buffer,
+		                             image.get_handle(),
+		                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		                             VK_ACCESS_SHADER_WRITE_BIT,
+		                             VK_ACCESS_SHADER_READ_BIT,
+		                             VK_IMAGE_LAYOUT_GENERAL,
+		                             VK_IMAGE_LAYOUT_GENERAL,
+		                             get_level_range(image, level, 1));
+	}
+
+	vkb::image_layout_transition(command_buffer,
+	                             image.get_handle(),
+	                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                             VK_ACCESS_SHADER_WRITE_BIT,
+	                             VK_ACCESS_SHADER_READ_BIT,
+	                             VK_IMAGE_LAYOUT_GENERAL,
+	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                             get_level_range(image, 0, level_count));
+}
+
+void MipmapGenerator::prepare_pipeline()
+{
+	if (pipeline != VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	std::vector<VkDescriptorSetLayoutBinding> bindings = {
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 0),
+	    vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1)};
+	VkDescriptorSetLayoutCreateInfo layout_create_info = vkb::initializers::descriptor_set_layout_create_info(bindings);
+	VK_CHECK(vkCreateDescriptorSetLayout(device.get_handle(), &layout_create_info, nullptr, &descriptor_set_layout));
+
+	VkPushConstantRange        push_constant_range         = vkb::initializers::push_constant_range(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(uint32_t), 0);
+	VkPipelineLayoutCreateInfo pipeline_layout_create_info = vkb::initializers::pipeline_layout_create_info(&descriptor_set_layout, 1);
+	pipeline_layout_create_info.pushConstantRangeCount     = 1;
+	pipeline_layout_create_info.pPushConstantRanges        = &push_constant_range;
+	VK_CHECK(vkCreatePipelineLayout(device.get_handle(), &pipeline_layout_create_info, nullptr, &pipeline_layout));
+
+	VkShaderModule shader_module = vkb::load_shader("mipmap_downsample.comp", device.get_handle(), VK_SHADER_STAGE_COMPUTE_BIT);
+	if (shader_module == VK_NULL_HANDLE)
+	{
+		throw std::runtime_error("Failed to load the mipmap downsampling shader");
+	}
+
+	VkComputePipelineCreateInfo pipeline_create_info = vkb::initializers::compute_pipeline_create_info(pipeline_layout);
+	pipeline_create_info.stage.sType                 = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipeline_create_info.stage.stage                 = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipeline_create_info.stage.module                = shader_module;
+	pipeline_create_info.stage.pName                 = "main";
+	VkResult result                                  = vkCreateComputePipelines(device.get_handle(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline);
+
+	vkDestroyShaderModule(device.get_handle(), shader_module, nullptr);
+	VK_CHECK(result);
+}
+}        // namespace vkb
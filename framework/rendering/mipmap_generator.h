@@ -0,0 +1,126 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "common/vk_common.h"
+#include "core/device.h"
+#include "core/image.h"
+
+namespace vkb
+{
+/**
+ * @brief Generates the mip chain of an image on the GPU, from its base level.
+ *
+ * Only the base level has to be uploaded, which saves a quarter of the staging memory and the CPU filtering time.
+ * Levels are generated with linear blits where the format supports them, with a compute shader otherwise.
+ * The compute path writes through UNORM views and filters sRGB data in linear space,
+ * so it is also preferred for sRGB data stored in a UNORM image, which a blit would filter in gamma space.
+ *
+ * Recorded compute generations hold image views and descriptor sets until release_transient_resources() is called,
+ * or the generator is destroyed, both of which must only happen once their command buffers completed.
+ */
+class MipmapGenerator
+{
+  public:
+	enum class Method
+	{
+		// The chain has to be generated on the CPU
+		None,
+
+		Blit,
+
+		Compute
+	};
+
+	MipmapGenerator(Device &device);
+
+	MipmapGenerator(const MipmapGenerator &) = delete;
+
+	MipmapGenerator(MipmapGenerator &&) = delete;
+
+	~MipmapGenerator();
+
+	MipmapGenerator &operator=(const MipmapGenerator &) = delete;
+
+	MipmapGenerator &operator=(MipmapGenerator &&) = delete;
+
+	/**
+	 * @return The number of levels of a full mip chain for the given extent
+	 */
+	static uint32_t get_mip_levels(const VkExtent3D &extent);
+
+	/**
+	 * @brief Selects how the mip chain of a 2D image can be generated on the GPU
+	 * @param device A valid Vulkan device
+	 * @param format Format of the image
+	 * @param srgb Whether the color channels hold sRGB data, implied by sRGB formats
+	 */
+	static Method get_method(Device &device, VkFormat format, bool srgb);
+
+	/**
+	 * @return The usage the image must be created with for the given method
+	 */
+	static VkImageUsageFlags get_image_usage(Method method);
+
+	/**
+	 * @return The flags the image must be created with for the given method
+	 *         The compute path needs mutable format and extended usage for formats other than R8G8B8A8_UNORM,
+	 *         views of the image format then leave out the storage usage, see core::ImageView
+	 */
+	static VkImageCreateFlags get_image_flags(Method method, VkFormat format);
+
+	/**
+	 * @brief Records the generation of all levels but the first
+	 *        All levels must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, with the base level written by transfer operations.
+	 *        All levels are left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, visible to vertex and fragment shaders.
+	 * @param command_buffer Command buffer in the recording state
+	 * @param image A 2D image created with the usage and flags required by the method
+	 * @param method Method returned by get_method for the image format
+	 * @param srgb Whether the color channels hold sRGB data, implied by sRGB formats
+	 */
+	void record(VkCommandBuffer command_buffer, const core::Image &image, Method method, bool srgb);
+
+	/**
+	 * @brief Destroys the image views and descriptor sets of the recorded compute generations
+	 *        The command buffers they were recorded into must have completed
+	 */
+	void release_transient_resources();
+
+  private:
+	Device &device;
+
+	VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
+
+	VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
+
+	VkPipeline pipeline{VK_NULL_HANDLE};
+
+	std::vector<VkDescriptorPool> descriptor_pools;
+
+	std::vector<VkImageView> image_views;
+
+	void record_blit(VkCommandBuffer command_buffer, const core::Image &image);
+
+	void record_compute(VkCommandBuffer command_buffer, const core::Image &image, bool srgb);
+
+	/**
+	 * @brief Creates the compute pipeline on first use
+	 */
+	void prepare_pipeline();
+};
+}        // namespace vkb
@@ -18,6 +18,7 @@
 #include "postprocessing_pipeline.h"
 
 #include "common/utils.h"
+#include "rendering/gpu_profiler.h"
 
 namespace vkb
 {
@@ -37,6 +38,7 @@ void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &d
 			pass.debug_name = fmt::format("PPP pass #{}", current_pass_index);
 		}
 		ScopedDebugLabel marker{command_buffer, pass.debug_name.c_str()};
+		ScopedGpuZone    gpu_zone{command_buffer, pass.debug_name};
 
 		if (!pass.prepared)
 		{
@@ -367,7 +367,7 @@ void PostProcessingRenderPass::transition_attachments(
 		barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 
 		assert(input < views.size());
-		command_buffer.image_memory_barrier(views[input], barrier);
+		command_buffer.add_image_memory_barrier(views[input], barrier);
 		render_target.set_layout(input, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 	}
 
@@ -416,7 +416,7 @@ void PostProcessingRenderPass::transition_attachments(
 		barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 
 		assert(attachment < sampled_rt->get_views().size());
-		command_buffer.image_memory_barrier(sampled_rt->get_views()[attachment], barrier);
+		command_buffer.add_image_memory_barrier(sampled_rt->get_views()[attachment], barrier);
 		sampled_rt->set_layout(attachment, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 	}
 
@@ -449,12 +449,13 @@ void PostProcessingRenderPass::transition_attachments(
 			barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		}
 
-		command_buffer.image_memory_barrier(views[output], barrier);
+		command_buffer.add_image_memory_barrier(views[output], barrier);
 		render_target.set_layout(output, output_layout);
 	}
 
 	// NOTE: Unused attachments might be carried over to other render passes,
 	//       so we don't want to transition them to UNDEFINED layout here
+	// NOTE: The barriers above are recorded as a single batch when the render pass begins
 }
 
 void PostProcessingRenderPass::prepare_draw(CommandBuffer &command_buffer, RenderTarget &fallback_render_target)
@@ -0,0 +1,262 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "readback_service.h"
+
+#include "core/device.h"
+#include "core/queue.h"
+
+namespace vkb
+{
+namespace
+{
+// Covers the offset alignment of buffer to image copies of any color format, and of 64-bit query results
+constexpr VkDeviceSize staging_alignment = 16;
+}        // namespace
+
+ReadbackService::ReadbackService(Device &device, const Queue &queue, uint32_t frame_count, VkDeviceSize staging_size) :
+    device{device}, queue{queue}, frames(frame_count), staging_size{staging_size}
+{
+	assert(frame_count > 0);
+
+	VkCommandPoolCreateInfo command_pool_info{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+	command_pool_info.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	command_pool_info.queueFamilyIndex = queue.get_family_index();
+	VK_CHECK(vkCreateCommandPool(device.get_handle(), &command_pool_info, nullptr, &command_pool));
+
+	std::vector<VkCommandBuffer> command_buffers(frame_count);
+
+	VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+	allocate_info.commandPool        = command_pool;
+	allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocate_info.commandBufferCount = frame_count;
+	VK_CHECK(vkAllocateCommandBuffers(device.get_handle(), &allocate_info, command_buffers.data()));
+
+	VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+	for (uint32_t i = 0; i < frame_count; ++i)
+	{
+		auto &frame = frames[i];
+
+		frame.command_buffer = command_buffers[i];
+		VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &frame.fence));
+
+		frame.staging_buffer = std::make_unique<core::BufferC>(device, staging_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+	}
+}
+
+ReadbackService::~ReadbackService()
+{
+	for (auto &frame : frames)
+	{
+		vkDestroyFence(device.get_handle(), frame.fence, nullptr);
+	}
+
+	// Frees the command buffers
+	vkDestroyCommandPool(device.get_handle(), command_pool, nullptr);
+}
+
+VkCommandBuffer ReadbackService::get_command_buffer()
+{
+	return get_recording_frame().command_buffer;
+}
+
+void ReadbackService::read_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, Callback callback)
+{
+	auto &frame = get_recording_frame();
+
+	auto [dst_buffer, dst_offset] = allocate(frame, size);
+
+	VkBufferCopy copy_region{offset, dst_offset, size};
+	vkCmdCopyBuffer(frame.command_buffer, buffer, dst_buffer->get_handle(), 1, &copy_region);
+
+	frame.readbacks.push_back({dst_buffer, dst_offset, size, std::move(callback)});
+}
+
+std::future<std::vector<uint8_t>> ReadbackService::read_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size)
+{
+	// std::function needs a copyable callable
+	auto promise = std::make_shared<std::promise<std::vector<uint8_t>>>();
+
+	read_buffer(buffer, offset, size, [promise](const uint8_t *data, VkDeviceSize data_size) {
+		promise->set_value(std::vector<uint8_t>(data, data + data_size));
+	});
+
+	return promise->get_future();
+}
+
+void ReadbackService::read_image(VkImage image, VkImageLayout layout, const VkBufferImageCopy &region, VkDeviceSize size, Callback callback)
+{
+	auto &frame = get_recording_frame();
+
+	auto [dst_buffer, dst_offset] = allocate(frame, size);
+
+	VkBufferImageCopy copy_region = region;
+	copy_region.bufferOffset      = dst_offset;
+	vkCmdCopyImageToBuffer(frame.command_buffer, image, layout, dst_buffer->get_handle(), 1, &copy_region);
+
+	frame.readbacks.push_back({dst_buffer, dst_offset, size, std::move(callback)});
+}
+
+void ReadbackService::read_query_results(VkQueryPool query_pool, uint32_t first_query, uint32_t query_count, VkDeviceSize stride,
+                                         VkQueryResultFlags flags, Callback callback)
+{
+	auto &frame = get_recording_frame();
+
+	VkDeviceSize size = stride * query_count;
+
+	auto [dst_buffer, dst_offset] = allocate(frame, size);
+
+	vkCmdCopyQueryPoolResults(frame.command_buffer, query_pool, first_query, query_count, dst_buffer->get_handle(), dst_offset, stride, flags);
+
+	frame.readbacks.push_back({dst_buffer, dst_offset, size, std::move(callback)});
+}
+
+void ReadbackService::submit()
+{
+	auto &frame = frames[current_frame];
+	if (!frame.recording)
+	{
+		return;
+	}
+
+	record_host_barrier(frame);
+	VK_CHECK(vkEndCommandBuffer(frame.command_buffer));
+	frame.recording = false;
+
+	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &frame.command_buffer;
+	VK_CHECK(queue.submit({submit_info}, frame.fence));
+	frame.submitted = true;
+
+	current_frame = (current_frame + 1) % static_cast<uint32_t>(frames.size());
+
+	// The ring is full, the next frame can only be recorded once the GPU is done with it
+	while (frames[current_frame].submitted)
+	{
+		auto &oldest = frames[oldest_frame];
+		VK_CHECK(vkWaitForFences(device.get_handle(), 1, &oldest.fence, VK_TRUE, UINT64_MAX));
+		deliver(oldest);
+	}
+}
+
+void ReadbackService::update()
+{
+	while (frames[oldest_frame].submitted)
+	{
+		auto &oldest = frames[oldest_frame];
+
+		VkResult result = vkGetFenceStatus(device.get_handle(), oldest.fence);
+		if (result == VK_NOT_READY)
+		{
+			break;
+		}
+		VK_CHECK(result);
+
+		deliver(oldest);
+	}
+}
+
+void ReadbackService::wait_idle()
+{
+	submit();
+
+	while (frames[oldest_frame].submitted)
+	{
+		auto &oldest = frames[oldest_frame];
+		VK_CHECK(vkWaitForFences(device.get_handle(), 1, &oldest.fence, VK_TRUE, UINT64_MAX));
+		deliver(oldest);
+	}
+}
+
+size_t ReadbackService::get_pending_count() const
+{
+	size_t count = 0;
+	for (auto &frame : frames)
+	{
+		count += frame.readbacks.size();
+	}
+	return count;
+}
+
+ReadbackService::Frame &ReadbackService::get_recording_frame()
+{
+	auto &frame = frames[current_frame];
+	if (!frame.recording)
+	{
+		assert(!frame.submitted);
+
+		VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+		begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK(vkBeginCommandBuffer(frame.command_buffer, &begin_info));
+		frame.recording = true;
+	}
+	return frame;
+}
+
+std::pair<core::BufferC *, VkDeviceSize> ReadbackService::allocate(Frame &frame, VkDeviceSize size)
+{
+	VkDeviceSize offset = (frame.staging_offset + staging_alignment - 1) & ~(staging_alignment - 1);
+	if (offset + size <= staging_size)
+	{
+		frame.staging_offset = offset + size;
+		return {frame.staging_buffer.get(), offset};
+	}
+
+	frame.dedicated_buffers.push_back(std::make_unique<core::BufferC>(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU));
+	return {frame.dedicated_buffers.back().get(), 0};
+}
+
+void ReadbackService::record_host_barrier(Frame &frame)
+{
+	// A fence only makes the writes available to the device, the host reads need a barrier
+	VkMemoryBarrier memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+	memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	vkCmdPipelineBarrier(frame.command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+}
+
+void ReadbackService::deliver(Frame &frame)
+{
+	if (frame.staging_offset > 0)
+	{
+		frame.staging_buffer->invalidate(0, frame.staging_offset);
+	}
+	for (auto &buffer : frame.dedicated_buffers)
+	{
+		buffer->invalidate();
+	}
+
+	// Recycle the frame first, so that callbacks can record new readbacks
+	auto readbacks         = std::move(frame.readbacks);
+	auto dedicated_buffers = std::move(frame.dedicated_buffers);
+	frame.readbacks.clear();
+	frame.dedicated_buffers.clear();
+	frame.staging_offset = 0;
+	frame.submitted      = false;
+	VK_CHECK(vkResetFences(device.get_handle(), 1, &frame.fence));
+
+	oldest_frame = (oldest_frame + 1) % static_cast<uint32_t>(frames.size());
+
+	// The staging buffer is only written again by a later submission
+	for (auto &readback : readbacks)
+	{
+		readback.callback(readback.buffer->get_data() + readback.offset, readback.size);
+	}
+}
+}        // namespace vkb
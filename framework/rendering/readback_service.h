@@ -0,0 +1,192 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <future>
+
+#include "common/vk_common.h"
+#include "core/buffer.h"
+
+namespace vkb
+{
+class Device;
+class Queue;
+
+/**
+ * @brief Reads data produced by the GPU back to the host, without waiting for the GPU.
+ *
+ * Copies are recorded into the command buffer of the current frame of a ring, into host visible staging memory owned
+ * by that frame. submit() sends the frame to the queue with its fence and moves to the next one. update() checks the
+ * fences of the submitted frames, and delivers the data of the completed ones to the callbacks of their copies, usually
+ * a few frames later. The host only waits when the ring is full, that is when the GPU is a whole ring behind.
+ *
+ * Staging memory is suballocated from a buffer per frame, copies that do not fit get a buffer of their own.
+ * Callbacks run on the thread calling update() or wait_idle(), the data they get is only valid during the call.
+ */
+class ReadbackService
+{
+  public:
+	using Callback = std::function<void(const uint8_t *data, VkDeviceSize size)>;
+
+	/**
+	 * @param device A valid Vulkan device
+	 * @param queue Queue the copies are submitted to, after the work producing their data
+	 * @param frame_count Number of frames of the ring, how many submissions can be in flight
+	 * @param staging_size Size of the staging buffer of each frame
+	 */
+	ReadbackService(Device &device, const Queue &queue, uint32_t frame_count = 3, VkDeviceSize staging_size = 64 * 1024);
+
+	ReadbackService(const ReadbackService &) = delete;
+
+	ReadbackService(ReadbackService &&) = delete;
+
+	/**
+	 * @brief Drops the pending readbacks without calling their callbacks, the device must be idle
+	 */
+	~ReadbackService();
+
+	ReadbackService &operator=(const ReadbackService &) = delete;
+
+	ReadbackService &operator=(ReadbackService &&) = delete;
+
+	/**
+	 * @brief Command buffer of the current frame, in the recording state
+	 *        Callers may record commands around their copies, such as layout transitions of the images they read.
+	 */
+	VkCommandBuffer get_command_buffer();
+
+	/**
+	 * @brief Records a copy of a buffer range
+	 *        Writes to the range must have been made available to transfer operations.
+	 */
+	void read_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, Callback callback);
+
+	/**
+	 * @brief Records a copy of a buffer range, returning a future of its data
+	 */
+	std::future<std::vector<uint8_t>> read_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size);
+
+	/**
+	 * @brief Records a copy of an image region, tightly packed unless the region sets a row length
+	 * @param image Image to read
+	 * @param layout Layout of the image during the copy, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL or VK_IMAGE_LAYOUT_GENERAL
+	 * @param region Region to copy, its buffer offset is ignored
+	 * @param size Size in bytes of the copied data
+	 * @param callback Receives the data
+	 */
+	void read_image(VkImage image, VkImageLayout layout, const VkBufferImageCopy &region, VkDeviceSize size, Callback callback);
+
+	/**
+	 * @brief Records a copy of query results
+	 *        With VK_QUERY_RESULT_WAIT_BIT, the GPU waits for the results instead of the host.
+	 *        The queries must not be reset before the frame is submitted.
+	 */
+	void read_query_results(VkQueryPool query_pool, uint32_t first_query, uint32_t query_count, VkDeviceSize stride,
+	                        VkQueryResultFlags flags, Callback callback);
+
+	/**
+	 * @brief Submits the copies recorded in the current frame and moves to the next frame of the ring
+	 *        Does nothing when no copy was recorded.
+	 */
+	void submit();
+
+	/**
+	 * @brief Delivers the data of the completed frames, without waiting
+	 */
+	void update();
+
+	/**
+	 * @brief Submits the current frame, then waits for all frames and delivers their data
+	 */
+	void wait_idle();
+
+	/**
+	 * @return The number of readbacks recorded or in flight
+	 */
+	size_t get_pending_count() const;
+
+  private:
+	struct Readback
+	{
+		core::BufferC *buffer;
+
+		VkDeviceSize offset;
+
+		VkDeviceSize size;
+
+		Callback callback;
+	};
+
+	struct Frame
+	{
+		VkCommandBuffer command_buffer{VK_NULL_HANDLE};
+
+		VkFence fence{VK_NULL_HANDLE};
+
+		std::unique_ptr<core::BufferC> staging_buffer;
+
+		VkDeviceSize staging_offset{0};
+
+		// Buffers of the copies that did not fit in the staging buffer
+		std::vector<std::unique_ptr<core::BufferC>> dedicated_buffers;
+
+		std::vector<Readback> readbacks;
+
+		bool recording{false};
+
+		bool submitted{false};
+	};
+
+	Device &device;
+
+	const Queue &queue;
+
+	VkCommandPool command_pool{VK_NULL_HANDLE};
+
+	std::vector<Frame> frames;
+
+	uint32_t current_frame{0};
+
+	// Index of the oldest submitted frame
+	uint32_t oldest_frame{0};
+
+	VkDeviceSize staging_size;
+
+	/**
+	 * @brief Begins the command buffer of the current frame if needed
+	 */
+	Frame &get_recording_frame();
+
+	/**
+	 * @brief Reserves staging memory in the current frame
+	 * @return The buffer and offset the copy must write to
+	 */
+	std::pair<core::BufferC *, VkDeviceSize> allocate(Frame &frame, VkDeviceSize size);
+
+	/**
+	 * @brief Makes the staging writes of the frame visible to the host
+	 */
+	void record_host_barrier(Frame &frame);
+
+	/**
+	 * @brief Calls the callbacks of a completed frame and recycles it
+	 */
+	void deliver(Frame &frame);
+};
+}        // namespace vkb
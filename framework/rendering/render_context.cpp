@@ -17,19 +17,22 @@
 
 #include "render_context.h"
 
+#include "core/util/profiling.hpp"
 #include "platform/window.h"
 
 namespace vkb
 {
 VkFormat RenderContext::DEFAULT_VK_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
 
+uint32_t RenderContext::OFFSCREEN_FRAME_COUNT = 3;
+
 RenderContext::RenderContext(Device                                &device,
                              VkSurfaceKHR                           surface,
                              const Window                          &window,
                              VkPresentModeKHR                       present_mode,
                              const std::vector<VkPresentModeKHR>   &present_mode_priority_list,
                              const std::vector<VkSurfaceFormatKHR> &surface_format_priority_list) :
-    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}
+    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}, readback_service{device, queue}
 {
 	if (surface != VK_NULL_HANDLE)
 	{
@@ -72,17 +75,20 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 	}
 	else
 	{
-		// Otherwise, create a single RenderFrame
+		// Otherwise, create a ring of offscreen RenderFrames, so that the CPU records a frame while the GPU renders the previous ones
 		swapchain = nullptr;
 
-		auto color_image = core::Image{device,
-		                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
-		                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-		                               VMA_MEMORY_USAGE_GPU_ONLY};
+		for (uint32_t i = 0; i < OFFSCREEN_FRAME_COUNT; ++i)
+		{
+			auto color_image = core::Image{device,
+			                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
+			                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			                               VMA_MEMORY_USAGE_GPU_ONLY};
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			auto render_target = create_render_target_func(std::move(color_image));
+			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+		}
 	}
 
 	this->create_render_target_func = create_render_target_func;
@@ -268,6 +274,7 @@ CommandBuffer &RenderContext::begin(CommandBuffer::ResetMode reset_mode)
 
 	if (!frame_active)
 	{
+		PROFILE_SCOPE("Begin frame");
 		begin_frame();
 	}
 
@@ -287,6 +294,8 @@ void RenderContext::submit(CommandBuffer &command_buffer)
 
 void RenderContext::submit(const std::vector<CommandBuffer *> &command_buffers)
 {
+	PROFILE_SCOPE("Submit frame");
+
 	assert(frame_active && "RenderContext is inactive, cannot submit command buffer. Please call begin()");
 
 	VkSemaphore render_semaphore = VK_NULL_HANDLE;
@@ -350,12 +359,19 @@ void RenderContext::begin_frame()
 			return;
 		}
 	}
+	else
+	{
+		// Without a swapchain to acquire from, go through the offscreen frames in order
+		active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
+	}
 
 	// Now the frame is active again
 	frame_active = true;
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	readback_service.update();
 }
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
@@ -416,6 +432,9 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
 
+	// The readbacks of the frame come after its submissions in the queue
+	readback_service.submit();
+
 	if (swapchain)
 	{
 		VkSwapchainKHR vk_swapchain = swapchain->get_handle();
@@ -554,4 +573,9 @@ std::vector<std::unique_ptr<RenderFrame>> &RenderContext::get_render_frames()
 	return frames;
 }
 
+ReadbackService &RenderContext::get_readback_service()
+{
+	return readback_service;
+}
+
 }        // namespace vkb
@@ -31,6 +31,7 @@
 #include "core/shader_module.h"
 #include "core/swapchain.h"
 #include "rendering/pipeline_state.h"
+#include "rendering/readback_service.h"
 #include "rendering/render_frame.h"
 #include "rendering/render_target.h"
 #include "resource_cache.h"
@@ -60,6 +61,9 @@ class RenderContext
 	// The format to use for the RenderTargets if a swapchain isn't created
 	static VkFormat DEFAULT_VK_FORMAT;
 
+	// The number of RenderFrames rendered in flight if a swapchain isn't created
+	static uint32_t OFFSCREEN_FRAME_COUNT;
+
 	/**
 	 * @brief Constructor
 	 * @param device A valid device
@@ -221,6 +225,12 @@ class RenderContext
 
 	std::vector<std::unique_ptr<RenderFrame>> &get_render_frames();
 
+	/**
+	 * @brief Readbacks recorded into the service are submitted at the end of each frame,
+	 *        and delivered at the beginning of the first frame after they completed
+	 */
+	ReadbackService &get_readback_service();
+
 	/**
 	 * @brief Handles surface changes, only applicable if the render_context makes use of a swapchain
 	 */
@@ -264,6 +274,8 @@ class RenderContext
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	ReadbackService readback_service;
 };
 
 }        // namespace vkb
@@ -29,12 +29,21 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
     swapchain_render_target{std::move(render_target)},
     thread_count{thread_count}
 {
-	for (auto &usage_it : supported_usage_map)
+	// Descriptor buffers reference resources through their device address
+	const bool               descriptor_buffer_enabled = device.is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+	const VkBufferUsageFlags extra_usage               = descriptor_buffer_enabled ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT : 0;
+	auto                     usage_map                 = supported_usage_map;
+	if (descriptor_buffer_enabled)
+	{
+		usage_map.emplace(DESCRIPTOR_BUFFER_USAGE, 1);
+	}
+
+	for (auto &usage_it : usage_map)
 	{
 		std::vector<std::pair<BufferPoolC, BufferBlockC *>> usage_buffer_pools;
 		for (size_t i = 0; i < thread_count; ++i)
 		{
-			usage_buffer_pools.push_back(std::make_pair(BufferPoolC{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first}, nullptr));
+			usage_buffer_pools.push_back(std::make_pair(BufferPoolC{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first | extra_usage}, nullptr));
 		}
 
 		auto res_ins_it = buffer_pools.emplace(usage_it.first, std::move(usage_buffer_pools));
@@ -45,6 +54,11 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 		}
 	}
 
+	if (GpuZoneQueries::is_supported(device))
+	{
+		gpu_zone_queries = std::make_unique<GpuZoneQueries>(device);
+	}
+
 	for (size_t i = 0; i < thread_count; ++i)
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
@@ -68,6 +82,12 @@ void RenderFrame::reset()
 
 	fence_pool.reset();
 
+	// The GPU is done with the frame, so its zones are read back without waiting
+	if (gpu_zone_queries)
+	{
+		gpu_zone_queries->resolve();
+	}
+
 	for (auto &command_pools_per_queue : command_pools)
 	{
 		for (auto &command_pool : command_pools_per_queue.second)
@@ -193,6 +213,11 @@ const RenderTarget &RenderFrame::get_render_target_const() const
 	return *swapchain_render_target;
 }
 
+size_t RenderFrame::get_thread_count() const
+{
+	return thread_count;
+}
+
 CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode, VkCommandBufferLevel level, size_t thread_index)
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
@@ -245,6 +270,11 @@ void RenderFrame::update_descriptor_sets(size_t thread_index)
 	}
 }
 
+GpuZoneQueries *RenderFrame::get_gpu_zone_queries()
+{
+	return gpu_zone_queries.get();
+}
+
 void RenderFrame::clear_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
@@ -298,4 +328,9 @@ BufferAllocationC RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, c
 
 	return buffer_block->allocate(to_u32(size));
 }
+
+BufferAllocationC RenderFrame::allocate_descriptor_buffer(VkDeviceSize size, size_t thread_index)
+{
+	return allocate_buffer(DESCRIPTOR_BUFFER_USAGE, size, thread_index);
+}
 }        // namespace vkb
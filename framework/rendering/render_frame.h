@@ -29,6 +29,7 @@
 #include "core/query_pool.h"
 #include "core/queue.h"
 #include "fence_pool.h"
+#include "rendering/gpu_profiler.h"
 #include "rendering/render_target.h"
 #include "semaphore_pool.h"
 
@@ -74,6 +75,12 @@ class RenderFrame
 	    {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1},
 	    {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1}};
 
+	/**
+	 * @brief Usage of the per-frame descriptor heap, only created when VK_EXT_descriptor_buffer is enabled
+	 */
+	static constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE =
+	    VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
 	RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count = 1);
 
 	RenderFrame(const RenderFrame &) = delete;
@@ -108,6 +115,11 @@ class RenderFrame
 
 	const RenderTarget &get_render_target_const() const;
 
+	/**
+	 * @return The number of threads the frame has command pools, buffer pools and descriptor sets for
+	 */
+	size_t get_thread_count() const;
+
 	/**
 	 * @brief Requests a command buffer to the command pool of the active frame
 	 *        A frame should be active at the moment of requesting it
@@ -151,11 +163,24 @@ class RenderFrame
 	 */
 	BufferAllocationC allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @brief Linearly allocates descriptor memory from the frame's descriptor heap, which is reset with the frame
+	 * @param size Amount of descriptor memory required
+	 * @param thread_index Index of the descriptor heap to be used by the current thread
+	 * @return The requested allocation, it may be empty
+	 */
+	BufferAllocationC allocate_descriptor_buffer(VkDeviceSize size, size_t thread_index = 0);
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @return The timestamp queries of the GPU zones recorded in this frame, or nullptr if the device cannot time them
+	 */
+	GpuZoneQueries *get_gpu_zone_queries();
+
   private:
 	Device &device;
 
@@ -190,6 +215,8 @@ class RenderFrame
 
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPoolC, BufferBlockC *>>> buffer_pools;
 
+	std::unique_ptr<GpuZoneQueries> gpu_zone_queries;
+
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
 }        // namespace vkb
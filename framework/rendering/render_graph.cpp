@@ -0,0 +1,859 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_graph.h"
+
+#include <algorithm>
+
+#include "core/debug.h"
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr VkAccessFlags2 write_access_mask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                             VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+VkImageAspectFlags get_aspect_mask(VkFormat format)
+{
+	if (is_depth_only_format(format))
+	{
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+	if (is_depth_stencil_format(format))
+	{
+		return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+	}
+	return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+}        // namespace
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph &graph, uint32_t pass) :
+    graph{graph}, pass{pass}
+{
+}
+
+void RenderGraph::PassBuilder::attach(ImageHandle image, const LoadStoreInfo &load_store, const VkClearValue &clear_value)
+{
+	assert(image < graph.images.size());
+	assert(graph.passes[pass].render_pipeline && "Only raster passes have attachments");
+
+	graph.passes[pass].attachments.push_back({image, load_store, clear_value});
+}
+
+void RenderGraph::PassBuilder::read(ImageHandle image, Access access)
+{
+	assert(image < graph.images.size());
+
+	graph.passes[pass].accesses.push_back({image, access, false});
+}
+
+void RenderGraph::PassBuilder::write(ImageHandle image, Access access)
+{
+	assert(image < graph.images.size());
+
+	graph.passes[pass].accesses.push_back({image, access, true});
+}
+
+RenderGraph::RenderGraph(Device &device) :
+    device{device}
+{
+	use_synchronization_2 = device.is_synchronization2_enabled();
+}
+
+RenderGraph::~RenderGraph()
+{
+	// Views and render targets first, then the images they refer to, then the memory bound to them
+	passes.clear();
+
+	for (auto &image : images)
+	{
+		image.views.clear();
+		image.transient_image.reset();
+
+		if (image.handle != VK_NULL_HANDLE)
+		{
+			vkDestroyImage(device.get_handle(), image.handle, nullptr);
+		}
+	}
+
+	for (auto &memory_block : memory_blocks)
+	{
+		if (memory_block.allocation != VK_NULL_HANDLE)
+		{
+			vmaFreeMemory(allocated::get_memory_allocator(), memory_block.allocation);
+		}
+	}
+}
+
+RenderGraph::ImageHandle RenderGraph::create_image(const std::string &name, const ImageDesc &desc)
+{
+	assert(!compiled && "Images must be declared before compiling the graph");
+
+	ImageResource image;
+	image.name = name;
+	image.desc = desc;
+	images.push_back(std::move(image));
+
+	return to_u32(images.size() - 1);
+}
+
+RenderGraph::ImageHandle RenderGraph::import_image(const std::string &name, core::Image &image, VkImageLayout initial_layout, VkImageLayout final_layout)
+{
+	assert(!compiled && "Images must be declared before compiling the graph");
+
+	ImageResource resource;
+	resource.name           = name;
+	resource.desc.extent    = {image.get_extent().width, image.get_extent().height};
+	resource.desc.format    = image.get_format();
+	resource.desc.samples   = image.get_sample_count();
+	resource.desc.usage     = image.get_usage();
+	resource.usage          = image.get_usage();
+	resource.image          = &image;
+	resource.initial_layout = initial_layout;
+	resource.final_layout   = final_layout;
+	resource.imported       = true;
+	images.push_back(std::move(resource));
+
+	return to_u32(images.size() - 1);
+}
+
+void RenderGraph::set_imported_image(ImageHandle handle, core::Image &image)
+{
+	auto &resource = images[handle];
+
+	assert(resource.imported);
+	assert(image.get_extent().width == resource.desc.extent.width && image.get_extent().height == resource.desc.extent.height);
+	assert(image.get_format() == resource.desc.format);
+
+	resource.image = &image;
+}
+
+void RenderGraph::mark_output(ImageHandle handle)
+{
+	images[handle].output = true;
+}
+
+void RenderGraph::add_raster_pass(const std::string &name, RenderPipeline &render_pipeline, std::function<void(PassBuilder &)> &&setup, std::function<void(CommandBuffer &)> &&record)
+{
+	assert(!compiled && "Passes must be added before compiling the graph");
+
+	Pass pass;
+	pass.name            = name;
+	pass.render_pipeline = &render_pipeline;
+	pass.record          = std::move(record);
+	passes.push_back(std::move(pass));
+
+	PassBuilder builder{*this, to_u32(passes.size() - 1)};
+	setup(builder);
+
+	assert(!passes.back().attachments.empty() && "Raster passes need at least one attachment");
+}
+
+void RenderGraph::add_pass(const std::string &name, std::function<void(PassBuilder &)> &&setup, std::function<void(CommandBuffer &)> &&record)
+{
+	assert(!compiled && "Passes must be added before compiling the graph");
+
+	Pass pass;
+	pass.name   = name;
+	pass.record = std::move(record);
+	passes.push_back(std::move(pass));
+
+	PassBuilder builder{*this, to_u32(passes.size() - 1)};
+	setup(builder);
+}
+
+void RenderGraph::compile()
+{
+	assert(!compiled && "The graph can only be compiled once");
+
+	cull_passes();
+
+	// Lifetimes of the transient images, in active passes
+	for (uint32_t i = 0; i < passes.size(); ++i)
+	{
+		auto &pass = passes[i];
+		if (!pass.active)
+		{
+			continue;
+		}
+
+		auto extend_lifetime = [&](ImageHandle handle) {
+			auto &image      = images[handle];
+			image.first_pass = std::min(image.first_pass, i);
+			image.last_pass  = std::max(image.last_pass, i);
+		};
+
+		for (auto &attachment : pass.attachments)
+		{
+			extend_lifetime(attachment.image);
+		}
+		for (auto &access : pass.accesses)
+		{
+			extend_lifetime(access.image);
+		}
+	}
+
+	create_transient_images();
+	allocate_memory_blocks();
+
+	compiled = true;
+
+	LOGI("Render graph: {} of {} passes active, {} transient images ({} lazily allocated) in {} KiB instead of {} KiB",
+	     stats.pass_count - stats.culled_pass_count, stats.pass_count, stats.transient_image_count, stats.lazily_allocated_image_count,
+	     stats.allocated_memory / 1024, stats.requested_memory / 1024);
+}
+
+void RenderGraph::execute(CommandBuffer &command_buffer)
+{
+	assert(compiled && "The graph must be compiled before its execution");
+
+	stats.barrier_batch_count = 0;
+	stats.image_barrier_count = 0;
+
+	for (auto &image : images)
+	{
+		// Transient images keep no content between executions, their memory blocks carry the dependencies instead
+		image.state        = {};
+		image.state.layout = static_cast<uint32_t>(image.imported ? image.initial_layout : VK_IMAGE_LAYOUT_UNDEFINED);
+	}
+
+	for (auto &pass : passes)
+	{
+		if (!pass.active)
+		{
+			continue;
+		}
+
+		std::vector<AttachmentAccess> attachment_accesses;
+		if (pass.render_pipeline)
+		{
+			attachment_accesses = get_attachment_accesses(pass);
+
+			for (size_t i = 0; i < pass.attachments.size(); ++i)
+			{
+				auto &attachment_access = attachment_accesses[i];
+				add_barrier(pass.attachments[i].image, {attachment_access.stages, attachment_access.access, attachment_access.initial_layout, true});
+			}
+		}
+
+		for (auto &access : pass.accesses)
+		{
+			auto access_info  = get_access_info(access.access, images[access.image].desc.format);
+			access_info.write = access.write;
+			add_barrier(access.image, access_info);
+		}
+
+		flush_barriers(command_buffer);
+
+		{
+			ScopedDebugLabel pass_label{command_buffer, pass.name.c_str()};
+
+			if (pass.render_pipeline)
+			{
+				std::vector<LoadStoreInfo> load_store;
+				std::vector<VkClearValue>  clear_value;
+				for (auto &attachment : pass.attachments)
+				{
+					load_store.push_back(attachment.load_store);
+					clear_value.push_back(attachment.clear_value);
+				}
+				pass.render_pipeline->set_load_store(load_store);
+				pass.render_pipeline->set_clear_value(clear_value);
+
+				auto &render_target = get_render_target(pass);
+				auto &extent        = render_target.get_extent();
+
+				VkViewport viewport{};
+				viewport.width    = static_cast<float>(extent.width);
+				viewport.height   = static_cast<float>(extent.height);
+				viewport.minDepth = 0.0f;
+				viewport.maxDepth = 1.0f;
+				command_buffer.set_viewport(0, {viewport});
+
+				VkRect2D scissor{};
+				scissor.extent = extent;
+				command_buffer.set_scissor(0, {scissor});
+
+				pass.render_pipeline->draw(command_buffer, render_target);
+				if (pass.record)
+				{
+					pass.record(command_buffer);
+				}
+				command_buffer.end_render_pass();
+			}
+			else
+			{
+				pass.record(command_buffer);
+			}
+		}
+
+		// The render pass transitions its attachments to their final layout
+		for (size_t i = 0; i < attachment_accesses.size(); ++i)
+		{
+			auto &state          = images[pass.attachments[i].image].state;
+			state.layout         = static_cast<uint32_t>(attachment_accesses[i].final_layout);
+			state.write_stages   = attachment_accesses[i].stages;
+			state.write_access   = attachment_accesses[i].access & write_access_mask;
+			state.read_stages    = VK_PIPELINE_STAGE_2_NONE;
+			state.visible_stages = VK_PIPELINE_STAGE_2_NONE;
+			state.visible_access = VK_ACCESS_2_NONE;
+		}
+
+		auto update_memory_block = [&](ImageHandle handle) {
+			auto &image = images[handle];
+			if (image.handle != VK_NULL_HANDLE)
+			{
+				auto &memory_block             = memory_blocks[image.memory_block];
+				memory_block.last_stages       = image.state.write_stages | image.state.read_stages;
+				memory_block.last_write_access = image.state.write_access;
+			}
+		};
+
+		for (auto &attachment : pass.attachments)
+		{
+			update_memory_block(attachment.image);
+		}
+		for (auto &access : pass.accesses)
+		{
+			update_memory_block(access.image);
+		}
+	}
+
+	for (uint32_t i = 0; i < images.size(); ++i)
+	{
+		auto &image = images[i];
+		if (image.imported && image.final_layout != VK_IMAGE_LAYOUT_UNDEFINED && static_cast<VkImageLayout>(image.state.layout) != image.final_layout)
+		{
+			// Later work, such as a present, waits on its own semaphores
+			add_barrier(i, {VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, VK_ACCESS_2_NONE, image.final_layout, false});
+		}
+	}
+
+	flush_barriers(command_buffer);
+}
+
+const core::ImageView &RenderGraph::get_image_view(ImageHandle handle)
+{
+	assert(compiled && "Transient images are created when compiling the graph");
+
+	auto &image = images[handle];
+
+	auto &view = image.views[image.image->get_handle()];
+	if (!view)
+	{
+		view = std::make_unique<core::ImageView>(*image.image, VK_IMAGE_VIEW_TYPE_2D);
+	}
+	return *view;
+}
+
+const RenderGraph::Stats &RenderGraph::get_stats() const
+{
+	return stats;
+}
+
+bool RenderGraph::is_pass_active(const std::string &name) const
+{
+	auto it = std::find_if(passes.begin(), passes.end(), [&name](const Pass &pass) { return pass.name == name; });
+	return it != passes.end() && it->active;
+}
+
+RenderGraph::AccessInfo RenderGraph::get_access_info(Access access, VkFormat format)
+{
+	// Only uses stages and accesses that have a VK_KHR_synchronization2 free equivalent
+	switch (access)
+	{
+		case Access::ColorAttachment:
+			return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			        VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+			        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true};
+		case Access::DepthStencilAttachment:
+			return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+			        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+			        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true};
+		case Access::InputAttachment:
+			return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT,
+			        is_depth_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false};
+		case Access::FragmentSampled:
+			return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT,
+			        is_depth_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false};
+		case Access::ComputeSampled:
+			return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT,
+			        is_depth_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false};
+		case Access::ComputeStorageRead:
+			return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false};
+		case Access::ComputeStorageWrite:
+			return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true};
+		case Access::TransferRead:
+			return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false};
+		case Access::TransferWrite:
+			return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true};
+		default:
+			throw std::runtime_error("Unknown render graph access");
+	}
+}
+
+VkImageUsageFlags RenderGraph::get_image_usage(Access access)
+{
+	switch (access)
+	{
+		case Access::ColorAttachment:
+			return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		case Access::DepthStencilAttachment:
+			return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		case Access::InputAttachment:
+			return VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+		case Access::FragmentSampled:
+		case Access::ComputeSampled:
+			return VK_IMAGE_USAGE_SAMPLED_BIT;
+		case Access::ComputeStorageRead:
+		case Access::ComputeStorageWrite:
+			return VK_IMAGE_USAGE_STORAGE_BIT;
+		case Access::TransferRead:
+			return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		case Access::TransferWrite:
+			return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		default:
+			throw std::runtime_error("Unknown render graph access");
+	}
+}
+
+void RenderGraph::cull_passes()
+{
+	stats.pass_count        = to_u32(passes.size());
+	stats.culled_pass_count = 0;
+
+	// Images whose content is needed after the execution
+	std::vector<bool> needed(images.size(), false);
+	for (size_t i = 0; i < images.size(); ++i)
+	{
+		needed[i] = images[i].output || (images[i].imported && images[i].final_layout != VK_IMAGE_LAYOUT_UNDEFINED);
+	}
+
+	// Attachments are written, loaded attachments also read the content written by earlier passes.
+	// Input attachments are read within the pass writing them, which is enough to keep it.
+	std::vector<RenderGraphPassResources> pass_resources(passes.size());
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		for (auto &attachment : passes[i].attachments)
+		{
+			pass_resources[i].writes.push_back(attachment.image);
+			if (attachment.load_store.load_op == VK_ATTACHMENT_LOAD_OP_LOAD)
+			{
+				pass_resources[i].reads.push_back(attachment.image);
+			}
+		}
+		for (auto &access : passes[i].accesses)
+		{
+			(access.write ? pass_resources[i].writes : pass_resources[i].reads).push_back(access.image);
+		}
+	}
+
+	auto active = find_active_passes(pass_resources, std::move(needed));
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		passes[i].active = active[i];
+		if (!active[i])
+		{
+			LOGD("Render graph: culled pass {}", passes[i].name);
+			stats.culled_pass_count++;
+		}
+	}
+}
+
+void RenderGraph::create_transient_images()
+{
+	auto &memory_properties = device.get_gpu().get_memory_properties();
+
+	bool lazily_allocated_supported = false;
+	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+	{
+		if (memory_properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+		{
+			lazily_allocated_supported = true;
+		}
+	}
+
+	for (uint32_t i = 0; i < passes.size(); ++i)
+	{
+		auto &pass = passes[i];
+		if (!pass.active)
+		{
+			continue;
+		}
+
+		if (pass.render_pipeline)
+		{
+			auto attachment_accesses = get_attachment_accesses(pass);
+			for (size_t j = 0; j < pass.attachments.size(); ++j)
+			{
+				images[pass.attachments[j].image].usage |= attachment_accesses[j].usage;
+			}
+		}
+		for (auto &access : pass.accesses)
+		{
+			images[access.image].usage |= get_image_usage(access.access);
+		}
+	}
+
+	for (uint32_t i = 0; i < images.size(); ++i)
+	{
+		auto &image = images[i];
+		if (image.imported)
+		{
+			assert((image.usage & ~image.desc.usage) == 0 && "An imported image lacks a usage the passes need");
+			continue;
+		}
+		if (image.first_pass == ~0u)
+		{
+			// Only used by culled passes
+			continue;
+		}
+
+		image.usage |= image.desc.usage;
+
+		// The content of an image attached to a single render pass, neither loaded nor stored, never leaves the tile memory
+		if (lazily_allocated_supported && !image.output && image.first_pass == image.last_pass && passes[image.first_pass].render_pipeline)
+		{
+			auto &pass = passes[image.first_pass];
+
+			bool attachment_only = std::none_of(pass.accesses.begin(), pass.accesses.end(), [i](const ImageAccess &access) { return access.image == i; });
+			for (auto &attachment : pass.attachments)
+			{
+				if (attachment.image == i && (attachment.load_store.load_op == VK_ATTACHMENT_LOAD_OP_LOAD || attachment.load_store.store_op != VK_ATTACHMENT_STORE_OP_DONT_CARE))
+				{
+					attachment_only = false;
+				}
+			}
+
+			constexpr VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+			if (attachment_only && (image.usage & ~attachment_usage) == 0)
+			{
+				image.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+				image.lazily_allocated = true;
+			}
+		}
+
+		VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		image_info.imageType     = VK_IMAGE_TYPE_2D;
+		image_info.format        = image.desc.format;
+		image_info.extent        = {image.desc.extent.width, image.desc.extent.height, 1};
+		image_info.mipLevels     = 1;
+		image_info.arrayLayers   = 1;
+		image_info.samples       = image.desc.samples;
+		image_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+		image_info.usage         = image.usage;
+		image_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// Images sharing memory are created unbound, and bound once the memory blocks are allocated
+		VK_CHECK(vkCreateImage(device.get_handle(), &image_info, nullptr, &image.handle));
+		vkGetImageMemoryRequirements(device.get_handle(), image.handle, &image.memory_requirements);
+
+		stats.transient_image_count++;
+		stats.requested_memory += image.memory_requirements.size;
+		if (image.lazily_allocated)
+		{
+			stats.lazily_allocated_image_count++;
+		}
+	}
+}
+
+void RenderGraph::allocate_memory_blocks()
+{
+	std::vector<ImageHandle> aliased_images;
+	for (uint32_t i = 0; i < images.size(); ++i)
+	{
+		if (images[i].handle != VK_NULL_HANDLE)
+		{
+			aliased_images.push_back(i);
+		}
+	}
+
+	std::vector<RenderGraphImageMemory> image_memory;
+	for (auto handle : aliased_images)
+	{
+		auto &image = images[handle];
+
+		RenderGraphImageMemory memory{};
+		memory.size             = image.memory_requirements.size;
+		memory.alignment        = image.memory_requirements.alignment;
+		memory.memory_type_bits = image.memory_requirements.memoryTypeBits;
+		memory.first_pass       = image.first_pass;
+		memory.last_pass        = image.last_pass;
+		memory.dedicated        = image.lazily_allocated;
+		image_memory.push_back(memory);
+	}
+
+	for (auto &block : alias_image_memory(image_memory))
+	{
+		MemoryBlock memory_block;
+		memory_block.memory_requirements.size           = block.size;
+		memory_block.memory_requirements.alignment      = block.alignment;
+		memory_block.memory_requirements.memoryTypeBits = block.memory_type_bits;
+
+		for (auto index : block.images)
+		{
+			memory_block.images.push_back(aliased_images[index]);
+			images[aliased_images[index]].memory_block = to_u32(memory_blocks.size());
+		}
+		memory_blocks.push_back(std::move(memory_block));
+	}
+
+	auto &allocator = allocated::get_memory_allocator();
+
+	for (auto &memory_block : memory_blocks)
+	{
+		auto &first_image = images[memory_block.images.front()];
+
+		VmaAllocationCreateInfo allocation_info{};
+		if (first_image.lazily_allocated)
+		{
+			allocation_info.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+			VK_CHECK(vmaAllocateMemoryForImage(allocator, first_image.handle, &allocation_info, &memory_block.allocation, nullptr));
+		}
+		else
+		{
+			allocation_info.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			VK_CHECK(vmaAllocateMemory(allocator, &memory_block.memory_requirements, &allocation_info, &memory_block.allocation, nullptr));
+
+			stats.allocated_memory += memory_block.memory_requirements.size;
+		}
+
+		for (auto handle : memory_block.images)
+		{
+			auto &image = images[handle];
+
+			VK_CHECK(vmaBindImageMemory(allocator, memory_block.allocation, image.handle));
+
+			// The graph owns the handle and its memory, the wrapper does not
+			image.transient_image = std::make_unique<core::Image>(device, image.handle, VkExtent3D{image.desc.extent.width, image.desc.extent.height, 1},
+			                                                      image.desc.format, image.usage, image.desc.samples);
+			image.transient_image->set_debug_name(image.name);
+			image.image = image.transient_image.get();
+		}
+	}
+}
+
+RenderTarget &RenderGraph::get_render_target(Pass &pass)
+{
+	std::vector<VkImage> key;
+	for (auto &attachment : pass.attachments)
+	{
+		key.push_back(images[attachment.image].image->get_handle());
+	}
+
+	auto &render_target = pass.render_targets[key];
+	if (!render_target)
+	{
+		std::vector<core::ImageView> views;
+		for (auto &attachment : pass.attachments)
+		{
+			views.emplace_back(*images[attachment.image].image, VK_IMAGE_VIEW_TYPE_2D);
+		}
+		render_target = std::make_unique<RenderTarget>(std::move(views));
+	}
+	return *render_target;
+}
+
+void RenderGraph::add_barrier(ImageHandle handle, const AccessInfo &access_info)
+{
+	auto &image = images[handle];
+
+	// First use in this execution, the memory may still be in use by an image it is shared with
+	bool first_use = image.handle != VK_NULL_HANDLE && static_cast<VkImageLayout>(image.state.layout) == VK_IMAGE_LAYOUT_UNDEFINED;
+
+	auto barrier = track_image_access(image.state, {access_info.stages, access_info.access, static_cast<uint32_t>(access_info.layout), access_info.write}, write_access_mask);
+	if (!barrier.needed)
+	{
+		return;
+	}
+
+	if (first_use)
+	{
+		auto &memory_block = memory_blocks[image.memory_block];
+		barrier.src_stages |= memory_block.last_stages;
+		barrier.src_access |= memory_block.last_write_access;
+	}
+
+	auto it = std::find_if(pending_barriers.begin(), pending_barriers.end(), [&](const VkImageMemoryBarrier2 &pending_barrier) {
+		return pending_barrier.image == image.image->get_handle();
+	});
+
+	if (it != pending_barriers.end())
+	{
+		// A pass using the same image twice, the accesses must agree on its layout
+		assert(it->newLayout == access_info.layout);
+		it->dstStageMask |= access_info.stages;
+		it->dstAccessMask |= access_info.access;
+	}
+	else
+	{
+		VkImageMemoryBarrier2 image_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+		image_barrier.srcStageMask        = barrier.src_stages;
+		image_barrier.srcAccessMask       = barrier.src_access;
+		image_barrier.dstStageMask        = access_info.stages;
+		image_barrier.dstAccessMask       = access_info.access;
+		image_barrier.oldLayout           = static_cast<VkImageLayout>(barrier.old_layout);
+		image_barrier.newLayout           = access_info.layout;
+		image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.image               = image.image->get_handle();
+		image_barrier.subresourceRange    = {get_aspect_mask(image.desc.format), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+		pending_barriers.push_back(image_barrier);
+	}
+}
+
+void RenderGraph::flush_barriers(CommandBuffer &command_buffer)
+{
+	if (pending_barriers.empty())
+	{
+		return;
+	}
+
+	if (use_synchronization_2)
+	{
+		VkDependencyInfo dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+		dependency_info.imageMemoryBarrierCount = to_u32(pending_barriers.size());
+		dependency_info.pImageMemoryBarriers    = pending_barriers.data();
+		vkCmdPipelineBarrier2KHR(command_buffer.get_handle(), &dependency_info);
+	}
+	else
+	{
+		// The stages and accesses of get_access_info have the same values in both versions
+		VkPipelineStageFlags src_stages = 0;
+		VkPipelineStageFlags dst_stages = 0;
+
+		std::vector<VkImageMemoryBarrier> image_barriers;
+		for (auto &barrier : pending_barriers)
+		{
+			src_stages |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+			dst_stages |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+
+			VkImageMemoryBarrier image_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+			image_barrier.srcAccessMask       = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+			image_barrier.dstAccessMask       = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+			image_barrier.oldLayout           = barrier.oldLayout;
+			image_barrier.newLayout           = barrier.newLayout;
+			image_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			image_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			image_barrier.image               = barrier.image;
+			image_barrier.subresourceRange    = barrier.subresourceRange;
+			image_barriers.push_back(image_barrier);
+		}
+
+		vkCmdPipelineBarrier(command_buffer.get_handle(),
+		                     src_stages ? src_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		                     dst_stages ? dst_stages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                     0, 0, nullptr, 0, nullptr, to_u32(image_barriers.size()), image_barriers.data());
+	}
+
+	stats.barrier_batch_count++;
+	stats.image_barrier_count += to_u32(pending_barriers.size());
+	pending_barriers.clear();
+}
+
+std::vector<RenderGraph::AttachmentAccess> RenderGraph::get_attachment_accesses(const Pass &pass) const
+{
+	std::vector<AttachmentAccess> attachment_accesses;
+	for (auto &attachment : pass.attachments)
+	{
+		// Load and store operations access every attachment, in the attachment stages
+		bool depth = is_depth_format(images[attachment.image].desc.format);
+
+		AttachmentAccess attachment_access{};
+		attachment_access.initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachment_access.final_layout   = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachment_access.stages         = get_access_info(depth ? Access::DepthStencilAttachment : Access::ColorAttachment, VK_FORMAT_UNDEFINED).stages;
+		attachment_access.access         = get_access_info(depth ? Access::DepthStencilAttachment : Access::ColorAttachment, VK_FORMAT_UNDEFINED).access;
+		attachment_access.usage          = get_image_usage(depth ? Access::DepthStencilAttachment : Access::ColorAttachment);
+		attachment_accesses.push_back(attachment_access);
+	}
+
+	auto first_depth = std::find_if(pass.attachments.begin(), pass.attachments.end(), [this](const AttachmentInfo &attachment) {
+		return is_depth_format(images[attachment.image].desc.format);
+	});
+
+	auto &subpasses = pass.render_pipeline->get_subpasses();
+	for (size_t i = 0; i < subpasses.size(); ++i)
+	{
+		auto &subpass = *subpasses[i];
+		bool  last    = i + 1 == subpasses.size();
+
+		// Same order as RenderPass, which uses the layout of the first reference as initial layout, and of the last subpass as final layout
+		auto use = [&](uint32_t index, Access access, bool sets_final_layout = true) {
+			assert(index < attachment_accesses.size() && "The pipeline uses an attachment the pass does not attach");
+
+			auto  access_info       = get_access_info(access, images[pass.attachments[index].image].desc.format);
+			auto &attachment_access = attachment_accesses[index];
+			if (attachment_access.initial_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+			{
+				attachment_access.initial_layout = access_info.layout;
+			}
+			if (last && sets_final_layout)
+			{
+				attachment_access.final_layout = access_info.layout;
+			}
+			attachment_access.stages |= access_info.stages;
+			attachment_access.access |= access_info.access;
+			attachment_access.usage |= get_image_usage(access);
+		};
+
+		for (auto index : subpass.get_output_attachments())
+		{
+			if (!is_depth_format(images[pass.attachments[index].image].desc.format))
+			{
+				use(index, Access::ColorAttachment);
+			}
+		}
+
+		bool depth_input = false;
+		for (auto index : subpass.get_input_attachments())
+		{
+			use(index, Access::InputAttachment);
+			depth_input |= is_depth_format(images[pass.attachments[index].image].desc.format);
+		}
+
+		// The last subpass drops the depth attachment it reads as input, after its initial layout was picked
+		if (first_depth != pass.attachments.end() && !subpass.get_disable_depth_stencil_attachment())
+		{
+			use(to_u32(std::distance(pass.attachments.begin(), first_depth)), Access::DepthStencilAttachment, !depth_input);
+
+			if (subpass.get_depth_stencil_resolve_mode() != VK_RESOLVE_MODE_NONE)
+			{
+				use(subpass.get_depth_stencil_resolve_attachment(), Access::DepthStencilAttachment);
+			}
+		}
+
+		for (auto index : subpass.get_color_resolve_attachments())
+		{
+			use(index, Access::ColorAttachment);
+		}
+	}
+
+	for (auto &attachment_access : attachment_accesses)
+	{
+		if (attachment_access.initial_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			attachment_access.initial_layout = attachment_access.final_layout;
+		}
+	}
+
+	return attachment_accesses;
+}
+}        // namespace vkb
@@ -0,0 +1,368 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+
+#include <core/util/render_graph_schedule.hpp>
+
+#include "common/vk_common.h"
+#include "core/command_buffer.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/render_target.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief A graph of passes declaring the images they read and write, which records the barriers between them.
+ *
+ * Raster passes draw a RenderPipeline into a RenderTarget made of the images they attach, other passes record
+ * their own commands. compile() culls the passes whose results are never used, and creates the transient images:
+ * images whose lifetimes do not overlap share their memory, and images that only live within a single render pass
+ * are lazily allocated where the device supports it. execute() records the passes, preceded by all the barriers
+ * they need at once: through vkCmdPipelineBarrier2KHR when the synchronization2 feature is enabled, in a single
+ * vkCmdPipelineBarrier otherwise.
+ *
+ * Passes run in the order they were added. Imported images, such as swapchain images, can be swapped for
+ * another image of the same description between executions.
+ */
+class RenderGraph
+{
+  public:
+	using ImageHandle = uint32_t;
+
+	/**
+	 * @brief How a pass uses an image, which implies its layout and the stages accessing it
+	 */
+	enum class Access
+	{
+		ColorAttachment,
+		DepthStencilAttachment,
+		InputAttachment,
+		FragmentSampled,
+		ComputeSampled,
+		ComputeStorageRead,
+		ComputeStorageWrite,
+		TransferRead,
+		TransferWrite
+	};
+
+	/**
+	 * @brief Description of a transient image, created and owned by the graph
+	 */
+	struct ImageDesc
+	{
+		VkExtent2D extent{};
+
+		VkFormat format{VK_FORMAT_UNDEFINED};
+
+		VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+
+		// Usage on top of the one implied by the accesses of the passes
+		VkImageUsageFlags usage{0};
+	};
+
+	struct Stats
+	{
+		uint32_t pass_count{0};
+
+		uint32_t culled_pass_count{0};
+
+		uint32_t transient_image_count{0};
+
+		uint32_t lazily_allocated_image_count{0};
+
+		// Memory the transient images would take without aliasing, and the memory they take
+		VkDeviceSize requested_memory{0};
+
+		VkDeviceSize allocated_memory{0};
+
+		// Barrier commands recorded by the last execution, and the image barriers they hold
+		uint32_t barrier_batch_count{0};
+
+		uint32_t image_barrier_count{0};
+	};
+
+	/**
+	 * @brief Declares the images a pass uses
+	 */
+	class PassBuilder
+	{
+	  public:
+		/**
+		 * @brief Adds an attachment to the render target of a raster pass, in order
+		 *        Color and depth attachments are written, the input attachments of the pipeline are read within the pass.
+		 */
+		void attach(ImageHandle image, const LoadStoreInfo &load_store = {}, const VkClearValue &clear_value = {});
+
+		void read(ImageHandle image, Access access);
+
+		void write(ImageHandle image, Access access);
+
+	  private:
+		friend class RenderGraph;
+
+		PassBuilder(RenderGraph &graph, uint32_t pass);
+
+		RenderGraph &graph;
+
+		uint32_t pass;
+	};
+
+	RenderGraph(Device &device);
+
+	RenderGraph(const RenderGraph &) = delete;
+
+	RenderGraph(RenderGraph &&) = delete;
+
+	~RenderGraph();
+
+	RenderGraph &operator=(const RenderGraph &) = delete;
+
+	RenderGraph &operator=(RenderGraph &&) = delete;
+
+	/**
+	 * @brief Declares a transient image, its content does not outlive an execution
+	 */
+	ImageHandle create_image(const std::string &name, const ImageDesc &desc);
+
+	/**
+	 * @brief Declares an image owned by the caller, such as a swapchain image
+	 * @param name Name of the image
+	 * @param image Image to use in the next executions
+	 * @param initial_layout Layout of the image at the beginning of each execution
+	 * @param final_layout Layout the image is left in, VK_IMAGE_LAYOUT_UNDEFINED to leave it in its last layout.
+	 *        Passes writing an image with a final layout are never culled.
+	 */
+	ImageHandle import_image(const std::string &name, core::Image &image, VkImageLayout initial_layout, VkImageLayout final_layout);
+
+	/**
+	 * @brief Replaces an imported image by another one with the same extent, format and usage
+	 */
+	void set_imported_image(ImageHandle handle, core::Image &image);
+
+	/**
+	 * @brief Keeps the passes writing an image even if no pass reads it
+	 */
+	void mark_output(ImageHandle handle);
+
+	/**
+	 * @brief Adds a raster pass drawing a render pipeline
+	 *        The attachments must have the same extent, the pipeline load store and clear values are set from them.
+	 *        The viewport and scissor cover the attachments.
+	 * @param name Name of the pass, used as debug label
+	 * @param render_pipeline Pipeline to draw, it must outlive the graph
+	 * @param setup Declares the attachments of the pass, and the images it reads outside of them
+	 * @param record Records additional commands in the last subpass, such as the GUI
+	 */
+	void add_raster_pass(const std::string &name, RenderPipeline &render_pipeline, std::function<void(PassBuilder &)> &&setup, std::function<void(CommandBuffer &)> &&record = {});
+
+	/**
+	 * @brief Adds a pass recording its own commands, outside of a render pass
+	 * @param name Name of the pass, used as debug label
+	 * @param setup Declares the images the pass reads and writes
+	 * @param record Records the commands of the pass
+	 */
+	void add_pass(const std::string &name, std::function<void(PassBuilder &)> &&setup, std::function<void(CommandBuffer &)> &&record);
+
+	/**
+	 * @brief Culls the unused passes and creates the transient images
+	 *        Must be called once all passes were added, and before the first execution.
+	 */
+	void compile();
+
+	/**
+	 * @brief Records the passes and their barriers
+	 */
+	void execute(CommandBuffer &command_buffer);
+
+	/**
+	 * @return A view of the whole image, to bind it in descriptor sets
+	 */
+	const core::ImageView &get_image_view(ImageHandle handle);
+
+	const Stats &get_stats() const;
+
+	/**
+	 * @return Whether the pass with the given name is recorded
+	 */
+	bool is_pass_active(const std::string &name) const;
+
+  private:
+	struct AccessInfo
+	{
+		VkPipelineStageFlags2 stages;
+
+		VkAccessFlags2 access;
+
+		VkImageLayout layout;
+
+		bool write;
+	};
+
+	struct ImageAccess
+	{
+		ImageHandle image;
+
+		Access access;
+
+		bool write;
+	};
+
+	// Use of an attachment over a whole render pass
+	struct AttachmentAccess
+	{
+		VkImageLayout initial_layout;
+
+		VkImageLayout final_layout;
+
+		VkPipelineStageFlags2 stages;
+
+		VkAccessFlags2 access;
+
+		VkImageUsageFlags usage;
+	};
+
+	struct AttachmentInfo
+	{
+		ImageHandle image;
+
+		LoadStoreInfo load_store;
+
+		VkClearValue clear_value;
+	};
+
+	struct Pass
+	{
+		std::string name;
+
+		RenderPipeline *render_pipeline{nullptr};
+
+		std::function<void(CommandBuffer &)> record;
+
+		std::vector<AttachmentInfo> attachments;
+
+		std::vector<ImageAccess> accesses;
+
+		// Render targets of the pass, one for each combination of imported images
+		std::map<std::vector<VkImage>, std::unique_ptr<RenderTarget>> render_targets;
+
+		bool active{true};
+	};
+
+	struct ImageResource
+	{
+		std::string name;
+
+		ImageDesc desc;
+
+		VkImageUsageFlags usage{0};
+
+		core::Image *image{nullptr};
+
+		VkImageLayout initial_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		VkImageLayout final_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		bool imported{false};
+
+		bool output{false};
+
+		// Transient images only
+		std::unique_ptr<core::Image> transient_image;
+
+		VkImage handle{VK_NULL_HANDLE};
+
+		VkMemoryRequirements memory_requirements{};
+
+		uint32_t memory_block{0};
+
+		bool lazily_allocated{false};
+
+		// First and last active passes using the image
+		uint32_t first_pass{~0u};
+
+		uint32_t last_pass{0};
+
+		// Views of the whole image, for each image it was bound to
+		std::map<VkImage, std::unique_ptr<core::ImageView>> views;
+
+		RenderGraphImageState state;
+	};
+
+	// Memory shared by transient images with disjoint lifetimes
+	struct MemoryBlock
+	{
+		VmaAllocation allocation{VK_NULL_HANDLE};
+
+		VkMemoryRequirements memory_requirements{};
+
+		std::vector<ImageHandle> images;
+
+		// Stages and accesses of the last use of any image of the block, which the first use of the next one waits for
+		VkPipelineStageFlags2 last_stages{VK_PIPELINE_STAGE_2_NONE};
+
+		VkAccessFlags2 last_write_access{VK_ACCESS_2_NONE};
+	};
+
+	Device &device;
+
+	std::vector<Pass> passes;
+
+	std::vector<ImageResource> images;
+
+	std::vector<MemoryBlock> memory_blocks;
+
+	std::vector<VkImageMemoryBarrier2> pending_barriers;
+
+	bool compiled{false};
+
+	bool use_synchronization_2{false};
+
+	Stats stats;
+
+	static AccessInfo get_access_info(Access access, VkFormat format);
+
+	static VkImageUsageFlags get_image_usage(Access access);
+
+	void cull_passes();
+
+	void create_transient_images();
+
+	void allocate_memory_blocks();
+
+	RenderTarget &get_render_target(Pass &pass);
+
+	/**
+	 * @brief Queues the barrier an access needs, and updates the state of the image
+	 */
+	void add_barrier(ImageHandle handle, const AccessInfo &access_info);
+
+	void flush_barriers(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Computes how a raster pass uses its attachments, following the layouts RenderPass picks for them
+	 */
+	std::vector<AttachmentAccess> get_attachment_accesses(const Pass &pass) const;
+};
+}        // namespace vkb
@@ -17,6 +17,7 @@
 
 #include "render_pipeline.h"
 
+#include "rendering/gpu_profiler.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/material.h"
@@ -104,13 +105,20 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 
 		subpass->update_render_target_attachments(render_target);
 
+		// Subpasses recording secondary command buffers override the requested contents
+		VkSubpassContents subpass_contents = i == 0 ? contents : VK_SUBPASS_CONTENTS_INLINE;
+		if (subpass->get_use_secondary_command_buffers())
+		{
+			subpass_contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+		}
+
 		if (i == 0)
 		{
-			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, contents);
+			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, subpass_contents);
 		}
 		else
 		{
-			command_buffer.next_subpass();
+			command_buffer.next_subpass(subpass_contents);
 		}
 
 		if (subpass->get_debug_name().empty())
@@ -118,6 +126,7 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 			subpass->set_debug_name(fmt::format("RP subpass #{}", i));
 		}
 		ScopedDebugLabel subpass_debug_label{command_buffer, subpass->get_debug_name().c_str()};
+		ScopedGpuZone    subpass_gpu_zone{command_buffer, subpass->get_debug_name()};
 
 		subpass->draw(command_buffer);
 	}
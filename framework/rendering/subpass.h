@@ -134,6 +134,7 @@ class Subpass
 	RenderContextType                                         &get_render_context();
 	std::unordered_map<std::string, ShaderResourceMode> const &get_resource_mode_map() const;
 	SampleCountflagBitsType                                    get_sample_count() const;
+	bool                                                       get_use_secondary_command_buffers() const;
 	const ShaderSource                                        &get_vertex_shader() const;
 	void                                                       set_color_resolve_attachments(std::vector<uint32_t> const &color_resolve);
 	void                                                       set_debug_name(const std::string &name);
@@ -143,6 +144,7 @@ class Subpass
 	void                                                       set_input_attachments(std::vector<uint32_t> const &input);
 	void                                                       set_output_attachments(std::vector<uint32_t> const &output);
 	void                                                       set_sample_count(SampleCountflagBitsType sample_count);
+	void                                                       set_use_secondary_command_buffers(bool use_secondary_command_buffers);
 
 	/**
 	 * @brief Updates the render target attachments with the ones stored in this subpass
@@ -192,7 +194,14 @@ class Subpass
 	std::unordered_map<std::string, ShaderResourceMode> resource_mode_map;
 
 	vk::SampleCountFlagBits sample_count{vk::SampleCountFlagBits::e1};
-	ShaderSource            vertex_shader;
+
+	/**
+	 * @brief When set, the RenderPipeline begins the subpass with secondary command buffers contents,
+	 *        and the subpass records all its commands into secondary command buffers
+	 */
+	bool use_secondary_command_buffers{false};
+
+	ShaderSource vertex_shader;
 };
 
 using SubpassC   = Subpass<vkb::BindingType::C>;
@@ -280,6 +289,12 @@ inline typename Subpass<bindingType>::SampleCountflagBitsType Subpass<bindingTyp
 	}
 }
 
+template <vkb::BindingType bindingType>
+inline bool Subpass<bindingType>::get_use_secondary_command_buffers() const
+{
+	return use_secondary_command_buffers;
+}
+
 template <vkb::BindingType bindingType>
 inline const ShaderSource &Subpass<bindingType>::get_vertex_shader() const
 {
@@ -478,6 +493,12 @@ inline void Subpass<bindingType>::set_sample_count(SampleCountflagBitsType sampl
 	}
 }
 
+template <vkb::BindingType bindingType>
+inline void Subpass<bindingType>::set_use_secondary_command_buffers(bool use_secondary_command_buffers_)
+{
+	use_secondary_command_buffers = use_secondary_command_buffers_;
+}
+
 template <vkb::BindingType bindingType>
 inline void Subpass<bindingType>::update_render_target_attachments(RenderTargetType &render_target)
 {
@@ -0,0 +1,261 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/clustered_forward_subpass.h"
+
+#include <limits>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+sg::PerspectiveCamera &as_perspective_camera(sg::Camera &camera)
+{
+	auto perspective_camera = dynamic_cast<sg::PerspectiveCamera *>(&camera);
+	if (!perspective_camera)
+	{
+		throw std::runtime_error("ClusteredForwardSubpass needs a perspective camera to slice the view frustum");
+	}
+	return *perspective_camera;
+}
+}        // namespace
+
+ClusteredForwardSubpass::ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_,
+                                                 sg::Camera &camera, const glm::uvec3 &grid_size) :
+    GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    perspective_camera{as_perspective_camera(camera)},
+    grid_size{grid_size}
+{
+	assert(grid_size.x > 0 && grid_size.y > 0 && grid_size.z > 0);
+}
+
+void ClusteredForwardSubpass::prepare()
+{
+	auto &device = get_render_context().get_device();
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			auto &variant = sub_mesh->get_mut_shader_variant();
+
+			variant.add_definitions(vkb::rendering::light_type_definitions);
+
+			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
+			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+		}
+	}
+}
+
+void ClusteredForwardSubpass::draw(CommandBuffer &command_buffer)
+{
+	bin_lights();
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto bind = [&](VkBufferUsageFlags usage, const void *data, size_t size, uint32_t binding) {
+		// Descriptors cannot cover empty ranges
+		auto allocation = render_frame.allocate_buffer(usage, std::max<size_t>(size, sizeof(glm::uvec4)), thread_index);
+		if (size > 0)
+		{
+			allocation.get_buffer().update(data, size, allocation.get_offset());
+		}
+		command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, binding, 0);
+	};
+
+	bind(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, lights.data(), lights.size() * sizeof(rendering::Light), 4);
+	bind(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, &cluster_uniform, sizeof(ClusterUniform), 5);
+	bind(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, clusters.data(), clusters.size() * sizeof(glm::uvec2), 6);
+	bind(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, light_indices.data(), light_indices.size() * sizeof(uint32_t), 7);
+
+	GeometrySubpass::draw(command_buffer);
+}
+
+const ClusteredForwardSubpass::Stats &ClusteredForwardSubpass::get_stats() const
+{
+	return stats;
+}
+
+void ClusteredForwardSubpass::bin_lights()
+{
+	stats = {};
+	lights.clear();
+	light_ranges.clear();
+
+	float near_plane = perspective_camera.get_near_plane();
+	float far_plane  = perspective_camera.get_far_plane();
+
+	glm::mat4 view       = camera.get_view();
+	glm::mat4 projection = camera.get_pre_rotation() * vkb::rendering::vulkan_style_projection(camera.get_projection());
+
+	// Slice k starts at near * (far / near) ^ (k / z), so that clusters stay roughly cubic with the distance
+	float log_depth_range = std::log(far_plane / near_plane);
+
+	cluster_uniform.view         = view;
+	cluster_uniform.view_proj    = projection * view;
+	cluster_uniform.depth_params = {grid_size.z / log_depth_range, -(grid_size.z * std::log(near_plane)) / log_depth_range, 0.0f, 0.0f};
+
+	std::vector<rendering::Light> binned_lights;
+
+	for (auto &scene_light : scene.get_components<sg::Light>())
+	{
+		const auto &properties = scene_light->get_properties();
+		if (properties.intensity <= 0.0f)
+		{
+			continue;
+		}
+		stats.light_count++;
+
+		auto &transform = scene_light->get_node()->get_transform();
+
+		rendering::Light light{{transform.get_translation(), static_cast<float>(scene_light->get_light_type())},
+		                       {properties.color, properties.intensity},
+		                       {transform.get_rotation() * properties.direction, properties.range},
+		                       {properties.inner_cone_angle, properties.outer_cone_angle}};
+
+		if (scene_light->get_light_type() == sg::LightType::Directional || properties.range <= 0.0f)
+		{
+			lights.push_back(light);
+			continue;
+		}
+
+		// Spot lights are bounded by the sphere of their range, which is conservative for narrow cones
+		ClusterRange range;
+		if (get_cluster_range(projection, glm::vec3(view * glm::vec4(transform.get_translation(), 1.0f)), properties.range, range))
+		{
+			binned_lights.push_back(light);
+			light_ranges.push_back(range);
+		}
+	}
+
+	auto global_light_count = to_u32(lights.size());
+	lights.insert(lights.end(), binned_lights.begin(), binned_lights.end());
+
+	cluster_uniform.grid_size = {grid_size, global_light_count};
+	stats.visible_light_count = to_u32(lights.size());
+
+	// Count the lights of each cluster, then lay the indices out cluster after cluster
+	clusters.assign(grid_size.x * grid_size.y * grid_size.z, glm::uvec2{0});
+	stats.cluster_count = to_u32(clusters.size());
+
+	auto for_each_cluster = [this](const ClusterRange &range, auto &&func) {
+		for (uint32_t z = range.min.z; z <= range.max.z; ++z)
+		{
+			for (uint32_t y = range.min.y; y <= range.max.y; ++y)
+			{
+				for (uint32_t x = range.min.x; x <= range.max.x; ++x)
+				{
+					func(clusters[(z * grid_size.y + y) * grid_size.x + x]);
+				}
+			}
+		}
+	};
+
+	for (auto &range : light_ranges)
+	{
+		for_each_cluster(range, [](glm::uvec2 &cluster) { cluster.y++; });
+	}
+
+	uint32_t offset = 0;
+	for (auto &cluster : clusters)
+	{
+		stats.max_cluster_light_count = std::max(stats.max_cluster_light_count, cluster.y);
+
+		cluster.x = offset;
+		offset += cluster.y;
+		cluster.y = 0;
+	}
+
+	light_indices.resize(offset);
+	stats.light_index_count = offset;
+
+	for (uint32_t i = 0; i < light_ranges.size(); ++i)
+	{
+		uint32_t light_index = global_light_count + i;
+		for_each_cluster(light_ranges[i], [this, light_index](glm::uvec2 &cluster) { light_indices[cluster.x + cluster.y++] = light_index; });
+	}
+}
+
+bool ClusteredForwardSubpass::get_cluster_range(const glm::mat4 &projection, const glm::vec3 &view_position, float radius, ClusterRange &range) const
+{
+	float near_plane = perspective_camera.get_near_plane();
+	float far_plane  = perspective_camera.get_far_plane();
+
+	// The camera looks down -z
+	float depth = -view_position.z;
+	if (depth + radius < near_plane || depth - radius > far_plane)
+	{
+		return false;
+	}
+
+	auto get_slice = [&](float slice_depth) {
+		float slice = std::log(slice_depth) * cluster_uniform.depth_params.x + cluster_uniform.depth_params.y;
+		return std::min(static_cast<uint32_t>(std::max(slice, 0.0f)), grid_size.z - 1);
+	};
+
+	range.min.z = get_slice(std::max(depth - radius, near_plane));
+	range.max.z = get_slice(std::min(depth + radius, far_plane));
+
+	if (depth - radius <= near_plane)
+	{
+		// The sphere crosses the near plane, its projection is unbounded
+		range.min.x = 0;
+		range.min.y = 0;
+		range.max.x = grid_size.x - 1;
+		range.max.y = grid_size.y - 1;
+		return true;
+	}
+
+	// The projection of the bounding box of the sphere, all in front of the camera, bounds the projection of the sphere
+	glm::vec2 ndc_min{std::numeric_limits<float>::max()};
+	glm::vec2 ndc_max{std::numeric_limits<float>::lowest()};
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		glm::vec3 corner = view_position + radius * glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+		glm::vec4 clip   = projection * glm::vec4(corner, 1.0f);
+		glm::vec2 ndc    = glm::vec2(clip) / clip.w;
+
+		ndc_min = glm::min(ndc_min, ndc);
+		ndc_max = glm::max(ndc_max, ndc);
+	}
+
+	if (ndc_max.x < -1.0f || ndc_min.x > 1.0f || ndc_max.y < -1.0f || ndc_min.y > 1.0f)
+	{
+		return false;
+	}
+
+	auto get_tile = [](float ndc, uint32_t count) {
+		float tile = (ndc * 0.5f + 0.5f) * count;
+		return std::min(static_cast<uint32_t>(std::max(tile, 0.0f)), count - 1);
+	};
+
+	range.min.x = get_tile(ndc_min.x, grid_size.x);
+	range.min.y = get_tile(ndc_min.y, grid_size.y);
+	range.max.x = get_tile(ndc_max.x, grid_size.x);
+	range.max.y = get_tile(ndc_max.y, grid_size.y);
+	return true;
+}
+}        // namespace vkb
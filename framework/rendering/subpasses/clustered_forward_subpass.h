@@ -0,0 +1,141 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/subpasses/geometry_subpass.h"
+
+namespace vkb
+{
+namespace sg
+{
+class Scene;
+class Camera;
+class PerspectiveCamera;
+}        // namespace sg
+
+/**
+ * @brief Uniform describing the cluster grid to the clustered forward shader
+ */
+struct alignas(16) ClusterUniform
+{
+	glm::mat4 view;
+
+	glm::mat4 view_proj;
+
+	// xyz: number of clusters along each axis, w: number of lights applied to every fragment
+	glm::uvec4 grid_size;
+
+	// x: scale, y: bias of the logarithmic depth slicing
+	glm::vec4 depth_params;
+};
+
+/**
+ * @brief Forward rendering of a Scene with any number of lights
+ *
+ * Each frame, the point and spot lights are binned on the CPU into a grid of clusters dividing the view frustum:
+ * tiles on screen, and slices in depth which grow exponentially with the distance. The fragment shader only
+ * evaluates the lights of the cluster it falls in, so the cost of a fragment depends on the number of lights
+ * reaching it rather than on the number of lights in the scene.
+ *
+ * Lights need a range to be binned, directional lights and lights without a range are applied to every fragment.
+ * Lights without intensity are skipped.
+ *
+ * The fragment shader gets the lights, the cluster uniform, the clusters and the light indices of the clusters
+ * at bindings 4 to 7 of set 0, see shaders/clustered_forward.frag.
+ */
+class ClusteredForwardSubpass : public GeometrySubpass
+{
+  public:
+	struct Stats
+	{
+		uint32_t cluster_count{0};
+
+		uint32_t light_count{0};
+
+		// Lights intersecting the view frustum, and the sum of the lights of each cluster
+		uint32_t visible_light_count{0};
+
+		uint32_t light_index_count{0};
+
+		uint32_t max_cluster_light_count{0};
+	};
+
+	/**
+	 * @brief Constructs a subpass for clustered forward rendering
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Perspective camera used to look at the scene
+	 * @param grid_size Number of clusters along the width, height and depth of the view frustum
+	 */
+	ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene,
+	                        sg::Camera &camera, const glm::uvec3 &grid_size = {16, 9, 24});
+
+	virtual ~ClusteredForwardSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Bins the lights of the scene and records draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @return Statistics of the last binning
+	 */
+	const Stats &get_stats() const;
+
+  private:
+	// Range of clusters a light reaches, bounds included
+	struct ClusterRange
+	{
+		glm::uvec3 min;
+
+		glm::uvec3 max;
+	};
+
+	sg::PerspectiveCamera &perspective_camera;
+
+	glm::uvec3 grid_size;
+
+	// Lights applied to every fragment first, then the binned lights
+	std::vector<rendering::Light> lights;
+
+	std::vector<ClusterRange> light_ranges;
+
+	// Offset and count of the light indices of each cluster
+	std::vector<glm::uvec2> clusters;
+
+	std::vector<uint32_t> light_indices;
+
+	ClusterUniform cluster_uniform{};
+
+	Stats stats;
+
+	/**
+	 * @brief Gathers the lights of the scene and assigns them to the clusters they reach
+	 */
+	void bin_lights();
+
+	/**
+	 * @return Whether the sphere reaches the view frustum, and if so the clusters it reaches
+	 */
+	bool get_cluster_range(const glm::mat4 &projection, const glm::vec3 &view_position, float radius, ClusterRange &range) const;
+};
+}        // namespace vkb
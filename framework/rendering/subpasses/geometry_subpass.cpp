@@ -16,6 +16,13 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <core/util/job_system.hpp>
+#include <core/util/profiling.hpp>
+
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
@@ -87,28 +94,82 @@ void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *
 
 void GeometrySubpass::draw(CommandBuffer &command_buffer)
 {
+	PROFILE_SCOPE("Geometry subpass");
+
 	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
 	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
 
 	get_sorted_nodes(opaque_nodes, transparent_nodes);
 
-	// Draw opaque objects in front-to-back order
+	// Opaque objects are drawn in front-to-back order, transparent ones in back-to-front order
+	std::vector<std::pair<sg::Node *, sg::SubMesh *>> sorted_opaque_nodes;
+	sorted_opaque_nodes.reserve(opaque_nodes.size());
+	if (state_sorting && !opaque_nodes.empty())
 	{
-		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+		float max_distance = std::max(opaque_nodes.rbegin()->first, std::numeric_limits<float>::min());
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		std::vector<std::pair<uint64_t, std::pair<sg::Node *, sg::SubMesh *>>> keyed_opaque_nodes;
+		keyed_opaque_nodes.reserve(opaque_nodes.size());
+		for (auto &node_it : opaque_nodes)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			auto &node = node_it.second;
+			keyed_opaque_nodes.emplace_back(get_state_sort_key(*node.first, *node.second, node_it.first / max_distance), node);
+		}
 
-			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
-			bool        flipped    = scale.x * scale.y * scale.z < 0;
-			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		std::stable_sort(keyed_opaque_nodes.begin(), keyed_opaque_nodes.end(),
+		                 [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+		for (auto &keyed_node : keyed_opaque_nodes)
+		{
+			sorted_opaque_nodes.push_back(keyed_node.second);
 		}
 	}
+	else
+	{
+		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		{
+			sorted_opaque_nodes.push_back(node_it->second);
+		}
+	}
+
+	std::vector<std::pair<sg::Node *, sg::SubMesh *>> sorted_transparent_nodes;
+	sorted_transparent_nodes.reserve(transparent_nodes.size());
+	for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+	{
+		sorted_transparent_nodes.push_back(node_it->second);
+	}
+
+	if (get_use_secondary_command_buffers())
+	{
+		draw_secondary(command_buffer, sorted_opaque_nodes, sorted_transparent_nodes);
+		return;
+	}
 
+	draw_opaque_nodes(command_buffer, sorted_opaque_nodes, 0, sorted_opaque_nodes.size(), thread_index);
+
+	draw_transparent_nodes(command_buffer, sorted_transparent_nodes, thread_index);
+}
+
+void GeometrySubpass::draw_opaque_nodes(CommandBuffer &command_buffer, const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &nodes,
+                                        size_t first, size_t last, size_t node_thread_index)
+{
+	ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+
+	for (size_t i = first; i < last; ++i)
+	{
+		update_uniform(command_buffer, *nodes[i].first, node_thread_index);
+
+		// Invert the front face if the mesh was flipped
+		const auto &scale      = nodes[i].first->get_transform().get_scale();
+		bool        flipped    = scale.x * scale.y * scale.z < 0;
+		VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+		draw_submesh(command_buffer, *nodes[i].second, front_face);
+	}
+}
+
+void GeometrySubpass::draw_transparent_nodes(CommandBuffer &command_buffer, const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &nodes, size_t node_thread_index)
+{
 	// Enable alpha blending
 	ColorBlendAttachmentState color_blend_attachment{};
 	color_blend_attachment.blend_enable           = VK_TRUE;
@@ -126,17 +187,100 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 
 	command_buffer.set_depth_stencil_state(get_depth_stencil_state());
 
-	// Draw transparent objects in back-to-front order
+	ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+
+	for (auto &node : nodes)
 	{
-		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+		update_uniform(command_buffer, *node.first, node_thread_index);
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
-		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+		draw_submesh(command_buffer, *node.second);
+	}
+}
+
+void GeometrySubpass::draw_secondary(CommandBuffer                                            &primary_command_buffer,
+                                     const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
+                                     const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+{
+	auto &render_frame = get_render_context().get_active_frame();
+	auto &queue        = get_render_context().get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	// Chunks need thread indices of their own, past the one of the subpass
+	size_t worker_count = 0;
+	if (render_frame.get_thread_count() > thread_index + 1)
+	{
+		worker_count = std::min<size_t>(recording_thread_count, render_frame.get_thread_count() - thread_index - 1);
+	}
+
+	// Small chunks are not worth a secondary command buffer
+	const size_t min_draws_per_chunk = 16;
+	size_t       chunk_count         = std::max<size_t>(1, std::min(worker_count, (opaque_nodes.size() + min_draws_per_chunk - 1) / min_draws_per_chunk));
+
+	// Command buffers are requested upfront, as command pools are created on first use and not thread safe
+	std::vector<CommandBuffer *> secondary_command_buffers;
+	for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+	{
+		size_t chunk_thread_index = worker_count > 0 ? thread_index + 1 + chunk : thread_index;
+		secondary_command_buffers.push_back(&render_frame.request_command_buffer(queue, CommandBuffer::ResetMode::ResetPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY, chunk_thread_index));
+	}
+	if (!transparent_nodes.empty())
+	{
+		secondary_command_buffers.push_back(&render_frame.request_command_buffer(queue, CommandBuffer::ResetMode::ResetPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY, thread_index));
+	}
 
-			draw_submesh(command_buffer, *node_it->second.second);
+	auto begin_secondary = [&](CommandBuffer &secondary_command_buffer) {
+		secondary_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &primary_command_buffer);
+
+		// Dynamic state is not inherited, the draws cover the whole framebuffer
+		auto extent = primary_command_buffer.get_current_render_pass().framebuffer->get_extent();
+
+		VkViewport viewport{};
+		viewport.width    = static_cast<float>(extent.width);
+		viewport.height   = static_cast<float>(extent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		secondary_command_buffer.set_viewport(0, {viewport});
+
+		VkRect2D scissor{};
+		scissor.extent = extent;
+		secondary_command_buffer.set_scissor(0, {scissor});
+
+		secondary_command_buffer.inherit_resource_bindings(primary_command_buffer);
+	};
+
+	auto record_opaque_chunk = [&](size_t chunk, size_t chunk_thread_index) {
+		PROFILE_SCOPE("Record opaque draws");
+
+		auto &secondary_command_buffer = *secondary_command_buffers[chunk];
+		begin_secondary(secondary_command_buffer);
+		draw_opaque_nodes(secondary_command_buffer, opaque_nodes, opaque_nodes.size() * chunk / chunk_count, opaque_nodes.size() * (chunk + 1) / chunk_count, chunk_thread_index);
+		secondary_command_buffer.end();
+	};
+
+	JobCounter chunk_counter;
+	if (worker_count > 0)
+	{
+		for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+		{
+			JobSystem::get().submit([&, chunk]() { record_opaque_chunk(chunk, thread_index + 1 + chunk); }, &chunk_counter);
 		}
 	}
+	else
+	{
+		record_opaque_chunk(0, thread_index);
+	}
+
+	// The transparent draws are recorded on the calling thread meanwhile
+	if (!transparent_nodes.empty())
+	{
+		auto &secondary_command_buffer = *secondary_command_buffers.back();
+		begin_secondary(secondary_command_buffer);
+		draw_transparent_nodes(secondary_command_buffer, transparent_nodes, thread_index);
+		secondary_command_buffer.end();
+	}
+
+	JobSystem::get().wait(chunk_counter);
+
+	primary_command_buffer.execute_commands(secondary_command_buffers);
 }
 
 void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
@@ -316,4 +460,37 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_recording_thread_count(uint32_t thread_count)
+{
+	recording_thread_count = thread_count;
+
+	set_use_secondary_command_buffers(thread_count > 0);
+}
+
+void GeometrySubpass::set_state_sorting(bool enabled)
+{
+	state_sorting = enabled;
+}
+
+uint64_t GeometrySubpass::get_state_sort_key(sg::Node &node, sg::SubMesh &sub_mesh, float depth)
+{
+	// Ids past the bits of their field wrap around, which only makes different states sort together
+	uint64_t shader_variant_id = shader_variant_ids.emplace(sub_mesh.get_shader_variant().get_id(), shader_variant_ids.size()).first->second;
+	uint64_t material_id       = material_ids.emplace(sub_mesh.get_material(), material_ids.size()).first->second;
+	uint64_t sub_mesh_id       = sub_mesh_ids.emplace(&sub_mesh, sub_mesh_ids.size()).first->second;
+
+	// The front face and cull mode of draw_opaque_nodes and prepare_pipeline_state
+	const auto &scale        = node.get_transform().get_scale();
+	uint64_t    flipped      = scale.x * scale.y * scale.z < 0;
+	uint64_t    double_sided = sub_mesh.get_material()->double_sided;
+	uint64_t    depth_bucket = static_cast<uint64_t>(glm::clamp(depth, 0.0f, 1.0f) * 0xffff);
+
+	return (shader_variant_id & 0xfff) << 52 |
+	       double_sided << 51 |
+	       flipped << 50 |
+	       (material_id & 0xffff) << 34 |
+	       (sub_mesh_id & 0x3ffff) << 16 |
+	       depth_bucket;
+}
 }        // namespace vkb
@@ -32,6 +32,7 @@ class Node;
 class Mesh;
 class SubMesh;
 class Camera;
+class Material;
 }        // namespace sg
 
 /**
@@ -88,6 +89,29 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Records the draws as jobs of the job system, into secondary command buffers executed in order
+	 *
+	 * The sorted opaque draws are split into contiguous chunks, at most one per thread, and the transparent draws
+	 * are recorded into one more secondary command buffer to keep their order. Chunk i allocates its resources
+	 * with the thread index thread_index + 1 + i, threads the render context was not prepared for are not used.
+	 *
+	 * Resources bound on the primary command buffer before the draws, such as the lights of subclasses, are bound
+	 * again on every secondary command buffer.
+	 *
+	 * @param thread_count Number of chunks recorded in parallel, 0 records the draws inline on the primary command buffer
+	 */
+	void set_recording_thread_count(uint32_t thread_count);
+
+	/**
+	 * @brief Sorts the opaque draws by a 64-bit key of their pipeline state, material and mesh before their distance,
+	 *        so that consecutive draws share most of their state and the command buffer skips their redundant binds
+	 *
+	 * Draws sharing all of their state are still drawn front-to-back, the scene as a whole is not anymore.
+	 * Transparent draws keep their back-to-front order.
+	 */
+	void set_state_sorting(bool enabled);
+
   protected:
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
@@ -117,6 +141,35 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+  private:
+	uint32_t recording_thread_count{0};
+
+	bool state_sorting{false};
+
+	// Small ids packed into the sort keys, given in the order the draws are first seen
+	std::unordered_map<size_t, uint64_t> shader_variant_ids;
+
+	std::unordered_map<const sg::Material *, uint64_t> material_ids;
+
+	std::unordered_map<const sg::SubMesh *, uint64_t> sub_mesh_ids;
+
+	/**
+	 * @brief Computes the sort key of an opaque draw, from the most to the least significant bits:
+	 *        12 bits of shader variant, 2 bits of rasterization state, 16 bits of material, 18 bits of sub mesh
+	 *        and 16 bits of depth
+	 * @param depth Distance of the node from the camera, relative to the farthest opaque draw
+	 */
+	uint64_t get_state_sort_key(sg::Node &node, sg::SubMesh &sub_mesh, float depth);
+
+	void draw_opaque_nodes(CommandBuffer &command_buffer, const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &nodes,
+	                       size_t first, size_t last, size_t node_thread_index);
+
+	void draw_transparent_nodes(CommandBuffer &command_buffer, const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &nodes, size_t node_thread_index);
+
+	void draw_secondary(CommandBuffer                                            &primary_command_buffer,
+	                    const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
+	                    const std::vector<std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
 };
 
 }        // namespace vkb
@@ -0,0 +1,519 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/virtual_texture.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/strings.h"
+#include "common/utils.h"
+#include "common/vk_initializers.h"
+
+namespace vkb
+{
+namespace
+{
+// Number of pages allocated at once when the memory pool grows
+constexpr uint32_t PAGES_PER_ALLOCATION = 64;
+
+constexpr uint32_t BYTES_PER_TEXEL = 4;
+}        // namespace
+
+VirtualTexture::VirtualTexture(Device &device, std::unique_ptr<sg::Image> &&source_image, const Config &config) :
+    device{device},
+    config{config},
+    source{std::move(source_image)}
+{
+	const auto &features = device.get_gpu().get_requested_features();
+	if (!features.sparseBinding || !features.sparseResidencyImage2D)
+	{
+		throw std::runtime_error("VirtualTexture requires the sparseBinding and sparseResidencyImage2D features");
+	}
+
+	if (get_bits_per_pixel(source->get_format()) != BYTES_PER_TEXEL * 8)
+	{
+		throw std::runtime_error("VirtualTexture only supports formats with " + std::to_string(BYTES_PER_TEXEL) + " bytes per texel");
+	}
+
+	if (source->get_mipmaps().size() == 1)
+	{
+		source->generate_mipmaps();
+	}
+	mip_levels = to_u32(source->get_mipmaps().size());
+	if (config.mip_levels > 0)
+	{
+		mip_levels = std::min(mip_levels, config.mip_levels);
+	}
+
+	this->config.frames_in_flight = std::max(1U, config.frames_in_flight);
+
+	sparse_queue = device.get_queue_by_flags(VK_QUEUE_SPARSE_BINDING_BIT, 0).get_handle();
+
+	create_image();
+	bind_mip_tail();
+	upload_mip_tail();
+
+	staging_segment_size = (config.staging_size / this->config.frames_in_flight) / page_size * page_size;
+	if (staging_segment_size == 0)
+	{
+		throw std::runtime_error("VirtualTexture staging ring is too small to hold a single page per frame");
+	}
+	staging_ring = std::make_unique<core::BufferC>(device,
+	                                               staging_segment_size * this->config.frames_in_flight,
+	                                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	                                               VMA_MEMORY_USAGE_CPU_TO_GPU,
+	                                               VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+	bind_semaphores.resize(this->config.frames_in_flight);
+	VkSemaphoreCreateInfo semaphore_create_info = initializers::semaphore_create_info();
+	for (auto &semaphore : bind_semaphores)
+	{
+		VK_CHECK(vkCreateSemaphore(device.get_handle(), &semaphore_create_info, nullptr, &semaphore));
+	}
+
+	selection_thread = std::thread([this] { selection_worker(); });
+}
+
+VirtualTexture::~VirtualTexture()
+{
+	{
+		std::lock_guard<std::mutex> lock{selection_mutex};
+		stop_selection = true;
+	}
+	selection_condition.notify_one();
+	if (selection_thread.joinable())
+	{
+		selection_thread.join();
+	}
+
+	device.wait_idle();
+
+	for (auto semaphore : bind_semaphores)
+	{
+		vkDestroySemaphore(device.get_handle(), semaphore, nullptr);
+	}
+
+	vkDestroyImageView(device.get_handle(), image_view, nullptr);
+	vkDestroyImage(device.get_handle(), image, nullptr);
+
+	for (auto memory : memory_blocks)
+	{
+		vkFreeMemory(device.get_handle(), memory, nullptr);
+	}
+
+	if (mip_tail_memory != VK_NULL_HANDLE)
+	{
+		vkFreeMemory(device.get_handle(), mip_tail_memory, nullptr);
+	}
+}
+
+void VirtualTexture::request(std::vector<VirtualTextureRequest> &&requests)
+{
+	{
+		std::lock_guard<std::mutex> lock{selection_mutex};
+		pending_requests     = std::move(requests);
+		has_pending_requests = true;
+	}
+	selection_condition.notify_one();
+}
+
+VkSemaphore VirtualTexture::update(VkCommandBuffer command_buffer, uint32_t frame_index)
+{
+	page_table->begin_frame();
+	stats = {};
+
+	{
+		std::lock_guard<std::mutex> lock{selection_mutex};
+		if (has_selected_pages)
+		{
+			working_set        = std::move(selected_pages);
+			has_selected_pages = false;
+		}
+	}
+
+	// Mark the resident part of the working set as used first, so none of it is picked for eviction below
+	std::vector<uint32_t> faults;
+	for (auto page_index : working_set)
+	{
+		if (page_table->get_slot(page_index) >= 0)
+		{
+			page_table->touch(page_index);
+		}
+		else
+		{
+			faults.push_back(page_index);
+		}
+	}
+	stats.page_faults = to_u32(faults.size());
+
+	std::vector<VkSparseImageMemoryBind> binds;
+	std::vector<VkBufferImageCopy>       copies;
+
+	VkDeviceSize segment_offset = (frame_index % config.frames_in_flight) * staging_segment_size;
+	uint8_t     *segment_data   = staging_ring->map() + segment_offset;
+
+	for (auto page_index : faults)
+	{
+		if (stats.upload_bytes + page_size > staging_segment_size)
+		{
+			break;
+		}
+
+		int64_t slot_index = acquire_slot(page_index, binds);
+		if (slot_index < 0)
+		{
+			break;
+		}
+
+		const auto &slot = slots[slot_index];
+
+		auto bind         = get_page_bind(page_index);
+		bind.memory       = slot.memory;
+		bind.memoryOffset = slot.offset;
+		binds.push_back(bind);
+
+		VkBufferImageCopy copy{};
+		copy.bufferOffset                    = segment_offset + stats.upload_bytes;
+		copy.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.imageSubresource.mipLevel       = bind.subresource.mipLevel;
+		copy.imageSubresource.baseArrayLayer = 0;
+		copy.imageSubresource.layerCount     = 1;
+		copy.imageOffset                     = bind.offset;
+		copy.imageExtent                     = bind.extent;
+		copies.push_back(copy);
+
+		stats.upload_bytes += stage_page(bind, segment_data + stats.upload_bytes);
+	}
+
+	stats.pages_uploaded = to_u32(copies.size());
+	stats.resident_pages = page_table->get_resident_page_count();
+
+	if (binds.empty())
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	if (!copies.empty())
+	{
+		staging_ring->flush(segment_offset, stats.upload_bytes);
+
+		VkImageSubresourceRange subresource_range{};
+		subresource_range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		subresource_range.baseMipLevel   = 0;
+		subresource_range.levelCount     = to_u32(page_table->get_levels().size());
+		subresource_range.baseArrayLayer = 0;
+		subresource_range.layerCount     = 1;
+
+		image_layout_transition(command_buffer, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
+		vkCmdCopyBufferToImage(command_buffer, staging_ring->get_handle(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, to_u32(copies.size()), copies.data());
+		image_layout_transition(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
+	}
+
+	// All binds and unbinds of this update go to the sparse queue at once
+	VkSparseImageMemoryBindInfo image_bind_info{};
+	image_bind_info.image     = image;
+	image_bind_info.bindCount = to_u32(binds.size());
+	image_bind_info.pBinds    = binds.data();
+
+	VkSemaphore semaphore = bind_semaphores[frame_index % config.frames_in_flight];
+
+	VkBindSparseInfo bind_sparse_info     = initializers::bind_sparse_info();
+	bind_sparse_info.imageBindCount       = 1;
+	bind_sparse_info.pImageBinds          = &image_bind_info;
+	bind_sparse_info.signalSemaphoreCount = 1;
+	bind_sparse_info.pSignalSemaphores    = &semaphore;
+
+	VK_CHECK(vkQueueBindSparse(sparse_queue, 1, &bind_sparse_info, VK_NULL_HANDLE));
+
+	return semaphore;
+}
+
+VkImage VirtualTexture::get_image() const
+{
+	return image;
+}
+
+VkImageView VirtualTexture::get_image_view() const
+{
+	return image_view;
+}
+
+VkExtent3D VirtualTexture::get_extent() const
+{
+	return source->get_extent();
+}
+
+uint32_t VirtualTexture::get_mip_levels() const
+{
+	return mip_levels;
+}
+
+uint32_t VirtualTexture::get_mip_tail_first_lod() const
+{
+	return to_u32(page_table->get_levels().size());
+}
+
+VkDeviceSize VirtualTexture::get_page_size() const
+{
+	return page_size;
+}
+
+const VirtualTextureStats &VirtualTexture::get_stats() const
+{
+	return stats;
+}
+
+void VirtualTexture::create_image()
+{
+	const auto &extent = source->get_extent();
+
+	VkImageCreateInfo image_create_info = initializers::image_create_info();
+	image_create_info.flags             = VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+	image_create_info.imageType         = VK_IMAGE_TYPE_2D;
+	image_create_info.format            = source->get_format();
+	image_create_info.extent            = {extent.width, extent.height, 1};
+	image_create_info.mipLevels         = mip_levels;
+	image_create_info.arrayLayers       = 1;
+	image_create_info.samples           = VK_SAMPLE_COUNT_1_BIT;
+	image_create_info.tiling            = VK_IMAGE_TILING_OPTIMAL;
+	image_create_info.usage             = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | config.usage;
+	image_create_info.sharingMode       = VK_SHARING_MODE_EXCLUSIVE;
+	image_create_info.initialLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VK_CHECK(vkCreateImage(device.get_handle(), &image_create_info, nullptr, &image));
+
+	uint32_t requirement_count = 0;
+	vkGetImageSparseMemoryRequirements(device.get_handle(), image, &requirement_count, nullptr);
+	std::vector<VkSparseImageMemoryRequirements> requirements(requirement_count);
+	vkGetImageSparseMemoryRequirements(device.get_handle(), image, &requirement_count, requirements.data());
+
+	auto it = std::find_if(requirements.begin(), requirements.end(), [](const VkSparseImageMemoryRequirements &requirement) {
+		return requirement.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT;
+	});
+	if (it == requirements.end())
+	{
+		throw std::runtime_error("VirtualTexture format " + to_string(source->get_format()) + " does not support sparse residency");
+	}
+	sparse_requirements = *it;
+	format_properties   = it->formatProperties;
+
+	// The alignment of a sparse resource is the size of its sparse blocks
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements(device.get_handle(), image, &memory_requirements);
+	page_size         = memory_requirements.alignment;
+	memory_type_index = device.get_memory_type(memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	// Slots are as many pages as fit in the memory budget
+	const auto &granularity   = format_properties.imageGranularity;
+	uint32_t    slot_capacity = std::max(1U, to_u32(config.memory_budget / page_size));
+	page_table                = std::make_unique<VirtualTexturePageTable>(extent.width, extent.height, mip_levels, sparse_requirements.imageMipTailFirstLod, granularity.width, granularity.height, slot_capacity, config.frames_in_flight);
+
+	VkImageViewCreateInfo view_create_info       = initializers::image_view_create_info();
+	view_create_info.image                       = image;
+	view_create_info.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
+	view_create_info.format                      = source->get_format();
+	view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	view_create_info.subresourceRange.levelCount = mip_levels;
+	view_create_info.subresourceRange.layerCount = 1;
+
+	VK_CHECK(vkCreateImageView(device.get_handle(), &view_create_info, nullptr, &image_view));
+}
+
+void VirtualTexture::bind_mip_tail()
+{
+	if (sparse_requirements.imageMipTailFirstLod >= mip_levels)
+	{
+		return;
+	}
+
+	// With a single array layer there is only one mip tail, whether VK_SPARSE_IMAGE_FORMAT_SINGLE_MIPTAIL_BIT is set or not
+	VkMemoryAllocateInfo memory_allocate_info{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+	memory_allocate_info.allocationSize  = sparse_requirements.imageMipTailSize;
+	memory_allocate_info.memoryTypeIndex = memory_type_index;
+	VK_CHECK(vkAllocateMemory(device.get_handle(), &memory_allocate_info, nullptr, &mip_tail_memory));
+
+	VkSparseMemoryBind mip_tail_bind{};
+	mip_tail_bind.resourceOffset = sparse_requirements.imageMipTailOffset;
+	mip_tail_bind.size           = sparse_requirements.imageMipTailSize;
+	mip_tail_bind.memory         = mip_tail_memory;
+
+	VkSparseImageOpaqueMemoryBindInfo opaque_bind_info{};
+	opaque_bind_info.image     = image;
+	opaque_bind_info.bindCount = 1;
+	opaque_bind_info.pBinds    = &mip_tail_bind;
+
+	VkBindSparseInfo bind_sparse_info     = initializers::bind_sparse_info();
+	bind_sparse_info.imageOpaqueBindCount = 1;
+	bind_sparse_info.pImageOpaqueBinds    = &opaque_bind_info;
+
+	VkFence           fence;
+	VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &fence));
+	VK_CHECK(vkQueueBindSparse(sparse_queue, 1, &bind_sparse_info, fence));
+	VK_CHECK(vkWaitForFences(device.get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
+	vkDestroyFence(device.get_handle(), fence, nullptr);
+}
+
+void VirtualTexture::upload_mip_tail()
+{
+	const auto &mipmaps = source->get_mipmaps();
+
+	VkImageSubresourceRange subresource_range{};
+	subresource_range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+	subresource_range.baseMipLevel   = 0;
+	subresource_range.levelCount     = mip_levels;
+	subresource_range.baseArrayLayer = 0;
+	subresource_range.layerCount     = 1;
+
+	VkCommandBuffer command_buffer = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+	image_layout_transition(command_buffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
+
+	// The staging buffer has to outlive the command buffer
+	std::unique_ptr<core::BufferC> staging_buffer;
+
+	uint32_t first_tail_level = to_u32(page_table->get_levels().size());
+	if (first_tail_level < mip_levels)
+	{
+		VkDeviceSize   tail_offset = mipmaps[first_tail_level].offset;
+		VkDeviceSize   tail_size   = source->get_data().size() - tail_offset;
+		const uint8_t *tail_data   = source->get_data().data() + tail_offset;
+		staging_buffer             = std::make_unique<core::BufferC>(core::BufferC::create_staging_buffer(device, tail_size, tail_data));
+
+		std::vector<VkBufferImageCopy> copies;
+		for (uint32_t level = first_tail_level; level < mip_levels; ++level)
+		{
+			VkBufferImageCopy copy{};
+			copy.bufferOffset                    = mipmaps[level].offset - tail_offset;
+			copy.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+			copy.imageSubresource.mipLevel       = level;
+			copy.imageSubresource.baseArrayLayer = 0;
+			copy.imageSubresource.layerCount     = 1;
+			copy.imageExtent                     = mipmaps[level].extent;
+			copies.push_back(copy);
+		}
+
+		vkCmdCopyBufferToImage(command_buffer, staging_buffer->get_handle(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, to_u32(copies.size()), copies.data());
+	}
+
+	image_layout_transition(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
+
+	device.flush_command_buffer(command_buffer, device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_handle());
+}
+
+void VirtualTexture::selection_worker()
+{
+	while (true)
+	{
+		std::vector<VirtualTextureRequest> requests;
+		{
+			std::unique_lock<std::mutex> lock{selection_mutex};
+			selection_condition.wait(lock, [this] { return stop_selection || has_pending_requests; });
+			if (stop_selection)
+			{
+				return;
+			}
+			requests             = std::move(pending_requests);
+			has_pending_requests = false;
+		}
+
+		std::vector<VirtualTexturePageRequest> page_requests;
+		page_requests.reserve(requests.size());
+		for (const auto &request : requests)
+		{
+			page_requests.push_back({request.uv_min.x, request.uv_min.y, request.uv_max.x, request.uv_max.y, request.lod});
+		}
+
+		auto selection = page_table->select_pages(page_requests);
+
+		{
+			std::lock_guard<std::mutex> lock{selection_mutex};
+			selected_pages     = std::move(selection);
+			has_selected_pages = true;
+		}
+	}
+}
+
+VkSparseImageMemoryBind VirtualTexture::get_page_bind(uint32_t page_index) const
+{
+	uint32_t    level       = page_table->get_level(page_index);
+	const auto &properties  = page_table->get_levels()[level];
+	const auto &granularity = format_properties.imageGranularity;
+
+	uint32_t local_index = page_index - properties.first_page;
+	uint32_t x           = (local_index % properties.columns) * granularity.width;
+	uint32_t y           = (local_index / properties.columns) * granularity.height;
+
+	VkSparseImageMemoryBind bind{};
+	bind.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	bind.subresource.mipLevel   = level;
+	bind.subresource.arrayLayer = 0;
+	bind.offset                 = {static_cast<int32_t>(x), static_cast<int32_t>(y), 0};
+	bind.extent                 = {std::min(granularity.width, properties.width - x), std::min(granularity.height, properties.height - y), 1};
+	bind.memory                 = VK_NULL_HANDLE;
+	return bind;
+}
+
+int64_t VirtualTexture::acquire_slot(uint32_t page_index, std::vector<VkSparseImageMemoryBind> &binds)
+{
+	if (page_table->needs_slots())
+	{
+		uint32_t page_count = std::min(PAGES_PER_ALLOCATION, page_table->get_slot_capacity() - page_table->get_slot_count());
+
+		VkMemoryAllocateInfo memory_allocate_info{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+		memory_allocate_info.allocationSize  = page_size * page_count;
+		memory_allocate_info.memoryTypeIndex = memory_type_index;
+
+		VkDeviceMemory memory;
+		VK_CHECK(vkAllocateMemory(device.get_handle(), &memory_allocate_info, nullptr, &memory));
+		memory_blocks.push_back(memory);
+
+		for (uint32_t i = 0; i < page_count; ++i)
+		{
+			slots.push_back({memory, page_size * i});
+		}
+		page_table->add_slots(page_count);
+	}
+
+	int64_t evicted_page = -1;
+	int64_t slot_index   = page_table->make_resident(page_index, evicted_page);
+	if (evicted_page >= 0)
+	{
+		binds.push_back(get_page_bind(static_cast<uint32_t>(evicted_page)));
+		++stats.pages_evicted;
+	}
+
+	return slot_index;
+}
+
+VkDeviceSize VirtualTexture::stage_page(const VkSparseImageMemoryBind &bind, uint8_t *destination) const
+{
+	const auto    &properties = page_table->get_levels()[bind.subresource.mipLevel];
+	const uint8_t *level_data = source->get_data().data() + source->get_mipmaps()[bind.subresource.mipLevel].offset;
+
+	// Rows are written tightly packed, straight into the mapped staging ring
+	VkDeviceSize row_size = bind.extent.width * BYTES_PER_TEXEL;
+	for (uint32_t row = 0; row < bind.extent.height; ++row)
+	{
+		VkDeviceSize source_offset = ((bind.offset.y + row) * static_cast<VkDeviceSize>(properties.width) + bind.offset.x) * BYTES_PER_TEXEL;
+		std::memcpy(destination + row * row_size, level_data + source_offset, row_size);
+	}
+
+	return row_size * bind.extent.height;
+}
+}        // namespace vkb
@@ -0,0 +1,243 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <core/util/virtual_texture_pages.hpp>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/device.h"
+#include "scene_graph/components/image.h"
+
+namespace vkb
+{
+/**
+ * @brief Statistics of the last VirtualTexture::update call
+ */
+struct VirtualTextureStats
+{
+	/// Pages requested by the current selection that were not resident
+	uint32_t page_faults{0};
+
+	/// Pages uploaded and bound during the update
+	uint32_t pages_uploaded{0};
+
+	/// Resident pages whose memory was reused for other pages
+	uint32_t pages_evicted{0};
+
+	/// Pages resident after the update, the mip tail is not included
+	uint32_t resident_pages{0};
+
+	/// Bytes written to the staging ring during the update
+	VkDeviceSize upload_bytes{0};
+};
+
+/**
+ * @brief A region of the texture, in normalized texture coordinates, sampled at a given level of detail
+ */
+struct VirtualTextureRequest
+{
+	glm::vec2 uv_min{0.0f};
+	glm::vec2 uv_max{1.0f};
+	float     lod{0.0f};
+};
+
+/**
+ * @brief A sparse residency texture whose pages are streamed from CPU memory on demand.
+ *
+ * Visibility is reported through request(), a background thread turns it into a prioritized list of pages,
+ * and update() makes as many of them resident as the staging ring allows for the frame.
+ * Device memory is limited to a fixed budget: once it is exhausted the least recently used pages are evicted.
+ * A page is only evicted if no frame in flight may still sample it.
+ *
+ * All sparse binds of an update are batched into a single vkQueueBindSparse call, which signals a semaphore
+ * the frame submission has to wait on. The mip tail is bound and uploaded at creation and never evicted.
+ *
+ * The device must have the sparseBinding and sparseResidencyImage2D features enabled.
+ */
+class VirtualTexture
+{
+  public:
+	struct Config
+	{
+		/// Device memory available for streamed pages
+		VkDeviceSize memory_budget{64 * 1024 * 1024};
+
+		/// Size of the persistently mapped staging ring, split evenly between the frames in flight
+		VkDeviceSize staging_size{16 * 1024 * 1024};
+
+		/// Number of frames that may be in flight, pages are only evicted once they are unused for this many frames
+		uint32_t frames_in_flight{3};
+
+		/// Image usage in addition to VK_IMAGE_USAGE_SAMPLED_BIT and VK_IMAGE_USAGE_TRANSFER_DST_BIT
+		VkImageUsageFlags usage{0};
+
+		/// Maximum number of mip levels of the texture, 0 to keep all the levels of the source
+		uint32_t mip_levels{0};
+	};
+
+	/**
+	 * @brief Creates the sparse image and binds and uploads its mip tail
+	 * @param device A valid Vulkan device
+	 * @param source Image holding the texel data, mipmaps are generated if it only has one level;
+	 *               it must use a four byte per texel format and is kept in CPU memory for streaming
+	 * @param config Streaming configuration
+	 */
+	VirtualTexture(Device &device, std::unique_ptr<sg::Image> &&source, const Config &config);
+
+	VirtualTexture(const VirtualTexture &) = delete;
+
+	VirtualTexture(VirtualTexture &&) = delete;
+
+	~VirtualTexture();
+
+	VirtualTexture &operator=(const VirtualTexture &) = delete;
+
+	VirtualTexture &operator=(VirtualTexture &&) = delete;
+
+	/**
+	 * @brief Hands the current visibility to the page selection thread
+	 *        Does not block; a request not yet processed is replaced
+	 * @param requests Regions of the texture visible in the current frame
+	 */
+	void request(std::vector<VirtualTextureRequest> &&requests);
+
+	/**
+	 * @brief Makes the pages of the latest selection resident
+	 *        Evicts and binds pages and records the uploads into the given command buffer.
+	 *        The caller must ensure the frame that last used frame_index has completed.
+	 * @param command_buffer Command buffer in the recording state, submitted before the texture is sampled
+	 * @param frame_index Index of the frame in flight, selects the staging ring segment
+	 * @return A semaphore the submission of command_buffer must wait on, or VK_NULL_HANDLE if nothing was bound
+	 */
+	VkSemaphore update(VkCommandBuffer command_buffer, uint32_t frame_index);
+
+	VkImage get_image() const;
+
+	VkImageView get_image_view() const;
+
+	VkExtent3D get_extent() const;
+
+	uint32_t get_mip_levels() const;
+
+	/**
+	 * @return The first mip level of the mip tail, levels from this one onwards are always resident
+	 */
+	uint32_t get_mip_tail_first_lod() const;
+
+	VkDeviceSize get_page_size() const;
+
+	const VirtualTextureStats &get_stats() const;
+
+  private:
+	/// A page-sized range of device memory
+	struct MemorySlot
+	{
+		VkDeviceMemory memory;
+		VkDeviceSize   offset;
+	};
+
+	Device &device;
+
+	Config config;
+
+	std::unique_ptr<sg::Image> source;
+
+	VkImage image{VK_NULL_HANDLE};
+
+	VkImageView image_view{VK_NULL_HANDLE};
+
+	VkQueue sparse_queue{VK_NULL_HANDLE};
+
+	VkSparseImageFormatProperties format_properties{};
+
+	VkSparseImageMemoryRequirements sparse_requirements{};
+
+	VkDeviceSize page_size{0};
+
+	uint32_t memory_type_index{0};
+
+	uint32_t mip_levels{0};
+
+	/// Page grid, selection and residency of the streamed levels
+	std::unique_ptr<VirtualTexturePageTable> page_table;
+
+	/// Memory of the page table slots, indexed by slot
+	std::vector<MemorySlot> slots;
+
+	std::vector<VkDeviceMemory> memory_blocks;
+
+	VkDeviceMemory mip_tail_memory{VK_NULL_HANDLE};
+
+	std::unique_ptr<core::BufferC> staging_ring;
+
+	VkDeviceSize staging_segment_size{0};
+
+	std::vector<VkSemaphore> bind_semaphores;
+
+	/// Latest selection received from the page selection thread, ordered by priority
+	std::vector<uint32_t> working_set;
+
+	VirtualTextureStats stats;
+
+	/// Page selection thread
+	std::thread selection_thread;
+
+	std::mutex selection_mutex;
+
+	std::condition_variable selection_condition;
+
+	std::vector<VirtualTextureRequest> pending_requests;
+
+	bool has_pending_requests{false};
+
+	std::vector<uint32_t> selected_pages;
+
+	bool has_selected_pages{false};
+
+	bool stop_selection{false};
+
+	void create_image();
+
+	void bind_mip_tail();
+
+	void upload_mip_tail();
+
+	void selection_worker();
+
+	VkSparseImageMemoryBind get_page_bind(uint32_t page_index) const;
+
+	/**
+	 * @brief Assigns a memory slot to a page, allocating memory or evicting a page if required
+	 * @param binds Receives the unbind of an evicted page
+	 * @return The slot index, or -1 if the budget is exhausted by pages still in use
+	 */
+	int64_t acquire_slot(uint32_t page_index, std::vector<VkSparseImageMemoryBind> &binds);
+
+	/**
+	 * @brief Copies the texels of a page into the mapped staging ring
+	 * @return The number of bytes written
+	 */
+	VkDeviceSize stage_page(const VkSparseImageMemoryBind &bind, uint8_t *destination) const;
+};
+}        // namespace vkb
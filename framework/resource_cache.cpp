@@ -20,6 +20,8 @@
 #include "common/resource_caching.h"
 #include "core/device.h"
 
+#include <core/util/startup_profiler.hpp>
+
 namespace vkb
 {
 namespace
@@ -42,6 +44,8 @@ ResourceCache::ResourceCache(Device &device) :
 
 void ResourceCache::warmup(const std::vector<uint8_t> &data)
 {
+	PROFILE_STARTUP_SCOPE("Warm up resource cache");
+
 	recorder.set_data(data);
 
 	replayer.play(*this, recorder);
@@ -70,9 +74,10 @@ PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderM
 
 DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const uint32_t                     set_index,
                                                                   const std::vector<ShaderModule *> &shader_modules,
-                                                                  const std::vector<ShaderResource> &set_resources)
+                                                                  const std::vector<ShaderResource> &set_resources,
+                                                                  VkDescriptorSetLayoutCreateFlags   create_flags)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources, create_flags);
 }
 
 GraphicsPipeline &ResourceCache::request_graphics_pipeline(PipelineState &pipeline_state)
@@ -101,7 +101,8 @@ class ResourceCache
 
 	DescriptorSetLayout &request_descriptor_set_layout(const uint32_t                     set_index,
 	                                                   const std::vector<ShaderModule *> &shader_modules,
-	                                                   const std::vector<ShaderResource> &set_resources);
+	                                                   const std::vector<ShaderResource> &set_resources,
+	                                                   VkDescriptorSetLayoutCreateFlags   create_flags = 0);
 
 	GraphicsPipeline &request_graphics_pipeline(PipelineState &pipeline_state);
 
@@ -18,11 +18,12 @@
 #include "hpp_image.h"
 
 #include "common/hpp_utils.h"
+#include "filesystem/filesystem.hpp"
 #include "filesystem/legacy.h"
 #include "scene_graph/components/image/astc.h"
 #include "scene_graph/components/image/ktx.h"
 #include "scene_graph/components/image/stb.h"
-#include <stb_image_resize.h>
+#include <core/util/mip_chain.hpp>
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_format_traits.hpp>
 
@@ -49,7 +50,7 @@ std::unique_ptr<vkb::scene_graph::components::HPPImage> HPPImage::load(const std
 {
 	std::unique_ptr<vkb::scene_graph::components::HPPImage> image{nullptr};
 
-	auto data = fs::read_asset(uri);
+	auto data = vkb::filesystem::get()->map_file(fs::path::get(fs::path::Type::Assets) + uri);
 
 	// Get extension
 	auto extension = get_extension(uri);
@@ -58,17 +59,17 @@ std::unique_ptr<vkb::scene_graph::components::HPPImage> HPPImage::load(const std
 	if (extension == "png" || extension == "jpg")
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(reinterpret_cast<vkb::scene_graph::components::HPPImage *>(
-		    std::make_unique<vkb::sg::Stb>(name, data, static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
+		    std::make_unique<vkb::sg::Stb>(name, data.data(), data.size(), static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
 	}
 	else if (extension == "astc")
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(
-		    reinterpret_cast<vkb::scene_graph::components::HPPImage *>(std::make_unique<vkb::sg::Astc>(name, data).release()));
+		    reinterpret_cast<vkb::scene_graph::components::HPPImage *>(std::make_unique<vkb::sg::Astc>(name, data.data(), data.size()).release()));
 	}
 	else if ((extension == "ktx") || (extension == "ktx2"))
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(reinterpret_cast<vkb::scene_graph::components::HPPImage *>(
-		    std::make_unique<vkb::sg::Ktx>(name, data, static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
+		    std::make_unique<vkb::sg::Ktx>(name, data.data(), data.size(), static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
 	}
 
 	return image;
@@ -218,7 +219,7 @@ void HPPImage::create_vk_image(vkb::core::HPPDevice &device, vk::ImageViewType i
 	vk_image_view->set_debug_name("View on " + get_name());
 }
 
-void HPPImage::generate_mipmaps()
+void HPPImage::generate_mipmaps(uint32_t thread_count)
 {
 	assert(mipmaps.size() == 1 && "Mipmaps already generated");
 
@@ -227,40 +228,24 @@ void HPPImage::generate_mipmaps()
 		return;        // Do not generate again
 	}
 
-	auto extent      = get_extent();
-	auto next_width  = std::max<uint32_t>(1u, extent.width / 2);
-	auto next_height = std::max<uint32_t>(1u, extent.height / 2);
-	auto channels    = 4;
-	auto next_size   = next_width * next_height * channels;
+	auto extent = get_extent();
 
-	while (true)
-	{
-		// Make space for next mipmap
-		auto old_size = to_u32(data.size());
-		data.resize(old_size + next_size);
+	// Allocate for all the mips at once, the base level keeps its place at the start of the data
+	size_t total_size = 0;
+	auto   levels     = vkb::get_mip_chain_layout(extent.width, extent.height, total_size);
+	data.resize(total_size);
 
-		auto &prev_mipmap = mipmaps.back();
-		// Update mipmaps
-		vkb::scene_graph::components::HPPMipmap next_mipmap{};
-		next_mipmap.level  = prev_mipmap.level + 1;
-		next_mipmap.offset = old_size;
-		next_mipmap.extent = vk::Extent3D(next_width, next_height, 1u);
+	bool srgb = format == vk::Format::eR8G8B8A8Srgb || format == vk::Format::eB8G8R8A8Srgb;
+	vkb::build_mip_chain(data.data(), levels, srgb, vkb::MipFilter::Box, thread_count);
 
-		// Fill next mipmap memory
-		stbir_resize_uint8(data.data() + prev_mipmap.offset, prev_mipmap.extent.width, prev_mipmap.extent.height, 0,
-		                   data.data() + next_mipmap.offset, next_mipmap.extent.width, next_mipmap.extent.height, 0, channels);
+	for (uint32_t level = 1; level < to_u32(levels.size()); ++level)
+	{
+		vkb::scene_graph::components::HPPMipmap next_mipmap{};
+		next_mipmap.level  = level;
+		next_mipmap.offset = to_u32(levels[level].offset);
+		next_mipmap.extent = vk::Extent3D(levels[level].width, levels[level].height, 1u);
 
 		mipmaps.emplace_back(std::move(next_mipmap));
-
-		// Next mipmap values
-		next_width  = std::max<uint32_t>(1u, next_width / 2);
-		next_height = std::max<uint32_t>(1u, next_height / 2);
-		next_size   = next_width * next_height * channels;
-
-		if (next_width == 1 && next_height == 1)
-		{
-			break;
-		}
 	}
 }
 
@@ -68,7 +68,7 @@ class HPPImage : public vkb::sg::Component
 	void                                                        clear_data();
 	void                                                        coerce_format_to_srgb();
 	void                                                        create_vk_image(vkb::core::HPPDevice &device, vk::ImageViewType image_view_type = vk::ImageViewType::e2D, vk::ImageCreateFlags flags = {});
-	void                                                        generate_mipmaps();
+	void                                                        generate_mipmaps(uint32_t thread_count = 0);
 	const std::vector<uint8_t>                                 &get_data() const;
 	const vk::Extent3D                                         &get_extent() const;
 	vk::Format                                                  get_format() const;
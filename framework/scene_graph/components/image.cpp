@@ -21,10 +21,10 @@
 
 #include "common/error.h"
 
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
-#include <stb_image_resize.h>
+#include <core/util/mip_chain.hpp>
 
 #include "common/utils.h"
+#include "filesystem/filesystem.hpp"
 #include "filesystem/legacy.h"
 #include "scene_graph/components/image/astc.h"
 #include "scene_graph/components/image/ktx.h"
@@ -196,17 +196,19 @@ const std::vector<std::vector<VkDeviceSize>> &Image::get_offsets() const
 	return offsets;
 }
 
-void Image::create_vk_image(Device &device, VkImageViewType image_view_type, VkImageCreateFlags flags)
+void Image::create_vk_image(Device &device, VkImageViewType image_view_type, VkImageCreateFlags flags,
+                            VkImageUsageFlags additional_usage, uint32_t mip_levels)
 {
 	assert(!vk_image && !vk_image_view && "Vulkan image already constructed");
+	assert((mip_levels == 0 || mip_levels >= mipmaps.size()) && "The Vulkan image must hold all the levels of the data");
 
 	vk_image = std::make_unique<core::Image>(device,
 	                                         get_extent(),
 	                                         format,
-	                                         VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	                                         VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | additional_usage,
 	                                         VMA_MEMORY_USAGE_GPU_ONLY,
 	                                         VK_SAMPLE_COUNT_1_BIT,
-	                                         to_u32(mipmaps.size()),
+	                                         mip_levels == 0 ? to_u32(mipmaps.size()) : mip_levels,
 	                                         layers,
 	                                         VK_IMAGE_TILING_OPTIMAL,
 	                                         flags);
@@ -234,25 +236,12 @@ Mipmap &Image::get_mipmap(const size_t index)
 	return mipmaps[index];
 }
 
-// Note that this function returns the required size for ALL mip levels, *including* the base level.
-uint32_t get_required_mipmaps_size(const VkExtent3D &extent)
+void Image::generate_mipmaps(uint32_t thread_count)
 {
-	constexpr uint32_t channels = 4;
-	auto               width    = std::max<uint32_t>(1, extent.width);
-	auto               height   = std::max<uint32_t>(1, extent.height);
-	auto               size     = width * height * channels;
-	auto               result   = size;
-	while (size != channels)
-	{
-		width  = std::max<uint32_t>(1u, width >> 1);
-		height = std::max<uint32_t>(1u, height >> 1);
-		size   = width * height * channels;
-		result += size;
-	}
-	return result;
+	generate_mipmaps_srgb(format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB, thread_count);
 }
 
-void Image::generate_mipmaps()
+void Image::generate_mipmaps_srgb(bool srgb, uint32_t thread_count)
 {
 	assert(mipmaps.size() == 1 && "Mipmaps already generated");
 
@@ -261,44 +250,23 @@ void Image::generate_mipmaps()
 		return;        // Do not generate again
 	}
 
-	auto extent      = get_extent();
-	auto next_width  = std::max<uint32_t>(1u, extent.width / 2);
-	auto next_height = std::max<uint32_t>(1u, extent.height / 2);
-	auto channels    = 4;
-	auto next_size   = next_width * next_height * channels;
+	auto extent = get_extent();
 
-	// Allocate for all the mips at once.  The function returns the total size needed for the
-	// existing base mip as well as all the mips that will be generated.
-	data.reserve(get_required_mipmaps_size(extent));
+	// Allocate for all the mips at once, the base level keeps its place at the start of the data
+	size_t total_size = 0;
+	auto   levels     = get_mip_chain_layout(extent.width, extent.height, total_size);
+	data.resize(total_size);
 
-	while (true)
-	{
-		// Make space for next mipmap
-		auto old_size = to_u32(data.size());
-		data.resize(old_size + next_size);
+	build_mip_chain(data.data(), levels, srgb, MipFilter::Box, thread_count);
 
-		auto &prev_mipmap = mipmaps.back();
-		// Update mipmaps
+	for (uint32_t level = 1; level < to_u32(levels.size()); ++level)
+	{
 		Mipmap next_mipmap{};
-		next_mipmap.level  = prev_mipmap.level + 1;
-		next_mipmap.offset = old_size;
-		next_mipmap.extent = {next_width, next_height, 1u};
-
-		// Fill next mipmap memory
-		stbir_resize_uint8(data.data() + prev_mipmap.offset, prev_mipmap.extent.width, prev_mipmap.extent.height, 0,
-		                   data.data() + next_mipmap.offset, next_mipmap.extent.width, next_mipmap.extent.height, 0, channels);
+		next_mipmap.level  = level;
+		next_mipmap.offset = to_u32(levels[level].offset);
+		next_mipmap.extent = {levels[level].width, levels[level].height, 1u};
 
 		mipmaps.emplace_back(std::move(next_mipmap));
-
-		// Next mipmap values
-		next_width  = std::max<uint32_t>(1u, next_width / 2);
-		next_height = std::max<uint32_t>(1u, next_height / 2);
-		next_size   = next_width * next_height * channels;
-
-		if (next_width == 1 && next_height == 1)
-		{
-			break;
-		}
 	}
 }
 
@@ -361,26 +329,27 @@ std::unique_ptr<Image> Image::load(const std::string &name, const std::string &u
 {
 	std::unique_ptr<Image> image{nullptr};
 
-	auto data = fs::read_asset(uri);
+	// Decoded straight from the file mapping, which is released once the image is decoded
+	auto data = filesystem::get()->map_file(fs::path::get(fs::path::Type::Assets) + uri);
 
 	// Get extension
 	auto extension = get_extension(uri);
 
 	if (extension == "png" || extension == "jpg")
 	{
-		image = std::make_unique<Stb>(name, data, content_type);
+		image = std::make_unique<Stb>(name, data.data(), data.size(), content_type);
 	}
 	else if (extension == "astc")
 	{
-		image = std::make_unique<Astc>(name, data);
+		image = std::make_unique<Astc>(name, data.data(), data.size());
 	}
 	else if (extension == "ktx")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = std::make_unique<Ktx>(name, data.data(), data.size(), content_type);
 	}
 	else if (extension == "ktx2")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = std::make_unique<Ktx>(name, data.data(), data.size(), content_type);
 	}
 
 	return image;
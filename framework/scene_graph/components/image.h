@@ -92,9 +92,32 @@ class Image : public Component
 
 	const std::vector<std::vector<VkDeviceSize>> &get_offsets() const;
 
-	void generate_mipmaps();
+	/**
+	 * @brief Generates the full mip chain of a single level, four byte per texel image
+	 *        Color channels are filtered in linear space if the format is sRGB
+	 * @param thread_count Number of threads each level is split across, 0 uses all hardware threads
+	 */
+	void generate_mipmaps(uint32_t thread_count = 0);
 
-	void create_vk_image(Device &device, VkImageViewType image_view_type = VK_IMAGE_VIEW_TYPE_2D, VkImageCreateFlags flags = 0);
+	/**
+	 * @brief Generates the full mip chain of a single level, four byte per texel image
+	 *        Named apart from generate_mipmaps, as a bool would silently convert to its thread count
+	 * @param srgb Whether to filter the color channels in linear space, regardless of the format
+	 * @param thread_count Number of threads each level is split across, 0 uses all hardware threads
+	 */
+	void generate_mipmaps_srgb(bool srgb, uint32_t thread_count = 0);
+
+	/**
+	 * @brief Creates the Vulkan image and its view
+	 * @param device A valid Vulkan device
+	 * @param image_view_type Type of the image view
+	 * @param flags Image creation flags
+	 * @param additional_usage Usage in addition to VK_IMAGE_USAGE_SAMPLED_BIT and VK_IMAGE_USAGE_TRANSFER_DST_BIT
+	 * @param mip_levels Number of levels of the Vulkan image, 0 to use the levels of the image data;
+	 *                   levels missing from the data have to be generated on the GPU, see vkb::MipmapGenerator
+	 */
+	void create_vk_image(Device &device, VkImageViewType image_view_type = VK_IMAGE_VIEW_TYPE_2D, VkImageCreateFlags flags = 0,
+	                     VkImageUsageFlags additional_usage = 0, uint32_t mip_levels = 0);
 
 	const core::Image &get_vk_image() const;
 
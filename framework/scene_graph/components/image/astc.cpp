@@ -18,9 +18,13 @@
 #include "scene_graph/components/image/astc.h"
 
 #include <mutex>
+#include <unordered_map>
 
 #include "common/error.h"
+#include "core/util/hash.hpp"
+#include "core/util/job_system.hpp"
 #include "core/util/profiling.hpp"
+#include "filesystem/legacy.h"
 
 #include "common/glm_common.h"
 #if defined(_WIN32) || defined(_WIN64)
@@ -30,6 +34,8 @@
 #include <astcenc.h>
 
 #define MAGIC_FILE_CONSTANT 0x5CA1AB13
+#define CACHE_MAGIC_CONSTANT 0x43545341        // "ASTC"
+#define CACHE_VERSION 1
 
 namespace vkb
 {
@@ -97,19 +103,56 @@ struct AstcHeader
 	uint8_t zsize[3];        // block count is inferred
 };
 
-void Astc::init()
+namespace
+{
+struct AstcContextDeleter
 {
+	void operator()(astcenc_context *context) const
+	{
+		astcenc_context_free(context);
+	}
+};
+
+using AstcContextPtr = std::unique_ptr<astcenc_context, AstcContextDeleter>;
+
+// Levels with fewer blocks than this are decoded by the calling thread only
+constexpr uint32_t MIN_BLOCKS_PER_THREAD = 256;
+
+/**
+ * @brief Decodes run on the job system, the thread requesting a decode takes part in it as well
+ */
+uint32_t get_decode_thread_count()
+{
+	return JobSystem::get().get_worker_count() + 1;
 }
 
-void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compressed_data, uint32_t compressed_size)
+std::mutex context_mutex;
+
+// Decode contexts which are not in use, keyed by block dimensions. Allocating a context is expensive, so they are
+// kept for all images with the same block size. Several of them may exist if images are decoded concurrently.
+std::unordered_map<uint32_t, std::vector<AstcContextPtr>> free_contexts;
+
+uint32_t to_key(BlockDim blockdim)
 {
-	PROFILE_SCOPE("Decode ASTC Image");
+	return (blockdim.x << 16) | (blockdim.y << 8) | blockdim.z;
+}
+
+AstcContextPtr acquire_context(BlockDim blockdim)
+{
+	{
+		std::lock_guard<std::mutex> lock{context_mutex};
+
+		auto &contexts = free_contexts[to_key(blockdim)];
+		if (!contexts.empty())
+		{
+			auto context = std::move(contexts.back());
+			contexts.pop_back();
+			return context;
+		}
+	}
 
-	// Actual decoding
-	astcenc_swizzle swizzle = {ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A};
-	// Configure the compressor run
 	astcenc_config astc_config;
-	auto           atscresult = astcenc_config_init(
+	auto           result = astcenc_config_init(
         ASTCENC_PRF_LDR_SRGB,
         blockdim.x,
         blockdim.y,
@@ -118,45 +161,227 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compresse
         ASTCENC_FLG_DECOMPRESS_ONLY,
         &astc_config);
 
-	if (atscresult != ASTCENC_SUCCESS)
+	if (result != ASTCENC_SUCCESS)
 	{
 		throw std::runtime_error{"Error initializing astc"};
 	}
 
-	if (extent.width == 0 || extent.height == 0 || extent.depth == 0)
+	astcenc_context *context;
+	if (astcenc_context_alloc(&astc_config, get_decode_thread_count(), &context) != ASTCENC_SUCCESS)
 	{
-		throw std::runtime_error{"Error reading astc: invalid size"};
+		throw std::runtime_error{"Error allocating astc context"};
 	}
 
-	// Allocate working state given config and thread_count
-	astcenc_context *astc_context;
-	astcenc_context_alloc(&astc_config, 1, &astc_context);
+	return AstcContextPtr{context};
+}
 
-	astcenc_image decoded{};
-	decoded.dim_x     = extent.width;
-	decoded.dim_y     = extent.height;
-	decoded.dim_z     = extent.depth;
-	decoded.data_type = ASTCENC_TYPE_U8;
+void release_context(BlockDim blockdim, AstcContextPtr &&context)
+{
+	std::lock_guard<std::mutex> lock{context_mutex};
+	free_contexts[to_key(blockdim)].push_back(std::move(context));
+}
 
-	// allocate storage for the decoded image
-	// The astcenc_decompress_image function will write directly to the image data vector
-	auto  uncompressed_size = decoded.dim_x * decoded.dim_y * decoded.dim_z * 4;
-	auto &decoded_data      = get_mut_data();
+std::string get_cache_filename(uint64_t hash)
+{
+	return fmt::format("astc_{:016x}.cache", hash);
+}
+
+struct CacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t mip_count;
+};
+}        // namespace
+
+void Astc::init()
+{
+}
+
+void Astc::decode(BlockDim blockdim, const std::vector<Mipmap> &mipmaps, const uint8_t *compressed_data, size_t compressed_size)
+{
+	PROFILE_SCOPE("Decode ASTC Image");
+
+	// Decoded levels are stored tightly packed in level order
+	std::vector<Mipmap> decoded_mipmaps;
+	uint32_t            uncompressed_size = 0;
+	for (const auto &mipmap : mipmaps)
+	{
+		const auto &extent = mipmap.extent;
+		if (extent.width == 0 || extent.height == 0 || extent.depth == 0)
+		{
+			throw std::runtime_error{"Error reading astc: invalid size"};
+		}
+
+		Mipmap decoded_mipmap{};
+		decoded_mipmap.level  = mipmap.level;
+		decoded_mipmap.offset = uncompressed_size;
+		decoded_mipmap.extent = extent;
+		decoded_mipmaps.push_back(decoded_mipmap);
+
+		uncompressed_size += extent.width * extent.height * extent.depth * 4;
+	}
+
+	auto &decoded_data = get_mut_data();
 	decoded_data.resize(uncompressed_size);
-	void *data_ptr = static_cast<void *>(decoded_data.data());
-	decoded.data   = &data_ptr;
 
-	atscresult = astcenc_decompress_image(astc_context, compressed_data, compressed_size, &decoded, &swizzle, 0);
-	if (atscresult != ASTCENC_SUCCESS)
+	astcenc_swizzle swizzle = {ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A};
+
+	auto context = acquire_context(blockdim);
+
+	for (size_t i = 0; i < mipmaps.size(); ++i)
 	{
-		throw std::runtime_error("Error decoding astc");
+		const auto &extent = mipmaps[i].extent;
+
+		uint32_t block_count = ((extent.width + blockdim.x - 1) / blockdim.x) *
+		                       ((extent.height + blockdim.y - 1) / blockdim.y) *
+		                       ((extent.depth + blockdim.z - 1) / blockdim.z);
+
+		// Every ASTC block is 16 bytes, regardless of its dimensions
+		size_t level_size = block_count * 16;
+		if (mipmaps[i].offset + level_size > compressed_size)
+		{
+			throw std::runtime_error{"Error reading astc: invalid memory"};
+		}
+		const uint8_t *level_data = compressed_data + mipmaps[i].offset;
+
+		astcenc_image decoded{};
+		decoded.dim_x     = extent.width;
+		decoded.dim_y     = extent.height;
+		decoded.dim_z     = extent.depth;
+		decoded.data_type = ASTCENC_TYPE_U8;
+
+		// The astcenc_decompress_image function will write directly to the image data vector
+		void *data_ptr = static_cast<void *>(decoded_data.data() + decoded_mipmaps[i].offset);
+		decoded.data   = &data_ptr;
+
+		auto worker_count = std::min(get_decode_thread_count(), std::max(1u, block_count / MIN_BLOCKS_PER_THREAD));
+
+		std::vector<astcenc_error> thread_results(worker_count, ASTCENC_SUCCESS);
+		JobCounter                 decode_counter;
+		for (uint32_t thread_index = 1; thread_index < worker_count; ++thread_index)
+		{
+			JobSystem::get().submit([&, thread_index]() {
+				thread_results[thread_index] = astcenc_decompress_image(context.get(), level_data, level_size, &decoded, &swizzle, thread_index);
+			},
+			                        &decode_counter);
+		}
+
+		thread_results[0] = astcenc_decompress_image(context.get(), level_data, level_size, &decoded, &swizzle, 0);
+		JobSystem::get().wait(decode_counter);
+
+		auto result = ASTCENC_SUCCESS;
+		for (auto thread_result : thread_results)
+		{
+			if (thread_result != ASTCENC_SUCCESS)
+			{
+				result = thread_result;
+			}
+		}
+
+		// The context has to be reset before it can decode another image
+		astcenc_decompress_reset(context.get());
+
+		if (result != ASTCENC_SUCCESS)
+		{
+			release_context(blockdim, std::move(context));
+			throw std::runtime_error("Error decoding astc");
+		}
 	}
-	astcenc_context_free(astc_context);
+
+	release_context(blockdim, std::move(context));
+
+	get_mut_mipmaps() = std::move(decoded_mipmaps);
 
 	set_format(VK_FORMAT_R8G8B8A8_SRGB);
-	set_width(decoded.dim_x);
-	set_height(decoded.dim_y);
-	set_depth(decoded.dim_z);
+	set_width(mipmaps[0].extent.width);
+	set_height(mipmaps[0].extent.height);
+	set_depth(mipmaps[0].extent.depth);
+}
+
+bool Astc::load_from_cache(uint64_t hash)
+{
+	PROFILE_SCOPE("Load ASTC decode cache");
+
+	auto filename = get_cache_filename(hash);
+	if (!fs::is_file(fs::path::get(fs::path::Type::Temp) + filename))
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> cache_data;
+	try
+	{
+		cache_data = fs::read_temp(filename);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read astc decode cache {}: {}", filename, e.what());
+		return false;
+	}
+
+	CacheHeader header{};
+	if (cache_data.size() < sizeof(CacheHeader))
+	{
+		return false;
+	}
+	std::memcpy(&header, cache_data.data(), sizeof(CacheHeader));
+	if (header.magic != CACHE_MAGIC_CONSTANT || header.version != CACHE_VERSION || header.mip_count == 0)
+	{
+		return false;
+	}
+
+	size_t data_offset = sizeof(CacheHeader) + header.mip_count * sizeof(Mipmap);
+	if (cache_data.size() < data_offset)
+	{
+		return false;
+	}
+
+	std::vector<Mipmap> mipmaps(header.mip_count);
+	std::memcpy(mipmaps.data(), cache_data.data() + sizeof(CacheHeader), header.mip_count * sizeof(Mipmap));
+
+	const auto &last_mipmap = mipmaps.back();
+	if (cache_data.size() != data_offset + last_mipmap.offset + last_mipmap.extent.width * last_mipmap.extent.height * last_mipmap.extent.depth * 4)
+	{
+		LOGW("Ignoring truncated astc decode cache {}", filename);
+		return false;
+	}
+
+	set_data(cache_data.data() + data_offset, cache_data.size() - data_offset);
+	set_format(static_cast<VkFormat>(header.format));
+	set_width(mipmaps[0].extent.width);
+	set_height(mipmaps[0].extent.height);
+	set_depth(mipmaps[0].extent.depth);
+	get_mut_mipmaps() = std::move(mipmaps);
+
+	return true;
+}
+
+void Astc::store_in_cache(uint64_t hash) const
+{
+	const auto &mipmaps = get_mipmaps();
+	const auto &data    = get_data();
+
+	CacheHeader header{};
+	header.magic     = CACHE_MAGIC_CONSTANT;
+	header.version   = CACHE_VERSION;
+	header.format    = static_cast<uint32_t>(get_format());
+	header.mip_count = to_u32(mipmaps.size());
+
+	std::vector<uint8_t> cache_data(sizeof(CacheHeader) + mipmaps.size() * sizeof(Mipmap) + data.size());
+	std::memcpy(cache_data.data(), &header, sizeof(CacheHeader));
+	std::memcpy(cache_data.data() + sizeof(CacheHeader), mipmaps.data(), mipmaps.size() * sizeof(Mipmap));
+	std::memcpy(cache_data.data() + sizeof(CacheHeader) + mipmaps.size() * sizeof(Mipmap), data.data(), data.size());
+
+	try
+	{
+		fs::write_temp(cache_data, get_cache_filename(hash));
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write astc decode cache: {}", e.what());
+	}
 }
 
 Astc::Astc(const Image &image) :
@@ -164,49 +389,59 @@ Astc::Astc(const Image &image) :
 {
 	init();
 
-	// Locate mip #0 in the KTX. This is the first one in the data array for KTX1s, but the last one in KTX2s!
-	auto mip_it = std::find_if(image.get_mipmaps().begin(), image.get_mipmaps().end(),
-	                           [](auto &mip) { return mip.level == 0; });
-	assert(mip_it != image.get_mipmaps().end() && "Mip #0 not found");
-
-	// When decoding ASTC on CPU (as it is the case in here), we don't decode all mips in the mip chain.
-	// Instead, we just decode mip #0 and re-generate the other LODs later (via image->generate_mipmaps()).
-	const auto     blockdim = to_blockdim(image.get_format());
-	const auto    &extent   = mip_it->extent;
-	auto           size     = extent.width * extent.height * extent.depth * 4;
-	const uint8_t *data_ptr = image.get_data().data() + mip_it->offset;
-	decode(blockdim, mip_it->extent, data_ptr, size);
+	const auto &data = image.get_data();
+	auto        hash = hash_fnv1a(data.data(), data.size(), static_cast<uint64_t>(image.get_format()));
+	if (load_from_cache(hash))
+	{
+		return;
+	}
+
+	// Decode the levels in order, KTX1 stores mip #0 first but KTX2 stores it last
+	auto mipmaps = image.get_mipmaps();
+	std::sort(mipmaps.begin(), mipmaps.end(), [](const Mipmap &left, const Mipmap &right) { return left.level < right.level; });
+	assert(!mipmaps.empty() && mipmaps[0].level == 0 && "Mip #0 not found");
+
+	decode(to_blockdim(image.get_format()), mipmaps, data.data(), data.size());
+	store_in_cache(hash);
 }
 
-Astc::Astc(const std::string &name, const std::vector<uint8_t> &data) :
+Astc::Astc(const std::string &name, const uint8_t *data, size_t size) :
     Image{name}
 {
 	init();
 
 	// Read header
-	if (data.size() < sizeof(AstcHeader))
+	if (size < sizeof(AstcHeader))
 	{
 		throw std::runtime_error{"Error reading astc: invalid memory"};
 	}
 	AstcHeader header{};
-	std::memcpy(&header, data.data(), sizeof(AstcHeader));
+	std::memcpy(&header, data, sizeof(AstcHeader));
 	uint32_t magicval = header.magic[0] + 256 * static_cast<uint32_t>(header.magic[1]) + 65536 * static_cast<uint32_t>(header.magic[2]) + 16777216 * static_cast<uint32_t>(header.magic[3]);
 	if (magicval != MAGIC_FILE_CONSTANT)
 	{
 		throw std::runtime_error{"Error reading astc: invalid magic"};
 	}
 
+	auto hash = hash_fnv1a(data, size, static_cast<uint64_t>(VK_FORMAT_UNDEFINED));
+	if (load_from_cache(hash))
+	{
+		return;
+	}
+
 	BlockDim blockdim = {
 	    /* xdim = */ header.blockdim_x,
 	    /* ydim = */ header.blockdim_y,
 	    /* zdim = */ header.blockdim_z};
 
-	VkExtent3D extent = {
+	Mipmap mipmap{};
+	mipmap.extent = {
 	    /* width  = */ static_cast<uint32_t>(header.xsize[0] + 256 * header.xsize[1] + 65536 * header.xsize[2]),
 	    /* height = */ static_cast<uint32_t>(header.ysize[0] + 256 * header.ysize[1] + 65536 * header.ysize[2]),
 	    /* depth  = */ static_cast<uint32_t>(header.zsize[0] + 256 * header.zsize[1] + 65536 * header.zsize[2])};
 
-	decode(blockdim, extent, data.data() + sizeof(AstcHeader), to_u32(data.size() - sizeof(AstcHeader)));
+	decode(blockdim, {mipmap}, data + sizeof(AstcHeader), size - sizeof(AstcHeader));
+	store_in_cache(hash);
 }
 
 }        // namespace sg
@@ -35,7 +35,7 @@ class Astc : public Image
 {
   public:
 	/**
-	 * @brief Decodes an ASTC image
+	 * @brief Decodes an ASTC image, including all of its mip levels
 	 * @param image Image to decode
 	 */
 	Astc(const Image &image);
@@ -44,19 +44,35 @@ class Astc : public Image
 	 * @brief Decodes ASTC data with an ASTC header
 	 * @param name Name of the component
 	 * @param data ASTC data with header
+	 * @param size Size of the data in bytes
 	 */
-	Astc(const std::string &name, const std::vector<uint8_t> &data);
+	Astc(const std::string &name, const uint8_t *data, size_t size);
 
 	virtual ~Astc() = default;
 
   private:
 	/**
-	 * @brief Decodes ASTC data
+	 * @brief Decodes ASTC data into an RGBA8 mip chain
+	 *        Each level is decoded by all threads of the decoder thread pool
 	 * @param blockdim Dimensions of the block
-	 * @param extent Extent of the image
+	 * @param mipmaps Levels to decode, with offsets relative to data
 	 * @param data Pointer to ASTC image data
+	 * @param size Size of the ASTC image data in bytes
 	 */
-	void decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data, uint32_t size);
+	void decode(BlockDim blockdim, const std::vector<Mipmap> &mipmaps, const uint8_t *data, size_t size);
+
+	/**
+	 * @brief Loads a previously decoded mip chain from the decode cache
+	 * @param hash Hash of the ASTC data
+	 * @return Whether the image was found in the cache
+	 */
+	bool load_from_cache(uint64_t hash);
+
+	/**
+	 * @brief Stores the decoded mip chain in the decode cache
+	 * @param hash Hash of the ASTC data
+	 */
+	void store_in_cache(uint64_t hash) const;
 
 	/**
 	 * @brief Initializes ASTC library
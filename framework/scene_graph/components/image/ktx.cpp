@@ -19,6 +19,12 @@
 #include "scene_graph/components/image/ktx.h"
 
 #include "common/error.h"
+#include "core/device.h"
+#include "core/util/hash.hpp"
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+#include "filesystem/legacy.h"
+#include "timer.h"
 
 #include <ktx.h>
 #include <ktxvulkan.h>
@@ -27,6 +33,98 @@ namespace vkb
 {
 namespace sg
 {
+namespace
+{
+ktx_transcode_fmt_e get_ktx_transcode_format(Ktx::TranscodeTarget target)
+{
+	switch (target)
+	{
+		case Ktx::TranscodeTarget::Astc4x4:
+			return KTX_TTF_ASTC_4x4_RGBA;
+		case Ktx::TranscodeTarget::Bc7:
+			return KTX_TTF_BC7_RGBA;
+		case Ktx::TranscodeTarget::Etc2:
+			return KTX_TTF_ETC2_RGBA;
+		default:
+			return KTX_TTF_RGBA32;
+	}
+}
+
+std::string get_cache_filename(uint64_t hash)
+{
+	return fmt::format("basisu_{:016x}.ktx2", hash);
+}
+
+/**
+ * @return The transcoded texture cached for the hash, nullptr if there is none
+ */
+ktxTexture *load_from_cache(uint64_t hash)
+{
+	PROFILE_SCOPE("Load Basis Universal transcode cache");
+
+	auto filename = get_cache_filename(hash);
+	if (!fs::is_file(fs::path::get(fs::path::Type::Temp) + filename))
+	{
+		return nullptr;
+	}
+
+	std::vector<uint8_t> cache_data;
+	try
+	{
+		cache_data = fs::read_temp(filename);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read basis universal transcode cache {}: {}", filename, e.what());
+		return nullptr;
+	}
+
+	// Image data is loaded right away, as the cache data does not outlive this function
+	ktxTexture *texture = nullptr;
+	if (ktxTexture_CreateFromMemory(cache_data.data(), cache_data.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) != KTX_SUCCESS)
+	{
+		LOGW("Ignoring invalid basis universal transcode cache {}", filename);
+		return nullptr;
+	}
+
+	if (texture->classId == ktxTexture2_c && ktxTexture2_NeedsTranscoding(reinterpret_cast<ktxTexture2 *>(texture)))
+	{
+		ktxTexture_Destroy(texture);
+		return nullptr;
+	}
+
+	return texture;
+}
+
+void store_in_cache(ktxTexture *texture, uint64_t hash)
+{
+	ktx_uint8_t *bytes = nullptr;
+	ktx_size_t   size  = 0;
+	if (ktxTexture_WriteToMemory(texture, &bytes, &size) != KTX_SUCCESS)
+	{
+		LOGW("Failed to serialize basis universal transcode cache");
+		return;
+	}
+
+	try
+	{
+		fs::write_temp(std::vector<uint8_t>(bytes, bytes + size), get_cache_filename(hash));
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write basis universal transcode cache: {}", e.what());
+	}
+
+	free(bytes);
+}
+
+bool is_format_sampleable(Device &device, VkFormat format)
+{
+	auto properties = device.get_gpu().get_format_properties(format);
+	return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_DST_BIT) && (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+}
+}        // namespace
+
 struct CallbackData final
 {
 	ktxTexture          *texture;
@@ -65,11 +163,31 @@ static ktx_error_code_e KTX_APIENTRY optimal_tiling_callback(int          mip_le
 	return KTX_SUCCESS;
 }
 
-Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type) :
+Ktx::TranscodeTarget Ktx::get_transcode_target(Device &device)
+{
+	// Compressed formats can only be used if their feature was enabled on the device
+	const auto features = device.get_gpu().get_requested_features();
+
+	if (features.textureCompressionASTC_LDR && is_format_sampleable(device, VK_FORMAT_ASTC_4x4_SRGB_BLOCK))
+	{
+		return TranscodeTarget::Astc4x4;
+	}
+	if (features.textureCompressionBC && is_format_sampleable(device, VK_FORMAT_BC7_SRGB_BLOCK))
+	{
+		return TranscodeTarget::Bc7;
+	}
+	if (features.textureCompressionETC2 && is_format_sampleable(device, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK))
+	{
+		return TranscodeTarget::Etc2;
+	}
+	return TranscodeTarget::Rgba8;
+}
+
+Ktx::Ktx(const std::string &name, const uint8_t *data, size_t size, ContentType content_type, TranscodeTarget transcode_target) :
     Image{name}
 {
-	auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data.data());
-	auto data_size   = static_cast<ktx_size_t>(data.size());
+	auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data);
+	auto data_size   = static_cast<ktx_size_t>(size);
 
 	ktxTexture *texture;
 	auto        load_ktx_result = ktxTexture_CreateFromMemory(data_buffer,
@@ -81,6 +199,35 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		throw std::runtime_error{"Error loading KTX texture: " + name};
 	}
 
+	if (texture->classId == ktxTexture2_c && ktxTexture2_NeedsTranscoding(reinterpret_cast<ktxTexture2 *>(texture)))
+	{
+		// The transcode cache key, the same data is cached once per target
+		auto hash = hash_fnv1a(data, size, static_cast<uint64_t>(transcode_target));
+		if (auto cached_texture = load_from_cache(hash))
+		{
+			ktxTexture_Destroy(texture);
+			texture = cached_texture;
+		}
+		else
+		{
+			PROFILE_SCOPE("Transcode Basis Universal texture");
+
+			Timer timer;
+			timer.start();
+
+			auto transcode_result = ktxTexture2_TranscodeBasis(reinterpret_cast<ktxTexture2 *>(texture), get_ktx_transcode_format(transcode_target), 0);
+			if (transcode_result != KTX_SUCCESS)
+			{
+				ktxTexture_Destroy(texture);
+				throw std::runtime_error{"Error transcoding KTX texture: " + name};
+			}
+
+			LOGI("Transcoded {} in {:.2f} ms", name, timer.stop<Timer::Milliseconds>());
+
+			store_in_cache(texture, hash);
+		}
+	}
+
 	if (texture->pData)
 	{
 		// Already loaded
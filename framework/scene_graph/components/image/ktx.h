@@ -21,12 +21,35 @@
 
 namespace vkb
 {
+class Device;
+
 namespace sg
 {
 class Ktx : public Image
 {
   public:
-	Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type);
+	/**
+	 * @brief Native format that Basis Universal supercompressed textures are transcoded to
+	 */
+	enum class TranscodeTarget
+	{
+		Astc4x4,
+		Bc7,
+		Etc2,
+		Rgba8
+	};
+
+	/**
+	 * @return The first target the device can sample from, in the order ASTC 4x4, BC7, ETC2 and RGBA8
+	 */
+	static TranscodeTarget get_transcode_target(Device &device);
+
+	/**
+	 * @brief Loads a KTX or KTX2 texture
+	 *        Basis Universal data is transcoded to the given target. The transcoded texture is cached in the
+	 *        temporary directory, keyed by the file data and the target, so that later loads skip the transcoding.
+	 */
+	Ktx(const std::string &name, const uint8_t *data, size_t size, ContentType content_type, TranscodeTarget transcode_target = TranscodeTarget::Rgba8);
 
 	virtual ~Ktx() = default;
 };
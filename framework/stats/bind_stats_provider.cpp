@@ -0,0 +1,51 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bind_stats_provider.h"
+
+namespace vkb
+{
+BindStatsProvider::BindStatsProvider(std::set<StatIndex> &requested_stats) :
+    last_counts{BindStateCache::get_total_counts()}
+{
+	requested_stats.erase(StatIndex::bind_commands);
+	requested_stats.erase(StatIndex::skipped_bind_commands);
+}
+
+bool BindStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::bind_commands || index == StatIndex::skipped_bind_commands;
+}
+
+StatsProvider::Counters BindStatsProvider::sample(float delta_time)
+{
+	auto counts = BindStateCache::get_total_counts();
+
+	Counters res;
+	res[StatIndex::bind_commands].result         = static_cast<double>(counts.recorded - last_counts.recorded);
+	res[StatIndex::skipped_bind_commands].result = static_cast<double>(counts.skipped - last_counts.skipped);
+
+	last_counts = counts;
+
+	return res;
+}
+
+StatsProvider::Counters BindStatsProvider::continuous_sample(float delta_time)
+{
+	return sample(delta_time);
+}
+}        // namespace vkb
@@ -0,0 +1,94 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_profiler_stats_provider.h"
+
+#include "rendering/gpu_profiler.h"
+
+namespace vkb
+{
+namespace
+{
+bool get_pass_slot(StatIndex index, size_t &slot)
+{
+	slot = static_cast<size_t>(index) - static_cast<size_t>(StatIndex::gpu_pass_time_0);
+	return index >= StatIndex::gpu_pass_time_0 && slot < GpuProfilerStatsProvider::PASS_SLOT_COUNT;
+}
+}        // namespace
+
+GpuProfilerStatsProvider::GpuProfilerStatsProvider(std::set<StatIndex> &requested_stats, const std::vector<std::string> &pass_names) :
+    pass_names{pass_names}
+{
+	for (auto it = requested_stats.begin(); it != requested_stats.end();)
+	{
+		it = is_available(*it) ? requested_stats.erase(it) : std::next(it);
+	}
+
+	for (size_t slot = 0; slot < PASS_SLOT_COUNT; ++slot)
+	{
+		pass_graph_data[slot] = default_graph_data(static_cast<StatIndex>(static_cast<size_t>(StatIndex::gpu_pass_time_0) + slot));
+		if (slot < pass_names.size())
+		{
+			pass_graph_data[slot].name = "GPU " + pass_names[slot];
+		}
+	}
+}
+
+bool GpuProfilerStatsProvider::is_available(StatIndex index) const
+{
+	size_t slot;
+	return index == StatIndex::gpu_pass_time || get_pass_slot(index, slot);
+}
+
+const StatGraphData &GpuProfilerStatsProvider::get_graph_data(StatIndex index) const
+{
+	size_t slot;
+	return get_pass_slot(index, slot) ? pass_graph_data[slot] : StatsProvider::get_graph_data(index);
+}
+
+StatsProvider::Counters GpuProfilerStatsProvider::sample(float delta_time)
+{
+	// The passes of a frame are read back a few frames after they were recorded
+	auto last_frame = GpuProfiler::get().get_last_frame();
+
+	Counters res;
+	res[StatIndex::gpu_pass_time].result = GpuProfiler::get().get_last_frame_time();
+
+	// A pass recorded several times in a frame reports the sum of its times
+	for (size_t slot = 0; slot < PASS_SLOT_COUNT; ++slot)
+	{
+		double time_ms = 0.0;
+		if (slot < pass_names.size())
+		{
+			for (auto &pass : last_frame)
+			{
+				if (pass.name == pass_names[slot])
+				{
+					time_ms += pass.time_ms;
+				}
+			}
+		}
+		res[static_cast<StatIndex>(static_cast<size_t>(StatIndex::gpu_pass_time_0) + slot)].result = time_ms * 1e-3;
+	}
+	return res;
+}
+
+StatsProvider::Counters GpuProfilerStatsProvider::continuous_sample(float delta_time)
+{
+	return sample(delta_time);
+}
+}        // namespace vkb
@@ -0,0 +1,77 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+/**
+ * @brief Reports the GPU time of the passes timed with ScopedGpuZone, as read back by GpuProfiler
+ *
+ * StatIndex::gpu_pass_time is the time of the outermost passes of a frame. StatIndex::gpu_pass_time_0 to
+ * StatIndex::gpu_pass_time_7 are the times of the passes named with Stats::request_gpu_pass_times, and their graphs
+ * are named after them.
+ */
+class GpuProfilerStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a GpuProfilerStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 * @param pass_names Names of the passes reported by StatIndex::gpu_pass_time_0 and the following stats
+	 */
+	GpuProfilerStatsProvider(std::set<StatIndex> &requested_stats, const std::vector<std::string> &pass_names);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve graphing data for the given enabled stat, named after its pass
+	 * @param index The stat index
+	 */
+	const StatGraphData &get_graph_data(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+	/**
+	 * @brief Retrieve a new sample set from continuous sampling
+	 * @param delta_time Time since last sample
+	 */
+	Counters continuous_sample(float delta_time) override;
+
+	static constexpr size_t PASS_SLOT_COUNT = 8;
+
+  private:
+	std::vector<std::string> pass_names;
+
+	std::array<StatGraphData, PASS_SLOT_COUNT> pass_graph_data;
+};
+}        // namespace vkb
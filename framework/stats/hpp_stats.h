@@ -37,6 +37,7 @@ class HPPStats : private vkb::Stats
 	using vkb::Stats::get_graph_data;
 	using vkb::Stats::get_requested_stats;
 	using vkb::Stats::is_available;
+	using vkb::Stats::request_gpu_pass_times;
 	using vkb::Stats::request_stats;
 	using vkb::Stats::resize;
 	using vkb::Stats::update;
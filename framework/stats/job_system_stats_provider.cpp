@@ -0,0 +1,68 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "job_system_stats_provider.h"
+
+#include <algorithm>
+
+#include <core/util/job_system.hpp>
+
+namespace vkb
+{
+JobSystemStatsProvider::JobSystemStatsProvider(std::set<StatIndex> &requested_stats) :
+    last_busy_times{JobSystem::get().get_worker_busy_times()}
+{
+	requested_stats.erase(StatIndex::job_utilization);
+	requested_stats.erase(StatIndex::job_max_worker_utilization);
+}
+
+bool JobSystemStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::job_utilization || index == StatIndex::job_max_worker_utilization;
+}
+
+StatsProvider::Counters JobSystemStatsProvider::sample(float delta_time)
+{
+	auto busy_times = JobSystem::get().get_worker_busy_times();
+
+	Counters res;
+	if (delta_time > 0.0f && !busy_times.empty())
+	{
+		// Share of the time since the last sample each worker spent running jobs
+		double total_utilization = 0.0;
+		double max_utilization   = 0.0;
+		for (size_t i = 0; i < busy_times.size(); ++i)
+		{
+			double utilization = std::min(1.0, (busy_times[i] - last_busy_times[i]) / delta_time);
+			total_utilization += utilization;
+			max_utilization = std::max(max_utilization, utilization);
+		}
+
+		res[StatIndex::job_utilization].result            = total_utilization / busy_times.size();
+		res[StatIndex::job_max_worker_utilization].result = max_utilization;
+	}
+
+	last_busy_times = std::move(busy_times);
+
+	return res;
+}
+
+StatsProvider::Counters JobSystemStatsProvider::continuous_sample(float delta_time)
+{
+	return sample(delta_time);
+}
+}        // namespace vkb
@@ -18,12 +18,17 @@
 
 #include "stats/stats.h"
 
+#include <algorithm>
+
 #include <core/util/profiling.hpp>
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.hpp>
 
 #include "core/device.h"
+#include "bind_stats_provider.h"
 #include "frame_time_stats_provider.h"
+#include "gpu_profiler_stats_provider.h"
+#include "job_system_stats_provider.h"
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 #	include "hwcpipe_stats_provider.h"
 #endif
@@ -71,6 +76,9 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<JobSystemStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<GpuProfilerStatsProvider>(stats, gpu_pass_names));
+	providers.emplace_back(std::make_unique<BindStatsProvider>(stats));
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 #endif
@@ -107,6 +115,28 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	}
 }
 
+std::vector<StatIndex> Stats::request_gpu_pass_times(const std::vector<std::string> &pass_names)
+{
+	if (providers.size() != 0)
+	{
+		throw std::runtime_error("GPU pass times must be requested before the stats");
+	}
+
+	if (pass_names.size() > GpuProfilerStatsProvider::PASS_SLOT_COUNT)
+	{
+		LOGW("Only the GPU time of the first {} passes can be graphed", GpuProfilerStatsProvider::PASS_SLOT_COUNT);
+	}
+
+	gpu_pass_names.assign(pass_names.begin(), pass_names.begin() + std::min(pass_names.size(), GpuProfilerStatsProvider::PASS_SLOT_COUNT));
+
+	std::vector<StatIndex> pass_stats;
+	for (size_t slot = 0; slot < gpu_pass_names.size(); ++slot)
+	{
+		pass_stats.push_back(static_cast<StatIndex>(static_cast<size_t>(StatIndex::gpu_pass_time_0) + slot));
+	}
+	return pass_stats;
+}
+
 void Stats::resize(const size_t width)
 {
 	// The circular buffer size will be 1/16th of the width of the screen
@@ -358,6 +388,32 @@ const char *to_string(StatIndex index)
 			return "External Read Bytes (MiB/s)";
 		case StatIndex::gpu_ext_write_bytes:
 			return "External Write Bytes (MiB/s)";
+		case StatIndex::job_utilization:
+			return "Job Workers Utilization (%)";
+		case StatIndex::job_max_worker_utilization:
+			return "Busiest Job Worker Utilization (%)";
+		case StatIndex::gpu_pass_time:
+			return "GPU Pass Time (ms)";
+		case StatIndex::gpu_pass_time_0:
+			return "GPU Pass 0 (ms)";
+		case StatIndex::gpu_pass_time_1:
+			return "GPU Pass 1 (ms)";
+		case StatIndex::gpu_pass_time_2:
+			return "GPU Pass 2 (ms)";
+		case StatIndex::gpu_pass_time_3:
+			return "GPU Pass 3 (ms)";
+		case StatIndex::gpu_pass_time_4:
+			return "GPU Pass 4 (ms)";
+		case StatIndex::gpu_pass_time_5:
+			return "GPU Pass 5 (ms)";
+		case StatIndex::gpu_pass_time_6:
+			return "GPU Pass 6 (ms)";
+		case StatIndex::gpu_pass_time_7:
+			return "GPU Pass 7 (ms)";
+		case StatIndex::bind_commands:
+			return "Bind Commands";
+		case StatIndex::skipped_bind_commands:
+			return "Skipped Bind Commands";
 		default:
 			return nullptr;
 	}
@@ -23,6 +23,7 @@
 #include <future>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "stats_common.h"
@@ -61,6 +62,14 @@ class Stats
 	void request_stats(const std::set<StatIndex> &requested_stats,
 	                   CounterSamplingConfig      sampling_config = {CounterSamplingMode::Polling});
 
+	/**
+	 * @brief Names the passes timed with ScopedGpuZone whose GPU time is graphed, must be called before request_stats
+	 *        Passes are timed under the debug name of their subpass, or the name given to their ScopedGpuZone.
+	 * @param pass_names Names of the passes, the first one is reported by StatIndex::gpu_pass_time_0 and so on
+	 * @return The stats reporting the passes, to be requested with request_stats
+	 */
+	std::vector<StatIndex> request_gpu_pass_times(const std::vector<std::string> &pass_names);
+
 	/**
 	 * @brief Resizes the stats buffers according to the width of the screen
 	 * @param width The width of the screen
@@ -140,6 +149,9 @@ class Stats
 	/// Stats that were requested - they may not all be available
 	std::set<StatIndex> requested_stats;
 
+	/// Names of the passes whose GPU time is reported
+	std::vector<std::string> gpu_pass_names;
+
 	/// Provider that tracks frame times
 	StatsProvider *frame_time_provider;
 
@@ -63,6 +63,23 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+
+	job_utilization,
+	job_max_worker_utilization,
+
+	gpu_pass_time,
+	// Time of the passes named with Stats::request_gpu_pass_times, in the order they were given
+	gpu_pass_time_0,
+	gpu_pass_time_1,
+	gpu_pass_time_2,
+	gpu_pass_time_3,
+	gpu_pass_time_4,
+	gpu_pass_time_5,
+	gpu_pass_time_6,
+	gpu_pass_time_7,
+
+	bind_commands,
+	skipped_bind_commands,
 };
 
 struct StatIndexHash
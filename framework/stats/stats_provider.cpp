@@ -54,6 +54,22 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+
+    {StatIndex::job_utilization,            {"Job Workers Utilization",                "{:3.1f}%",      100.0f,                       true,     100.0f}},
+    {StatIndex::job_max_worker_utilization, {"Busiest Job Worker Utilization",         "{:3.1f}%",      100.0f,                       true,     100.0f}},
+
+    {StatIndex::gpu_pass_time,              {"GPU Pass Time",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_0,            {"GPU Pass 0",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_1,            {"GPU Pass 1",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_2,            {"GPU Pass 2",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_3,            {"GPU Pass 3",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_4,            {"GPU Pass 4",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_5,            {"GPU Pass 5",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_6,            {"GPU Pass 6",                             "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_7,            {"GPU Pass 7",                             "{:3.2f} ms",    1000.0f}},
+
+    {StatIndex::bind_commands,              {"Bind Commands",                          "{:4.0f}",       1.0f}},
+    {StatIndex::skipped_bind_commands,      {"Skipped Bind Commands",                  "{:4.0f}",       1.0f}},
     // clang-format on
 };
 
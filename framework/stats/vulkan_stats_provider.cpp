@@ -21,6 +21,7 @@
 #include "rendering/render_context.h"
 #include "vulkan_stats_provider.h"
 
+#include <cstring>
 #include <regex>
 
 namespace vkb
@@ -277,6 +278,8 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 		timestamp_pool_create_info.queryCount = num_framebuffers * 2;        // 2 timestamps per frame (start & end)
 
 		timestamp_pool = std::make_unique<QueryPool>(device, timestamp_pool_create_info);
+
+		gpu_delta_times.resize(num_framebuffers, 0.0f);
 	}
 
 	return true;
@@ -378,6 +381,19 @@ void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 		cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2 + 1, 1);
 		cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *timestamp_pool,
 		                   active_frame_idx * 2 + 1);
+
+		// The copy is submitted after this command buffer, the GPU waits for the timestamps instead of the host.
+		// They are delivered when the frame index comes back, after its fence was waited.
+		render_context.get_readback_service().read_query_results(
+		    timestamp_pool->get_handle(), active_frame_idx * 2, 2, sizeof(uint64_t),
+		    VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT,
+		    [this, active_frame_idx](const uint8_t *data, VkDeviceSize size) {
+			    std::array<uint64_t, 2> timestamps;
+			    std::memcpy(timestamps.data(), data, sizeof(timestamps));
+
+			    float elapsed_ns                  = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]);
+			    gpu_delta_times[active_frame_idx] = elapsed_ns * 0.000000001f;
+		    });
 	}
 }
 
@@ -404,31 +420,19 @@ static double get_counter_value(const VkPerformanceCounterResultKHR &result,
 	}
 }
 
-float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
+float VulkanStatsProvider::get_best_delta_time(float sw_delta_time)
 {
 	if (!timestamp_pool)
 	{
 		return sw_delta_time;
 	}
 
-	float delta_time = sw_delta_time;
-
-	// Query the timestamps to get an accurate delta time
-	std::array<uint64_t, 2> timestamps;
-
+	// Use the timestamps of the frame if they were delivered in time
 	uint32_t active_frame_idx = render_context.get_active_frame_index();
 
-	VkResult r = timestamp_pool->get_results(active_frame_idx * 2, 2,
-	                                         timestamps.size() * sizeof(uint64_t),
-	                                         timestamps.data(), sizeof(uint64_t),
-	                                         VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT);
-	if (r == VK_SUCCESS)
-	{
-		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]);
-		delta_time       = elapsed_ns * 0.000000001f;
-	}
+	float delta_time = std::exchange(gpu_delta_times[active_frame_idx], 0.0f);
 
-	return delta_time;
+	return delta_time > 0.0f ? delta_time : sw_delta_time;
 }
 
 StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
@@ -445,9 +449,11 @@ StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 
 	std::vector<VkPerformanceCounterResultKHR> results(counter_indices.size());
 
+	// The fence of the frame was waited when it began, so the results are available without waiting.
+	// Performance queries cannot go through the readback service, copying them in a command buffer is optional.
 	VkResult r = query_pool->get_results(active_frame_idx, 1,
 	                                     results.size() * sizeof(VkPerformanceCounterResultKHR),
-	                                     results.data(), stride, VK_QUERY_RESULT_WAIT_BIT);
+	                                     results.data(), stride, 0);
 	if (r != VK_SUCCESS)
 	{
 		return out;
@@ -129,7 +129,7 @@ class VulkanStatsProvider : public StatsProvider
 
 	bool create_query_pools(uint32_t queue_family_index);
 
-	float get_best_delta_time(float sw_delta_time) const;
+	float get_best_delta_time(float sw_delta_time);
 
   private:
 	// The render context
@@ -147,6 +147,9 @@ class VulkanStatsProvider : public StatsProvider
 	// Query pool for timestamps
 	std::unique_ptr<QueryPool> timestamp_pool;
 
+	// GPU time of each frame, in seconds, read back from the timestamps
+	std::vector<float> gpu_delta_times;
+
 	// Map of vendor specific stat data
 	VendorStatMap vendor_data;
 
@@ -0,0 +1,188 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "zone_timeline.h"
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include <imgui.h>
+
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+#include "filesystem/legacy.h"
+
+namespace vkb
+{
+namespace
+{
+// Zones with the same name keep the same color from frame to frame
+ImU32 get_zone_color(const char *name)
+{
+	auto hash = std::hash<std::string_view>{}(name);
+	return ImColor::HSV(static_cast<float>(hash % 360) / 360.0f, 0.5f, 0.7f);
+}
+}        // namespace
+
+void ZoneTimeline::draw(float width)
+{
+	auto &profiler = ZoneProfiler::get();
+
+	bool enabled = ZoneProfiler::is_enabled();
+	if (ImGui::Checkbox("CPU zones", &enabled))
+	{
+		profiler.set_enabled(enabled);
+		capture = {};
+	}
+
+	if (!enabled)
+	{
+		return;
+	}
+
+	ImGui::SameLine();
+	ImGui::PushItemWidth(ImGui::CalcTextSize("0000000000").x);
+	ImGui::SliderInt("Frames", &frame_count, 1, 16);
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	ImGui::Checkbox("Pause", &paused);
+	ImGui::SameLine();
+	if (ImGui::Button("Save Chrome trace"))
+	{
+		save_chrome_trace();
+	}
+	if (!saved_trace_path.empty())
+	{
+		ImGui::SameLine();
+		ImGui::Text("Saved to %s", saved_trace_path.c_str());
+	}
+
+	if (!paused)
+	{
+		capture = profiler.capture(static_cast<uint32_t>(frame_count));
+	}
+
+	if (capture.frame_times_ns.size() < 2)
+	{
+		ImGui::Text("Waiting for frames");
+		return;
+	}
+
+	const auto &style      = ImGui::GetStyle();
+	const float row_height = ImGui::GetTextLineHeight() + 2.0f;
+
+	float label_width = 0.0f;
+	for (auto &thread : capture.threads)
+	{
+		label_width = std::max(label_width, ImGui::CalcTextSize(thread.thread_name.c_str()).x);
+	}
+	label_width += style.ItemSpacing.x;
+
+	const uint64_t window_begin   = capture.frame_times_ns.front();
+	const uint64_t window_end     = capture.frame_times_ns.back();
+	const float    timeline_width = std::max(1.0f, width - label_width);
+	const double   pixels_per_ns  = timeline_width / static_cast<double>(window_end - window_begin);
+
+	auto  *draw_list  = ImGui::GetWindowDrawList();
+	ImVec2 origin     = ImGui::GetCursorScreenPos();
+	float  timeline_x = origin.x + label_width;
+	ImVec2 mouse      = ImGui::GetIO().MousePos;
+	ImU32  text_color = ImGui::GetColorU32(ImGuiCol_Text);
+	float  y          = origin.y;
+
+	const char *hovered_name        = nullptr;
+	uint64_t    hovered_duration_ns = 0;
+
+	auto to_x = [&](uint64_t time_ns) {
+		time_ns = std::min(std::max(time_ns, window_begin), window_end);
+		return timeline_x + static_cast<float>(static_cast<double>(time_ns - window_begin) * pixels_per_ns);
+	};
+
+	for (auto &thread : capture.threads)
+	{
+		uint32_t depth_count = 1;
+		for (auto &zone : thread.zones)
+		{
+			depth_count = std::max(depth_count, zone.depth + 1);
+		}
+
+		draw_list->AddText(ImVec2{origin.x, y}, text_color, thread.thread_name.c_str());
+
+		// Nested zones are drawn below the zone they are nested in
+		for (auto &zone : thread.zones)
+		{
+			const char *name = zone.name ? zone.name : "";
+
+			ImVec2 min{to_x(zone.begin_ns), y + zone.depth * row_height};
+			ImVec2 max{std::max(to_x(zone.end_ns), min.x + 1.0f), min.y + row_height - 1.0f};
+
+			draw_list->AddRectFilled(min, max, get_zone_color(name));
+			if (max.x - min.x > ImGui::CalcTextSize(name).x)
+			{
+				draw_list->PushClipRect(min, max, true);
+				draw_list->AddText(ImVec2{min.x + 2.0f, min.y + 1.0f}, text_color, name);
+				draw_list->PopClipRect();
+			}
+
+			if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+			{
+				hovered_name        = name;
+				hovered_duration_ns = zone.end_ns - zone.begin_ns;
+			}
+		}
+
+		y += depth_count * row_height + style.ItemSpacing.y;
+	}
+
+	// Frame boundaries
+	for (auto frame_time : capture.frame_times_ns)
+	{
+		float x = to_x(frame_time);
+		draw_list->AddLine(ImVec2{x, origin.y}, ImVec2{x, y}, text_color);
+	}
+
+	ImGui::Dummy(ImVec2{width, y - origin.y});
+
+	if (hovered_name && ImGui::IsWindowHovered())
+	{
+		ImGui::SetTooltip("%s: %.3f ms", hovered_name, static_cast<double>(hovered_duration_ns) * 1e-6);
+	}
+}
+
+void ZoneTimeline::save_chrome_trace()
+{
+	if (capture.frame_times_ns.size() < 2)
+	{
+		LOGW("No complete frame was captured, the CPU zones are not saved");
+		return;
+	}
+
+	try
+	{
+		auto path = fs::path::get(fs::path::Type::Logs, "zone_trace.json");
+		filesystem::get()->write_file(path, ZoneProfiler::to_chrome_trace(capture));
+
+		saved_trace_path = path;
+		LOGI("Saved the CPU zones of the last {} frames to {}", capture.frame_times_ns.size() - 1, path);
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Failed to save the CPU zones: {}", e.what());
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,52 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "core/util/zone_profiler.hpp"
+
+namespace vkb
+{
+/**
+ * @brief Draws the CPU zones of the last frames recorded by ZoneProfiler as a flame graph, with a row per thread
+ *
+ * Used by the debug window of the GUI, it also controls the profiler and saves captures as Chrome traces.
+ */
+class ZoneTimeline
+{
+  public:
+	/**
+	 * @brief Draws the controls and the timeline into the current ImGui window
+	 * @param width Width of the timeline in pixels
+	 */
+	void draw(float width);
+
+  private:
+	ZoneProfiler::Capture capture;
+
+	int frame_count{3};
+
+	// Keeps showing the same capture while paused
+	bool paused{false};
+
+	std::string saved_trace_path;
+
+	void save_chrome_trace();
+};
+}        // namespace vkb
@@ -33,12 +33,21 @@ ComputeNBody::ComputeNBody()
 	camera.set_rotation(glm::vec3(-26.0f, 75.0f, 0.0f));
 	camera.set_translation(glm::vec3(0.0f, 0.0f, -14.0f));
 	camera.translation_speed = 2.5f;
+
+	// Larger particle counts turn the sample into a compute throughput benchmark in batch mode
+	auto &config = get_configuration();
+
+	config.insert<vkb::IntSetting>(0, particle_count, 0);
+	config.insert<vkb::IntSetting>(1, particle_count, 64 * 1024);
+	config.insert<vkb::IntSetting>(2, particle_count, 256 * 1024);
 }
 
 ComputeNBody::~ComputeNBody()
 {
 	if (has_device())
 	{
+		log_average_throughput();
+
 		// Graphics
 		graphics.uniform_buffer.reset();
 		vkDestroyPipeline(get_device().get_handle(), graphics.pipeline, nullptr);
@@ -55,6 +64,7 @@ ComputeNBody::~ComputeNBody()
 		vkDestroyPipeline(get_device().get_handle(), compute.pipeline_integrate, nullptr);
 		vkDestroySemaphore(get_device().get_handle(), compute.semaphore, nullptr);
 		vkDestroyCommandPool(get_device().get_handle(), compute.command_pool, nullptr);
+		vkDestroyQueryPool(get_device().get_handle(), timestamps.query_pool, nullptr);
 
 		vkDestroySampler(get_device().get_handle(), textures.particle.sampler, nullptr);
 		vkDestroySampler(get_device().get_handle(), textures.gradient.sampler, nullptr);
@@ -199,11 +209,22 @@ void ComputeNBody::build_compute_command_buffer()
 		    0, nullptr);
 	}
 
+	uint32_t group_count = (num_particles + work_group_size - 1) / work_group_size;
+
 	// First pass: Calculate particle movement
 	// -------------------------------------------------------------------------------------------------------
+	if (timestamps.supported)
+	{
+		vkCmdResetQueryPool(compute.command_buffer, timestamps.query_pool, 0, 2);
+		vkCmdWriteTimestamp(compute.command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestamps.query_pool, 0);
+	}
 	vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_calculate);
 	vkCmdBindDescriptorSets(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_layout, 0, 1, &compute.descriptor_set, 0, 0);
-	vkCmdDispatch(compute.command_buffer, num_particles / work_group_size, 1, 1);
+	vkCmdDispatch(compute.command_buffer, group_count, 1, 1);
+	if (timestamps.supported)
+	{
+		vkCmdWriteTimestamp(compute.command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamps.query_pool, 1);
+	}
 
 	// Add memory barrier to ensure that the computer shader has finished writing to the buffer
 	VkBufferMemoryBarrier memory_barrier = vkb::initializers::buffer_memory_barrier();
@@ -226,7 +247,7 @@ void ComputeNBody::build_compute_command_buffer()
 	// Second pass: Integrate particles
 	// -------------------------------------------------------------------------------------------------------
 	vkCmdBindPipeline(compute.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_integrate);
-	vkCmdDispatch(compute.command_buffer, num_particles / work_group_size, 1, 1);
+	vkCmdDispatch(compute.command_buffer, group_count, 1, 1);
 
 	// Release
 	if (graphics.queue_family_index != compute.queue_family_index)
@@ -256,15 +277,81 @@ void ComputeNBody::build_compute_command_buffer()
 	vkEndCommandBuffer(compute.command_buffer);
 }
 
-// Setup and fill the compute shader storage buffers containing the particles
+VkCommandBuffer ComputeNBody::begin_compute_command_buffer()
+{
+	VkCommandBuffer command_buffer;
+
+	VkCommandBufferAllocateInfo command_buffer_allocate_info =
+	    vkb::initializers::command_buffer_allocate_info(
+	        compute.command_pool,
+	        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+	        1);
+
+	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &command_buffer_allocate_info, &command_buffer));
+
+	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
+	command_buffer_begin_info.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	VK_CHECK(vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info));
+
+	return command_buffer;
+}
+
+// Copied from Device::flush_command_buffer, which we can't use because it would be
+// working with the wrong command pool
+void ComputeNBody::flush_compute_command_buffer(VkCommandBuffer command_buffer)
+{
+	VK_CHECK(vkEndCommandBuffer(command_buffer));
+
+	VkSubmitInfo submit_info       = vkb::initializers::submit_info();
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &command_buffer;
+
+	// Create fence to ensure that the command buffer has finished executing
+	VkFenceCreateInfo fence_info = vkb::initializers::fence_create_info();
+	VkFence           fence;
+	VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_info, nullptr, &fence));
+
+	// Submit to the *compute* queue
+	VK_CHECK(vkQueueSubmit(compute.queue, 1, &submit_info, fence));
+
+	// Wait for the fence to signal that command buffer has finished executing
+	VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
+	vkDestroyFence(get_device().get_handle(), fence, nullptr);
+
+	vkFreeCommandBuffers(get_device().get_handle(), compute.command_pool, 1, &command_buffer);
+}
+
+// Setup the compute shader storage buffer containing the particles
 void ComputeNBody::prepare_storage_buffers()
 {
-#if 0
-	std::vector<glm::vec3> attractors = {
-		glm::vec3(2.5f, 1.5f, 0.0f),
-		glm::vec3(-2.5f, -1.5f, 0.0f),
-	};
-#else
+	// The particles are spread evenly over the attractors, the count is raised by the configurations to benchmark compute throughput
+	prepared_particle_count = particle_count;
+	particles_per_attractor = particle_count > 0 ? (static_cast<uint32_t>(particle_count) + ATTRACTOR_COUNT - 1) / ATTRACTOR_COUNT : PARTICLES_PER_ATTRACTOR;
+
+	// The HLSL shaders have no bounds checks, so every work group must be full
+	if (get_shading_language() == vkb::ShadingLanguage::HLSL)
+	{
+		particles_per_attractor = (particles_per_attractor + work_group_size - 1) / work_group_size * work_group_size;
+	}
+
+	num_particles              = ATTRACTOR_COUNT * particles_per_attractor;
+	compute.ubo.particle_count = num_particles;
+
+	compute.storage_buffer = std::make_unique<vkb::core::BufferC>(get_device(),
+	                                                              num_particles * sizeof(Particle),
+	                                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                              VMA_MEMORY_USAGE_GPU_ONLY);
+
+	// The particles are generated by a compute shader with GLSL, there is no HLSL version of it
+	if (get_shading_language() == vkb::ShadingLanguage::HLSL)
+	{
+		upload_particles();
+	}
+}
+
+// Generate the particles on the host and upload them to the storage buffer
+void ComputeNBody::upload_particles()
+{
 	std::vector<glm::vec3> attractors = {
 	    glm::vec3(5.0f, 0.0f, 0.0f),
 	    glm::vec3(-5.0f, 0.0f, 0.0f),
@@ -273,9 +360,6 @@ void ComputeNBody::prepare_storage_buffers()
 	    glm::vec3(0.0f, 4.0f, 0.0f),
 	    glm::vec3(0.0f, -8.0f, 0.0f),
 	};
-#endif
-
-	num_particles = static_cast<uint32_t>(attractors.size()) * PARTICLES_PER_ATTRACTOR;
 
 	// Initial particle positions
 	std::vector<Particle> particle_buffer(num_particles);
@@ -285,9 +369,9 @@ void ComputeNBody::prepare_storage_buffers()
 
 	for (uint32_t i = 0; i < static_cast<uint32_t>(attractors.size()); i++)
 	{
-		for (uint32_t j = 0; j < PARTICLES_PER_ATTRACTOR; j++)
+		for (uint32_t j = 0; j < particles_per_attractor; j++)
 		{
-			Particle &particle = particle_buffer[i * PARTICLES_PER_ATTRACTOR + j];
+			Particle &particle = particle_buffer[i * particles_per_attractor + j];
 
 			// First particle in group as heavy center of gravity
 			if (j == 0)
@@ -316,23 +400,14 @@ void ComputeNBody::prepare_storage_buffers()
 		}
 	}
 
-	compute.ubo.particle_count = num_particles;
-
-	VkDeviceSize storage_buffer_size = particle_buffer.size() * sizeof(Particle);
-
 	// Staging
 	// SSBO won't be changed on the host after upload so copy to device local memory
 	vkb::core::BufferC staging_buffer = vkb::core::BufferC::create_staging_buffer(get_device(), particle_buffer);
 
-	compute.storage_buffer = std::make_unique<vkb::core::BufferC>(get_device(),
-	                                                              storage_buffer_size,
-	                                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-	                                                              VMA_MEMORY_USAGE_GPU_ONLY);
-
 	// Copy from staging buffer to storage buffer
 	VkCommandBuffer copy_command = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 	VkBufferCopy    copy_region  = {};
-	copy_region.size             = storage_buffer_size;
+	copy_region.size             = compute.storage_buffer->get_size();
 	vkCmdCopyBuffer(copy_command, staging_buffer.get_handle(), compute.storage_buffer->get_handle(), 1, &copy_region);
 	// Execute a transfer to the compute queue, if necessary
 	if (graphics.queue_family_index != compute.queue_family_index)
@@ -362,6 +437,188 @@ void ComputeNBody::prepare_storage_buffers()
 	get_device().flush_command_buffer(copy_command, queue, true);
 }
 
+// Generate the particles on the GPU, one compute shader invocation per particle
+void ComputeNBody::seed_particles()
+{
+	struct PushConstants
+	{
+		uint32_t seed;
+		uint32_t particles_per_attractor;
+		uint32_t particle_count;
+	} push_constants;
+
+	push_constants.seed                    = lock_simulation_speed ? 0 : static_cast<uint32_t>(time(nullptr));
+	push_constants.particles_per_attractor = particles_per_attractor;
+	push_constants.particle_count          = num_particles;
+
+	VkPushConstantRange        push_constant_range         = vkb::initializers::push_constant_range(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(push_constants), 0);
+	VkPipelineLayoutCreateInfo pipeline_layout_create_info = vkb::initializers::pipeline_layout_create_info(&compute.descriptor_set_layout, 1);
+	pipeline_layout_create_info.pushConstantRangeCount     = 1;
+	pipeline_layout_create_info.pPushConstantRanges        = &push_constant_range;
+
+	VkPipelineLayout pipeline_layout;
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &pipeline_layout_create_info, nullptr, &pipeline_layout));
+
+	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(pipeline_layout, 0);
+	compute_pipeline_create_info.stage                       = load_shader("compute_nbody", "particle_seed.comp", VK_SHADER_STAGE_COMPUTE_BIT);
+
+	VkPipeline pipeline;
+	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &pipeline));
+
+	VkCommandBuffer command_buffer = begin_compute_command_buffer();
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &compute.descriptor_set, 0, nullptr);
+	vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push_constants), &push_constants);
+
+	// The seed shader has a fixed local size of 128
+	vkCmdDispatch(command_buffer, (num_particles + 127) / 128, 1, 1);
+	flush_compute_command_buffer(command_buffer);
+
+	vkDestroyPipeline(get_device().get_handle(), pipeline, nullptr);
+	vkDestroyPipelineLayout(get_device().get_handle(), pipeline_layout, nullptr);
+}
+
+// Create the N-body velocity calculation pipeline (1st pass) for a work group size and a number of particles loaded to shared memory at once
+VkPipeline ComputeNBody::create_calculate_pipeline(uint32_t group_size, uint32_t data_size)
+{
+	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(compute.pipeline_layout, 0);
+	compute_pipeline_create_info.stage                       = load_shader("compute_nbody", "particle_calculate.comp", VK_SHADER_STAGE_COMPUTE_BIT);
+
+	// Set some shader parameters via specialization constants
+	struct SpecializationData
+	{
+		uint32_t workgroup_size;
+		uint32_t shared_data_size;
+		float    gravity;
+		float    power;
+		float    soften;
+	} specialization_data;
+
+	std::vector<VkSpecializationMapEntry> specialization_map_entries;
+	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(0, offsetof(SpecializationData, workgroup_size), sizeof(uint32_t)));
+	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(1, offsetof(SpecializationData, shared_data_size), sizeof(uint32_t)));
+	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(2, offsetof(SpecializationData, gravity), sizeof(float)));
+	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(3, offsetof(SpecializationData, power), sizeof(float)));
+	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(4, offsetof(SpecializationData, soften), sizeof(float)));
+
+	specialization_data.workgroup_size   = group_size;
+	specialization_data.shared_data_size = data_size;
+	specialization_data.gravity          = 0.002f;
+	specialization_data.power            = 0.75f;
+	specialization_data.soften           = 0.05f;
+
+	VkSpecializationInfo specialization_info =
+	    vkb::initializers::specialization_info(static_cast<uint32_t>(specialization_map_entries.size()), specialization_map_entries.data(), sizeof(specialization_data), &specialization_data);
+	compute_pipeline_create_info.stage.pSpecializationInfo = &specialization_info;
+
+	VkPipeline pipeline;
+	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &pipeline));
+	return pipeline;
+}
+
+// Returns the duration of the velocity calculation pass in ms, or 0 if its timestamps are not available
+float ComputeNBody::get_calculate_time(VkQueryResultFlags flags)
+{
+	std::array<uint64_t, 2> results;
+
+	VkResult result = vkGetQueryPoolResults(get_device().get_handle(), timestamps.query_pool, 0, 2, sizeof(results), results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | flags);
+	if (result != VK_SUCCESS)
+	{
+		return 0.0f;
+	}
+
+	return static_cast<float>(((results[1] - results[0]) & timestamps.valid_mask) * timestamps.period / 1000000.0);
+}
+
+// Time the velocity calculation pass with several work group and shared data sizes, and keep the fastest pipeline
+void ComputeNBody::tune_calculate_pipeline()
+{
+	const VkPhysicalDeviceLimits &limits = get_device().get_gpu().get_properties().limits;
+
+	// A null time step leaves the particles unchanged, and a subset of them keeps the tuning short with large particle counts
+	auto ubo                   = compute.ubo;
+	compute.ubo.delta_time     = 0.0f;
+	compute.ubo.particle_count = std::min(num_particles, tuning_particle_count);
+	compute.uniform_buffer->convert_and_update(compute.ubo);
+
+	// Every dispatch writes the velocities read and written by the next one
+	VkMemoryBarrier memory_barrier = vkb::initializers::memory_barrier();
+	memory_barrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+	memory_barrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+	float    best_time       = std::numeric_limits<float>::max();
+	uint32_t best_group_size = work_group_size;
+	uint32_t best_data_size  = shared_data_size;
+
+	compute.pipeline_calculate = VK_NULL_HANDLE;
+
+	for (uint32_t group_size : {64u, 128u, 256u, 512u})
+	{
+		if (group_size > limits.maxComputeWorkGroupSize[0] || group_size > limits.maxComputeWorkGroupInvocations)
+		{
+			continue;
+		}
+
+		for (uint32_t data_size : {256u, 512u, 1024u, 2048u})
+		{
+			if (data_size * sizeof(glm::vec4) > limits.maxComputeSharedMemorySize)
+			{
+				continue;
+			}
+
+			VkPipeline pipeline    = create_calculate_pipeline(group_size, data_size);
+			uint32_t   group_count = (compute.ubo.particle_count + group_size - 1) / group_size;
+
+			// One submission per candidate, so that slow candidates on slow devices do not add up in a single submission
+			VkCommandBuffer command_buffer = begin_compute_command_buffer();
+			vkCmdResetQueryPool(command_buffer, timestamps.query_pool, 0, 2);
+			vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+			vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline_layout, 0, 1, &compute.descriptor_set, 0, nullptr);
+
+			// The first dispatch is not timed, it warms the caches up
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+				if (i == 1)
+				{
+					vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestamps.query_pool, 0);
+				}
+				vkCmdDispatch(command_buffer, group_count, 1, 1);
+			}
+			vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamps.query_pool, 1);
+			flush_compute_command_buffer(command_buffer);
+
+			float time = get_calculate_time(VK_QUERY_RESULT_WAIT_BIT) / 2.0f;
+			LOGI("N-body tuning with {} particles, work group size {}, shared data size {}: {:.3f} ms", compute.ubo.particle_count, group_size, data_size, time);
+
+			if (time > 0.0f && time < best_time)
+			{
+				vkDestroyPipeline(get_device().get_handle(), compute.pipeline_calculate, nullptr);
+				compute.pipeline_calculate = pipeline;
+				best_time                  = time;
+				best_group_size            = group_size;
+				best_data_size             = data_size;
+			}
+			else
+			{
+				vkDestroyPipeline(get_device().get_handle(), pipeline, nullptr);
+			}
+		}
+	}
+
+	compute.ubo = ubo;
+	compute.uniform_buffer->convert_and_update(compute.ubo);
+
+	work_group_size  = best_group_size;
+	shared_data_size = best_data_size;
+	if (compute.pipeline_calculate == VK_NULL_HANDLE)
+	{
+		compute.pipeline_calculate = create_calculate_pipeline(work_group_size, shared_data_size);
+	}
+
+	LOGI("N-body tuning selected work group size {} and shared data size {}", work_group_size, shared_data_size);
+}
+
 void ComputeNBody::setup_descriptor_pool()
 {
 	std::vector<VkDescriptorPoolSize> pool_sizes =
@@ -599,55 +856,11 @@ void ComputeNBody::prepare_compute()
 
 	vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(compute_write_descriptor_sets.size()), compute_write_descriptor_sets.data(), 0, NULL);
 
-	// Create pipelines
-	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(compute.pipeline_layout, 0);
-
-	// 1st pass - Particle movement calculations
-	compute_pipeline_create_info.stage = load_shader("compute_nbody", "particle_calculate.comp", VK_SHADER_STAGE_COMPUTE_BIT);
-
-	// Set some shader parameters via specialization constants
-	struct SpecializationData
-	{
-		uint32_t workgroup_size;
-		uint32_t shared_data_size;
-		float    gravity;
-		float    power;
-		float    soften;
-	} specialization_data;
-
-	std::vector<VkSpecializationMapEntry> specialization_map_entries;
-	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(0, offsetof(SpecializationData, workgroup_size), sizeof(uint32_t)));
-	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(1, offsetof(SpecializationData, shared_data_size), sizeof(uint32_t)));
-	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(2, offsetof(SpecializationData, gravity), sizeof(float)));
-	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(3, offsetof(SpecializationData, power), sizeof(float)));
-	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(4, offsetof(SpecializationData, soften), sizeof(float)));
-
-	specialization_data.workgroup_size   = work_group_size;
-	specialization_data.shared_data_size = shared_data_size;
-	specialization_data.gravity          = 0.002f;
-	specialization_data.power            = 0.75f;
-	specialization_data.soften           = 0.05f;
-
-	VkSpecializationInfo specialization_info =
-	    vkb::initializers::specialization_info(static_cast<uint32_t>(specialization_map_entries.size()), specialization_map_entries.data(), sizeof(specialization_data), &specialization_data);
-	compute_pipeline_create_info.stage.pSpecializationInfo = &specialization_info;
-
-	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &compute.pipeline_calculate));
-
-	// 2nd pass - Particle integration
-	compute_pipeline_create_info.stage = load_shader("compute_nbody", "particle_integrate.comp", VK_SHADER_STAGE_COMPUTE_BIT);
-
-	specialization_map_entries.clear();
-	specialization_map_entries.push_back(vkb::initializers::specialization_map_entry(0, 0, sizeof(uint32_t)));
-	specialization_info =
-	    vkb::initializers::specialization_info(1, specialization_map_entries.data(), sizeof(work_group_size), &work_group_size);
-
-	compute_pipeline_create_info.stage.pSpecializationInfo = &specialization_info;
-	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &compute.pipeline_integrate));
-
 	// Separate command pool as queue family for compute may be different than graphics
+	// The compute command buffer is recorded again when the particle count changes
 	VkCommandPoolCreateInfo command_pool_create_info = {};
 	command_pool_create_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	command_pool_create_info.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 	command_pool_create_info.queueFamilyIndex        = get_device().get_queue_family_index(VK_QUEUE_COMPUTE_BIT);
 	VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_create_info, nullptr, &compute.command_pool));
 
@@ -660,6 +873,49 @@ void ComputeNBody::prepare_compute()
 
 	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &command_buffer_allocate_info, &compute.command_buffer));
 
+	// Timestamps of the velocity calculation pass, to report the compute throughput
+	const VkPhysicalDeviceLimits &limits     = get_device().get_gpu().get_properties().limits;
+	uint32_t                      valid_bits = get_device().get_gpu().get_queue_family_properties()[compute.queue_family_index].timestampValidBits;
+	timestamps.supported                     = valid_bits > 0 && limits.timestampPeriod > 0.0f;
+	if (timestamps.supported)
+	{
+		timestamps.valid_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+		timestamps.period     = limits.timestampPeriod;
+
+		VkQueryPoolCreateInfo query_pool_create_info = {};
+		query_pool_create_info.sType                 = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		query_pool_create_info.queryType             = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_create_info.queryCount            = 2;
+		VK_CHECK(vkCreateQueryPool(get_device().get_handle(), &query_pool_create_info, nullptr, &timestamps.query_pool));
+	}
+
+	// The seed and tuning shaders only exist in GLSL, and the HLSL velocity calculation shader has a fixed work group size
+	if (get_shading_language() == vkb::ShadingLanguage::GLSL)
+	{
+		seed_particles();
+	}
+
+	// 1st pass - Particle movement calculations
+	if (get_shading_language() == vkb::ShadingLanguage::GLSL && timestamps.supported)
+	{
+		tune_calculate_pipeline();
+	}
+	else
+	{
+		compute.pipeline_calculate = create_calculate_pipeline(work_group_size, shared_data_size);
+	}
+
+	// 2nd pass - Particle integration
+	VkComputePipelineCreateInfo compute_pipeline_create_info = vkb::initializers::compute_pipeline_create_info(compute.pipeline_layout, 0);
+	compute_pipeline_create_info.stage                       = load_shader("compute_nbody", "particle_integrate.comp", VK_SHADER_STAGE_COMPUTE_BIT);
+
+	VkSpecializationMapEntry specialization_map_entry = vkb::initializers::specialization_map_entry(0, 0, sizeof(uint32_t));
+	VkSpecializationInfo     specialization_info =
+	    vkb::initializers::specialization_info(1, &specialization_map_entry, sizeof(work_group_size), &work_group_size);
+
+	compute_pipeline_create_info.stage.pSpecializationInfo = &specialization_info;
+	VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &compute.pipeline_integrate));
+
 	// Semaphore for compute & graphics sync
 	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
 	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &compute.semaphore));
@@ -674,89 +930,110 @@ void ComputeNBody::prepare_compute()
 	// Build a single command buffer containing the compute dispatch commands
 	build_compute_command_buffer();
 
-	// If necessary, acquire and immediately release the storage buffer, so that the initial acquire
-	// from the graphics command buffers are matched up properly.
+	release_particles();
+}
+
+// Hand the particles over to the graphics command buffers
+void ComputeNBody::release_particles()
+{
+	VkCommandBuffer transfer_command = begin_compute_command_buffer();
 	if (graphics.queue_family_index != compute.queue_family_index)
 	{
-		VkCommandBuffer transfer_command;
-
-		// Create a transient command buffer for setting up the initial buffer transfer state
-		VkCommandBufferAllocateInfo command_buffer_allocate_info =
-		    vkb::initializers::command_buffer_allocate_info(
-		        compute.command_pool,
-		        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-		        1);
-
-		VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &command_buffer_allocate_info, &transfer_command));
-
-		VkCommandBufferBeginInfo command_buffer_info{};
-		command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		VK_CHECK(vkBeginCommandBuffer(transfer_command, &command_buffer_info));
+		// The particles uploaded from the host were released by the graphics queue, acquire them so that the
+		// release below matches up with the initial acquire of the graphics command buffers.
+		if (get_shading_language() == vkb::ShadingLanguage::HLSL)
+		{
+			VkBufferMemoryBarrier acquire_buffer_barrier =
+			    {
+			        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+			        nullptr,
+			        0,
+			        VK_ACCESS_SHADER_WRITE_BIT,
+			        graphics.queue_family_index,
+			        compute.queue_family_index,
+			        compute.storage_buffer->get_handle(),
+			        0,
+			        compute.storage_buffer->get_size()};
+			vkCmdPipelineBarrier(
+			    transfer_command,
+			    VK_PIPELINE_STAGE_TRANSFER_BIT,
+			    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			    0,
+			    0, nullptr,
+			    1, &acquire_buffer_barrier,
+			    0, nullptr);
+		}
 
-		VkBufferMemoryBarrier acquire_buffer_barrier =
+		VkBufferMemoryBarrier release_buffer_barrier =
 		    {
 		        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
 		        nullptr,
-		        0,
 		        VK_ACCESS_SHADER_WRITE_BIT,
-		        graphics.queue_family_index,
+		        0,
 		        compute.queue_family_index,
+		        graphics.queue_family_index,
 		        compute.storage_buffer->get_handle(),
 		        0,
 		        compute.storage_buffer->get_size()};
 		vkCmdPipelineBarrier(
 		    transfer_command,
-		    VK_PIPELINE_STAGE_TRANSFER_BIT,
 		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		    VK_PIPELINE_STAGE_TRANSFER_BIT,
 		    0,
 		    0, nullptr,
-		    1, &acquire_buffer_barrier,
+		    1, &release_buffer_barrier,
 		    0, nullptr);
-
-		VkBufferMemoryBarrier release_buffer_barrier =
-		    {
-		        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-		        nullptr,
-		        VK_ACCESS_SHADER_WRITE_BIT,
-		        0,
-		        compute.queue_family_index,
-		        graphics.queue_family_index,
-		        compute.storage_buffer->get_handle(),
-		        0,
-		        compute.storage_buffer->get_size()};
+	}
+	else
+	{
+		// Make the seeded particles visible to the first draw
+		VkMemoryBarrier memory_barrier = vkb::initializers::memory_barrier();
+		memory_barrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+		memory_barrier.dstAccessMask   = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
 		vkCmdPipelineBarrier(
 		    transfer_command,
 		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-		    VK_PIPELINE_STAGE_TRANSFER_BIT,
+		    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
 		    0,
+		    1, &memory_barrier,
 		    0, nullptr,
-		    1, &release_buffer_barrier,
 		    0, nullptr);
+	}
+	flush_compute_command_buffer(transfer_command);
+}
+
+// Recreate the particles when a configuration changes their count
+void ComputeNBody::update_particle_count()
+{
+	// The storage buffer may still be used by the submitted frames
+	get_device().wait_idle();
+
+	log_average_throughput();
+	timestamps.gflops_sum     = 0.0;
+	timestamps.gflops_samples = 0;
+	timestamps.written        = false;
+
+	prepare_storage_buffers();
+
+	VkDescriptorBufferInfo storage_buffer_descriptor = create_descriptor(*compute.storage_buffer);
+	VkWriteDescriptorSet   write_descriptor_set      = vkb::initializers::write_descriptor_set(compute.descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0, &storage_buffer_descriptor);
+	vkUpdateDescriptorSets(get_device().get_handle(), 1, &write_descriptor_set, 0, nullptr);
+
+	if (get_shading_language() == vkb::ShadingLanguage::GLSL)
+	{
+		seed_particles();
+	}
+
+	build_compute_command_buffer();
+	release_particles();
+	build_command_buffers();
+}
 
-		// Copied from Device::flush_command_buffer, which we can't use because it would be
-		// working with the wrong command pool
-		VK_CHECK(vkEndCommandBuffer(transfer_command));
-
-		// Submit compute commands
-		VkSubmitInfo submit_info{};
-		submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submit_info.commandBufferCount = 1;
-		submit_info.pCommandBuffers    = &transfer_command;
-
-		// Create fence to ensure that the command buffer has finished executing
-		VkFenceCreateInfo fence_info{};
-		fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fence_info.flags = VK_FLAGS_NONE;
-
-		VkFence fence;
-		VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_info, nullptr, &fence));
-		// Submit to the *compute* queue
-		VkResult result = vkQueueSubmit(compute.queue, 1, &submit_info, fence);
-		// Wait for the fence to signal that command buffer has finished executing
-		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
-		vkDestroyFence(get_device().get_handle(), fence, nullptr);
-
-		vkFreeCommandBuffers(get_device().get_handle(), compute.command_pool, 1, &transfer_command);
+void ComputeNBody::log_average_throughput()
+{
+	if (timestamps.gflops_samples > 0)
+	{
+		LOGI("Average N-body throughput with {} particles: {:.1f} GFLOP/s", num_particles, timestamps.gflops_sum / timestamps.gflops_samples);
 	}
 }
 
@@ -813,6 +1090,20 @@ void ComputeNBody::draw()
 
 	ApiVulkanSample::submit_frame();
 
+	// The previous compute submission has completed, as the graphics submission waited for it
+	if (timestamps.written)
+	{
+		float time = get_calculate_time(0);
+		if (time > 0.0f)
+		{
+			// About 20 floating point operations per interaction between two particles
+			timestamps.calculate_time = time;
+			timestamps.gflops         = static_cast<float>(num_particles) * static_cast<float>(num_particles) * 20.0f / (time * 1000000.0f);
+			timestamps.gflops_sum += timestamps.gflops;
+			timestamps.gflops_samples++;
+		}
+	}
+
 	// Wait for rendering finished
 	VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
@@ -826,6 +1117,7 @@ void ComputeNBody::draw()
 	compute_submit_info.signalSemaphoreCount = 1;
 	compute_submit_info.pSignalSemaphores    = &compute.semaphore;
 	VK_CHECK(vkQueueSubmit(compute.queue, 1, &compute_submit_info, VK_NULL_HANDLE));
+	timestamps.written = timestamps.supported;
 }
 
 bool ComputeNBody::prepare(const vkb::ApplicationOptions &options)
@@ -858,6 +1150,10 @@ void ComputeNBody::render(float delta_time)
 	{
 		return;
 	}
+	if (particle_count != prepared_particle_count)
+	{
+		update_particle_count();
+	}
 	draw();
 	update_compute_uniform_buffers(delta_time);
 	if (camera.updated)
@@ -873,6 +1169,21 @@ bool ComputeNBody::resize(const uint32_t width, const uint32_t height)
 	return true;
 }
 
+void ComputeNBody::on_update_ui_overlay(vkb::Drawer &drawer)
+{
+	if (drawer.header("Statistics"))
+	{
+		drawer.text("Particles: %d", num_particles);
+		drawer.text("Work group size: %d", work_group_size);
+		drawer.text("Shared data size: %d", shared_data_size);
+		if (timestamps.supported)
+		{
+			drawer.text("N-body pass: %.2f ms", timestamps.calculate_time);
+			drawer.text("Throughput: %.1f GFLOP/s", timestamps.gflops);
+		}
+	}
+}
+
 std::unique_ptr<vkb::Application> create_compute_nbody()
 {
 	return std::make_unique<ComputeNBody>();
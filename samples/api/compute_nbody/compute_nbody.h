@@ -30,13 +30,38 @@
 #	define PARTICLES_PER_ATTRACTOR 4 * 1024
 #endif
 
+// Must match the attractors of the particle_seed compute shader
+#define ATTRACTOR_COUNT 6
+
 class ComputeNBody : public ApiVulkanSample
 {
   public:
 	uint32_t num_particles;
+	uint32_t particles_per_attractor;
 	uint32_t work_group_size  = 128;
 	uint32_t shared_data_size = 1024;
 
+	// Number of particles set by the configurations, 0 for the default count of the platform
+	int particle_count{0};
+	int prepared_particle_count{0};
+
+	// Number of particles the work group and shared data sizes are tuned with, bounded to keep the startup short
+	const uint32_t tuning_particle_count = 16 * 1024;
+
+	// Timings of the N-body velocity calculation pass
+	struct
+	{
+		bool        supported{false};
+		VkQueryPool query_pool{VK_NULL_HANDLE};
+		uint64_t    valid_mask{0};
+		float       period{0.0f};                // Nanoseconds per timestamp tick
+		bool        written{false};              // Whether the compute command buffer has run once
+		float       calculate_time{0.0f};        // In ms
+		float       gflops{0.0f};
+		double      gflops_sum{0.0};
+		uint32_t    gflops_samples{0};
+	} timestamps;
+
 	struct
 	{
 		Texture particle;
@@ -96,24 +121,35 @@ class ComputeNBody : public ApiVulkanSample
 
 	ComputeNBody();
 	~ComputeNBody();
-	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
-	void         load_assets();
-	void         build_command_buffers() override;
-	void         build_compute_command_buffer();
-	void         prepare_storage_buffers();
-	void         setup_descriptor_pool();
-	void         setup_descriptor_set_layout();
-	void         setup_descriptor_set();
-	void         prepare_pipelines();
-	void         prepare_graphics();
-	void         prepare_compute();
-	void         prepare_uniform_buffers();
-	void         update_compute_uniform_buffers(float delta_time);
-	void         update_graphics_uniform_buffers();
-	void         draw();
-	bool         prepare(const vkb::ApplicationOptions &options) override;
-	virtual void render(float delta_time) override;
-	virtual bool resize(const uint32_t width, const uint32_t height) override;
+	virtual void    request_gpu_features(vkb::PhysicalDevice &gpu) override;
+	void            load_assets();
+	void            build_command_buffers() override;
+	void            build_compute_command_buffer();
+	VkCommandBuffer begin_compute_command_buffer();
+	void            flush_compute_command_buffer(VkCommandBuffer command_buffer);
+	void            prepare_storage_buffers();
+	void            upload_particles();
+	void            seed_particles();
+	void            release_particles();
+	void            update_particle_count();
+	void            log_average_throughput();
+	VkPipeline      create_calculate_pipeline(uint32_t group_size, uint32_t data_size);
+	float           get_calculate_time(VkQueryResultFlags flags);
+	void            tune_calculate_pipeline();
+	void            setup_descriptor_pool();
+	void            setup_descriptor_set_layout();
+	void            setup_descriptor_set();
+	void            prepare_pipelines();
+	void            prepare_graphics();
+	void            prepare_compute();
+	void            prepare_uniform_buffers();
+	void            update_compute_uniform_buffers(float delta_time);
+	void            update_graphics_uniform_buffers();
+	void            draw();
+	bool            prepare(const vkb::ApplicationOptions &options) override;
+	virtual void    render(float delta_time) override;
+	virtual bool    resize(const uint32_t width, const uint32_t height) override;
+	virtual void    on_update_ui_overlay(vkb::Drawer &drawer) override;
 };
 
 std::unique_ptr<vkb::Application> create_compute_nbody();
@@ -93,9 +93,15 @@ void OITLinkedLists::render(float delta_time)
 	}
 
 	ApiVulkanSample::prepare_frame();
+
+	// The previous frame drawn to this swapchain image has completed, as submit_frame waits for the queue
+	read_fragment_counter();
+	update_fragment_pool_size();
+
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
+	fragment_counter_readback_capacity[current_buffer] = fragment_max_count;
 	ApiVulkanSample::submit_frame();
 
 	if (camera_auto_rotation)
@@ -123,6 +129,17 @@ void OITLinkedLists::on_update_ui_overlay(vkb::Drawer &drawer)
 	drawer.checkbox("Camera auto-rotation", &camera_auto_rotation);
 	drawer.slider_int("Sorted fragments per pixel", &sorted_fragment_count, kSortedFragmentMinCount, kSortedFragmentMaxCount);
 	drawer.slider_float("Background grayscale", &background_grayscale, kBackgroundGrayscaleMin, kBackgroundGrayscaleMax);
+	drawer.checkbox("Adaptive fragment pool", &adaptive_fragment_pool);
+
+	if (drawer.header("Fragment pool"))
+	{
+		drawer.text("Capacity: %u fragments (%.1f MB)", fragment_max_count, static_cast<float>(fragment_buffer->get_size()) / (1024.0f * 1024.0f));
+		drawer.text("Fragments: %u, peak %u", fragment_stats.count, fragment_stats.peak_count);
+		drawer.text("Fill ratio: %.1f %%", fragment_stats.fill_ratio * 100.0f);
+		drawer.text("Dropped fragments: %u", fragment_stats.overflow_count);
+		drawer.text("Frames with dropped fragments: %u", fragment_stats.overflow_frame_count);
+		drawer.text("Pool resizes: %u", fragment_stats.resize_count);
+	}
 }
 
 void OITLinkedLists::build_command_buffers()
@@ -161,6 +178,31 @@ void OITLinkedLists::build_command_buffers()
 				vkCmdEndRenderPass(draw_cmd_buffers[i]);
 			}
 
+			// Copy the fragment count to the readback slot of this command buffer, before the combine pass resets it
+			{
+				VkBufferMemoryBarrier counter_barrier = vkb::initializers::buffer_memory_barrier();
+				counter_barrier.srcAccessMask         = VK_ACCESS_SHADER_WRITE_BIT;
+				counter_barrier.dstAccessMask         = VK_ACCESS_TRANSFER_READ_BIT;
+				counter_barrier.buffer                = fragment_counter->get_handle();
+				counter_barrier.size                  = fragment_counter->get_size();
+				vkCmdPipelineBarrier(draw_cmd_buffers[i], VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &counter_barrier, 0, nullptr);
+
+				VkBufferCopy copy_region = {0, i * sizeof(glm::uint), sizeof(glm::uint)};
+				vkCmdCopyBuffer(draw_cmd_buffers[i], fragment_counter->get_handle(), fragment_counter_readback->get_handle(), 1, &copy_region);
+
+				counter_barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+				counter_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+				vkCmdPipelineBarrier(draw_cmd_buffers[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 1, &counter_barrier, 0, nullptr);
+
+				VkBufferMemoryBarrier readback_barrier = vkb::initializers::buffer_memory_barrier();
+				readback_barrier.srcAccessMask         = VK_ACCESS_TRANSFER_WRITE_BIT;
+				readback_barrier.dstAccessMask         = VK_ACCESS_HOST_READ_BIT;
+				readback_barrier.buffer                = fragment_counter_readback->get_handle();
+				readback_barrier.offset                = copy_region.dstOffset;
+				readback_barrier.size                  = copy_region.size;
+				vkCmdPipelineBarrier(draw_cmd_buffers[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &readback_barrier, 0, nullptr);
+			}
+
 			VkImageSubresourceRange subresource_range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 			vkb::image_layout_transition(
 			    draw_cmd_buffers[i], linked_list_head_image->get_handle(),
@@ -219,6 +261,9 @@ void OITLinkedLists::destroy_sized_objects()
 	vkDestroyFramebuffer(get_device().get_handle(), gather_framebuffer, nullptr);
 	vkDestroyRenderPass(get_device().get_handle(), gather_render_pass, nullptr);
 
+	fragment_counter_readback.reset();
+	fragment_counter_readback_capacity.clear();
+	fragment_stats = {};
 	fragment_counter.reset();
 	fragment_buffer.reset();
 	fragment_max_count = 0;
@@ -255,17 +300,29 @@ void OITLinkedLists::create_fragment_resources(const uint32_t width, const uint3
 		linked_list_head_image_view   = std::make_unique<vkb::core::ImageView>(*linked_list_head_image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R32_UINT);
 	}
 
+	// The pool starts from an average depth complexity, and adapts to the actual one from the next frames
+	create_fragment_buffer(width * height * kFragmentsPerPixelAverage);
+
 	{
-		fragment_max_count                  = width * height * kFragmentsPerPixelAverage;
-		const uint32_t fragment_buffer_size = sizeof(glm::uvec3) * fragment_max_count;
-		fragment_buffer                     = std::make_unique<vkb::core::BufferC>(get_device(), fragment_buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		fragment_counter = std::make_unique<vkb::core::BufferC>(get_device(), sizeof(glm::uint), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
 	}
 
 	{
-		fragment_counter = std::make_unique<vkb::core::BufferC>(get_device(), sizeof(glm::uint), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		const uint32_t slot_count = static_cast<uint32_t>(draw_cmd_buffers.size());
+		fragment_counter_readback = std::make_unique<vkb::core::BufferC>(get_device(), sizeof(glm::uint) * slot_count, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+		fragment_counter_readback_capacity.assign(slot_count, 0U);
 	}
 }
 
+void OITLinkedLists::create_fragment_buffer(const uint32_t max_count)
+{
+	const uint32_t device_max_count = get_device().get_gpu().get_properties().limits.maxStorageBufferRange / sizeof(glm::uvec3);
+
+	fragment_max_count                  = std::min(max_count, device_max_count);
+	const uint32_t fragment_buffer_size = sizeof(glm::uvec3) * fragment_max_count;
+	fragment_buffer                     = std::make_unique<vkb::core::BufferC>(get_device(), fragment_buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+}
+
 void OITLinkedLists::clear_sized_resources()
 {
 	VkCommandBuffer             command_buffer;
@@ -307,6 +364,81 @@ void OITLinkedLists::clear_sized_resources()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void OITLinkedLists::read_fragment_counter()
+{
+	const glm::uint capacity = fragment_counter_readback_capacity[current_buffer];
+	if (capacity == 0U)
+	{
+		return;
+	}
+
+	// The gather pass keeps counting the fragments it drops, so the counter holds the actual fragment count
+	fragment_counter_readback->invalidate(current_buffer * sizeof(glm::uint), sizeof(glm::uint));
+	const glm::uint count = reinterpret_cast<const glm::uint *>(fragment_counter_readback->get_data())[current_buffer];
+
+	fragment_stats.count          = count;
+	fragment_stats.overflow_count = count > capacity ? count - capacity : 0U;
+	fragment_stats.fill_ratio     = static_cast<float>(std::min(count, capacity)) / static_cast<float>(capacity);
+	if (fragment_stats.overflow_count > 0U)
+	{
+		++fragment_stats.overflow_frame_count;
+	}
+
+	fragment_stats.history.push_back(count);
+	if (fragment_stats.history.size() > kFragmentPoolPeakWindow)
+	{
+		fragment_stats.history.pop_front();
+	}
+	fragment_stats.peak_count = *std::max_element(fragment_stats.history.begin(), fragment_stats.history.end());
+}
+
+void OITLinkedLists::update_fragment_pool_size()
+{
+	if (!adaptive_fragment_pool)
+	{
+		// Back to the fixed size guessed from the average depth complexity
+		const uint32_t fixed_count = width * height * kFragmentsPerPixelAverage;
+		if (fragment_max_count != fixed_count)
+		{
+			resize_fragment_pool(fixed_count);
+		}
+		return;
+	}
+
+	if (fragment_stats.history.empty())
+	{
+		return;
+	}
+
+	const float    peak_count   = static_cast<float>(fragment_stats.peak_count);
+	const float    capacity     = static_cast<float>(fragment_max_count);
+	const uint32_t target_count = (static_cast<uint32_t>(peak_count * kFragmentPoolHeadroom) / kFragmentPoolGranularity + 1) * kFragmentPoolGranularity;
+
+	// Growing is immediate, while shrinking waits for a full window of frames well below the capacity
+	const bool grow   = peak_count > capacity * kFragmentPoolGrowThreshold;
+	const bool shrink = fragment_stats.history.size() == kFragmentPoolPeakWindow && peak_count < capacity * kFragmentPoolShrinkThreshold;
+	if ((grow && target_count > fragment_max_count) || (shrink && target_count < fragment_max_count))
+	{
+		resize_fragment_pool(target_count);
+	}
+}
+
+void OITLinkedLists::resize_fragment_pool(const uint32_t max_count)
+{
+	// The descriptor set and the command buffers referencing the fragment buffer must not be in use
+	get_device().wait_idle();
+
+	fragment_buffer.reset();
+	create_fragment_buffer(max_count);
+	++fragment_stats.resize_count;
+
+	update_descriptors();
+	update_scene_constants();
+	build_command_buffers();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void OITLinkedLists::load_assets()
 {
 	object             = load_model("scenes/geosphere.gltf");
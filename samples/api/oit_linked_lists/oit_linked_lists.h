@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "api_vulkan_sample.h"
 #include "rendering/render_pipeline.h"
 #include "scene_graph/components/camera.h"
@@ -39,8 +41,13 @@ class OITLinkedLists : public ApiVulkanSample
 	void destroy_sized_objects();
 	void create_gather_pass_objects(const uint32_t width, const uint32_t height);
 	void create_fragment_resources(const uint32_t width, const uint32_t height);
+	void create_fragment_buffer(const uint32_t max_count);
 	void clear_sized_resources();
 
+	void read_fragment_counter();
+	void update_fragment_pool_size();
+	void resize_fragment_pool(const uint32_t max_count);
+
 	void load_assets();
 	void create_constant_buffers();
 	void create_descriptors();
@@ -58,6 +65,14 @@ class OITLinkedLists : public ApiVulkanSample
 
 	static constexpr uint32_t kFragmentsPerPixelAverage = 8;
 
+	// The adaptive fragment pool is sized from the peak fragment count of the last frames, with some headroom.
+	// It grows as soon as the peak gets close to its capacity, and only shrinks when the peak stays well below it.
+	static constexpr uint32_t kFragmentPoolGranularity     = 64 * 1024;
+	static constexpr uint32_t kFragmentPoolPeakWindow      = 120;
+	static constexpr float    kFragmentPoolHeadroom        = 1.25f;
+	static constexpr float    kFragmentPoolGrowThreshold   = 0.9f;
+	static constexpr float    kFragmentPoolShrinkThreshold = 0.5f;
+
 	static constexpr int32_t kSortedFragmentMinCount = 1;
 	static constexpr int32_t kSortedFragmentMaxCount = 16;
 
@@ -95,6 +110,21 @@ class OITLinkedLists : public ApiVulkanSample
 	std::unique_ptr<vkb::core::BufferC>   fragment_counter;
 	glm::uint                             fragment_max_count = 0U;
 
+	// The fragment counter is copied to one slot per swapchain image, and read back when the image is used again
+	std::unique_ptr<vkb::core::BufferC> fragment_counter_readback;
+	std::vector<glm::uint>              fragment_counter_readback_capacity;        // Pool capacity of the frame that wrote each slot, 0 when not written yet
+
+	struct
+	{
+		std::deque<glm::uint> history;                          // Fragment counts of the last frames
+		glm::uint             count                = 0U;        // Fragments of the last frame read back, including the dropped ones
+		glm::uint             peak_count           = 0U;
+		glm::uint             overflow_count       = 0U;        // Fragments dropped in the last frame read back
+		float                 fill_ratio           = 0.0f;
+		uint32_t              overflow_frame_count = 0U;
+		uint32_t              resize_count         = 0U;
+	} fragment_stats;
+
 	VkRenderPass  gather_render_pass = VK_NULL_HANDLE;
 	VkFramebuffer gather_framebuffer = VK_NULL_HANDLE;
 
@@ -107,10 +137,11 @@ class OITLinkedLists : public ApiVulkanSample
 	VkPipeline       background_pipeline;
 	VkPipeline       combine_pipeline;
 
-	int32_t sort_fragments        = true;
-	int32_t camera_auto_rotation  = false;
-	int32_t sorted_fragment_count = kSortedFragmentMaxCount;
-	float   background_grayscale  = 0.3f;
+	int32_t sort_fragments         = true;
+	int32_t camera_auto_rotation   = false;
+	int32_t sorted_fragment_count  = kSortedFragmentMaxCount;
+	float   background_grayscale   = 0.3f;
+	int32_t adaptive_fragment_pool = true;
 };
 
 std::unique_ptr<vkb::VulkanSampleC> create_oit_linked_lists();
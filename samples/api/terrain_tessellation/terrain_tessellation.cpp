@@ -21,7 +21,10 @@
 
 #include "terrain_tessellation.h"
 
+#include <numeric>
+
 #include "heightmap.h"
+#include "timer.h"
 
 TerrainTessellation::TerrainTessellation()
 {
@@ -242,7 +245,8 @@ void TerrainTessellation::build_command_buffers()
 		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.terrain, 0, 1, &descriptor_sets.terrain, 0, NULL);
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, terrain.vertices->get(), offsets);
 		vkCmdBindIndexBuffer(draw_cmd_buffers[i], terrain.indices->get_handle(), 0, VK_INDEX_TYPE_UINT32);
-		vkCmdDrawIndexed(draw_cmd_buffers[i], terrain.index_count, 1, 0, 0, 0);
+		// The patches left after culling are written to the index buffer and the draw command each frame
+		vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], terrain.draw_command->get_handle(), 0, 1, sizeof(VkDrawIndexedIndirectCommand));
 		if (get_device().get_gpu().get_features().pipelineStatisticsQuery)
 		{
 			// End pipeline statistics query
@@ -261,89 +265,100 @@ void TerrainTessellation::build_command_buffers()
 void TerrainTessellation::generate_terrain()
 {
 	const uint32_t      patch_size   = 64;
+	const uint32_t      vertex_size  = patch_size << terrain_size;
 	const float         uv_scale     = 1.0f;
-	const uint32_t      vertex_count = patch_size * patch_size;
+	const uint32_t      vertex_count = vertex_size * vertex_size;
 	std::vector<Vertex> vertices(vertex_count);
 
 	const float wx = 2.0f;
 	const float wy = 2.0f;
 
-	for (auto x = 0; x < patch_size; x++)
+	// Larger terrains keep the same resolution, the height map is mirrored as the sampler does
+	vkb::HeightMap heightmap("textures/terrain_heightmap_r16.ktx", patch_size);
+
+	vkb::Timer timer;
+	timer.start();
+
+	for (auto x = 0; x < vertex_size; x++)
 	{
-		for (auto y = 0; y < patch_size; y++)
+		for (auto y = 0; y < vertex_size; y++)
 		{
-			uint32_t index         = (x + y * patch_size);
-			vertices[index].pos[0] = x * wx + wx / 2.0f - static_cast<float>(patch_size) * wx / 2.0f;
+			uint32_t index         = (x + y * vertex_size);
+			vertices[index].pos[0] = x * wx + wx / 2.0f - static_cast<float>(vertex_size) * wx / 2.0f;
 			vertices[index].pos[1] = 0.0f;
-			vertices[index].pos[2] = y * wy + wy / 2.0f - static_cast<float>(patch_size) * wy / 2.0f;
+			vertices[index].pos[2] = y * wy + wy / 2.0f - static_cast<float>(vertex_size) * wy / 2.0f;
 			vertices[index].uv     = glm::vec2(static_cast<float>(x) / patch_size, static_cast<float>(y) / patch_size) * uv_scale;
 		}
 	}
 
 	// Calculate normals from height map using a sobel filter
-	vkb::HeightMap heightmap("textures/terrain_heightmap_r16.ktx", patch_size);
-	for (auto x = 0; x < patch_size; x++)
+	heightmap.get_normals(0, 0, vertex_size, vertex_size, vkb::HeightMapAddressMode::MirroredRepeat, &vertices[0].normal.x, sizeof(Vertex));
+
+	// Indices, grouped in culling patches of 8 x 8 quads
+	const uint32_t w                  = (vertex_size - 1);
+	const uint32_t culling_patch_size = 8;
+	const uint32_t culling_patches    = (w + culling_patch_size - 1) / culling_patch_size;
+
+	std::vector<float> patch_height_ranges(culling_patches * culling_patches * 2);
+	terrain.patch_indices.clear();
+	terrain.patch_indices.reserve(w * w * 4);
+	terrain.patch_offsets.clear();
+	for (uint32_t patch_y = 0; patch_y < culling_patches; patch_y++)
 	{
-		for (auto y = 0; y < patch_size; y++)
+		for (uint32_t patch_x = 0; patch_x < culling_patches; patch_x++)
 		{
-			// Get height samples centered around current position
-			float heights[3][3];
-			for (auto hx = -1; hx <= 1; hx++)
+			uint32_t first_x = patch_x * culling_patch_size;
+			uint32_t first_y = patch_y * culling_patch_size;
+			uint32_t last_x  = std::min(first_x + culling_patch_size, w);
+			uint32_t last_y  = std::min(first_y + culling_patch_size, w);
+
+			terrain.patch_offsets.push_back(static_cast<uint32_t>(terrain.patch_indices.size()));
+			for (auto y = first_y; y < last_y; y++)
 			{
-				for (auto hy = -1; hy <= 1; hy++)
+				for (auto x = first_x; x < last_x; x++)
 				{
-					heights[hx + 1][hy + 1] = heightmap.get_height(x + hx, y + hy);
+					uint32_t index = (x + y * vertex_size);
+					terrain.patch_indices.insert(terrain.patch_indices.end(), {index, index + vertex_size, index + vertex_size + 1, index + 1});
 				}
 			}
 
-			// Calculate the normal
-			glm::vec3 normal;
-			// Gx sobel filter
-			normal.x = heights[0][0] - heights[2][0] + 2.0f * heights[0][1] - 2.0f * heights[2][1] + heights[0][2] - heights[2][2];
-			// Gy sobel filter
-			normal.z = heights[0][0] + 2.0f * heights[1][0] + heights[2][0] - heights[0][2] - 2.0f * heights[1][2] - heights[2][2];
-			// Calculate missing up component of the normal using the filtered x and y axis
-			// The first value controls the bump strength
-			normal.y = 0.25f * sqrt(1.0f - normal.x * normal.x - normal.z * normal.z);
-
-			vertices[x + y * patch_size].normal = glm::normalize(normal * glm::vec3(2.0f, 1.0f, 2.0f));
+			float *range = &patch_height_ranges[(patch_x + patch_y * culling_patches) * 2];
+			heightmap.get_height_range(first_x, first_y, last_x - first_x, last_y - first_y, vkb::HeightMapAddressMode::MirroredRepeat, range[0], range[1]);
 		}
 	}
+	terrain.patch_offsets.push_back(static_cast<uint32_t>(terrain.patch_indices.size()));
+	terrain.index_count = static_cast<uint32_t>(terrain.patch_indices.size());
 
-	// Indices
-	const uint32_t        w           = (patch_size - 1);
-	const uint32_t        index_count = w * w * 4;
-	std::vector<uint32_t> indices(index_count);
-	for (auto x = 0; x < w; x++)
-	{
-		for (auto y = 0; y < w; y++)
-		{
-			uint32_t index     = (x + y * w) * 4;
-			indices[index]     = (x + y * patch_size);
-			indices[index + 1] = indices[index] + patch_size;
-			indices[index + 2] = indices[index + 1] + 1;
-			indices[index + 3] = indices[index] + 1;
-		}
-	}
-	terrain.index_count = index_count;
+	// The last row and column of patches may be narrower, their bounds are then larger than needed
+	terrain.quadtree          = std::make_unique<vkb::TerrainQuadtree>(patch_height_ranges.data(), culling_patches, culling_patches);
+	terrain.layout.origin_x   = wx / 2.0f - static_cast<float>(vertex_size) * wx / 2.0f;
+	terrain.layout.origin_z   = wy / 2.0f - static_cast<float>(vertex_size) * wy / 2.0f;
+	terrain.layout.patch_size = culling_patch_size * wx;
+
+	terrain.generation_time = static_cast<float>(timer.stop<vkb::Timer::Milliseconds>());
 
 	uint32_t vertex_buffer_size = vertex_count * sizeof(Vertex);
-	uint32_t index_buffer_size  = index_count * sizeof(uint32_t);
+	uint32_t index_buffer_size  = terrain.index_count * sizeof(uint32_t);
 
 	// Create staging buffers
 
 	vkb::core::BufferC vertex_staging = vkb::core::BufferC::create_staging_buffer(get_device(), vertices);
-	vkb::core::BufferC index_staging  = vkb::core::BufferC::create_staging_buffer(get_device(), indices);
 
 	terrain.vertices = std::make_unique<vkb::core::BufferC>(get_device(),
 	                                                        vertex_buffer_size,
 	                                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 	                                                        VMA_MEMORY_USAGE_GPU_ONLY);
 
+	// Indices of the visible patches and the draw command are written by the host before each frame
 	terrain.indices = std::make_unique<vkb::core::BufferC>(get_device(),
 	                                                       index_buffer_size,
-	                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-	                                                       VMA_MEMORY_USAGE_GPU_ONLY);
+	                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+	                                                       VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+	terrain.draw_command = std::make_unique<vkb::core::BufferC>(get_device(),
+	                                                            sizeof(VkDrawIndexedIndirectCommand),
+	                                                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+	                                                            VMA_MEMORY_USAGE_CPU_TO_GPU);
 
 	// Copy from staging buffers
 	VkCommandBuffer copy_command = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
@@ -358,17 +373,51 @@ void TerrainTessellation::generate_terrain()
 	    1,
 	    &copy_region);
 
-	copy_region.size = index_buffer_size;
-	vkCmdCopyBuffer(
-	    copy_command,
-	    index_staging.get_handle(),
-	    terrain.indices->get_handle(),
-	    1,
-	    &copy_region);
-
 	get_device().flush_command_buffer(copy_command, queue, true);
 }
 
+// Select the patches to draw on the CPU, so that the tessellation stages only see the ones that may be visible
+void TerrainTessellation::update_visible_patches()
+{
+	visible_patches.clear();
+	if (patch_culling)
+	{
+		float frustum_planes[6][4];
+		for (size_t i = 0; i < 6; i++)
+		{
+			memcpy(frustum_planes[i], &frustum.get_planes()[i], sizeof(frustum_planes[i]));
+		}
+
+		// Terrain is displaced along -y by the evaluation shader
+		terrain.layout.height_scale = -ubo_tess.displacement_factor;
+
+		glm::vec3 eye = glm::vec3(glm::inverse(camera.matrices.view)[3]);
+		terrain.quadtree->cull(terrain.layout, frustum_planes, &eye.x, horizon_culling, visible_patches);
+	}
+	else
+	{
+		visible_patches.resize(terrain.quadtree->get_patch_count());
+		std::iota(visible_patches.begin(), visible_patches.end(), 0);
+	}
+
+	visible_indices.clear();
+	for (auto patch : visible_patches)
+	{
+		visible_indices.insert(visible_indices.end(),
+		                       terrain.patch_indices.begin() + terrain.patch_offsets[patch],
+		                       terrain.patch_indices.begin() + terrain.patch_offsets[patch + 1]);
+	}
+	if (!visible_indices.empty())
+	{
+		terrain.indices->update(visible_indices);
+	}
+
+	VkDrawIndexedIndirectCommand draw_command = {};
+	draw_command.indexCount                   = static_cast<uint32_t>(visible_indices.size());
+	draw_command.instanceCount                = 1;
+	terrain.draw_command->convert_and_update(draw_command);
+}
+
 void TerrainTessellation::setup_descriptor_pool()
 {
 	std::vector<VkDescriptorPoolSize> pool_sizes =
@@ -679,6 +728,9 @@ void TerrainTessellation::draw()
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 
+	// The previous frame has completed, its index and draw command buffers can be rewritten
+	update_visible_patches();
+
 	// Submit to queue
 	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
 
@@ -754,6 +806,22 @@ void TerrainTessellation::on_update_ui_overlay(vkb::Drawer &drawer)
 				rebuild_command_buffers();
 			}
 		}
+		if (drawer.combo_box("Terrain size", &terrain_size, {"64 x 64", "128 x 128", "256 x 256", "512 x 512"}))
+		{
+			get_device().wait_idle();
+			generate_terrain();
+			rebuild_command_buffers();
+		}
+		drawer.checkbox("Patch culling", &patch_culling);
+		if (patch_culling)
+		{
+			drawer.checkbox("Horizon culling", &horizon_culling);
+		}
+	}
+	if (drawer.header("Terrain"))
+	{
+		drawer.text("Generation: %.2f ms", terrain.generation_time);
+		drawer.text("Patches drawn: %d / %d", static_cast<uint32_t>(visible_patches.size()), terrain.quadtree->get_patch_count());
 	}
 	if (get_device().get_gpu().get_features().pipelineStatisticsQuery)
 	{
@@ -25,12 +25,21 @@
 #include "core/buffer.h"
 #include "geometry/frustum.h"
 
+#include <core/util/terrain.hpp>
+
 class TerrainTessellation : public ApiVulkanSample
 {
   public:
 	bool wireframe    = false;
 	bool tessellation = true;
 
+	// Terrain is 64 vertices per side, doubled for each size
+	int32_t terrain_size = 0;
+
+	// Culling of the patches of the terrain on the CPU, before the tessellation stages
+	bool patch_culling   = true;
+	bool horizon_culling = true;
+
 	struct
 	{
 		Texture heightmap;
@@ -51,9 +60,24 @@ class TerrainTessellation : public ApiVulkanSample
 	{
 		std::unique_ptr<vkb::core::BufferC> vertices;
 		std::unique_ptr<vkb::core::BufferC> indices;
+		std::unique_ptr<vkb::core::BufferC> draw_command;
 		uint32_t                            index_count;
+
+		// Quads of the culling patches, one patch after the other, with the first index of each patch
+		std::vector<uint32_t> patch_indices;
+		std::vector<uint32_t> patch_offsets;
+
+		std::unique_ptr<vkb::TerrainQuadtree> quadtree;
+		vkb::TerrainLayout                    layout;
+
+		// Time taken on the CPU by generate_terrain, in milliseconds
+		float generation_time = 0.0f;
 	} terrain;
 
+	// Patches drawn in the current frame, and their indices
+	std::vector<uint32_t> visible_patches;
+	std::vector<uint32_t> visible_indices;
+
 	struct
 	{
 		std::unique_ptr<vkb::core::BufferC> terrain_tessellation;
@@ -120,6 +144,7 @@ class TerrainTessellation : public ApiVulkanSample
 	void         load_assets();
 	void         build_command_buffers() override;
 	void         generate_terrain();
+	void         update_visible_patches();
 	void         setup_descriptor_pool();
 	void         setup_descriptor_set_layouts();
 	void         setup_descriptor_sets();
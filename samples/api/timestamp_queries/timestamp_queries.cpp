@@ -21,6 +21,8 @@
 
 #include "timestamp_queries.h"
 
+#include <cstring>
+
 #include "scene_graph/components/sub_mesh.h"
 
 TimestampQueries::TimestampQueries()
@@ -900,18 +902,20 @@ void TimestampQueries::get_time_stamp_results()
 	uint32_t count = static_cast<uint32_t>(bloom ? time_stamps.size() : time_stamps.size() - 2);
 
 	// Fetch the time stamp results written in the command buffer submissions
+	// Instead of reading them on the host right away, they are copied by the GPU to host visible memory through the readback service,
+	// which hands them over once the copy has completed, so the CPU never waits for the frame to finish
 	// A note on the flags used:
 	//	VK_QUERY_RESULT_64_BIT: Results will have 64 bits. As time stamp values are on nano-seconds, this flag should always be used to avoid 32 bit overflows
-	//  VK_QUERY_RESULT_WAIT_BIT: Since we want to immediately display the results, we use this flag to have the CPU wait until the results are available
-	vkGetQueryPoolResults(
-	    get_device().get_handle(),
+	//  VK_QUERY_RESULT_WAIT_BIT: The GPU waits until the results are available before copying them, the host does not wait at all
+	get_render_context().get_readback_service().read_query_results(
 	    query_pool_timestamps,
 	    0,
 	    count,
-	    time_stamps.size() * sizeof(uint64_t),
-	    time_stamps.data(),
 	    sizeof(uint64_t),
-	    VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+	    VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT,
+	    [this](const uint8_t *data, VkDeviceSize size) {
+		    std::memcpy(time_stamps.data(), data, static_cast<size_t>(size));
+	    });
 }
 
 void TimestampQueries::update_uniform_buffers()
@@ -934,10 +938,11 @@ void TimestampQueries::draw()
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
-	ApiVulkanSample::submit_frame();
 
-	// Read back the time stamp query results after the frame is finished
+	// Read back the time stamp query results, the copy is submitted after the frame
 	get_time_stamp_results();
+
+	ApiVulkanSample::submit_frame();
 }
 
 bool TimestampQueries::prepare(const vkb::ApplicationOptions &options)
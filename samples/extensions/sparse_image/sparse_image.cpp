@@ -27,54 +27,27 @@ SparseImage::~SparseImage()
 {
 	if (has_device())
 	{
-		vkDestroySemaphore(get_device().get_handle(), submit_semaphore, nullptr);
-		vkDestroySemaphore(get_device().get_handle(), bound_semaphore, nullptr);
+		vkDestroyCommandPool(get_device().get_handle(), upload_cmd_pool, nullptr);
 		vkDestroyPipeline(get_device().get_handle(), sample_pipeline, nullptr);
 		vkDestroyPipelineLayout(get_device().get_handle(), sample_pipeline_layout, nullptr);
 		vkDestroyDescriptorSetLayout(get_device().get_handle(), descriptor_set_layout, nullptr);
 		vkDestroySampler(get_device().get_handle(), texture_sampler, nullptr);
-		vkDestroyImageView(get_device().get_handle(), virtual_texture.texture_image_view, nullptr);
-		vkDestroyImage(get_device().get_handle(), virtual_texture.texture_image, nullptr);
 	}
 }
 
 /**
- * 	@brief Load the main .ktx file to be accessible from CPU's side.
+ * 	@brief Load the main .ktx file and create the virtual texture streaming it, its mip tail is resident from the start.
  */
 void SparseImage::load_assets()
 {
-	virtual_texture.raw_data_image = vkb::sg::Image::load("/textures/vulkan_logo_full.ktx", "/textures/vulkan_logo_full.ktx", vkb::sg::Image::ContentType::Color);
+	auto source = vkb::sg::Image::load("/textures/vulkan_logo_full.ktx", "/textures/vulkan_logo_full.ktx", vkb::sg::Image::ContentType::Color);
+	assert(source->get_format() == image_format);
 
-	assert(virtual_texture.raw_data_image->get_format() == image_format);
-	VkExtent3D   tex_extent = virtual_texture.raw_data_image->get_extent();
-	VkDeviceSize image_size = tex_extent.width * tex_extent.height * 4U;
+	vkb::VirtualTexture::Config config;
+	config.frames_in_flight = vkb::to_u32(draw_cmd_buffers.size());
+	config.mip_levels       = MIP_LEVELS;
 
-	virtual_texture.width  = tex_extent.width;
-	virtual_texture.height = tex_extent.height;
-}
-
-/**
- * 	@brief Create a dedicated queue (if available) for sparse-binding.
- */
-void SparseImage::create_sparse_bind_queue()
-{
-	const auto &queue_family_properties = get_device().get_gpu().get_queue_family_properties();
-
-	uint8_t sparse_queue_family_index = 0xFF;
-	for (uint32_t i = 0; i < static_cast<uint32_t>(queue_family_properties.size()); i++)
-	{
-		if ((queue_family_properties[i].queueFlags & VK_QUEUE_TRANSFER_BIT) && (queue_family_properties[i].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) && !(queue_family_properties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT))
-		{
-			sparse_queue_family_index = i;
-			break;
-		}
-	}
-
-	if (sparse_queue_family_index == 0xFF)
-	{
-		sparse_queue_family_index = get_device().get_queue_family_index(VK_QUEUE_SPARSE_BINDING_BIT);
-	}
-	vkGetDeviceQueue(get_device().get_handle(), sparse_queue_family_index, 0U, &sparse_queue);
+	virtual_texture = std::make_unique<vkb::VirtualTexture>(get_device(), std::move(source), config);
 }
 
 bool SparseImage::prepare(const vkb::ApplicationOptions &options)
@@ -92,24 +65,23 @@ bool SparseImage::prepare(const vkb::ApplicationOptions &options)
 	create_index_buffer();
 	create_uniform_buffers();
 
-	create_sparse_bind_queue();
-	create_sparse_texture_image();
 	create_texture_sampler();
 
 	create_descriptor_pool();
 	create_descriptor_sets();
 
+	create_upload_command_buffers();
+
 	prepare_pipelines();
 	build_command_buffers();
 
 	update_mvp();
 	update_frag_settings();
 
-	load_least_detailed_level();
-
-	mesh_data = CalculateMipLevelData(current_mvp_transform, VkExtent2D({static_cast<uint32_t>(virtual_texture.width), static_cast<uint32_t>(virtual_texture.height)}), VkExtent2D({static_cast<uint32_t>(width), static_cast<uint32_t>(height)}), static_cast<uint32_t>(num_vertical_blocks), static_cast<uint32_t>(num_horizontal_blocks), virtual_texture.mip_levels);
+	VkExtent3D texture_extent = virtual_texture->get_extent();
+	mesh_data                 = CalculateMipLevelData(current_mvp_transform, VkExtent2D({texture_extent.width, texture_extent.height}), VkExtent2D({static_cast<uint32_t>(width), static_cast<uint32_t>(height)}), static_cast<uint32_t>(num_vertical_blocks), static_cast<uint32_t>(num_horizontal_blocks), static_cast<uint8_t>(virtual_texture->get_mip_levels()));
 
-	next_stage = Stages::Idle;
+	request_visible_blocks();
 
 	prepared = true;
 	return true;
@@ -178,263 +150,6 @@ void SparseImage::setup_camera()
 	camera.translation_speed = 20.0f;
 }
 
-/**
- * 	@brief Fill up the information on how the sparse image should be bound and call vkQueueBindSparse.
- */
-void SparseImage::bind_sparse_image()
-{
-	for (size_t page_index = 0U; page_index < virtual_texture.page_table.size(); page_index++)
-	{
-		auto &page = virtual_texture.page_table[page_index];
-		if (!page.gen_mip_required && page.render_required_set.empty())
-		{
-			virtual_texture.sparse_image_memory_bind[page_index].memory = VK_NULL_HANDLE;
-			continue;
-		}
-
-		if (page.valid)
-		{
-			continue;
-		}
-
-		virtual_texture.memory_allocations.get_allocation(page.page_memory_info, page_index);
-
-		virtual_texture.sparse_image_memory_bind[page_index].memory       = page.page_memory_info.memory_sector->memory;
-		virtual_texture.sparse_image_memory_bind[page_index].memoryOffset = page.page_memory_info.offset;
-	}
-
-	VkBindSparseInfo bind_sparse_info = vkb::initializers::bind_sparse_info();
-	bind_sparse_info.bufferBindCount  = 0U;
-	bind_sparse_info.pBufferBinds     = nullptr;
-
-	VkSparseImageMemoryBindInfo sparse_image_memory_bind_info{};
-	sparse_image_memory_bind_info.image     = virtual_texture.texture_image;
-	sparse_image_memory_bind_info.bindCount = static_cast<uint32_t>(virtual_texture.sparse_image_memory_bind.size());
-	sparse_image_memory_bind_info.pBinds    = virtual_texture.sparse_image_memory_bind.data();
-
-	bind_sparse_info.imageBindCount = 1U;
-	bind_sparse_info.pImageBinds    = &sparse_image_memory_bind_info;
-
-	bind_sparse_info.signalSemaphoreCount = 1U;
-	bind_sparse_info.pSignalSemaphores    = &bound_semaphore;
-	bind_sparse_info.waitSemaphoreCount   = 1U;
-	bind_sparse_info.pWaitSemaphores      = &submit_semaphore;
-
-	VkFence           fence;
-	VkFenceCreateInfo fence_info{};
-	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	fence_info.flags = VK_FLAGS_NONE;
-
-	VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_info, nullptr, &fence));
-	vkQueueBindSparse(sparse_queue, 1U, &bind_sparse_info, fence);
-	VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &fence, VK_TRUE, DEFAULT_FENCE_TIMEOUT));
-	vkDestroyFence(get_device().get_handle(), fence, nullptr);
-}
-
-/**
- * 	@brief Return information on what mip_level the particular page_index belongs to.
- */
-uint8_t SparseImage::get_mip_level(size_t page_index)
-{
-	uint8_t mip_level = 0xFF;
-	if (virtual_texture.mip_levels == 1U)
-	{
-		return virtual_texture.base_mip_level;
-	}
-
-	for (uint32_t i = virtual_texture.base_mip_level; i < virtual_texture.mip_levels; i++)
-	{
-		if (page_index < (virtual_texture.mip_properties[i].mip_base_page_index + virtual_texture.mip_properties[i].mip_num_pages))
-		{
-			mip_level = i;
-			break;
-		}
-	}
-	return mip_level;
-}
-
-/**
- * 	@brief Calculate dependencies, fill the required lists and set required flags for the particular BLOCK to be updated on screen.
- */
-void SparseImage::process_texture_block(const TextureBlock &texture_block)
-{
-	std::vector<size_t> page_indices;
-
-	// Old value calculations and removal from the render required list
-	page_indices = get_memory_dependency_for_the_block(texture_block.column, texture_block.row, static_cast<uint8_t>(texture_block.old_mip_level));
-
-	for (auto page_index : page_indices)
-	{
-		if (!virtual_texture.page_table[page_index].fixed)
-		{
-			virtual_texture.page_table[page_index].render_required_set.erase({static_cast<uint8_t>(texture_block.old_mip_level), texture_block.column, texture_block.row});
-		}
-	}
-	page_indices.clear();
-
-	if (!texture_block.on_screen)
-	{
-		return;
-	}
-
-	// New value calculations and placing into update and render_required lists
-	page_indices = get_memory_dependency_for_the_block(texture_block.column, texture_block.row, static_cast<uint8_t>(texture_block.new_mip_level));
-
-	for (auto page_index : page_indices)
-	{
-		virtual_texture.page_table[page_index].render_required_set.insert({static_cast<uint8_t>(texture_block.new_mip_level), texture_block.column, texture_block.row});
-
-		if (!virtual_texture.page_table[page_index].valid)
-		{
-			virtual_texture.update_set.insert(page_index);
-
-			std::vector<MemPageDescription> mipgen_required_vec;
-			MemPageDescription              mem_page_description = get_mem_page_description(page_index);
-
-			mipgen_required_vec.push_back(mem_page_description);
-
-			while (!mipgen_required_vec.empty())
-			{
-				mem_page_description = mipgen_required_vec.back();
-				mipgen_required_vec.pop_back();
-
-				check_mip_page_requirements(mipgen_required_vec, mem_page_description);
-			}
-		}
-	}
-	page_indices.clear();
-}
-
-/**
- * 	@brief Fill the MemPageDescription data structure.
- */
-SparseImage::MemPageDescription SparseImage::get_mem_page_description(size_t page_index)
-{
-	MemPageDescription mem_page_description = {};
-	uint8_t            mip_level            = get_mip_level(page_index);
-
-	mem_page_description.mip_level = mip_level;
-	mem_page_description.x         = (page_index - virtual_texture.mip_properties[mip_level].mip_base_page_index) % virtual_texture.mip_properties[mip_level].num_columns;
-	mem_page_description.y         = (page_index - virtual_texture.mip_properties[mip_level].mip_base_page_index) / virtual_texture.mip_properties[mip_level].num_columns;
-
-	return mem_page_description;
-}
-
-/**
- * 	@brief Get the page_index of the particular page based on the MemPageDescription data structure.
- */
-size_t SparseImage::get_page_index(MemPageDescription mem_page_desc)
-{
-	return virtual_texture.mip_properties[mem_page_desc.mip_level].mip_base_page_index + virtual_texture.mip_properties[mem_page_desc.mip_level].num_columns * mem_page_desc.y + mem_page_desc.x;
-}
-
-/**
- * 	@brief Check if all the required resources (memory pages from the more detailed mip level) for the particular memory page to be rendered, are already allocated and valid in the memory.
- */
-void SparseImage::check_mip_page_requirements(std::vector<MemPageDescription> &mipgen_required_vec, MemPageDescription mem_page_desc)
-{
-	if (mem_page_desc.mip_level == 0U)
-	{
-		return;
-	}
-
-	MemPageDescription req_mem_page_desc;
-	req_mem_page_desc.mip_level = mem_page_desc.mip_level - 1;
-	for (uint8_t y = 0U; y < 2U; y++)
-	{
-		for (uint8_t x = 0U; x < 2U; x++)
-		{
-			req_mem_page_desc.x = std::min((mem_page_desc.x * 2U) + x, virtual_texture.mip_properties[req_mem_page_desc.mip_level].num_columns - 1U);
-			req_mem_page_desc.y = std::min((mem_page_desc.y * 2U) + y, virtual_texture.mip_properties[req_mem_page_desc.mip_level].num_rows - 1U);
-
-			size_t page_index = get_page_index(req_mem_page_desc);
-
-			virtual_texture.page_table[page_index].gen_mip_required = true;
-
-			if (!virtual_texture.page_table[page_index].valid)
-			{
-				if (req_mem_page_desc.mip_level > 0U)
-				{
-					mipgen_required_vec.push_back(req_mem_page_desc);
-				}
-				virtual_texture.update_set.insert(page_index);
-			}
-		}
-	}
-}
-
-/**
- * 	@brief Convert information from BLOCK-based into PAGE-based data. BLOCKS are just the abstraction units described by num_horizontal_blocks and num_vertical_blocks. PAGES are the actually allocated chunks of memory, their size is device-dependent.
- */
-std::vector<size_t> SparseImage::get_memory_dependency_for_the_block(size_t column, size_t row, uint8_t mip_level)
-{
-	std::vector<size_t> dependencies;
-
-	double height_on_screen_divider = 1.0 / num_vertical_blocks;
-	double width_on_screen_divider  = 1.0 / num_horizontal_blocks;
-
-	double x_low  = width_on_screen_divider * column;
-	double x_high = width_on_screen_divider * (column + 1U);
-
-	double y_low  = height_on_screen_divider * row;
-	double y_high = height_on_screen_divider * (row + 1U);
-
-	double texel_width  = virtual_texture.mip_properties[mip_level].width;
-	double texel_height = virtual_texture.mip_properties[mip_level].height;
-
-	double in_memory_row_pages    = texel_height / virtual_texture.format_properties.imageGranularity.height;
-	double in_memory_column_pages = texel_width / virtual_texture.format_properties.imageGranularity.width;
-
-	size_t mem_x_low  = static_cast<size_t>(floor(x_low * in_memory_column_pages));
-	size_t mem_x_high = static_cast<size_t>(ceil(x_high * in_memory_column_pages));
-
-	size_t mem_y_low  = static_cast<size_t>(floor(y_low * in_memory_row_pages));
-	size_t mem_y_high = static_cast<size_t>(ceil(y_high * in_memory_row_pages));
-
-	for (size_t y = mem_y_low; y < mem_y_high; y++)
-	{
-		for (size_t x = mem_x_low; x < mem_x_high; x++)
-		{
-			size_t page_index = virtual_texture.mip_properties[mip_level].mip_base_page_index + virtual_texture.mip_properties[mip_level].num_columns * y + x;
-			dependencies.push_back(page_index);
-		}
-	}
-	return dependencies;
-}
-
-/**
- * 	@brief Compare required and currently present mip_level for each BLOCK.
- */
-void SparseImage::compare_mips_table()
-{
-	virtual_texture.texture_block_update_set.clear();
-
-	for (size_t y = 0U; y < virtual_texture.current_mip_table.size(); y++)
-	{
-		for (size_t x = 0U; x < virtual_texture.current_mip_table[y].size(); x++)
-		{
-			if (!virtual_texture.new_mip_table[y][x].on_screen && virtual_texture.current_mip_table[y][x].on_screen)
-			{
-				// The particular block is removed from all render_required_set`s in page_table[] entries, because it was previously visible on screen, and is not anymore.
-				TextureBlock texture_block = {y, x, virtual_texture.current_mip_table[y][x].mip_level, virtual_texture.new_mip_table[y][x].mip_level, false};
-				process_texture_block(texture_block);
-
-				virtual_texture.current_mip_table[y][x] = virtual_texture.new_mip_table[y][x];        // These tables are equal in size
-				update_required                         = true;
-			}
-			else if (virtual_texture.new_mip_table[y][x].on_screen &&
-			         (!virtual_texture.current_mip_table[y][x].on_screen ||
-			          (static_cast<uint8_t>(virtual_texture.new_mip_table[y][x].mip_level) != static_cast<uint8_t>(virtual_texture.current_mip_table[y][x].mip_level))))
-			{
-				// The particular block is visible on screen and needs to be updated, because either it wasn't previously visible on screen or the required mip_level has changed.
-				TextureBlock texture_block = {y, x, virtual_texture.current_mip_table[y][x].mip_level, virtual_texture.new_mip_table[y][x].mip_level, true};
-				virtual_texture.texture_block_update_set.insert(texture_block);
-				update_required = true;
-			}
-		}
-	}
-}
-
 /**
  * 	@brief Update UBO with the MVP data, based on the camera.
  */
@@ -515,405 +230,95 @@ void SparseImage::build_command_buffers()
 }
 
 /**
- * 	@brief Run the update process for a number of blocks, described by blocks_to_update_per_cycle.
+ * 	@brief Calculate the required mip level for each texture block and request the visible ones from the virtual texture.
  */
-void SparseImage::process_texture_blocks()
+void SparseImage::request_visible_blocks()
 {
-	uint8_t block_counter;
-	block_counter = std::min(blocks_to_update_per_cycle, virtual_texture.texture_block_update_set.size());
-	frame_counter_per_transfer++;
-
-	auto it = virtual_texture.texture_block_update_set.begin();
-	for (; block_counter > 0U; it++, block_counter--)
-	{
-		process_texture_block(*it);
-		virtual_texture.current_mip_table[(*it).row][(*it).column] = virtual_texture.new_mip_table[(*it).row][(*it).column];
-	}
-	virtual_texture.texture_block_update_set.erase(virtual_texture.texture_block_update_set.begin(), it);
-}
-
-/**
- * 	@brief Bind the image, update all of the required pages by either loading the original data via staging buffer or generating mipmaps.
- */
-void SparseImage::update_and_generate()
-{
-	bind_sparse_image();
-	uint8_t current_mip_level = 0xFF;
-
-	std::vector<uint8_t> temp_buffer(virtual_texture.page_size);
-
-	size_t level_zero_count = std::count_if(
-	    virtual_texture.update_set.begin(), virtual_texture.update_set.end(), [this](auto page_index) { return get_mip_level(page_index) == 0; });
-	size_t level_zero_index = 0;
-
-	std::unique_ptr<vkb::core::BufferC> multi_page_buffer;
-	if (0 < level_zero_count)
-	{
-		multi_page_buffer = std::make_unique<vkb::core::BufferC>(get_device(), level_zero_count * virtual_texture.page_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT);
-	}
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	for (auto page_index : virtual_texture.update_set)
-	{
-		uint8_t mip_level = get_mip_level(page_index);
-
-		VkImageSubresourceRange subresource_range{};
-
-		subresource_range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-		subresource_range.baseArrayLayer = 0U;
-		subresource_range.layerCount     = 1U;
-		subresource_range.levelCount     = 1U;
-
-		if (current_mip_level != mip_level)
-		{
-			if (current_mip_level != 0xFF)
-			{
-				subresource_range.baseMipLevel = current_mip_level;
-				vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-				if (current_mip_level != 0)
-				{
-					subresource_range.baseMipLevel = current_mip_level - 1U;
-					vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-				}
-			}
-
-			subresource_range.baseMipLevel = mip_level;
-			vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
-			if (mip_level != 0)
-			{
-				subresource_range.baseMipLevel = mip_level - 1U;
-				vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, subresource_range);
-			}
-
-			current_mip_level = mip_level;
-		}
-
-		assert(virtual_texture.page_table[page_index].gen_mip_required || !virtual_texture.page_table[page_index].render_required_set.empty());
-		assert(!virtual_texture.page_table[page_index].valid);
-
-		VkExtent2D block_extent{};
-		block_extent.height = virtual_texture.sparse_image_memory_bind[page_index].extent.height;
-		block_extent.width  = virtual_texture.sparse_image_memory_bind[page_index].extent.width;
-
-		VkOffset2D block_offset{};
-		block_offset.x = virtual_texture.sparse_image_memory_bind[page_index].offset.x;
-		block_offset.y = virtual_texture.sparse_image_memory_bind[page_index].offset.y;
-
-		if (mip_level == 0U)
-		{
-			// Copying a single raw data block
-			for (size_t row = 0U; row < block_extent.height; row++)
-			{
-				size_t position = (row + block_offset.y) * (virtual_texture.width * 4U) + block_offset.x * 4U;
-				memcpy(&temp_buffer[row * block_extent.width * 4U], &virtual_texture.raw_data_image->get_data()[position], block_extent.width * 4U);
-			}
-
-			VkDeviceSize buffer_offset = level_zero_index++ * virtual_texture.page_size;
-			multi_page_buffer->update(temp_buffer, buffer_offset);
-
-			VkBufferImageCopy region{};
-			region.bufferOffset      = buffer_offset;
-			region.bufferRowLength   = 0U;
-			region.bufferImageHeight = 0U;
-
-			region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-			region.imageSubresource.mipLevel       = 0U;
-			region.imageSubresource.baseArrayLayer = 0U;
-			region.imageSubresource.layerCount     = 1U;
-
-			region.imageOffset = VkOffset3D({block_offset.x, block_offset.y, 0});
-			region.imageExtent = VkExtent3D({block_extent.width, block_extent.height, 1U});
-
-			vkCmdCopyBufferToImage(command_buffer, multi_page_buffer->get_handle(), virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1U, &region);
-
-			virtual_texture.page_table[page_index].valid = true;
-		}
-		else
-		{
-			VkImageBlit blit_cmd{};
-			blit_cmd.srcOffsets[0]                 = {(block_offset.x) * 2, (block_offset.y) * 2, 0};
-			blit_cmd.srcOffsets[1]                 = {(block_offset.x + static_cast<int>(block_extent.width)) * 2, (block_offset.y + static_cast<int>(block_extent.height)) * 2, 1};
-			blit_cmd.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-			blit_cmd.srcSubresource.mipLevel       = mip_level - 1U;
-			blit_cmd.srcSubresource.baseArrayLayer = 0U;
-			blit_cmd.srcSubresource.layerCount     = 1U;
-			blit_cmd.dstOffsets[0]                 = {block_offset.x, block_offset.y, 0};
-			blit_cmd.dstOffsets[1]                 = {block_offset.x + static_cast<int>(block_extent.width), block_offset.y + static_cast<int>(block_extent.height), 1};
-			blit_cmd.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-			blit_cmd.dstSubresource.mipLevel       = mip_level;
-			blit_cmd.dstSubresource.baseArrayLayer = 0U;
-			blit_cmd.dstSubresource.layerCount     = 1U;
-
-			vkCmdBlitImage(command_buffer,
-			               virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-			               virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			               1U, &blit_cmd,
-			               VK_FILTER_LINEAR);
-
-			virtual_texture.page_table[page_index].valid = true;
-		}
-	}
-	virtual_texture.update_set.clear();
-
-	VkImageSubresourceRange subresource_range{};
-
-	subresource_range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseArrayLayer = 0U;
-	subresource_range.layerCount     = 1U;
-	subresource_range.levelCount     = 1U;
-
-	if (current_mip_level != 0xFF)
+	if ((num_vertical_blocks != num_vertical_blocks_upd) || (num_horizontal_blocks != num_horizontal_blocks_upd))
 	{
-		subresource_range.baseMipLevel = current_mip_level;
-		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-		if (current_mip_level != 0)
-		{
-			subresource_range.baseMipLevel = current_mip_level - 1U;
-			vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-		}
-	}
-
-	get_device().flush_command_buffer(command_buffer, queue, true);
+		num_vertical_blocks   = num_vertical_blocks_upd;
+		num_horizontal_blocks = num_horizontal_blocks_upd;
 
-	for (auto &page : virtual_texture.page_table)
-	{
-		page.gen_mip_required = false;
+		mesh_data = CalculateMipLevelData(current_mvp_transform, mesh_data.texture_base_dim, mesh_data.screen_base_dim, static_cast<uint32_t>(num_vertical_blocks), static_cast<uint32_t>(num_horizontal_blocks), mesh_data.mip_levels);
 	}
-}
-
-/**
- * 	@brief Leave only render-required pages, free empty memory sectors, run defragmentation (if enabled), bind the image.
- */
-void SparseImage::free_unused_memory()
-{
-	for (size_t page_index = 0U; page_index < virtual_texture.page_table.size(); page_index++)
+	else
 	{
-		auto &page = virtual_texture.page_table[page_index];
-		if (page.render_required_set.empty() && page.valid)
-		{
-			page.valid  = false;
-			auto result = page.page_memory_info.memory_sector->available_offsets.insert(page.page_memory_info.offset);
-			page.page_memory_info.memory_sector->virt_page_indices.erase(page_index);
-			page.page_memory_info.memory_sector.reset();
-		}
+		mesh_data.mvp_transform = current_mvp_transform;
 	}
 
-	std::set<size_t> pages_to_reallocate;
-	uint8_t          sectors_to_reallocate = 0U;
+	mesh_data.calculate_mesh_coordinates();
+	mesh_data.calculate_mip_levels();
 
-	auto &sectors = virtual_texture.memory_allocations.get_memory_sectors();
-	for (auto it = sectors.begin(); it != sectors.end();)
+	// Rows of blocks go along the v axis of the texture, columns along the u axis
+	std::vector<vkb::VirtualTextureRequest> requests;
+	for (size_t row = 0U; row < mesh_data.mip_table.size(); row++)
 	{
-		if ((*it).expired())
+		for (size_t column = 0U; column < mesh_data.mip_table[row].size(); column++)
 		{
-			it = sectors.erase(it);
-			continue;
-		}
-
-		if (memory_defragmentation)
-		{
-			auto ptr = (*it).lock();
-			if (ptr->available_offsets.size() > MEMORY_FRAGMENTATION_CAP)
+			const auto &block = mesh_data.mip_table[row][column];
+			if (block.on_screen)
 			{
-				if (sectors_to_reallocate > 0U)
-				{
-					ptr->available_offsets.clear();        // This sector will not be used to allocate any additional pages
-					pages_to_reallocate.insert(ptr->virt_page_indices.begin(), ptr->virt_page_indices.end());
-				}
-				sectors_to_reallocate++;
+				vkb::VirtualTextureRequest request;
+				request.uv_min = glm::vec2(static_cast<float>(column) / num_horizontal_blocks, static_cast<float>(row) / num_vertical_blocks);
+				request.uv_max = glm::vec2(static_cast<float>(column + 1U) / num_horizontal_blocks, static_cast<float>(row + 1U) / num_vertical_blocks);
+				request.lod    = static_cast<float>(block.mip_level);
+				requests.push_back(request);
 			}
 		}
-		it++;
 	}
 
-	if (memory_defragmentation && !pages_to_reallocate.empty())
-	{
-		std::unique_ptr<vkb::core::BufferC> reallocation_buffer = std::make_unique<vkb::core::BufferC>(get_device(), virtual_texture.page_size * pages_to_reallocate.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-
-		VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-		std::vector<VkBufferImageCopy> copy_infos;
-
-		VkImageSubresourceLayers subresource_layers{};
-		subresource_layers.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-		subresource_layers.baseArrayLayer = 0U;
-		subresource_layers.layerCount     = 1U;
-
-		uint32_t index = 0U;
-		for (auto &page_index : pages_to_reallocate)
-		{
-			VkExtent2D block_extent{};
-			block_extent.height = virtual_texture.sparse_image_memory_bind[page_index].extent.height;
-			block_extent.width  = virtual_texture.sparse_image_memory_bind[page_index].extent.width;
-
-			VkOffset2D block_offset{};
-			block_offset.x = virtual_texture.sparse_image_memory_bind[page_index].offset.x;
-			block_offset.y = virtual_texture.sparse_image_memory_bind[page_index].offset.y;
-
-			subresource_layers.mipLevel = get_mip_level(page_index);
-
-			VkBufferImageCopy copy_info{};
-			copy_info.bufferOffset      = index * virtual_texture.page_size;
-			copy_info.bufferRowLength   = 0U;
-			copy_info.bufferImageHeight = 0U;
-			copy_info.imageSubresource  = subresource_layers;
-			copy_info.imageOffset       = VkOffset3D({block_offset.x, block_offset.y, 0});
-			copy_info.imageExtent       = VkExtent3D({block_extent.width, block_extent.height, 1U});
-
-			copy_infos.push_back(copy_info);
-			index++;
-		}
-
-		VkImageSubresourceRange subresource_range{};
-		subresource_range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-		subresource_range.baseArrayLayer = 0U;
-		subresource_range.layerCount     = 1U;
-		subresource_range.levelCount     = virtual_texture.mip_levels;
-		subresource_range.baseMipLevel   = virtual_texture.base_mip_level;
-
-		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, subresource_range);
-		vkCmdCopyImageToBuffer(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, reallocation_buffer->get_handle(), static_cast<uint32_t>(copy_infos.size()), copy_infos.data());
-		get_device().flush_command_buffer(command_buffer, queue, true);
-
-		std::vector<std::shared_ptr<MemSector>> temp_sectors;
-		for (auto &page_index : pages_to_reallocate)
-		{
-			auto &page = virtual_texture.page_table[page_index];
-
-			temp_sectors.push_back(page.page_memory_info.memory_sector);
-
-			page.page_memory_info.memory_sector->virt_page_indices.erase(page_index);
-			page.page_memory_info.memory_sector.reset();
-			page.valid = false;
-		}
-
-		sectors.sort(MemSectorCompare());
-		bind_sparse_image();
-
-		command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
-		vkCmdCopyBufferToImage(command_buffer, reallocation_buffer->get_handle(), virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copy_infos.size()), copy_infos.data());
-		vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-		get_device().flush_command_buffer(command_buffer, queue, true);
-
-		for (auto &page_index : pages_to_reallocate)
-		{
-			virtual_texture.page_table[page_index].valid = true;
-		}
-		temp_sectors.clear();
-	}
-	else
-	{
-		sectors.sort(MemSectorCompare());
-		bind_sparse_image();
-	}
+	virtual_texture->request(std::move(requests));
 }
 
 /**
- * 	@brief Generate the least detailed mip level, set it as unremovable, bind the image.
+ * 	@brief Create the command buffers recording the page uploads, re-recorded every frame.
  */
-void SparseImage::load_least_detailed_level()
+void SparseImage::create_upload_command_buffers()
 {
-	set_least_detailed_level();
-	compare_mips_table();
-	while (!virtual_texture.texture_block_update_set.empty())
-	{
-		process_texture_blocks();
-	}
-	VkSubmitInfo submit_info         = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-	submit_info.signalSemaphoreCount = 1;
-	submit_info.pSignalSemaphores    = &submit_semaphore;
-	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
+	VkCommandPoolCreateInfo command_pool_info = vkb::initializers::command_pool_create_info();
+	command_pool_info.flags                   = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	command_pool_info.queueFamilyIndex        = get_device().get_suitable_graphics_queue().get_family_index();
+	VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_info, nullptr, &upload_cmd_pool));
 
-	update_and_generate();
-}
+	upload_cmd_buffers.resize(draw_cmd_buffers.size());
 
-/**
- * 	@brief Handle the state machine.
- */
-void SparseImage::process_stage(Stages next_stage)
-{
-	switch (next_stage)
-	{
-		case Stages::Idle:
-			this->next_stage = Stages::FreeMemory;
-			break;
-
-		case Stages::CalculateMipsTable:
-			bind_sparse_image();
-			calculate_mips_table();
-			frame_counter_per_transfer = 0U;
-			this->next_stage           = Stages::CompareMipsTable;
-			break;
-
-		case Stages::CompareMipsTable:
-			bind_sparse_image();
-			compare_mips_table();
-			if (update_required)
-			{
-				this->next_stage = Stages::FreeMemory;
-			}
-			else
-			{
-				this->next_stage = Stages::CalculateMipsTable;
-			}
-			break;
-
-		case Stages::FreeMemory:
-			free_unused_memory();
-			if (virtual_texture.texture_block_update_set.empty())
-			{
-				this->next_stage = Stages::CalculateMipsTable;
-				update_required  = false;
-			}
-			else if (frame_counter_feature && (frame_counter_per_transfer > FRAME_COUNTER_CAP))
-			{
-				this->next_stage = Stages::CalculateMipsTable;
-			}
-			else
-			{
-				this->next_stage = Stages::ProcessTextureBlocks;
-			}
-			break;
-
-		case Stages::ProcessTextureBlocks:
-			bind_sparse_image();
-			process_texture_blocks();
-			this->next_stage = Stages::UpdateAndGenerate;
-			break;
-
-		case Stages::UpdateAndGenerate:
-			update_and_generate();
-			this->next_stage = Stages::FreeMemory;
-			break;
-
-		default:
-			assert(false);
-			break;
-	}
+	VkCommandBufferAllocateInfo allocate_info = vkb::initializers::command_buffer_allocate_info(upload_cmd_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, vkb::to_u32(upload_cmd_buffers.size()));
+	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &allocate_info, upload_cmd_buffers.data()));
 }
 
 /**
- * 	@brief Prepare and submit the frame.
+ * 	@brief Prepare and submit the frame, the page uploads are submitted ahead of the draw commands.
  */
 void SparseImage::draw()
 {
 	ApiVulkanSample::prepare_frame();
-	submit_info.commandBufferCount = 1U;
-	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
 
-	std::array<VkPipelineStageFlags, 2U> wait_stage_masks  = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-	std::array<VkSemaphore, 2U>          wait_semaphores   = {bound_semaphore, semaphores.acquired_image_ready};
-	std::array<VkSemaphore, 2U>          signal_semaphores = {submit_semaphore, semaphores.render_complete};
+	// The previous frame that used this command buffer has completed, submit_frame() waits for the queue to be idle
+	VkCommandBuffer          upload_cmd                = upload_cmd_buffers[current_buffer];
+	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
+	command_buffer_begin_info.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	VK_CHECK(vkBeginCommandBuffer(upload_cmd, &command_buffer_begin_info));
+	VkSemaphore bound_semaphore = virtual_texture->update(upload_cmd, current_buffer);
+	VK_CHECK(vkEndCommandBuffer(upload_cmd));
 
-	submit_info.waitSemaphoreCount = wait_semaphores.size();
+	std::array<VkCommandBuffer, 2U>   command_buffers  = {upload_cmd, draw_cmd_buffers[current_buffer]};
+	std::vector<VkPipelineStageFlags> wait_stage_masks = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+	std::vector<VkSemaphore>          wait_semaphores  = {semaphores.acquired_image_ready};
 
+	// The pages have to be bound before they are copied to
+	if (bound_semaphore != VK_NULL_HANDLE)
+	{
+		wait_stage_masks.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+		wait_semaphores.push_back(bound_semaphore);
+	}
+
+	submit_info.commandBufferCount   = vkb::to_u32(command_buffers.size());
+	submit_info.pCommandBuffers      = command_buffers.data();
+	submit_info.waitSemaphoreCount   = vkb::to_u32(wait_semaphores.size());
 	submit_info.pWaitSemaphores      = wait_semaphores.data();
 	submit_info.pWaitDstStageMask    = wait_stage_masks.data();
-	submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
-	submit_info.pSignalSemaphores    = signal_semaphores.data();
+	submit_info.signalSemaphoreCount = 1U;
+	submit_info.pSignalSemaphores    = &semaphores.render_complete;
 
 	VK_CHECK(vkQueueSubmit(queue, 1U, &submit_info, VK_NULL_HANDLE));
 	ApiVulkanSample::submit_frame();
@@ -929,14 +334,16 @@ void SparseImage::render(float delta_time)
 	{
 		update_mvp();
 	}
+	if (camera.updated || (num_vertical_blocks != num_vertical_blocks_upd) || (num_horizontal_blocks != num_horizontal_blocks_upd))
+	{
+		request_visible_blocks();
+	}
 	if (color_highlight_changed)
 	{
 		update_frag_settings();
 		color_highlight_changed = false;
 	}
 
-	process_stage(next_stage);
-
 	draw();
 }
 
@@ -945,30 +352,6 @@ std::unique_ptr<vkb::VulkanSampleC> create_sparse_image()
 	return std::make_unique<SparseImage>();
 }
 
-/**
- * 	@brief Generate the mesh and calculate required mip level for each texture block.
- */
-void SparseImage::calculate_mips_table()
-{
-	if ((num_vertical_blocks != num_vertical_blocks_upd) || (num_horizontal_blocks != num_horizontal_blocks_upd))
-	{
-		num_vertical_blocks   = num_vertical_blocks_upd;
-		num_horizontal_blocks = num_horizontal_blocks_upd;
-
-		reset_mip_table();
-		mesh_data = CalculateMipLevelData(current_mvp_transform, VkExtent2D({static_cast<uint32_t>(virtual_texture.width), static_cast<uint32_t>(virtual_texture.height)}), VkExtent2D({static_cast<uint32_t>(width), static_cast<uint32_t>(height)}), static_cast<uint32_t>(num_vertical_blocks), static_cast<uint32_t>(num_horizontal_blocks), virtual_texture.mip_levels);
-	}
-	else
-	{
-		mesh_data.mvp_transform = current_mvp_transform;
-	}
-
-	mesh_data.calculate_mesh_coordinates();
-	mesh_data.calculate_mip_levels();
-
-	virtual_texture.new_mip_table = mesh_data.mip_table;
-}
-
 /**
  * 	@brief Generate the mesh based on the current MVP transform and number of blocks.
  */
@@ -1285,7 +668,7 @@ void SparseImage::create_descriptor_sets()
 
 	VkDescriptorImageInfo image_info{};
 	image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	image_info.imageView   = virtual_texture.texture_image_view;
+	image_info.imageView   = virtual_texture->get_image_view();
 	image_info.sampler     = texture_sampler;
 
 	std::array<VkWriteDescriptorSet, 3U> write_descriptor_sets = {
@@ -1318,8 +701,8 @@ void SparseImage::update_frag_settings()
 {
 	FragSettingsData frag_settings = {};
 	frag_settings.color_highlight  = color_highlight;
-	frag_settings.minLOD           = virtual_texture.base_mip_level;
-	frag_settings.maxLOD           = virtual_texture.base_mip_level + virtual_texture.mip_levels - 1U;
+	frag_settings.minLOD           = 0;
+	frag_settings.maxLOD           = static_cast<int>(virtual_texture->get_mip_levels()) - 1;
 
 	frag_settings_data_buffer->update(&frag_settings, sizeof(FragSettingsData));
 }
@@ -1360,8 +743,8 @@ void SparseImage::create_texture_sampler()
 	sampler_info.compareOp               = VK_COMPARE_OP_ALWAYS;
 	sampler_info.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
 	sampler_info.mipLodBias              = 0.0f;
-	sampler_info.minLod                  = static_cast<float>(virtual_texture.base_mip_level);
-	sampler_info.maxLod                  = static_cast<float>(virtual_texture.mip_levels - 1U);
+	sampler_info.minLod                  = 0.0f;
+	sampler_info.maxLod                  = static_cast<float>(virtual_texture->get_mip_levels() - 1U);
 
 	VK_CHECK(vkCreateSampler(get_device().get_handle(), &sampler_info, nullptr, &texture_sampler));
 }
@@ -1383,239 +766,22 @@ void SparseImage::request_gpu_features(vkb::PhysicalDevice &gpu)
 	}
 }
 
-/**
- * @brief Setup least detailed level to be required and unremovable from the memory.
- */
-void SparseImage::set_least_detailed_level()
-{
-	// Setting the least detailed mip level to be constantly present in the memory (to avoid black spots on the screen)
-	size_t start_index = virtual_texture.mip_properties[virtual_texture.mip_levels - 1U].mip_base_page_index;
-	size_t num_pages   = virtual_texture.mip_properties[virtual_texture.mip_levels - 1U].mip_num_pages;
-
-	for (size_t page_index = start_index; page_index < (start_index + num_pages); page_index++)
-	{
-		virtual_texture.page_table[page_index].fixed = true;
-	}
-
-	for (auto &column : virtual_texture.new_mip_table)
-	{
-		for (auto &block : column)
-		{
-			block.mip_level = virtual_texture.mip_levels - 1U;
-		}
-	}
-}
-
-/**
- * @brief Create and setup the sparse texture.
- */
-void SparseImage::create_sparse_texture_image()
-{
-	//==================================================================================================
-	// Creating an Image
-	VkImageCreateInfo sparse_image_create_info = vkb::initializers::image_create_info();
-	sparse_image_create_info.imageType         = VK_IMAGE_TYPE_2D;
-
-	sparse_image_create_info.extent.width  = static_cast<uint32_t>(virtual_texture.width);
-	sparse_image_create_info.extent.height = static_cast<uint32_t>(virtual_texture.height);
-	sparse_image_create_info.extent.depth  = 1U;
-
-	/*
-	    The number of mip-levels is arbitrary.
-	    5 LODs fit well the current design (6th would be used from too far away).
-
-	    Before incrementing this value, one should consider handling the mip tail and binding it correctly:
-	     - vkGetImageSparseMemoryRequirements()
-	     - VkSparseImageOpaqueMemoryBindInfo
-	 */
-	virtual_texture.base_mip_level = 0U;
-	virtual_texture.mip_levels     = 5U;
-
-	sparse_image_create_info.mipLevels   = virtual_texture.mip_levels;
-	sparse_image_create_info.arrayLayers = 1U;
-
-	sparse_image_create_info.flags         = VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
-	sparse_image_create_info.format        = image_format;
-	sparse_image_create_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
-	sparse_image_create_info.initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
-	sparse_image_create_info.usage         = image_usage;
-	sparse_image_create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
-	sparse_image_create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
-
-	VK_CHECK(vkCreateImage(get_device().get_handle(), &sparse_image_create_info, nullptr, &virtual_texture.texture_image));
-
-	//==================================================================================================
-	// Calculating memory dependencies and defining total number of pages and page size
-
-	std::vector<VkSparseImageMemoryRequirements> sparse_image_memory_requirements;
-	VkMemoryRequirements                         memory_requirements;
-
-	uint32_t sparse_memory_req_count;
-	uint32_t memory_req_count;
-
-	vkGetImageSparseMemoryRequirements(
-	    get_device().get_handle(), virtual_texture.texture_image, &sparse_memory_req_count, sparse_image_memory_requirements.data());
-	sparse_image_memory_requirements.resize(sparse_memory_req_count);
-	vkGetImageSparseMemoryRequirements(
-	    get_device().get_handle(), virtual_texture.texture_image, &sparse_memory_req_count, sparse_image_memory_requirements.data());
-
-	vkGetImageMemoryRequirements(get_device().get_handle(), virtual_texture.texture_image, &memory_requirements);
-
-	virtual_texture.format_properties = sparse_image_memory_requirements[0].formatProperties;
-
-	// calculate page size
-	virtual_texture.page_size = virtual_texture.format_properties.imageGranularity.height * virtual_texture.format_properties.imageGranularity.width * 4U;
-
-	// calculate total number of pages
-	size_t num_total_pages    = 0U;
-	size_t current_mip_height = virtual_texture.height;
-	size_t current_mip_width  = virtual_texture.width;
-
-	virtual_texture.mip_properties.resize(virtual_texture.mip_levels);
-
-	for (uint32_t mip_level = 0U; mip_level < virtual_texture.mip_levels; mip_level++)
-	{
-		size_t numRows    = current_mip_height / virtual_texture.format_properties.imageGranularity.height + (current_mip_height % virtual_texture.format_properties.imageGranularity.height == 0U ? 0U : 1U);
-		size_t numColumns = current_mip_width / virtual_texture.format_properties.imageGranularity.width + (current_mip_width % virtual_texture.format_properties.imageGranularity.width == 0U ? 0U : 1U);
-
-		num_total_pages += numRows * numColumns;
-
-		virtual_texture.mip_properties[mip_level].width               = current_mip_width;
-		virtual_texture.mip_properties[mip_level].height              = current_mip_height;
-		virtual_texture.mip_properties[mip_level].num_columns         = numColumns;
-		virtual_texture.mip_properties[mip_level].num_rows            = numRows;
-		virtual_texture.mip_properties[mip_level].mip_num_pages       = numRows * numColumns;
-		virtual_texture.mip_properties[mip_level].mip_base_page_index = mip_level > 0U ? virtual_texture.mip_properties[mip_level - 1U].mip_base_page_index + virtual_texture.mip_properties[mip_level - 1U].mip_num_pages : 0U;
-
-		if (current_mip_height > 1U)
-		{
-			current_mip_height /= 2U;
-		}
-		if (current_mip_width > 1U)
-		{
-			current_mip_width /= 2U;
-		}
-	}
-
-	virtual_texture.width  = virtual_texture.mip_properties[0].width;
-	virtual_texture.height = virtual_texture.mip_properties[0].height;
-
-	virtual_texture.page_table.resize(num_total_pages);
-	virtual_texture.sparse_image_memory_bind.resize(num_total_pages);
-
-	// Resize table and reset page_table data
-	reset_mip_table();
-
-	// Memory allocation required data
-	virtual_texture.memory_allocations.device               = get_device().get_handle();
-	virtual_texture.memory_allocations.page_size            = virtual_texture.page_size;
-	virtual_texture.memory_allocations.memory_type_index    = get_device().get_memory_type(memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-	virtual_texture.memory_allocations.pages_per_allocation = PAGES_PER_ALLOC;
-
-	// Setting the constant data for memory page binding via vkQueueBindSparse()
-	for (size_t page_index = 0U; page_index < virtual_texture.page_table.size(); page_index++)
-	{
-		uint32_t mipLevel = get_mip_level(page_index);
-
-		auto &memory_bind_info = virtual_texture.sparse_image_memory_bind[page_index];
-		auto &mip_properties   = virtual_texture.mip_properties[mipLevel];
-
-		memory_bind_info.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		memory_bind_info.subresource.arrayLayer = 0U;
-		memory_bind_info.subresource.mipLevel   = mipLevel;
-		memory_bind_info.flags                  = 0U;
-
-		memory_bind_info.offset.x = static_cast<uint32_t>(((page_index - mip_properties.mip_base_page_index) % mip_properties.num_columns) * virtual_texture.format_properties.imageGranularity.width);
-		memory_bind_info.offset.y = static_cast<uint32_t>(((page_index - mip_properties.mip_base_page_index) / mip_properties.num_columns) * virtual_texture.format_properties.imageGranularity.height);
-		memory_bind_info.offset.z = 0;
-
-		memory_bind_info.extent.depth  = virtual_texture.format_properties.imageGranularity.depth;
-		memory_bind_info.extent.width  = (mip_properties.width - memory_bind_info.offset.x < virtual_texture.format_properties.imageGranularity.width) ? static_cast<uint32_t>(mip_properties.width - memory_bind_info.offset.x) : virtual_texture.format_properties.imageGranularity.width;
-		memory_bind_info.extent.height = (mip_properties.height - memory_bind_info.offset.y < virtual_texture.format_properties.imageGranularity.height) ? static_cast<uint32_t>(mip_properties.height - memory_bind_info.offset.y) : virtual_texture.format_properties.imageGranularity.height;
-	}
-
-	//==================================================================================================
-	// Creating texture image view
-
-	VkImageViewCreateInfo view_info           = vkb::initializers::image_view_create_info();
-	view_info.image                           = virtual_texture.texture_image;
-	view_info.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
-	view_info.format                          = image_format;
-	view_info.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-	view_info.subresourceRange.baseMipLevel   = virtual_texture.base_mip_level;
-	view_info.subresourceRange.levelCount     = virtual_texture.mip_levels;
-	view_info.subresourceRange.baseArrayLayer = 0U;
-	view_info.subresourceRange.layerCount     = 1U;
-
-	VK_CHECK(vkCreateImageView(get_device().get_handle(), &view_info, nullptr, &virtual_texture.texture_image_view));
-
-	VkCommandBuffer         command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-	VkImageSubresourceRange subresource_range{};
-
-	subresource_range.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseArrayLayer = 0U;
-	subresource_range.layerCount     = 1U;
-	subresource_range.levelCount     = virtual_texture.mip_levels;
-	subresource_range.baseMipLevel   = virtual_texture.base_mip_level;
-
-	vkb::image_layout_transition(command_buffer, virtual_texture.texture_image, VK_IMAGE_LAYOUT_PREINITIALIZED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresource_range);
-	get_device().flush_command_buffer(command_buffer, queue, true);
-
-	//==================================================================================================
-	// Synchronization primitives
-
-	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &submit_semaphore));
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &bound_semaphore));
-}
-
-/**
- * @brief Clear and potentially resize both current and new mip tables.
- */
-void SparseImage::reset_mip_table()
-{
-	virtual_texture.current_mip_table.clear();
-	virtual_texture.current_mip_table.resize(num_vertical_blocks);
-
-	virtual_texture.new_mip_table.clear();
-	virtual_texture.new_mip_table.resize(num_vertical_blocks);
-
-	for (size_t y = 0U; y < num_vertical_blocks; y++)
-	{
-		virtual_texture.current_mip_table[y].resize(num_horizontal_blocks);
-		virtual_texture.new_mip_table[y].resize(num_horizontal_blocks);
-
-		for (size_t x = 0U; x < num_horizontal_blocks; x++)
-		{
-			virtual_texture.current_mip_table[y][x].on_screen = false;
-			virtual_texture.new_mip_table[y][x].on_screen     = true;
-		}
-	}
-
-	for (auto &page : virtual_texture.page_table)
-	{
-		if (!page.fixed)
-		{
-			page.render_required_set.clear();
-		}
-	}
-}
-
 void SparseImage::on_update_ui_overlay(vkb::Drawer &drawer)
 {
 	if (drawer.header("Settings"))
 	{
 		color_highlight_changed = drawer.checkbox("Color highlight", &color_highlight);
-		drawer.checkbox("Memory defragmentation", &memory_defragmentation);
-		drawer.checkbox("Update prioritization", &frame_counter_feature);
-		drawer.slider_int("Blocks per cycle", reinterpret_cast<int32_t *>(&blocks_to_update_per_cycle), 1, 50);
 		drawer.slider_int("Vertical blocks", reinterpret_cast<int32_t *>(&num_vertical_blocks_upd), 1, 100);
 		drawer.slider_int("Horizontal blocks", reinterpret_cast<int32_t *>(&num_horizontal_blocks_upd), 1, 100);
 	}
 	if (drawer.header("Statistics"))
 	{
+		const auto &stats = virtual_texture->get_stats();
 		drawer.text("Memory usage in pages:");
-		drawer.text("* Virtual: %zu ", virtual_texture.page_table.size());
-		drawer.text("* Allocated: %zu ", virtual_texture.memory_allocations.get_size() * PAGES_PER_ALLOC);
+		drawer.text("* Resident: %u (%llu KiB)", stats.resident_pages, static_cast<unsigned long long>(stats.resident_pages * virtual_texture->get_page_size() / 1024U));
+		drawer.text("Last update:");
+		drawer.text("* Page faults: %u", stats.page_faults);
+		drawer.text("* Uploaded: %u (%llu KiB)", stats.pages_uploaded, static_cast<unsigned long long>(stats.upload_bytes / 1024U));
+		drawer.text("* Evicted: %u", stats.pages_evicted);
 	}
 }
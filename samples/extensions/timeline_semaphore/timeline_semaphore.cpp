@@ -97,7 +97,7 @@ void TimelineSemaphore::setup_shared_resources()
 
 	// Images and image views
 	{
-		const auto            present_index = get_device().get_queue_by_present(0).get_family_index();
+		const auto            present_index = get_render_context().has_swapchain() ? get_device().get_queue_by_present(0).get_family_index() : compute.queue_family_index;
 		auto                  sharing_mode  = VK_SHARING_MODE_CONCURRENT;
 		std::vector<uint32_t> queue_families{compute.queue_family_index};
 
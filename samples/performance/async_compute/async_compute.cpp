@@ -162,7 +162,8 @@ void AsyncComputeSample::prepare_render_targets()
 
 void AsyncComputeSample::setup_queues()
 {
-	present_graphics_queue = &get_device().get_queue_by_present(0);
+	// Offscreen rendering has no queue with present support
+	present_graphics_queue = get_render_context().has_swapchain() ? &get_device().get_queue_by_present(0) : &get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 	last_async_enabled     = async_enabled;
 
 	// Need to be careful about sync if we're going to suddenly switch to async compute.
@@ -0,0 +1,185 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "clustered_lighting.h"
+
+#include <random>
+
+#include <glm/gtc/constants.hpp>
+
+#include "common/vk_common.h"
+#include "core/util/job_system.hpp"
+#include "gltf_loader.h"
+#include "gui.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/node.h"
+#include "stats/stats.h"
+
+ClusteredLighting::ClusteredLighting()
+{
+	auto &config = get_configuration();
+
+	config.insert<vkb::IntSetting>(0, light_count, 256);
+	config.insert<vkb::IntSetting>(1, light_count, 1024);
+	config.insert<vkb::IntSetting>(2, light_count, max_light_count);
+
+	// Each draw binds its material and the light clusters, so the pipeline layouts bind through push descriptors or descriptor
+	// buffers when available, instead of allocating sets from the frame's pools, see vkb::PipelineLayout
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_MAINTENANCE_3_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, true);
+}
+
+bool ClusteredLighting::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!VulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	// Without a depth pre-pass every shaded fragment loops over the lights of its cluster, so overdraw is worth reducing
+	load_scene("scenes/sponza/Sponza01.gltf", true);
+
+	get_scene().clear_components<vkb::sg::Light>();
+	add_lights();
+
+	auto &camera_node = vkb::add_free_camera(get_scene(), "main_camera", get_render_context().get_surface_extent());
+	camera            = dynamic_cast<vkb::sg::PerspectiveCamera *>(&camera_node.get_component<vkb::sg::Camera>());
+
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("clustered_forward.frag");
+	auto              subpass = std::make_unique<vkb::ClusteredForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), get_scene(), *camera);
+	scene_subpass             = subpass.get();
+	subpass->set_debug_name("Clustered forward");
+
+	auto render_pipeline = std::make_unique<vkb::RenderPipeline>();
+	render_pipeline->add_subpass(std::move(subpass));
+	set_render_pipeline(std::move(render_pipeline));
+
+	// The GPU times of the passes are graphed under the names they are timed with
+	auto                     pass_stats = get_stats().request_gpu_pass_times({scene_subpass->get_debug_name(), "GUI"});
+	std::set<vkb::StatIndex> stats{vkb::StatIndex::frame_times, vkb::StatIndex::job_utilization, vkb::StatIndex::bind_commands, vkb::StatIndex::skipped_bind_commands};
+	stats.insert(pass_stats.begin(), pass_stats.end());
+	get_stats().request_stats(stats);
+	create_gui(*window, &get_stats());
+
+	return true;
+}
+
+void ClusteredLighting::prepare_render_context()
+{
+	// One thread index per job system worker, besides the one of the main thread
+	thread_count = vkb::JobSystem::get().get_worker_count() + 1;
+	get_render_context().prepare(thread_count);
+}
+
+void ClusteredLighting::add_lights()
+{
+	vkb::sg::AABB scene_bounds;
+	for (auto &mesh : get_scene().get_components<vkb::sg::Mesh>())
+	{
+		for (auto &node : mesh->get_nodes())
+		{
+			auto node_transform = node->get_transform().get_world_matrix();
+
+			vkb::sg::AABB world_bounds{mesh->get_bounds().get_min(), mesh->get_bounds().get_max()};
+			world_bounds.transform(node_transform);
+
+			scene_bounds.update(world_bounds.get_min());
+			scene_bounds.update(world_bounds.get_max());
+		}
+	}
+
+	glm::vec3 extent = scene_bounds.get_max() - scene_bounds.get_min();
+	amplitude        = extent.y * 0.1f;
+
+	// Fixed seed, so that benchmark runs are comparable
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> unit_distribution{0.0f, 1.0f};
+
+	vkb::sg::LightProperties props;
+	props.range = glm::length(extent) * 0.04f;
+
+	for (int i = 0; i < max_light_count; ++i)
+	{
+		glm::vec3 position = scene_bounds.get_min() + extent * glm::vec3(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator));
+
+		props.color     = glm::vec3(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator));
+		props.intensity = 0.0f;
+
+		auto &light = vkb::add_point_light(get_scene(), position, props);
+		lights.push_back({&light, position, unit_distribution(generator) * glm::two_pi<float>()});
+	}
+}
+
+void ClusteredLighting::update(float delta_time)
+{
+	elapsed_time += delta_time;
+
+	// Lights past the requested count have no intensity, which the subpass skips
+	for (int i = 0; i < max_light_count; ++i)
+	{
+		auto &moving_light = lights[i];
+
+		auto props      = moving_light.light->get_properties();
+		props.intensity = i < light_count ? light_intensity : 0.0f;
+		moving_light.light->set_properties(props);
+
+		auto &transform = moving_light.light->get_node()->get_transform();
+		transform.set_translation(moving_light.origin + glm::vec3(0.0f, amplitude * std::sin(elapsed_time + moving_light.phase), 0.0f));
+	}
+
+	VulkanSample::update(delta_time);
+}
+
+void ClusteredLighting::draw_gui()
+{
+	const auto &stats = scene_subpass->get_stats();
+
+	get_gui().show_options_window(
+	    /* body = */ [&]() {
+		    ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.55f);
+		    ImGui::SliderInt("##lightCount", &light_count, 0, max_light_count, "Lights: %d");
+		    ImGui::SameLine();
+		    ImGui::SliderFloat("##lightIntensity", &light_intensity, 0.0f, 4.0f, "Intensity: %.2f");
+		    ImGui::PopItemWidth();
+
+		    ImGui::Text("Visible: %u, per cluster: %.1f avg, %u max", stats.visible_light_count,
+		                static_cast<float>(stats.light_index_count) / std::max(stats.cluster_count, 1u), stats.max_cluster_light_count);
+
+		    if (ImGui::Checkbox("Parallel recording", &parallel_recording))
+		    {
+			    scene_subpass->set_recording_thread_count(parallel_recording ? thread_count - 1 : 0);
+		    }
+		    ImGui::SameLine();
+		    ImGui::Text("(%u threads)", thread_count - 1);
+		    ImGui::SameLine();
+		    if (ImGui::Checkbox("Sort by state", &state_sorting))
+		    {
+			    scene_subpass->set_state_sorting(state_sorting);
+		    }
+	    },
+	    /* lines = */ 3);
+}
+
+std::unique_ptr<vkb::VulkanSampleC> create_clustered_lighting()
+{
+	return std::make_unique<ClusteredLighting>();
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/render_pipeline.h"
+#include "rendering/subpasses/clustered_forward_subpass.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "vulkan_sample.h"
+
+/**
+ * @brief Stress test of clustered forward lighting: thousands of moving point lights in Sponza
+ */
+class ClusteredLighting : public vkb::VulkanSampleC
+{
+  public:
+	ClusteredLighting();
+
+	virtual ~ClusteredLighting() = default;
+
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+
+	virtual void prepare_render_context() override;
+
+	virtual void update(float delta_time) override;
+
+  private:
+	struct MovingLight
+	{
+		vkb::sg::Light *light;
+
+		glm::vec3 origin;
+
+		float phase;
+	};
+
+	static constexpr int max_light_count = 4096;
+
+	vkb::sg::PerspectiveCamera *camera{nullptr};
+
+	vkb::ClusteredForwardSubpass *scene_subpass{nullptr};
+
+	std::vector<MovingLight> lights;
+
+	// Height the lights move up and down by
+	float amplitude{0.0f};
+
+	float elapsed_time{0.0f};
+
+	int light_count{1024};
+
+	float light_intensity{1.0f};
+
+	// Threads the render context is prepared for, the scene draws are recorded on all but the main one
+	uint32_t thread_count{1};
+
+	bool parallel_recording{false};
+
+	bool state_sorting{false};
+
+	void add_lights();
+
+	virtual void draw_gui() override;
+};
+
+std::unique_ptr<vkb::VulkanSampleC> create_clustered_lighting();
@@ -18,6 +18,7 @@
 #include "multithreading_render_passes.h"
 
 #include "common/vk_common.h"
+#include "core/util/job_system.hpp"
 #include "filesystem/legacy.h"
 #include "gltf_loader.h"
 #include "gui.h"
@@ -197,11 +198,6 @@ std::vector<vkb::CommandBuffer *> MultithreadingRenderPasses::record_command_buf
 	auto use_multithreading = multithreading_mode != static_cast<int>(MultithreadingMode::None);
 	shadow_subpass->set_thread_index(use_multithreading ? 1 : 0);
 
-	if (use_multithreading && thread_pool.size() < 1)
-	{
-		thread_pool.resize(1);
-	}
-
 	switch (multithreading_mode)
 	{
 		case static_cast<int>(MultithreadingMode::PrimaryCommandBuffers):
@@ -234,12 +230,14 @@ void MultithreadingRenderPasses::record_separate_primary_command_buffers(std::ve
 	                                                                                             1);
 
 	// Recording shadow command buffer
-	auto shadow_buffer_future = thread_pool.push(
-	    [this, &shadow_command_buffer](size_t thread_id) {
+	vkb::JobCounter shadow_counter;
+	vkb::JobSystem::get().submit(
+	    [this, &shadow_command_buffer]() {
 		    shadow_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 		    draw_shadow_pass(shadow_command_buffer);
 		    shadow_command_buffer.end();
-	    });
+	    },
+	    &shadow_counter);
 
 	// Recording scene command buffer
 	main_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
@@ -250,7 +248,7 @@ void MultithreadingRenderPasses::record_separate_primary_command_buffers(std::ve
 	command_buffers.push_back(&main_command_buffer);
 
 	// Wait for recording
-	shadow_buffer_future.get();
+	vkb::JobSystem::get().wait(shadow_counter);
 }
 
 void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::vector<vkb::CommandBuffer *> &command_buffers, vkb::CommandBuffer &main_command_buffer)
@@ -281,12 +279,14 @@ void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::
 	auto &scene_framebuffer   = get_device().get_resource_cache().request_framebuffer(scene_render_target, scene_render_pass);
 
 	// Recording shadow command buffer
-	auto shadow_buffer_future = thread_pool.push(
-	    [this, &shadow_command_buffer, &shadow_render_pass, &shadow_framebuffer](size_t thread_id) {
+	vkb::JobCounter shadow_counter;
+	vkb::JobSystem::get().submit(
+	    [this, &shadow_command_buffer, &shadow_render_pass, &shadow_framebuffer]() {
 		    shadow_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &shadow_render_pass, &shadow_framebuffer, 0);
 		    draw_shadow_pass(shadow_command_buffer);
 		    shadow_command_buffer.end();
-	    });
+	    },
+	    &shadow_counter);
 
 	// Recording scene command buffer
 	vkb::ColorBlendState scene_color_blend_state;
@@ -298,7 +298,7 @@ void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::
 	scene_command_buffer.end();
 
 	// Wait for recording
-	shadow_buffer_future.get();
+	vkb::JobSystem::get().wait(shadow_counter);
 
 	// Recording main command buffer
 	main_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
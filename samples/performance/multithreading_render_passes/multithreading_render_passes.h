@@ -17,8 +17,6 @@
 
 #pragma once
 
-#include <ctpl_stl.h>
-
 #include "core/command_buffer.h"
 #include "rendering/render_pipeline.h"
 #include "rendering/subpasses/forward_subpass.h"
@@ -148,8 +146,6 @@ class MultithreadingRenderPasses : public vkb::VulkanSampleC
 	 */
 	vkb::sg::Camera *camera{};
 
-	ctpl::thread_pool thread_pool;
-
 	uint32_t swapchain_attachment_index{0};
 
 	uint32_t depth_attachment_index{1};
@@ -229,6 +229,9 @@ void Subpasses::update(float delta_time)
 			frame->reset();
 		}
 
+		// The G-buffer images of the render graph are created again with the new settings
+		render_graph.reset();
+
 		LOGI("Recreating render target");
 		get_render_context().recreate();
 	}
@@ -245,8 +248,14 @@ void Subpasses::draw_gui()
 		lines = lines * 2;
 	}
 
+	bool show_render_graph_stats = render_graph && configs[Config::RenderTechnique].value == 1;
+	if (show_render_graph_stats)
+	{
+		lines++;
+	}
+
 	get_gui().show_options_window(
-	    /* body = */ [this, lines]() {
+	    /* body = */ [this, lines, show_render_graph_stats]() {
 		    // Create a line for every config
 		    for (size_t i = 0; i < configs.size(); ++i)
 		    {
@@ -277,6 +286,12 @@ void Subpasses::draw_gui()
 
 			    ImGui::PopID();
 		    }
+
+		    if (show_render_graph_stats)
+		    {
+			    auto &stats = render_graph->get_stats();
+			    ImGui::Text("Render graph: %u image barriers in %u batches", stats.image_barrier_count, stats.barrier_batch_count);
+		    }
 	    },
 	    /* lines = */ vkb::to_u32(lines));
 }
@@ -320,20 +335,14 @@ std::unique_ptr<vkb::RenderPipeline> Subpasses::create_geometry_renderpass()
 	auto geometry_fs   = vkb::ShaderSource{"deferred/geometry.frag"};
 	auto scene_subpass = std::make_unique<vkb::GeometrySubpass>(get_render_context(), std::move(geometry_vs), std::move(geometry_fs), get_scene(), *camera);
 
-	// Outputs are depth, albedo, and normal
-	scene_subpass->set_output_attachments({1, 2, 3});
+	// Outputs are depth, albedo, and normal, the only attachments of the render pass
+	scene_subpass->set_output_attachments({0, 1, 2});
 
-	// Create geometry pipeline
+	// Create geometry pipeline, the render graph sets its load store operations and clear values
 	std::vector<std::unique_ptr<vkb::rendering::SubpassC>> scene_subpasses{};
 	scene_subpasses.push_back(std::move(scene_subpass));
 
-	auto geometry_render_pipeline = std::make_unique<vkb::RenderPipeline>(std::move(scene_subpasses));
-
-	geometry_render_pipeline->set_load_store(vkb::gbuffer::get_clear_store_all());
-
-	geometry_render_pipeline->set_clear_value(vkb::gbuffer::get_clear_value());
-
-	return geometry_render_pipeline;
+	return std::make_unique<vkb::RenderPipeline>(std::move(scene_subpasses));
 }
 
 std::unique_ptr<vkb::RenderPipeline> Subpasses::create_lighting_renderpass()
@@ -343,19 +352,14 @@ std::unique_ptr<vkb::RenderPipeline> Subpasses::create_lighting_renderpass()
 	auto lighting_fs      = vkb::ShaderSource{"deferred/lighting.frag"};
 	auto lighting_subpass = std::make_unique<vkb::LightingSubpass>(get_render_context(), std::move(lighting_vs), std::move(lighting_fs), *camera, get_scene());
 
-	// Inputs are depth, albedo, and normal from the geometry subpass
+	// Inputs are depth, albedo, and normal from the geometry render pass
 	lighting_subpass->set_input_attachments({1, 2, 3});
-	// Create lighting pipeline
+
+	// Create lighting pipeline, the render graph sets its load store operations and clear values
 	std::vector<std::unique_ptr<vkb::rendering::SubpassC>> lighting_subpasses{};
 	lighting_subpasses.push_back(std::move(lighting_subpass));
 
-	auto lighting_render_pipeline = std::make_unique<vkb::RenderPipeline>(std::move(lighting_subpasses));
-
-	lighting_render_pipeline->set_load_store(vkb::gbuffer::get_load_all_store_swapchain());
-
-	lighting_render_pipeline->set_clear_value(vkb::gbuffer::get_clear_value());
-
-	return lighting_render_pipeline;
+	return std::make_unique<vkb::RenderPipeline>(std::move(lighting_subpasses));
 }
 
 void draw_pipeline(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target, vkb::RenderPipeline &render_pipeline, vkb::Gui *gui = nullptr)
@@ -388,43 +392,75 @@ void Subpasses::draw_subpasses(vkb::CommandBuffer &command_buffer, vkb::RenderTa
 	draw_pipeline(command_buffer, render_target, *render_pipeline, &get_gui());
 }
 
-void Subpasses::draw_renderpasses(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+void Subpasses::create_render_graph(vkb::core::Image &swapchain_image)
 {
-	// First render pass (no gui)
-	draw_pipeline(command_buffer, render_target, *geometry_render_pipeline);
-
-	// Memory barriers needed
-	for (size_t i = 1; i < render_target.get_views().size(); ++i)
-	{
-		auto &view = render_target.get_views()[i];
+	render_graph        = std::make_unique<vkb::RenderGraph>(get_device());
+	render_graph_extent = {swapchain_image.get_extent().width, swapchain_image.get_extent().height};
+
+	// The swapchain image is in the color attachment layout before and after the render passes
+	swapchain_handle = render_graph->import_image("swapchain", swapchain_image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+	vkb::RenderGraph::ImageDesc depth_desc;
+	depth_desc.extent = render_graph_extent;
+	depth_desc.format = vkb::get_suitable_depth_format(get_device().get_gpu().get_handle());
+	depth_desc.usage  = rt_usage_flags;
+
+	vkb::RenderGraph::ImageDesc albedo_desc = depth_desc;
+	albedo_desc.format                      = albedo_format;
+
+	vkb::RenderGraph::ImageDesc normal_desc = depth_desc;
+	normal_desc.format                      = normal_format;
+
+	auto depth  = render_graph->create_image("depth", depth_desc);
+	auto albedo = render_graph->create_image("albedo", albedo_desc);
+	auto normal = render_graph->create_image("normal", normal_desc);
+
+	auto clear_store = vkb::gbuffer::get_clear_store_all();
+	auto load        = vkb::gbuffer::get_load_all_store_swapchain();
+	auto clear_value = vkb::gbuffer::get_clear_value();
+
+	render_graph->add_raster_pass("Geometry", *geometry_render_pipeline, [&](vkb::RenderGraph::PassBuilder &builder) {
+		builder.attach(depth, clear_store[1], clear_value[1]);
+		builder.attach(albedo, clear_store[2], clear_value[2]);
+		builder.attach(normal, clear_store[3], clear_value[3]);
+	});
+
+	// The G-buffer is loaded and read as input attachments, the graph transitions it between the render passes
+	render_graph->add_raster_pass(
+	    "Lighting", *lighting_render_pipeline,
+	    [&](vkb::RenderGraph::PassBuilder &builder) {
+		    builder.attach(swapchain_handle, load[0], clear_value[0]);
+		    builder.attach(depth, load[1], clear_value[1]);
+		    builder.attach(albedo, load[2], clear_value[2]);
+		    builder.attach(normal, load[3], clear_value[3]);
+	    },
+	    [this](vkb::CommandBuffer &command_buffer) { get_gui().draw(command_buffer); });
 
-		vkb::ImageMemoryBarrier barrier;
+	render_graph->compile();
+}
 
-		if (i == 1)
-		{
-			barrier.old_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-			barrier.new_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+void Subpasses::draw_renderpasses(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	// The render graph creates its own views of the swapchain image
+	auto &swapchain_image = const_cast<vkb::core::Image &>(render_target.get_views()[0].get_image());
 
-			barrier.src_stage_mask  = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-			barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-		}
-		else
+	auto &extent = render_target.get_extent();
+	if (!render_graph || render_graph_extent.width != extent.width || render_graph_extent.height != extent.height)
+	{
+		if (render_graph)
 		{
-			barrier.old_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-			barrier.new_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-			barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-			barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			// Frames in flight may still use the G-buffer images of the previous graph
+			get_device().wait_idle();
 		}
-
-		barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		barrier.dst_access_mask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
-
-		command_buffer.image_memory_barrier(view, barrier);
+		create_render_graph(swapchain_image);
+	}
+	else
+	{
+		render_graph->set_imported_image(swapchain_handle, swapchain_image);
 	}
 
-	// Second render pass
-	draw_pipeline(command_buffer, render_target, *lighting_render_pipeline, &get_gui());
+	// Both render passes, with a single batch of barriers between them
+	render_graph->execute(command_buffer);
 }
 
 void Subpasses::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
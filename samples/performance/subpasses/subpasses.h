@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "rendering/render_graph.h"
 #include "rendering/render_pipeline.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "vulkan_sample.h"
@@ -56,7 +57,7 @@ class Subpasses : public vkb::VulkanSampleC
 	std::unique_ptr<vkb::RenderPipeline> create_one_renderpass_two_subpasses();
 
 	/**
-	 * @return A geometry render pass which should run first
+	 * @return A geometry render pass which should run first, drawing to the depth, albedo and normal attachments
 	 */
 	std::unique_ptr<vkb::RenderPipeline> create_geometry_renderpass();
 
@@ -70,6 +71,11 @@ class Subpasses : public vkb::VulkanSampleC
 	 */
 	void draw_subpasses(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target);
 
+	/**
+	 * @brief Creates the render graph running the geometry and the lighting render passes, with its own G-buffer images
+	 */
+	void create_render_graph(vkb::core::Image &swapchain_image);
+
 	/**
 	 * @brief Draws using the bad practice: two separate render passes
 	 */
@@ -86,6 +92,13 @@ class Subpasses : public vkb::VulkanSampleC
 	/// 2. Bad pipeline with a lighting subpass in the second render pass
 	std::unique_ptr<vkb::RenderPipeline> lighting_render_pipeline{};
 
+	/// Runs the bad pipelines, recording the barriers between them
+	std::unique_ptr<vkb::RenderGraph> render_graph{};
+
+	vkb::RenderGraph::ImageHandle swapchain_handle{0};
+
+	VkExtent2D render_graph_extent{};
+
 	vkb::sg::PerspectiveCamera *camera{};
 
 	/**
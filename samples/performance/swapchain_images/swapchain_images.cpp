@@ -44,7 +44,8 @@ bool SwapchainImages::prepare(const vkb::ApplicationOptions &options)
 		return false;
 	}
 
-	load_scene("scenes/sponza/Sponza01.gltf");
+	// The frame rate does not depend on the scene content, so the sample starts rendering while meshes and images stream in
+	load_scene_async("scenes/sponza/Sponza01.gltf");
 
 	auto &camera_node = vkb::add_free_camera(get_scene(), "main_camera", get_render_context().get_surface_extent());
 	camera            = &camera_node.get_component<vkb::sg::Camera>();
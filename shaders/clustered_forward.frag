@@ -0,0 +1,139 @@
+#version 320 es
+/* Copyright (c) 2024, Mobica Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+precision highp float;
+
+#ifdef HAS_BASE_COLOR_TEXTURE
+layout(set = 0, binding = 0) uniform sampler2D base_color_texture;
+#endif
+
+layout(location = 0) in vec4 in_pos;
+layout(location = 1) in vec2 in_uv;
+layout(location = 2) in vec3 in_normal;
+
+layout(location = 0) out vec4 o_color;
+
+layout(set = 0, binding = 1) uniform GlobalUniform
+{
+	mat4 model;
+	mat4 view_proj;
+	vec3 camera_position;
+}
+global_uniform;
+
+// Push constants come with a limitation in the size of data.
+// The standard requires at least 128 bytes
+layout(push_constant, std430) uniform PBRMaterialUniform
+{
+	vec4  base_color_factor;
+	float metallic_factor;
+	float roughness_factor;
+}
+pbr_material_uniform;
+
+#include "lighting.h"
+
+// Lights applied to every fragment first, then the binned lights
+layout(set = 0, binding = 4, std430) readonly buffer LightsBuffer
+{
+	Light lights[];
+}
+lights_buffer;
+
+layout(set = 0, binding = 5) uniform ClusterUniform
+{
+	mat4  view;
+	mat4  view_proj;
+	uvec4 grid_size;               // grid_size.w represents the number of lights applied to every fragment
+	vec4  depth_params;            // depth_params.x represents the scale, depth_params.y the bias of the depth slicing
+}
+cluster_uniform;
+
+// Offset and count of the light indices of each cluster
+layout(set = 0, binding = 6, std430) readonly buffer ClustersBuffer
+{
+	uvec2 clusters[];
+}
+clusters_buffer;
+
+layout(set = 0, binding = 7, std430) readonly buffer LightIndicesBuffer
+{
+	uint light_indices[];
+}
+light_indices_buffer;
+
+vec3 apply_light(Light light, vec3 normal)
+{
+	if (light.position.w == DIRECTIONAL_LIGHT)
+	{
+		return apply_directional_light(light, normal);
+	}
+
+	vec3 contribution = light.position.w == POINT_LIGHT ? apply_point_light(light, in_pos.xyz, normal) : apply_spot_light(light, in_pos.xyz, normal);
+
+	// Fade lights out at their range, so that they do not pop at the edge of their clusters
+	if (light.direction.w > 0.0)
+	{
+		float ratio  = length(light.position.xyz - in_pos.xyz) / light.direction.w;
+		float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+		contribution *= window * window;
+	}
+
+	return contribution;
+}
+
+uint get_cluster_index()
+{
+	vec4  clip  = cluster_uniform.view_proj * vec4(in_pos.xyz, 1.0);
+	vec2  tile  = (clip.xy / clip.w * 0.5 + 0.5) * vec2(cluster_uniform.grid_size.xy);
+	float depth = -(cluster_uniform.view * vec4(in_pos.xyz, 1.0)).z;
+	float slice = log(depth) * cluster_uniform.depth_params.x + cluster_uniform.depth_params.y;
+
+	uvec3 cluster = min(uvec3(max(vec3(tile, slice), vec3(0.0))), cluster_uniform.grid_size.xyz - 1U);
+	return (cluster.z * cluster_uniform.grid_size.y + cluster.y) * cluster_uniform.grid_size.x + cluster.x;
+}
+
+void main(void)
+{
+	vec3 normal = normalize(in_normal);
+
+	vec3 light_contribution = vec3(0.0);
+
+	for (uint i = 0U; i < cluster_uniform.grid_size.w; ++i)
+	{
+		light_contribution += apply_light(lights_buffer.lights[i], normal);
+	}
+
+	uvec2 cluster = clusters_buffer.clusters[get_cluster_index()];
+	for (uint i = cluster.x; i < cluster.x + cluster.y; ++i)
+	{
+		light_contribution += apply_light(lights_buffer.lights[light_indices_buffer.light_indices[i]], normal);
+	}
+
+	vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
+
+#ifdef HAS_BASE_COLOR_TEXTURE
+	base_color = texture(base_color_texture, in_uv);
+#else
+	base_color = pbr_material_uniform.base_color_factor;
+#endif
+
+	vec3 ambient_color = vec3(0.2) * base_color.xyz;
+
+	o_color = vec4(ambient_color + light_contribution * base_color.xyz, base_color.w);
+}